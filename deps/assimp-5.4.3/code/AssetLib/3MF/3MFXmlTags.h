@@ -84,6 +84,9 @@ namespace XmlTag {
     const char* const transform = "transform";
     const char *const path = "path";
 
+    // Links <vertices> and <triangles> to the data decoded by the ModelStreamReader
+    const char *const stream_block = "assimp.streamblock";
+
     // Material definitions
     const char* const basematerials = "basematerials";
     const char* const basematerials_base = "base";
@@ -44,7 +44,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "D3MFImporter.h"
 #include "3MFXmlTags.h"
 #include "D3MFOpcPackage.h"
+#include "ModelStreamReader.h"
 #include "XmlSerializer.h"
+#include "Common/ParallelFor.h"
 
 #include <assimp/StringComparison.h>
 #include <assimp/StringUtils.h>
@@ -54,6 +56,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/scene.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/IOSystem.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/MemoryIOWrapper.h>
 #include <assimp/fast_atof.h>
 
 #include <cassert>
@@ -94,8 +98,8 @@ bool D3MFImporter::CanRead(const std::string &filename, IOSystem *pIOHandler, bo
     return true;
 }
 
-void D3MFImporter::SetupProperties(const Importer*) {
-    // empty
+void D3MFImporter::SetupProperties(const Importer *pImp) {
+    mNumThreads = GetWorkerThreadCount(pImp->GetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 0));
 }
 
 const aiImporterDesc *D3MFImporter::GetInfo() const {
@@ -105,9 +109,28 @@ const aiImporterDesc *D3MFImporter::GetInfo() const {
 void D3MFImporter::InternReadFile(const std::string &filename, aiScene *pScene, IOSystem *pIOHandler) {
     D3MFOpcPackage opcPackage(pIOHandler, filename);
 
+    // Decode the mesh data while the model part is inflated, only the
+    // remaining markup is parsed into a DOM.
+    IOStream *rootStream = opcPackage.OpenRootStreamed();
+    if (nullptr == rootStream) {
+        throw DeadlyImportError("Cannot open the model part of ", filename);
+    }
+
+    std::vector<char> skeleton;
+    std::vector<StreamedMeshBlock> blocks;
+    try {
+        ModelStreamReader reader(rootStream, mNumThreads > 1);
+        reader.Read(skeleton, blocks);
+    } catch (...) {
+        opcPackage.CloseStream(rootStream);
+        throw;
+    }
+    opcPackage.CloseStream(rootStream);
+
     XmlParser xmlParser;
-    if (xmlParser.parse(opcPackage.RootStream())) {
-        XmlSerializer xmlSerializer(&xmlParser);
+    MemoryIOStream skeletonStream(reinterpret_cast<const uint8_t *>(skeleton.data()), skeleton.size());
+    if (xmlParser.parse(&skeletonStream)) {
+        XmlSerializer xmlSerializer(&xmlParser, &blocks);
         xmlSerializer.ImportXml(pScene);
 
         const std::vector<aiTexture*> &tex =  opcPackage.GetEmbeddedTextures();
@@ -131,7 +131,7 @@ static bool IsEmbeddedTexture( const std::string &filename ) {
 }
 // ------------------------------------------------------------------------------------------------
 D3MFOpcPackage::D3MFOpcPackage(IOSystem *pIOHandler, const std::string &rFile) :
-        mRootStream(nullptr),
+        mRootFile(),
         mZipArchive() {
     mZipArchive = new ZipArchiveIOSystem(pIOHandler, rFile);
     if (!mZipArchive->isOpen()) {
@@ -166,11 +166,10 @@ D3MFOpcPackage::D3MFOpcPackage(IOSystem *pIOHandler, const std::string &rFile) :
 
             mZipArchive->Close(fileStream);
 
-            mRootStream = mZipArchive->Open(rootFile.c_str());
-            ai_assert(mRootStream != nullptr);
-            if (nullptr == mRootStream) {
+            if (!mZipArchive->Exists(rootFile.c_str())) {
                 throw DeadlyImportError("Cannot open root-file in archive : " + rootFile);
             }
+            mRootFile = rootFile;
         } else if (file == D3MF::XmlTag::CONTENT_TYPES_ARCHIVE) {
             ASSIMP_LOG_WARN("Ignored file of unsupported type CONTENT_TYPES_ARCHIVES", file);
         } else if (IsEmbeddedTexture(file)) {
@@ -184,12 +183,19 @@ D3MFOpcPackage::D3MFOpcPackage(IOSystem *pIOHandler, const std::string &rFile) :
 }
 
 D3MFOpcPackage::~D3MFOpcPackage() {
-    mZipArchive->Close(mRootStream);
     delete mZipArchive;
 }
 
-IOStream *D3MFOpcPackage::RootStream() const {
-    return mRootStream;
+IOStream *D3MFOpcPackage::OpenRootStreamed() {
+    if (mRootFile.empty()) {
+        return nullptr;
+    }
+
+    return mZipArchive->OpenStreamed(mRootFile.c_str());
+}
+
+void D3MFOpcPackage::CloseStream(IOStream *stream) {
+    mZipArchive->Close(stream);
 }
 
 const std::vector<aiTexture *> &D3MFOpcPackage::GetEmbeddedTextures() const {
@@ -199,7 +205,7 @@ const std::vector<aiTexture *> &D3MFOpcPackage::GetEmbeddedTextures() const {
 static const char *const ModelRef = "3D/3dmodel.model";
 
 bool D3MFOpcPackage::validate() {
-    if (nullptr == mRootStream || nullptr == mZipArchive) {
+    if (mRootFile.empty() || nullptr == mZipArchive) {
         return false;
     }
 
@@ -64,7 +64,8 @@ class D3MFOpcPackage {
 public:
     D3MFOpcPackage( IOSystem* pIOHandler, const std::string& file );
     ~D3MFOpcPackage();
-    IOStream* RootStream() const;
+    IOStream* OpenRootStreamed();
+    void CloseStream(IOStream *stream);
     bool validate();
     const std::vector<aiTexture*> &GetEmbeddedTextures() const;
 
@@ -73,7 +74,7 @@ protected:
     void LoadEmbeddedTextures(IOStream *fileStream, const std::string &filename);
 
 private:
-    IOStream* mRootStream;
+    std::string mRootFile;
     ZipArchiveIOSystem *mZipArchive;
     std::vector<aiTexture *> mEmbeddedTextures;
 };
@@ -0,0 +1,439 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+#ifndef ASSIMP_BUILD_NO_3MF_IMPORTER
+
+#include "ModelStreamReader.h"
+#include "3MFXmlTags.h"
+
+#include <assimp/IOStream.hpp>
+#include <assimp/StringUtils.h>
+#include <assimp/ai_assert.h>
+#include <assimp/fast_atof.h>
+
+#include <cstring>
+#include <string>
+#include <system_error>
+
+namespace Assimp {
+namespace D3MF {
+
+namespace {
+
+// the model part is inflated and decoded in chunks of this size
+static constexpr size_t ChunkSize = 1024 * 1024;
+
+static constexpr int IdNotSet = -1;
+
+inline bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline bool IsNameEnd(char c) {
+    return IsSpace(c) || c == '/' || c == '>';
+}
+
+inline bool IsTag(const char *name, const char *nameEnd, const char *tag) {
+    const size_t len = ::strlen(tag);
+    return static_cast<size_t>(nameEnd - name) == len && ::strncmp(name, tag, len) == 0;
+}
+
+// Calls func(name, nameEnd, value, valueEnd) for every attribute of the
+// start tag between cur and end, stops at the first malformed attribute.
+template <typename TFunc>
+void ForEachAttribute(const char *cur, const char *end, TFunc func) {
+    for (;;) {
+        while (cur < end && IsSpace(*cur)) {
+            ++cur;
+        }
+        if (cur >= end || *cur == '/' || *cur == '>') {
+            return;
+        }
+
+        const char *name = cur;
+        while (cur < end && *cur != '=' && !IsNameEnd(*cur)) {
+            ++cur;
+        }
+        const char *nameEnd = cur;
+        while (cur < end && IsSpace(*cur)) {
+            ++cur;
+        }
+        if (cur >= end || *cur != '=') {
+            return;
+        }
+        ++cur;
+        while (cur < end && IsSpace(*cur)) {
+            ++cur;
+        }
+        if (cur >= end || (*cur != '"' && *cur != '\'')) {
+            return;
+        }
+
+        const char quote = *cur++;
+        const char *value = cur;
+        while (cur < end && *cur != quote) {
+            ++cur;
+        }
+        if (cur >= end) {
+            return;
+        }
+        func(name, nameEnd, value, cur);
+        ++cur;
+    }
+}
+
+// Parses a real exactly like ai_strtof() does, so the result matches the DOM
+// based reader bit for bit. Short values are terminated in a stack buffer
+// instead of a std::string.
+ai_real ParseReal(const char *value, const char *valueEnd) {
+    char buffer[64];
+    const size_t length = static_cast<size_t>(valueEnd - value);
+    if (length >= sizeof(buffer)) {
+        return static_cast<ai_real>(ai_strtof(value, valueEnd));
+    }
+    ::memcpy(buffer, value, length);
+    buffer[length] = '\0';
+    return static_cast<ai_real>(static_cast<float>(::atof(buffer)));
+}
+
+// Same result as std::atoi() on the attribute value.
+int ParseInt(const char *value, const char *valueEnd) {
+    while (value < valueEnd && IsSpace(*value)) {
+        ++value;
+    }
+
+    return strtol10(value);
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+ModelStreamReader::ModelStreamReader(IOStream *stream, bool readAhead) :
+        mStream(stream),
+        mReadAhead(readAhead),
+        mEof(false),
+        mBuffer(),
+        mPos(0),
+        mEnd(0),
+        mAhead(),
+        mPending() {
+    ai_assert(nullptr != stream);
+    if (mReadAhead) {
+        mAhead.resize(ChunkSize);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+ModelStreamReader::~ModelStreamReader() {
+    if (mPending.valid()) {
+        mPending.wait();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ModelStreamReader::Read(std::vector<char> &skeleton, std::vector<StreamedMeshBlock> &blocks) {
+    enum class Mode {
+        Markup,
+        Vertices,
+        Triangles
+    };
+
+    Mode mode = Mode::Markup;
+    size_t block = 0;
+    // open child elements inside of the current <vertices> or <triangles> element
+    size_t depth = 0;
+    for (;;) {
+        // text content, only the one outside of the mesh data is kept
+        const char *data = mBuffer.data();
+        const char *lt = static_cast<const char *>(::memchr(data + mPos, '<', mEnd - mPos));
+        const size_t textEnd = (nullptr != lt) ? static_cast<size_t>(lt - data) : mEnd;
+        if (mode == Mode::Markup) {
+            skeleton.insert(skeleton.end(), data + mPos, data + textEnd);
+        }
+        mPos = textEnd;
+        if (nullptr == lt) {
+            if (!Fill()) {
+                break;
+            }
+            continue;
+        }
+
+        size_t length = 0;
+        while (!FindMarkupEnd(length)) {
+            if (!Fill()) {
+                // truncated document, leave the error handling to the xml parser
+                if (mode == Mode::Markup) {
+                    skeleton.insert(skeleton.end(), mBuffer.data() + mPos, mBuffer.data() + mEnd);
+                }
+                mPos = mEnd;
+                return;
+            }
+        }
+
+        const char *tag = mBuffer.data() + mPos;
+        const char *tagEnd = tag + length;
+        mPos += length;
+
+        // comments, processing instructions, CDATA and the doctype
+        if (tag[1] == '!' || tag[1] == '?') {
+            if (mode == Mode::Markup) {
+                skeleton.insert(skeleton.end(), tag, tagEnd);
+            }
+            continue;
+        }
+
+        const bool isEndTag = tag[1] == '/';
+        const bool isEmpty = !isEndTag && tagEnd[-2] == '/';
+        const char *name = tag + (isEndTag ? 2 : 1);
+        const char *nameEnd = name;
+        while (nameEnd < tagEnd && !IsNameEnd(*nameEnd)) {
+            ++nameEnd;
+        }
+
+        if (mode == Mode::Markup) {
+            const bool isVertices = IsTag(name, nameEnd, XmlTag::vertices);
+            if (isEndTag || !(isVertices || IsTag(name, nameEnd, XmlTag::triangles))) {
+                skeleton.insert(skeleton.end(), tag, tagEnd);
+                continue;
+            }
+
+            // link the element to its block
+            block = blocks.size();
+            blocks.emplace_back();
+            const std::string attribute = std::string(" ") + XmlTag::stream_block + "=\"" + ai_to_string(block) + "\"";
+            const char *close = isEmpty ? tagEnd - 2 : tagEnd - 1;
+            skeleton.insert(skeleton.end(), tag, close);
+            skeleton.insert(skeleton.end(), attribute.begin(), attribute.end());
+            skeleton.insert(skeleton.end(), close, tagEnd);
+            if (!isEmpty) {
+                mode = isVertices ? Mode::Vertices : Mode::Triangles;
+                depth = 0;
+            }
+            continue;
+        }
+
+        if (isEndTag) {
+            if (depth == 0) {
+                skeleton.insert(skeleton.end(), tag, tagEnd);
+                mode = Mode::Markup;
+            } else {
+                --depth;
+            }
+            continue;
+        }
+
+        if (depth == 0) {
+            if (mode == Mode::Vertices && IsTag(name, nameEnd, XmlTag::vertex)) {
+                DecodeVertex(nameEnd, tagEnd, blocks[block]);
+            } else if (mode == Mode::Triangles && IsTag(name, nameEnd, XmlTag::triangle)) {
+                DecodeTriangle(nameEnd, tagEnd, blocks[block]);
+            }
+        }
+        if (!isEmpty) {
+            ++depth;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ModelStreamReader::Fill() {
+    if (mEof) {
+        return false;
+    }
+
+    // keep the unprocessed rest in front of the new data
+    const size_t remaining = mEnd - mPos;
+    if (mPos != 0 && remaining != 0) {
+        ::memmove(mBuffer.data(), mBuffer.data() + mPos, remaining);
+    }
+    mPos = 0;
+    mEnd = remaining;
+    if (mBuffer.size() < remaining + ChunkSize) {
+        mBuffer.resize(remaining + ChunkSize);
+    }
+
+    size_t count = 0;
+    if (mReadAhead && !mPending.valid()) {
+        StartReadAhead();
+    }
+    if (mPending.valid()) {
+        count = mPending.get();
+        ::memcpy(mBuffer.data() + mEnd, mAhead.data(), count);
+        if (count == ChunkSize) {
+            StartReadAhead();
+        }
+    } else {
+        count = mStream->Read(mBuffer.data() + mEnd, 1, ChunkSize);
+    }
+
+    mEnd += count;
+    if (count < ChunkSize) {
+        mEof = true;
+    }
+
+    return count != 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ModelStreamReader::StartReadAhead() {
+    try {
+        mPending = std::async(std::launch::async, [this]() {
+            return mStream->Read(mAhead.data(), 1, ChunkSize);
+        });
+    } catch (const std::system_error &) {
+        // no threads available, continue reading on the calling thread
+        mReadAhead = false;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ModelStreamReader::FindMarkupEnd(size_t &length) {
+    const char *begin = mBuffer.data() + mPos;
+    const char *end = mBuffer.data() + mEnd;
+    const size_t available = static_cast<size_t>(end - begin);
+
+    auto findSequence = [&](const char *from, const char *sequence) {
+        const size_t len = ::strlen(sequence);
+        for (const char *cur = from; cur + len <= end; ++cur) {
+            if (*cur == *sequence && ::memcmp(cur, sequence, len) == 0) {
+                length = static_cast<size_t>(cur + len - begin);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (available < 2) {
+        return false;
+    }
+    if (begin[1] == '?') {
+        return findSequence(begin + 2, "?>");
+    }
+    if (begin[1] == '!') {
+        static constexpr char Comment[] = "<!--";
+        static constexpr char CData[] = "<![CDATA[";
+        if (available < sizeof(CData) - 1 && !mEof) {
+            return false;
+        }
+        if (available >= sizeof(Comment) - 1 && ::memcmp(begin, Comment, sizeof(Comment) - 1) == 0) {
+            return findSequence(begin + sizeof(Comment) - 1, "-->");
+        }
+        if (available >= sizeof(CData) - 1 && ::memcmp(begin, CData, sizeof(CData) - 1) == 0) {
+            return findSequence(begin + sizeof(CData) - 1, "]]>");
+        }
+        // the doctype, may contain an internal subset
+        for (const char *cur = begin + 2; cur < end; ++cur) {
+            if (*cur == '[') {
+                return findSequence(cur, "]>");
+            }
+            if (*cur == '>') {
+                length = static_cast<size_t>(cur + 1 - begin);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    char quote = 0;
+    for (const char *cur = begin + 1; cur < end; ++cur) {
+        if (quote != 0) {
+            if (*cur == quote) {
+                quote = 0;
+            }
+        } else if (*cur == '"' || *cur == '\'') {
+            quote = *cur;
+        } else if (*cur == '>') {
+            length = static_cast<size_t>(cur + 1 - begin);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ModelStreamReader::DecodeVertex(const char *attributes, const char *end, StreamedMeshBlock &block) {
+    aiVector3D vertex;
+    ForEachAttribute(attributes, end, [&vertex](const char *name, const char *nameEnd, const char *value, const char *valueEnd) {
+        if (nameEnd - name != 1) {
+            return;
+        }
+        switch (*name) {
+            case 'x': vertex.x = ParseReal(value, valueEnd); break;
+            case 'y': vertex.y = ParseReal(value, valueEnd); break;
+            case 'z': vertex.z = ParseReal(value, valueEnd); break;
+            default: break;
+        }
+    });
+
+    block.vertices.push_back(vertex);
+}
+
+// ------------------------------------------------------------------------------------------------
+void ModelStreamReader::DecodeTriangle(const char *attributes, const char *end, StreamedMeshBlock &block) {
+    int indices[3] = { 0, 0, 0 };
+    StreamedMeshBlock::TriangleProperty property = { block.indices.size() / 3, IdNotSet, { IdNotSet, IdNotSet, IdNotSet } };
+    bool hasPid = false;
+    ForEachAttribute(attributes, end, [&](const char *name, const char *nameEnd, const char *value, const char *valueEnd) {
+        if (nameEnd - name == 2 && name[1] >= '1' && name[1] <= '3') {
+            if (name[0] == 'v') {
+                indices[name[1] - '1'] = ParseInt(value, valueEnd);
+            } else if (name[0] == 'p') {
+                property.pindex[name[1] - '1'] = ParseInt(value, valueEnd);
+            }
+        } else if (IsTag(name, nameEnd, XmlTag::pid)) {
+            property.pid = ParseInt(value, valueEnd);
+            hasPid = true;
+        }
+    });
+
+    for (int index : indices) {
+        block.indices.push_back(static_cast<unsigned int>(index));
+    }
+    if (hasPid) {
+        block.properties.push_back(property);
+    }
+}
+
+} // namespace D3MF
+} // namespace Assimp
+
+#endif // ASSIMP_BUILD_NO_3MF_IMPORTER
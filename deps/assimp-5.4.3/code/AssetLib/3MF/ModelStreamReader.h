@@ -0,0 +1,123 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file  ModelStreamReader.h
+ *  @brief Single-pass reader for the 3MF model part, which decodes vertex
+ *      and triangle data while the part is inflated instead of building a
+ *      DOM for the whole document.
+ */
+#pragma once
+
+#include <assimp/types.h>
+
+#include <cstddef>
+#include <future>
+#include <vector>
+
+namespace Assimp {
+
+class IOStream;
+
+namespace D3MF {
+
+// ---------------------------------------------------------------------------
+/// @brief The data of one <vertices> or <triangles> element, decoded by the
+///        ModelStreamReader.
+// ---------------------------------------------------------------------------
+struct StreamedMeshBlock {
+    /// Material properties of a triangle which carries a pid attribute.
+    struct TriangleProperty {
+        size_t triangle;
+        int pid;
+        int pindex[3];
+    };
+
+    std::vector<aiVector3D> vertices;
+    std::vector<unsigned int> indices; // three per triangle
+    std::vector<TriangleProperty> properties;
+};
+
+// ---------------------------------------------------------------------------
+/// @brief Reads a model part in one pass.
+///
+/// The <vertex> and <triangle> elements are decoded directly into
+/// StreamedMeshBlock arrays. All other markup is passed through into a
+/// skeleton document, where every <vertices> and <triangles> element gets
+/// an XmlTag::stream_block attribute holding the index of its block. The
+/// skeleton is small and can be handed to the XmlParser as usual.
+// ---------------------------------------------------------------------------
+class ModelStreamReader {
+public:
+    /// @brief The class constructor.
+    /// @param stream       The stream of the model part, read sequentially.
+    /// @param readAhead    true to inflate the next chunk on a worker thread
+    ///                     while the current one is decoded.
+    ModelStreamReader(IOStream *stream, bool readAhead);
+
+    /// @brief The class destructor.
+    ~ModelStreamReader();
+
+    /// @brief Reads the whole stream.
+    /// @param skeleton     Receives the markup without vertex and triangle data.
+    /// @param blocks       Receives the decoded mesh blocks.
+    void Read(std::vector<char> &skeleton, std::vector<StreamedMeshBlock> &blocks);
+
+private:
+    bool Fill();
+    void StartReadAhead();
+    size_t ReadChunk(char *buffer);
+    bool FindMarkupEnd(size_t &length);
+    void DecodeVertex(const char *tag, const char *end, StreamedMeshBlock &block);
+    void DecodeTriangle(const char *tag, const char *end, StreamedMeshBlock &block);
+
+private:
+    IOStream *mStream;
+    bool mReadAhead;
+    bool mEof;
+    std::vector<char> mBuffer;
+    size_t mPos;
+    size_t mEnd;
+    std::vector<char> mAhead;
+    std::future<size_t> mPending;
+};
+
+} // namespace D3MF
+} // namespace Assimp
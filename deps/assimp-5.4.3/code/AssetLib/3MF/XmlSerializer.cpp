@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "D3MFOpcPackage.h"
 #include "3MFXmlTags.h"
 #include "3MFTypes.h"
+#include "ModelStreamReader.h"
 #include <assimp/scene.h>
 
 #include <utility>
@@ -199,10 +200,11 @@ void assignDiffuseColor(XmlNode &node, aiMaterial *mat) {
 
 } // namespace
 
-XmlSerializer::XmlSerializer(XmlParser *xmlParser) :
+XmlSerializer::XmlSerializer(XmlParser *xmlParser, std::vector<StreamedMeshBlock> *streamedBlocks) :
         mResourcesDictionnary(),
         mMeshCount(0),
-        mXmlParser(xmlParser) {
+        mXmlParser(xmlParser),
+        mStreamedBlocks(streamedBlocks) {
     ai_assert(nullptr != xmlParser);
 }
 
@@ -436,14 +438,28 @@ void XmlSerializer::ReadMetadata(XmlNode &node) {
     mMetaData.push_back(entry);
 }
 
+StreamedMeshBlock *XmlSerializer::GetStreamedBlock(XmlNode &node) {
+    pugi::xml_attribute attribute = node.attribute(XmlTag::stream_block);
+    if (nullptr == mStreamedBlocks || attribute.empty()) {
+        return nullptr;
+    }
+
+    const size_t index = static_cast<size_t>(attribute.as_ullong());
+    return index < mStreamedBlocks->size() ? &(*mStreamedBlocks)[index] : nullptr;
+}
+
 void XmlSerializer::ImportVertices(XmlNode &node, aiMesh *mesh) {
     ai_assert(nullptr != mesh);
 
     std::vector<aiVector3D> vertices;
-    for (XmlNode &currentNode : node.children()) {
-        const std::string currentName = currentNode.name();
-        if (currentName == XmlTag::vertex) {
-            vertices.push_back(ReadVertex(currentNode));
+    if (StreamedMeshBlock *block = GetStreamedBlock(node)) {
+        vertices.swap(block->vertices);
+    } else {
+        for (XmlNode &currentNode : node.children()) {
+            const std::string currentName = currentNode.name();
+            if (currentName == XmlTag::vertex) {
+                vertices.push_back(ReadVertex(currentNode));
+            }
         }
     }
 
@@ -453,6 +469,27 @@ void XmlSerializer::ImportVertices(XmlNode &node, aiMesh *mesh) {
 }
 
 void XmlSerializer::ImportTriangles(XmlNode &node, aiMesh *mesh) {
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+
+    if (StreamedMeshBlock *block = GetStreamedBlock(node)) {
+        mesh->mNumFaces = static_cast<unsigned int>(block->indices.size() / 3);
+        mesh->mFaces = new aiFace[mesh->mNumFaces];
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            aiFace &face = mesh->mFaces[i];
+            face.mNumIndices = 3;
+            face.mIndices = new unsigned int[3];
+            std::copy(&block->indices[i * 3], &block->indices[i * 3] + 3, face.mIndices);
+        }
+
+        for (const StreamedMeshBlock::TriangleProperty &property : block->properties) {
+            AssignTriangleProperties(mesh, mesh->mFaces[property.triangle].mIndices, property.pid, property.pindex);
+        }
+
+        std::vector<unsigned int>().swap(block->indices);
+        std::vector<StreamedMeshBlock::TriangleProperty>().swap(block->properties);
+        return;
+    }
+
     std::vector<aiFace> faces;
     for (XmlNode &currentNode : node.children()) {
         const std::string currentName = currentNode.name();
@@ -462,85 +499,94 @@ void XmlSerializer::ImportTriangles(XmlNode &node, aiMesh *mesh) {
 
             int pindex[3];
             aiFace face = ReadTriangle(currentNode, pindex[0], pindex[1], pindex[2]);
-            if (hasPid && (pindex[0] != IdNotSet || pindex[1] != IdNotSet || pindex[2] != IdNotSet)) {
-                auto it = mResourcesDictionnary.find(pid);
-                if (it != mResourcesDictionnary.end()) {
-                    if (it->second->getType() == ResourceType::RT_BaseMaterials) {
-                        BaseMaterials *baseMaterials = static_cast<BaseMaterials *>(it->second);
-
-                        auto update_material = [&](int idx) {
-                            if (pindex[idx] != IdNotSet) {
-                                mesh->mMaterialIndex = baseMaterials->mMaterialIndex[pindex[idx]];
-                            }
-                        };
+            if (hasPid) {
+                AssignTriangleProperties(mesh, face.mIndices, pid, pindex);
+            }
 
-                        update_material(0);
-                        update_material(1);
-                        update_material(2);
+            faces.push_back(face);
+        }
+    }
 
-                    } else if (it->second->getType() == ResourceType::RT_Texture2DGroup) {
-                        // Load texture coordinates into mesh, when any
-                        Texture2DGroup *group = static_cast<Texture2DGroup *>(it->second); // fix bug
-                        if (mesh->mTextureCoords[0] == nullptr) {
-                            mesh->mNumUVComponents[0] = 2;
-                            for (unsigned int i = 1; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
-                                mesh->mNumUVComponents[i] = 0;
-                            }
+    mesh->mNumFaces = static_cast<unsigned int>(faces.size());
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
 
-                            const std::string name = ai_to_string(group->mTexId);
-                            for (size_t i = 0; i < mMaterials.size(); ++i) {
-                                if (name == mMaterials[i]->GetName().C_Str()) {
-                                    mesh->mMaterialIndex = static_cast<unsigned int>(i);
-                                }
-                            }
-                            mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
-                            for (unsigned int vertex_index = 0; vertex_index < mesh->mNumVertices; vertex_index++) {
-                                mesh->mTextureCoords[0][vertex_index].z = IdNotSet;//mark not set
-                            }
-                        }
+    std::copy(faces.begin(), faces.end(), mesh->mFaces);
+}
 
-                        auto update_texture = [&](int idx) {
-                            if (pindex[idx] != IdNotSet) {
-                                size_t vertex_index = face.mIndices[idx];
-                                mesh->mTextureCoords[0][vertex_index] =
-                                        aiVector3D(group->mTex2dCoords[pindex[idx]].x, group->mTex2dCoords[pindex[idx]].y, 0.0f);
-                            }
-                        };
+void XmlSerializer::AssignTriangleProperties(aiMesh *mesh, const unsigned int *indices, int pid, const int *pindex) {
+    if (pindex[0] == IdNotSet && pindex[1] == IdNotSet && pindex[2] == IdNotSet) {
+        return;
+    }
 
-                        update_texture(0);
-                        update_texture(1);
-                        update_texture(2);
+    auto it = mResourcesDictionnary.find(pid);
+    if (it == mResourcesDictionnary.end()) {
+        return;
+    }
 
-                    } else if (it->second->getType() == ResourceType::RT_ColorGroup) {
-                        // Load vertex color into mesh, when any
-                        ColorGroup *group = static_cast<ColorGroup *>(it->second);
-                        if (mesh->mColors[0] == nullptr) {
-                            mesh->mColors[0] = new aiColor4D[mesh->mNumVertices];
-                        }
+    if (it->second->getType() == ResourceType::RT_BaseMaterials) {
+        BaseMaterials *baseMaterials = static_cast<BaseMaterials *>(it->second);
 
-                        auto update_color = [&](int idx) {
-                            if (pindex[idx] != IdNotSet) {
-                                size_t vertex_index = face.mIndices[idx];
-                                mesh->mColors[0][vertex_index] = group->mColors[pindex[idx]];
-                            }
-                        };
+        auto update_material = [&](int idx) {
+            if (pindex[idx] != IdNotSet) {
+                mesh->mMaterialIndex = baseMaterials->mMaterialIndex[pindex[idx]];
+            }
+        };
+
+        update_material(0);
+        update_material(1);
+        update_material(2);
+
+    } else if (it->second->getType() == ResourceType::RT_Texture2DGroup) {
+        // Load texture coordinates into mesh, when any
+        Texture2DGroup *group = static_cast<Texture2DGroup *>(it->second); // fix bug
+        if (mesh->mTextureCoords[0] == nullptr) {
+            mesh->mNumUVComponents[0] = 2;
+            for (unsigned int i = 1; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+                mesh->mNumUVComponents[i] = 0;
+            }
 
-                        update_color(0);
-                        update_color(1);
-                        update_color(2);
-                    }
+            const std::string name = ai_to_string(group->mTexId);
+            for (size_t i = 0; i < mMaterials.size(); ++i) {
+                if (name == mMaterials[i]->GetName().C_Str()) {
+                    mesh->mMaterialIndex = static_cast<unsigned int>(i);
                 }
             }
+            mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+            for (unsigned int vertex_index = 0; vertex_index < mesh->mNumVertices; vertex_index++) {
+                mesh->mTextureCoords[0][vertex_index].z = IdNotSet;//mark not set
+            }
+        }
 
-            faces.push_back(face);
+        auto update_texture = [&](int idx) {
+            if (pindex[idx] != IdNotSet) {
+                size_t vertex_index = indices[idx];
+                mesh->mTextureCoords[0][vertex_index] =
+                        aiVector3D(group->mTex2dCoords[pindex[idx]].x, group->mTex2dCoords[pindex[idx]].y, 0.0f);
+            }
+        };
+
+        update_texture(0);
+        update_texture(1);
+        update_texture(2);
+
+    } else if (it->second->getType() == ResourceType::RT_ColorGroup) {
+        // Load vertex color into mesh, when any
+        ColorGroup *group = static_cast<ColorGroup *>(it->second);
+        if (mesh->mColors[0] == nullptr) {
+            mesh->mColors[0] = new aiColor4D[mesh->mNumVertices];
         }
-    }
 
-    mesh->mNumFaces = static_cast<unsigned int>(faces.size());
-    mesh->mFaces = new aiFace[mesh->mNumFaces];
-    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+        auto update_color = [&](int idx) {
+            if (pindex[idx] != IdNotSet) {
+                size_t vertex_index = indices[idx];
+                mesh->mColors[0][vertex_index] = group->mColors[pindex[idx]];
+            }
+        };
 
-    std::copy(faces.begin(), faces.end(), mesh->mFaces);
+        update_color(0);
+        update_color(1);
+        update_color(2);
+    }
 }
 
 void XmlSerializer::ReadBaseMaterials(XmlNode &node) {
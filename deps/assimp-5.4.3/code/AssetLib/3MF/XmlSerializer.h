@@ -58,10 +58,11 @@ class Object;
 class Texture2DGroup;
 class EmbeddedTexture;
 class ColorGroup;
+struct StreamedMeshBlock;
 
 class XmlSerializer {
 public:
-    XmlSerializer(XmlParser *xmlParser);
+    XmlSerializer(XmlParser *xmlParser, std::vector<StreamedMeshBlock> *streamedBlocks = nullptr);
     ~XmlSerializer();
     void ImportXml(aiScene *scene);
 
@@ -72,6 +73,8 @@ private:
     void ReadMetadata(XmlNode &node);
     void ImportVertices(XmlNode &node, aiMesh *mesh);
     void ImportTriangles(XmlNode &node, aiMesh *mesh);
+    StreamedMeshBlock *GetStreamedBlock(XmlNode &node);
+    void AssignTriangleProperties(aiMesh *mesh, const unsigned int *indices, int pid, const int *pindex);
     void ReadBaseMaterials(XmlNode &node);
     void ReadEmbeddecTexture(XmlNode &node);
     void StoreEmbeddedTexture(EmbeddedTexture *tex);
@@ -93,6 +96,7 @@ private:
     std::map<unsigned int, Resource *> mResourcesDictionnary;
     unsigned int mMeshCount;
     XmlParser *mXmlParser;
+    std::vector<StreamedMeshBlock> *mStreamedBlocks;
 };
 
 } // namespace D3MF
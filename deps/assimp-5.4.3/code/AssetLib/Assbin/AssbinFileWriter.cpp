@@ -53,6 +53,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "zlib.h"
 
 #include <ctime>
+#include <vector>
 
 #if _MSC_VER
 #pragma warning(push)
@@ -218,17 +219,6 @@ inline size_t WriteBounds(IOStream *stream, const T *in, unsigned int size) {
     return t + Write<T>(stream, maxc);
 }
 
-// We use this to write out non-byte arrays so that we write using the specializations.
-// This way we avoid writing out extra bytes that potentially come from struct alignment.
-template <typename T>
-inline size_t WriteArray(IOStream *stream, const T *in, unsigned int size) {
-    size_t n = 0;
-    for (unsigned int i = 0; i < size; i++)
-        n += Write<T>(stream, in[i]);
-
-    return n;
-}
-
 // ----------------------------------------------------------------------------------
 /** @class  AssbinChunkWriter
  *  @brief  Chunk writer mechanism for the .assbin file structure
@@ -238,6 +228,9 @@ inline size_t WriteArray(IOStream *stream, const T *in, unsigned int size) {
  *  constructor, and when it is destroyed, it appends the magic number, the chunk size,
  *  and the chunk contents to the container stream. This allows relatively easy chunk
  *  chunk construction, even recursively.
+ *
+ *  Since a chunk is always appended at the current end of its container, the final
+ *  position of its data in the file is known up front, which Align() relies on.
  */
 class AssbinChunkWriter : public IOStream {
 private:
@@ -245,6 +238,7 @@ private:
     uint32_t magic;
     IOStream *container;
     size_t cur_size, cursor, initial;
+    size_t offset; // position of the chunk data in the file
 
 private:
     // -------------------------------------------------------------------
@@ -269,8 +263,13 @@ public:
             container(container),
             cur_size(0),
             cursor(0),
-            initial(initial) {
-        // empty
+            initial(initial),
+            offset(0) {
+        if (const AssbinChunkWriter *parent = dynamic_cast<const AssbinChunkWriter *>(container)) {
+            offset = parent->offset + parent->cursor + 8;
+        } else if (container) {
+            offset = container->Tell() + 8;
+        }
     }
 
     ~AssbinChunkWriter() override {
@@ -315,6 +314,16 @@ public:
 
         return pCount;
     }
+
+    // -------------------------------------------------------------------
+    // Pad with zeros until the next write starts at a multiple of alignment in the file
+    void Align(size_t alignment) {
+        static const uint8_t zeros[ASSBIN_STREAM_ALIGNMENT] = {};
+        ai_assert(alignment <= ASSBIN_STREAM_ALIGNMENT);
+
+        const size_t padding = (alignment - (offset + cursor) % alignment) % alignment;
+        Write(zeros, 1, padding);
+    }
 };
 
 // ----------------------------------------------------------------------------------
@@ -327,8 +336,123 @@ class AssbinFileWriter {
 private:
     bool shortened;
     bool compressed;
+    bool compressStreams;
+
+    // streams smaller than this are not worth a deflate attempt
+    static constexpr size_t MinDeflateSize = 1024;
 
 protected:
+    // -----------------------------------------------------------------------------------
+    // Write a block of packed data as one stream, see assbin_chunks.h
+    void WriteStream(AssbinChunkWriter &chunk, const void *data, size_t size) {
+        if (size > 0xffffffff) {
+            throw DeadlyExportError("ASSBIN: stream exceeds 4 GiB");
+        }
+
+        unsigned int encoding = ASSBIN_STREAM_RAW;
+        const void *stored = data;
+        size_t storedSize = size;
+
+        // deflate at the fastest level, the point of the streams is write speed
+        std::vector<Bytef> deflated;
+        if (compressStreams && size >= MinDeflateSize) {
+            uLongf deflatedSize = compressBound(static_cast<uLong>(size));
+            deflated.resize(deflatedSize);
+            if (compress2(deflated.data(), &deflatedSize, static_cast<const Bytef *>(data), static_cast<uLong>(size), Z_BEST_SPEED) == Z_OK && deflatedSize < size) {
+                encoding = ASSBIN_STREAM_DEFLATE;
+                stored = deflated.data();
+                storedSize = deflatedSize;
+            }
+        }
+
+        Write<unsigned int>(&chunk, encoding);
+        Write<unsigned int>(&chunk, static_cast<unsigned int>(size));
+        Write<unsigned int>(&chunk, static_cast<unsigned int>(storedSize));
+        chunk.Align(ASSBIN_STREAM_ALIGNMENT);
+        chunk.Write(stored, 1, storedSize);
+    }
+
+    // -----------------------------------------------------------------------------------
+    // Write an array of vectors, colors or quaternions as one stream of floats
+    template <typename T>
+    void WriteRealStream(AssbinChunkWriter &chunk, const T *in, unsigned int size) {
+        static_assert(sizeof(T) % sizeof(ai_real) == 0, "T must consist of ai_real components");
+#ifdef ASSIMP_DOUBLE_PRECISION
+        std::vector<float> staging(size * (sizeof(T) / sizeof(ai_real)));
+        const ai_real *components = reinterpret_cast<const ai_real *>(in);
+        for (size_t i = 0; i < staging.size(); ++i) {
+            staging[i] = static_cast<float>(components[i]);
+        }
+        WriteStream(chunk, staging.data(), staging.size() * sizeof(float));
+#else
+        WriteStream(chunk, in, size * sizeof(T));
+#endif
+    }
+
+    // -----------------------------------------------------------------------------------
+    void WriteWeightStream(AssbinChunkWriter &chunk, const aiVertexWeight *in, unsigned int size) {
+#ifdef ASSIMP_DOUBLE_PRECISION
+        std::vector<uint32_t> staging(size * 2);
+        for (unsigned int i = 0; i < size; ++i) {
+            const float weight = static_cast<float>(in[i].mWeight);
+            staging[i * 2] = in[i].mVertexId;
+            memcpy(&staging[i * 2 + 1], &weight, sizeof(float));
+        }
+        WriteStream(chunk, staging.data(), staging.size() * sizeof(uint32_t));
+#else
+        static_assert(sizeof(aiVertexWeight) == 8, "aiVertexWeight must be packed");
+        WriteStream(chunk, in, size * sizeof(aiVertexWeight));
+#endif
+    }
+
+    // -----------------------------------------------------------------------------------
+    // Write animation keys as a stream of times followed by a stream of values
+    template <typename T>
+    void WriteKeyStreams(AssbinChunkWriter &chunk, const T *keys, unsigned int size) {
+        std::vector<double> times(size);
+        std::vector<decltype(T::mValue)> values(size);
+        for (unsigned int i = 0; i < size; ++i) {
+            times[i] = keys[i].mTime;
+            values[i] = keys[i].mValue;
+        }
+        WriteStream(chunk, times.data(), size * sizeof(double));
+        WriteRealStream(chunk, values.data(), size);
+    }
+
+    // -----------------------------------------------------------------------------------
+    // Write the face sizes and the concatenated face indices as two streams
+    void WriteFaceStreams(AssbinChunkWriter &chunk, const aiMesh *mesh) {
+        static_assert(AI_MAX_FACE_INDICES <= 0xffff, "AI_MAX_FACE_INDICES <= 0xffff");
+        std::vector<uint16_t> sizes(mesh->mNumFaces);
+        size_t numIndices = 0;
+        for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+            sizes[i] = static_cast<uint16_t>(mesh->mFaces[i].mNumIndices);
+            numIndices += mesh->mFaces[i].mNumIndices;
+        }
+        WriteStream(chunk, sizes.data(), sizes.size() * sizeof(uint16_t));
+
+        // if there are less than 2^16 vertices, we can simply use 16 bit integers ...
+        if (mesh->mNumVertices < (1u << 16)) {
+            std::vector<uint16_t> indices;
+            indices.reserve(numIndices);
+            for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+                const aiFace &f = mesh->mFaces[i];
+                for (unsigned int a = 0; a < f.mNumIndices; ++a) {
+                    indices.push_back(static_cast<uint16_t>(f.mIndices[a]));
+                }
+            }
+            WriteStream(chunk, indices.data(), indices.size() * sizeof(uint16_t));
+        } else {
+            std::vector<uint32_t> indices;
+            indices.reserve(numIndices);
+            for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+                const aiFace &f = mesh->mFaces[i];
+                indices.insert(indices.end(), f.mIndices, f.mIndices + f.mNumIndices);
+            }
+            WriteStream(chunk, indices.data(), indices.size() * sizeof(uint32_t));
+        }
+    }
+
     // -----------------------------------------------------------------------------------
     void WriteBinaryNode(IOStream *container, const aiNode *node) {
         AssbinChunkWriter chunk(container, ASSBIN_CHUNK_AINODE);
@@ -420,7 +544,7 @@ protected:
             WriteBounds(&chunk, b->mWeights, b->mNumWeights);
         } // else write as usual
         else
-            WriteArray<aiVertexWeight>(&chunk, b->mWeights, b->mNumWeights);
+            WriteWeightStream(chunk, b->mWeights, b->mNumWeights);
     }
 
     // -----------------------------------------------------------------------------------
@@ -464,14 +588,14 @@ protected:
                 WriteBounds(&chunk, mesh->mVertices, mesh->mNumVertices);
             } // else write as usual
             else
-                WriteArray<aiVector3D>(&chunk, mesh->mVertices, mesh->mNumVertices);
+                WriteRealStream(chunk, mesh->mVertices, mesh->mNumVertices);
         }
         if (mesh->mNormals) {
             if (shortened) {
                 WriteBounds(&chunk, mesh->mNormals, mesh->mNumVertices);
             } // else write as usual
             else
-                WriteArray<aiVector3D>(&chunk, mesh->mNormals, mesh->mNumVertices);
+                WriteRealStream(chunk, mesh->mNormals, mesh->mNumVertices);
         }
         if (mesh->mTangents && mesh->mBitangents) {
             if (shortened) {
@@ -479,8 +603,8 @@ protected:
                 WriteBounds(&chunk, mesh->mBitangents, mesh->mNumVertices);
             } // else write as usual
             else {
-                WriteArray<aiVector3D>(&chunk, mesh->mTangents, mesh->mNumVertices);
-                WriteArray<aiVector3D>(&chunk, mesh->mBitangents, mesh->mNumVertices);
+                WriteRealStream(chunk, mesh->mTangents, mesh->mNumVertices);
+                WriteRealStream(chunk, mesh->mBitangents, mesh->mNumVertices);
             }
         }
         for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_COLOR_SETS; ++n) {
@@ -491,7 +615,7 @@ protected:
                 WriteBounds(&chunk, mesh->mColors[n], mesh->mNumVertices);
             } // else write as usual
             else
-                WriteArray<aiColor4D>(&chunk, mesh->mColors[n], mesh->mNumVertices);
+                WriteRealStream(chunk, mesh->mColors[n], mesh->mNumVertices);
         }
         for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++n) {
             if (!mesh->mTextureCoords[n])
@@ -504,7 +628,7 @@ protected:
                 WriteBounds(&chunk, mesh->mTextureCoords[n], mesh->mNumVertices);
             } // else write as usual
             else
-                WriteArray<aiVector3D>(&chunk, mesh->mTextureCoords[n], mesh->mNumVertices);
+                WriteRealStream(chunk, mesh->mTextureCoords[n], mesh->mNumVertices);
         }
 
         // write faces. There are no floating-point calculations involved
@@ -530,21 +654,7 @@ protected:
             }
         } else // else write as usual
         {
-            // if there are less than 2^16 vertices, we can simply use 16 bit integers ...
-            for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-                const aiFace &f = mesh->mFaces[i];
-
-                static_assert(AI_MAX_FACE_INDICES <= 0xffff, "AI_MAX_FACE_INDICES <= 0xffff");
-                Write<uint16_t>(&chunk, static_cast<uint16_t>(f.mNumIndices));
-
-                for (unsigned int a = 0; a < f.mNumIndices; ++a) {
-                    if (mesh->mNumVertices < (1u << 16)) {
-                        Write<uint16_t>(&chunk, static_cast<uint16_t>(f.mIndices[a]));
-                    } else {
-                        Write<unsigned int>(&chunk, f.mIndices[a]);
-                    }
-                }
-            }
+            WriteFaceStreams(chunk, mesh);
         }
 
         // write bones
@@ -596,7 +706,7 @@ protected:
 
             } // else write as usual
             else
-                WriteArray<aiVectorKey>(&chunk, nd->mPositionKeys, nd->mNumPositionKeys);
+                WriteKeyStreams(chunk, nd->mPositionKeys, nd->mNumPositionKeys);
         }
         if (nd->mRotationKeys) {
             if (shortened) {
@@ -604,7 +714,7 @@ protected:
 
             } // else write as usual
             else
-                WriteArray<aiQuatKey>(&chunk, nd->mRotationKeys, nd->mNumRotationKeys);
+                WriteKeyStreams(chunk, nd->mRotationKeys, nd->mNumRotationKeys);
         }
         if (nd->mScalingKeys) {
             if (shortened) {
@@ -612,7 +722,7 @@ protected:
 
             } // else write as usual
             else
-                WriteArray<aiVectorKey>(&chunk, nd->mScalingKeys, nd->mNumScalingKeys);
+                WriteKeyStreams(chunk, nd->mScalingKeys, nd->mNumScalingKeys);
         }
     }
 
@@ -726,8 +836,8 @@ protected:
     }
 
 public:
-    AssbinFileWriter(bool shortened, bool compressed) :
-            shortened(shortened), compressed(compressed) {
+    AssbinFileWriter(bool shortened, bool compressed, bool compressStreams) :
+            shortened(shortened), compressed(compressed), compressStreams(compressStreams) {
     }
 
     // -----------------------------------------------------------------------------------
@@ -822,8 +932,8 @@ public:
 
 void DumpSceneToAssbin(
         const char *pFile, const char *cmd, IOSystem *pIOSystem,
-        const aiScene *pScene, bool shortened, bool compressed) {
-    AssbinFileWriter fileWriter(shortened, compressed);
+        const aiScene *pScene, bool shortened, bool compressed, bool compressStreams) {
+    AssbinFileWriter fileWriter(shortened, compressed, compressStreams);
     fileWriter.WriteBinaryDump(pFile, cmd, pIOSystem, pScene);
 }
 #if _MSC_VER
@@ -58,7 +58,8 @@ void ASSIMP_API DumpSceneToAssbin(
         IOSystem *pIOSystem,
         const aiScene *pScene,
         bool shortened,
-        bool compressed);
+        bool compressed,
+        bool compressStreams = false);
 
 }
 
@@ -52,10 +52,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Common/assbin_chunks.h"
 #include <assimp/MemoryIOWrapper.h>
 #include <assimp/anim.h>
+#include <assimp/config.h>
+#include <assimp/Importer.hpp>
 #include <assimp/importerdesc.h>
 #include <assimp/mesh.h>
 #include <assimp/scene.h>
 #include <memory>
+#include <vector>
 
 #ifdef ASSIMP_BUILD_NO_OWN_ZLIB
 #include <zlib.h>
@@ -78,11 +81,25 @@ static constexpr aiImporterDesc desc = {
     "assbin"
 };
 
+// -----------------------------------------------------------------------------------
+AssbinImporter::AssbinImporter() :
+        shortened(false),
+        compressed(false),
+        streams(false),
+        flatIndexBuffer(false) {
+    // empty
+}
+
 // -----------------------------------------------------------------------------------
 const aiImporterDesc *AssbinImporter::GetInfo() const {
     return &desc;
 }
 
+// -----------------------------------------------------------------------------------
+void AssbinImporter::SetupProperties(const Importer *pImp) {
+    flatIndexBuffer = pImp->GetPropertyBool(AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER, false);
+}
+
 // -----------------------------------------------------------------------------------
 bool AssbinImporter::CanRead(const std::string &pFile, IOSystem *pIOHandler, bool /*checkSig*/) const {
     IOStream *in = pIOHandler->Open(pFile);
@@ -204,6 +221,83 @@ void ReadArray(IOStream *stream, T *out, unsigned int size) {
     }
 }
 
+// -----------------------------------------------------------------------------------
+// Read one stream block (see assbin_chunks.h) holding exactly size decoded bytes
+static void ReadStream(IOStream *stream, void *out, size_t size) {
+    const uint32_t encoding = Read<uint32_t>(stream);
+    const uint32_t decodedSize = Read<uint32_t>(stream);
+    const uint32_t storedSize = Read<uint32_t>(stream);
+    if (decodedSize != size) {
+        throw DeadlyImportError("ASSBIN: Stream size doesn't match its element count");
+    }
+
+    stream->Seek((ASSBIN_STREAM_ALIGNMENT - stream->Tell() % ASSBIN_STREAM_ALIGNMENT) % ASSBIN_STREAM_ALIGNMENT, aiOrigin_CUR);
+    if (encoding == ASSBIN_STREAM_RAW) {
+        if (storedSize != size || (size && stream->Read(out, 1, size) != size)) {
+            throw DeadlyImportError("Unexpected EOF");
+        }
+    } else if (encoding == ASSBIN_STREAM_DEFLATE) {
+        std::vector<Bytef> deflated(storedSize);
+        if (stream->Read(deflated.data(), 1, storedSize) != storedSize) {
+            throw DeadlyImportError("Unexpected EOF");
+        }
+        uLongf inflatedSize = static_cast<uLongf>(size);
+        if (uncompress(static_cast<Bytef *>(out), &inflatedSize, deflated.data(), storedSize) != Z_OK || inflatedSize != size) {
+            throw DeadlyImportError("ASSBIN: Stream decompression failed.");
+        }
+    } else {
+        throw DeadlyImportError("ASSBIN: Unknown stream encoding ", encoding);
+    }
+}
+
+// -----------------------------------------------------------------------------------
+// Read a stream of floats into an array of vectors, colors or quaternions
+template <typename T>
+void ReadRealStream(IOStream *stream, T *out, unsigned int size) {
+    static_assert(sizeof(T) % sizeof(ai_real) == 0, "T must consist of ai_real components");
+#ifdef ASSIMP_DOUBLE_PRECISION
+    std::vector<float> staging(size * (sizeof(T) / sizeof(ai_real)));
+    ReadStream(stream, staging.data(), staging.size() * sizeof(float));
+    ai_real *components = reinterpret_cast<ai_real *>(out);
+    for (size_t i = 0; i < staging.size(); ++i) {
+        components[i] = staging[i];
+    }
+#else
+    ReadStream(stream, out, size * sizeof(T));
+#endif
+}
+
+// -----------------------------------------------------------------------------------
+static void ReadWeightStream(IOStream *stream, aiVertexWeight *out, unsigned int size) {
+#ifdef ASSIMP_DOUBLE_PRECISION
+    std::vector<uint32_t> staging(size * 2);
+    ReadStream(stream, staging.data(), staging.size() * sizeof(uint32_t));
+    for (unsigned int i = 0; i < size; ++i) {
+        float weight;
+        memcpy(&weight, &staging[i * 2 + 1], sizeof(float));
+        out[i].mVertexId = staging[i * 2];
+        out[i].mWeight = weight;
+    }
+#else
+    static_assert(sizeof(aiVertexWeight) == 8, "aiVertexWeight must be packed");
+    ReadStream(stream, out, size * sizeof(aiVertexWeight));
+#endif
+}
+
+// -----------------------------------------------------------------------------------
+// Read animation keys from a stream of times followed by a stream of values
+template <typename T>
+void ReadKeyStreams(IOStream *stream, T *out, unsigned int size) {
+    std::vector<double> times(size);
+    std::vector<decltype(T::mValue)> values(size);
+    ReadStream(stream, times.data(), size * sizeof(double));
+    ReadRealStream(stream, values.data(), size);
+    for (unsigned int i = 0; i < size; ++i) {
+        out[i].mTime = times[i];
+        out[i].mValue = values[i];
+    }
+}
+
 // -----------------------------------------------------------------------------------
 template <typename T>
 void ReadBounds(IOStream *stream, T * /*p*/, unsigned int n) {
@@ -304,7 +398,11 @@ void AssbinImporter::ReadBinaryBone(IOStream *stream, aiBone *b) {
     } else {
         // else write as usual
         b->mWeights = new aiVertexWeight[b->mNumWeights];
-        ReadArray<aiVertexWeight>(stream, b->mWeights, b->mNumWeights);
+        if (streams) {
+            ReadWeightStream(stream, b->mWeights, b->mNumWeights);
+        } else {
+            ReadArray<aiVertexWeight>(stream, b->mWeights, b->mNumWeights);
+        }
     }
 }
 
@@ -334,7 +432,11 @@ void AssbinImporter::ReadBinaryMesh(IOStream *stream, aiMesh *mesh) {
         } else {
             // else write as usual
             mesh->mVertices = new aiVector3D[mesh->mNumVertices];
-            ReadArray<aiVector3D>(stream, mesh->mVertices, mesh->mNumVertices);
+            if (streams) {
+                ReadRealStream(stream, mesh->mVertices, mesh->mNumVertices);
+            } else {
+                ReadArray<aiVector3D>(stream, mesh->mVertices, mesh->mNumVertices);
+            }
         }
     }
     if (c & ASSBIN_MESH_HAS_NORMALS) {
@@ -343,7 +445,11 @@ void AssbinImporter::ReadBinaryMesh(IOStream *stream, aiMesh *mesh) {
         } else {
             // else write as usual
             mesh->mNormals = new aiVector3D[mesh->mNumVertices];
-            ReadArray<aiVector3D>(stream, mesh->mNormals, mesh->mNumVertices);
+            if (streams) {
+                ReadRealStream(stream, mesh->mNormals, mesh->mNumVertices);
+            } else {
+                ReadArray<aiVector3D>(stream, mesh->mNormals, mesh->mNumVertices);
+            }
         }
     }
     if (c & ASSBIN_MESH_HAS_TANGENTS_AND_BITANGENTS) {
@@ -353,9 +459,17 @@ void AssbinImporter::ReadBinaryMesh(IOStream *stream, aiMesh *mesh) {
         } else {
             // else write as usual
             mesh->mTangents = new aiVector3D[mesh->mNumVertices];
-            ReadArray<aiVector3D>(stream, mesh->mTangents, mesh->mNumVertices);
+            if (streams) {
+                ReadRealStream(stream, mesh->mTangents, mesh->mNumVertices);
+            } else {
+                ReadArray<aiVector3D>(stream, mesh->mTangents, mesh->mNumVertices);
+            }
             mesh->mBitangents = new aiVector3D[mesh->mNumVertices];
-            ReadArray<aiVector3D>(stream, mesh->mBitangents, mesh->mNumVertices);
+            if (streams) {
+                ReadRealStream(stream, mesh->mBitangents, mesh->mNumVertices);
+            } else {
+                ReadArray<aiVector3D>(stream, mesh->mBitangents, mesh->mNumVertices);
+            }
         }
     }
     for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_COLOR_SETS; ++n) {
@@ -368,7 +482,11 @@ void AssbinImporter::ReadBinaryMesh(IOStream *stream, aiMesh *mesh) {
         } else {
             // else write as usual
             mesh->mColors[n] = new aiColor4D[mesh->mNumVertices];
-            ReadArray<aiColor4D>(stream, mesh->mColors[n], mesh->mNumVertices);
+            if (streams) {
+                ReadRealStream(stream, mesh->mColors[n], mesh->mNumVertices);
+            } else {
+                ReadArray<aiColor4D>(stream, mesh->mColors[n], mesh->mNumVertices);
+            }
         }
     }
     for (unsigned int n = 0; n < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++n) {
@@ -384,7 +502,11 @@ void AssbinImporter::ReadBinaryMesh(IOStream *stream, aiMesh *mesh) {
         } else {
             // else write as usual
             mesh->mTextureCoords[n] = new aiVector3D[mesh->mNumVertices];
-            ReadArray<aiVector3D>(stream, mesh->mTextureCoords[n], mesh->mNumVertices);
+            if (streams) {
+                ReadRealStream(stream, mesh->mTextureCoords[n], mesh->mNumVertices);
+            } else {
+                ReadArray<aiVector3D>(stream, mesh->mTextureCoords[n], mesh->mNumVertices);
+            }
         }
     }
 
@@ -394,6 +516,8 @@ void AssbinImporter::ReadBinaryMesh(IOStream *stream, aiMesh *mesh) {
     // using Assimp's standard hashing function.
     if (shortened) {
         Read<unsigned int>(stream);
+    } else if (streams) {
+        ReadBinaryFaces(stream, mesh);
     } else {
         // else write as usual
         // if there are less than 2^16 vertices, we can simply use 16 bit integers ...
@@ -426,6 +550,47 @@ void AssbinImporter::ReadBinaryMesh(IOStream *stream, aiMesh *mesh) {
     }
 }
 
+// -----------------------------------------------------------------------------------
+void AssbinImporter::ReadBinaryFaces(IOStream *stream, aiMesh *mesh) {
+    static_assert(AI_MAX_FACE_INDICES <= 0xffff, "AI_MAX_FACE_INDICES <= 0xffff");
+    std::vector<uint16_t> sizes(mesh->mNumFaces);
+    ReadStream(stream, sizes.data(), sizes.size() * sizeof(uint16_t));
+
+    size_t numIndices = 0;
+    for (uint16_t size : sizes) {
+        numIndices += size;
+    }
+
+    // Check if unsigned  short ( 16 bit  ) are big enough for the indices
+    std::unique_ptr<unsigned int[]> indices(new unsigned int[numIndices]);
+    if (fitsIntoUI16(mesh->mNumVertices)) {
+        std::vector<uint16_t> narrow(numIndices);
+        ReadStream(stream, narrow.data(), numIndices * sizeof(uint16_t));
+        std::copy(narrow.begin(), narrow.end(), indices.get());
+    } else {
+        ReadStream(stream, indices.get(), numIndices * sizeof(unsigned int));
+    }
+
+    // with a flat index buffer the faces point into the decoded stream
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    unsigned int *p = indices.get();
+    if (flatIndexBuffer && numIndices > 0) {
+        mesh->mIndexBufferSize = static_cast<unsigned int>(numIndices);
+        mesh->mIndexBuffer = indices.release();
+    }
+    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+        aiFace &f = mesh->mFaces[i];
+        f.mNumIndices = sizes[i];
+        if (mesh->mIndexBuffer) {
+            f.mIndices = p;
+        } else {
+            f.mIndices = new unsigned int[f.mNumIndices];
+            std::copy(p, p + f.mNumIndices, f.mIndices);
+        }
+        p += f.mNumIndices;
+    }
+}
+
 // -----------------------------------------------------------------------------------
 void AssbinImporter::ReadBinaryMaterialProperty(IOStream *stream, aiMaterialProperty *prop) {
     if (Read<uint32_t>(stream) != ASSBIN_CHUNK_AIMATERIALPROPERTY)
@@ -481,7 +646,11 @@ void AssbinImporter::ReadBinaryNodeAnim(IOStream *stream, aiNodeAnim *nd) {
         } // else write as usual
         else {
             nd->mPositionKeys = new aiVectorKey[nd->mNumPositionKeys];
-            ReadArray<aiVectorKey>(stream, nd->mPositionKeys, nd->mNumPositionKeys);
+            if (streams) {
+                ReadKeyStreams(stream, nd->mPositionKeys, nd->mNumPositionKeys);
+            } else {
+                ReadArray<aiVectorKey>(stream, nd->mPositionKeys, nd->mNumPositionKeys);
+            }
         }
     }
     if (nd->mNumRotationKeys) {
@@ -491,7 +660,11 @@ void AssbinImporter::ReadBinaryNodeAnim(IOStream *stream, aiNodeAnim *nd) {
         } else {
             // else write as usual
             nd->mRotationKeys = new aiQuatKey[nd->mNumRotationKeys];
-            ReadArray<aiQuatKey>(stream, nd->mRotationKeys, nd->mNumRotationKeys);
+            if (streams) {
+                ReadKeyStreams(stream, nd->mRotationKeys, nd->mNumRotationKeys);
+            } else {
+                ReadArray<aiQuatKey>(stream, nd->mRotationKeys, nd->mNumRotationKeys);
+            }
         }
     }
     if (nd->mNumScalingKeys) {
@@ -501,7 +674,11 @@ void AssbinImporter::ReadBinaryNodeAnim(IOStream *stream, aiNodeAnim *nd) {
         } else {
             // else write as usual
             nd->mScalingKeys = new aiVectorKey[nd->mNumScalingKeys];
-            ReadArray<aiVectorKey>(stream, nd->mScalingKeys, nd->mNumScalingKeys);
+            if (streams) {
+                ReadKeyStreams(stream, nd->mScalingKeys, nd->mNumScalingKeys);
+            } else {
+                ReadArray<aiVectorKey>(stream, nd->mScalingKeys, nd->mNumScalingKeys);
+            }
         }
     }
 }
@@ -683,9 +860,11 @@ void AssbinImporter::InternReadFile(const std::string &pFile, aiScene *pScene, I
 
     unsigned int versionMajor = Read<unsigned int>(stream);
     unsigned int versionMinor = Read<unsigned int>(stream);
-    if (versionMinor != ASSBIN_VERSION_MINOR || versionMajor != ASSBIN_VERSION_MAJOR) {
+    if (versionMinor > ASSBIN_VERSION_MINOR || versionMajor != ASSBIN_VERSION_MAJOR) {
+        pIOHandler->Close(stream);
         throw DeadlyImportError("Invalid version, data format not compatible!");
     }
+    streams = versionMinor >= 1;
 
     /*unsigned int versionRevision =*/Read<unsigned int>(stream);
     /*unsigned int compileFlags =*/Read<unsigned int>(stream);
@@ -693,8 +872,10 @@ void AssbinImporter::InternReadFile(const std::string &pFile, aiScene *pScene, I
     shortened = Read<uint16_t>(stream) > 0;
     compressed = Read<uint16_t>(stream) > 0;
 
-    if (shortened)
+    if (shortened) {
+        pIOHandler->Close(stream);
         throw DeadlyImportError("Shortened binaries are not supported!");
+    }
 
     stream->Seek(256, aiOrigin_CUR); // original filename
     stream->Seek(128, aiOrigin_CUR); // options
@@ -724,11 +905,23 @@ void AssbinImporter::InternReadFile(const std::string &pFile, aiScene *pScene, I
 
         delete[] uncompressedData;
         delete[] compressedData;
+        pIOHandler->Close(stream);
     } else {
-        ReadBinaryScene(stream, pScene);
-    }
+        // one bulk read of the whole file, the scene is then decoded from memory and
+        // the streams are copied straight into their arrays
+        const size_t fileSize = stream->FileSize();
+        std::vector<uint8_t> data(fileSize);
+        stream->Seek(0, aiOrigin_SET);
+        const size_t len = stream->Read(data.data(), 1, fileSize);
+        pIOHandler->Close(stream);
+        if (len != fileSize) {
+            throw DeadlyImportError("ASSBIN: Could not read ", pFile);
+        }
 
-    pIOHandler->Close(stream);
+        MemoryIOStream io(data.data(), fileSize);
+        io.Seek(ASSBIN_HEADER_LENGTH, aiOrigin_SET);
+        ReadBinaryScene(&io, pScene);
+    }
 }
 
 #endif // !! ASSIMP_BUILD_NO_ASSBIN_IMPORTER
@@ -71,17 +71,22 @@ class AssbinImporter : public BaseImporter
 private:
     bool shortened;
     bool compressed;
+    bool streams; // revision 1.1, arrays are stored as stream blocks
+    bool flatIndexBuffer;
 
 public:
+    AssbinImporter();
     bool CanRead(const std::string& pFile,
         IOSystem* pIOHandler, bool checkSig) const override;
     const aiImporterDesc* GetInfo() const override;
+    void SetupProperties(const Importer* pImp) override;
     void InternReadFile(
     const std::string& pFile,aiScene* pScene,IOSystem* pIOHandler) override;
     void ReadHeader();
     void ReadBinaryScene( IOStream * stream, aiScene* pScene );
     void ReadBinaryNode( IOStream * stream, aiNode** mRootNode, aiNode* parent );
     void ReadBinaryMesh( IOStream * stream, aiMesh* mesh );
+    void ReadBinaryFaces( IOStream * stream, aiMesh* mesh );
     void ReadBinaryBone( IOStream * stream, aiBone* bone );
     void ReadBinaryMaterial(IOStream * stream, aiMaterial* mat);
     void ReadBinaryMaterialProperty(IOStream * stream, aiMaterialProperty* prop);
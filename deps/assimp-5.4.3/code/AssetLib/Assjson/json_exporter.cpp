@@ -17,10 +17,17 @@ Licensed under a 3-clause BSD license. See the LICENSE file for more information
 #include <assimp/Importer.hpp>
 #include <assimp/Exceptional.h>
 
+#include <assimp/StringUtils.h>
+
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <limits>
 #include <memory>
-#include <sstream>
+#include <type_traits>
+#include <vector>
 
 #define CURRENT_FORMAT_VERSION 100
 
@@ -35,19 +42,22 @@ namespace Assimp {
 // Forward declarations
 void ExportAssimp2Json(const char *, Assimp::IOSystem *, const aiScene *, const Assimp::ExportProperties *);
 
-// small utility class to simplify serializing the aiScene to Json
+// small utility class to simplify serializing the aiScene to Json.
+// The output is collected in a fixed-size block that is handed to the stream whenever it runs
+// full, so the memory use does not depend on the size of the scene.
 class JSONWriter {
 public:
     enum {
         Flag_DoNotIndent = 0x1,
         Flag_WriteSpecialFloats = 0x2,
-        Flag_SkipWhitespaces = 0x4
+        Flag_SkipWhitespaces = 0x4,
+        Flag_Base64Streams = 0x8
     };
 
+    static constexpr size_t BufferSize = 64 * 1024;
+
     JSONWriter(Assimp::IOStream &out, unsigned int flags = 0u) :
-            out(out), indent (""), newline("\n"), space(" "), buff (), first(false), flags(flags) {
-        // make sure that all formatting happens using the standard, C locale and not the user's current locale
-        buff.imbue(std::locale("C"));
+            out(out), indent (""), newline("\n"), space(" "), buff(BufferSize), used(0), first(false), flags(flags) {
         if (flags & Flag_SkipWhitespaces) {
             newline = "";
             space = "";
@@ -59,9 +69,14 @@ public:
     }
 
     void Flush() {
-        const std::string s = buff.str();
-        out.Write(s.c_str(), s.length(), 1);
-        buff.clear();
+        if (used) {
+            out.Write(buff.data(), used, 1);
+            used = 0;
+        }
+    }
+
+    unsigned int GetFlags() const {
+        return flags;
     }
 
     void PushIndent() {
@@ -75,7 +90,10 @@ public:
     void Key(const std::string &name) {
         AddIndentation();
         Delimit();
-        buff << '\"' + name + "\":" << space;
+        Put('\"');
+        Put(name);
+        Put("\":");
+        Put(space);
     }
 
     template <typename Literal>
@@ -83,32 +101,44 @@ public:
         AddIndentation();
         Delimit();
 
-        LiteralToString(buff, name) << newline;
+        LiteralToString(name);
+        Put(newline);
     }
 
     template <typename Literal>
     void SimpleValue(const Literal &s) {
-        LiteralToString(buff, s) << newline;
+        LiteralToString(s);
+        Put(newline);
     }
 
     void SimpleValue(const void *buffer, size_t len) {
-        base64_encodestate s;
-        base64_init_encodestate(&s);
-
-        char *const cur_out = new char[std::max(len * 2, static_cast<size_t>(16u))];
-        const int n = base64_encode_block(reinterpret_cast<const char *>(buffer), static_cast<int>(len), cur_out, &s);
-        cur_out[n + base64_encode_blockend(cur_out + n, &s)] = '\0';
-
-        // base64 encoding may add newlines, but JSON strings may not contain 'real' newlines
-        // (only escaped ones). Remove any newlines in out.
-        for (char *cur = cur_out; *cur; ++cur) {
-            if (*cur == '\n') {
-                *cur = ' ';
-            }
+        StartBinary();
+        AppendBinary(buffer, len);
+        EndBinary();
+    }
+
+    // A base64 string value whose binary contents are appended piecewise
+    void StartBinary() {
+        base64_init_encodestate(&base64);
+        Put('\"');
+    }
+
+    void AppendBinary(const void *buffer, size_t len) {
+        // base64 turns 3 bytes into 4 characters and adds a newline every 72 characters
+        static constexpr size_t ChunkSize = 3 * 1024;
+        char encoded[ChunkSize * 2];
+        const char *data = reinterpret_cast<const char *>(buffer);
+        for (size_t offset = 0; offset < len; offset += ChunkSize) {
+            const size_t chunk = std::min(ChunkSize, len - offset);
+            PutBase64(encoded, base64_encode_block(data + offset, static_cast<int>(chunk), encoded, &base64));
         }
+    }
 
-        buff << '\"' << cur_out << "\"" << newline;
-        delete[] cur_out;
+    void EndBinary() {
+        char encoded[8];
+        PutBase64(encoded, base64_encode_blockend(encoded, &base64));
+        Put('\"');
+        Put(newline);
     }
 
     void StartObj(bool is_element = false) {
@@ -116,11 +146,12 @@ public:
         if (is_element) {
             AddIndentation();
             if (!first) {
-                buff << ',';
+                Put(',');
             }
         }
         first = true;
-        buff << "{" << newline;
+        Put('{');
+        Put(newline);
         PushIndent();
     }
 
@@ -128,7 +159,8 @@ public:
         PopIndent();
         AddIndentation();
         first = false;
-        buff << "}" << newline;
+        Put('}');
+        Put(newline);
     }
 
     void StartArray(bool is_element = false) {
@@ -136,97 +168,179 @@ public:
         if (is_element) {
             AddIndentation();
             if (!first) {
-                buff << ',';
+                Put(',');
             }
         }
         first = true;
-        buff << "[" << newline;
+        Put('[');
+        Put(newline);
         PushIndent();
     }
 
     void EndArray() {
         PopIndent();
         AddIndentation();
-        buff << "]" << newline;
+        Put(']');
+        Put(newline);
         first = false;
     }
 
     void AddIndentation() {
         if (!(flags & Flag_DoNotIndent) && !(flags & Flag_SkipWhitespaces)) {
-            buff << indent;
+            Put(indent);
         }
     }
 
     void Delimit() {
         if (!first) {
-            buff << ',';
+            Put(',');
         } else {
-            buff << space;
+            Put(space);
             first = false;
         }
     }
 
 private:
-    template <typename Literal>
-    std::stringstream &LiteralToString(std::stringstream &stream, const Literal &s) {
-        stream << s;
-        return stream;
+    void Put(char c) {
+        if (used == BufferSize) {
+            Flush();
+        }
+        buff[used++] = c;
+    }
+
+    void Put(const char *s, size_t len) {
+        if (len > BufferSize - used) {
+            Flush();
+            if (len > BufferSize) {
+                out.Write(s, len, 1);
+                return;
+            }
+        }
+        ::memcpy(buff.data() + used, s, len);
+        used += len;
+    }
+
+    void Put(const char *s) {
+        Put(s, ::strlen(s));
+    }
+
+    void Put(const std::string &s) {
+        Put(s.data(), s.length());
     }
 
-    std::stringstream &LiteralToString(std::stringstream &stream, const aiString &s) {
-        std::string t;
+    // base64 encoding may add newlines, but JSON strings may not contain 'real' newlines
+    // (only escaped ones), drop them.
+    void PutBase64(const char *encoded, int len) {
+        for (int i = 0; i < len; ++i) {
+            if (encoded[i] != '\n') {
+                Put(encoded[i]);
+            }
+        }
+    }
+
+    // Makes room for at least len characters and returns where to write them
+    char *Reserve(size_t len) {
+        if (len > BufferSize - used) {
+            Flush();
+        }
+        return buff.data() + used;
+    }
 
+    void LiteralToString(const char *s) {
+        Put(s);
+    }
+
+    template <typename Integer>
+    void LiteralToString(const Integer &i) {
+        char *const start = Reserve(24);
+        if constexpr (std::is_enum<Integer>::value) {
+            used += std::to_chars(start, start + 24, static_cast<typename std::underlying_type<Integer>::type>(i)).ptr - start;
+        } else {
+            used += std::to_chars(start, start + 24, i).ptr - start;
+        }
+    }
+
+    void LiteralToString(const aiString &s) {
         // escape backslashes and single quotes, both would render the JSON invalid if left as is
-        t.reserve(s.length);
+        Put('\"');
         for (size_t i = 0; i < s.length; ++i) {
             if (s.data[i] == '\\' || s.data[i] == '\'' || s.data[i] == '\"') {
-                t.push_back('\\');
+                Put('\\');
             }
 
-            t.push_back(s.data[i]);
+            Put(s.data[i]);
+        }
+        Put('\"');
+    }
+
+    void LiteralToString(float f) {
+        if (WriteSpecialFloat(f)) {
+            return;
+        }
+        char *const start = Reserve(32);
+        used += FormatShortest(start, f) - start;
+    }
+
+    void LiteralToString(double d) {
+        if (WriteSpecialFloat(d)) {
+            return;
         }
-        stream << "\"";
-        stream << t;
-        stream << "\"";
-        return stream;
+        char *const start = Reserve(32);
+        used += FormatShortest(start, d) - start;
     }
 
-    std::stringstream &LiteralToString(std::stringstream &stream, float f) {
-        if (!std::numeric_limits<float>::is_iec559) {
+    template <typename Real>
+    bool WriteSpecialFloat(Real f) {
+        if (!std::numeric_limits<Real>::is_iec559) {
             // on a non IEEE-754 platform, we make no assumptions about the representation or existence
             // of special floating-point numbers.
-            stream << f;
-            return stream;
+            return false;
         }
 
         // JSON does not support writing Inf/Nan
         // [RFC 4672: "Numeric values that cannot be represented as sequences of digits
         // (such as Infinity and NaN) are not permitted."]
         // Nevertheless, many parsers will accept the special keywords Infinity, -Infinity and NaN
-        if (std::numeric_limits<float>::infinity() == fabs(f)) {
+        if (std::numeric_limits<Real>::infinity() == std::fabs(f)) {
             if (flags & Flag_WriteSpecialFloats) {
-                stream << (f < 0 ? "\"-" : "\"") + std::string("Infinity\"");
-                return stream;
+                Put(f < 0 ? "\"-Infinity\"" : "\"Infinity\"");
+                return true;
             }
             //  we should print this warning, but we can't - this is called from within a generic assimp exporter, we cannot use cerr
             //	std::cerr << "warning: cannot represent infinite number literal, substituting 0 instead (use -i flag to enforce Infinity/NaN)" << std::endl;
-            stream << "0.0";
-            return stream;
+            Put("0.0");
+            return true;
         }
         // f!=f is the most reliable test for NaNs that I know of
         else if (f != f) {
             if (flags & Flag_WriteSpecialFloats) {
-                stream << "\"NaN\"";
-                return stream;
+                Put("\"NaN\"");
+                return true;
             }
             //  we should print this warning, but we can't - this is called from within a generic assimp exporter, we cannot use cerr
             //	std::cerr << "warning: cannot represent infinite number literal, substituting 0 instead (use -i flag to enforce Infinity/NaN)" << std::endl;
-            stream << "0.0";
-            return stream;
+            Put("0.0");
+            return true;
+        }
+        return false;
+    }
+
+    // Writes the shortest representation that reads back to the same value, needs up to 32 chars
+    template <typename Real>
+    static char *FormatShortest(char *out, Real f) {
+#ifdef __cpp_lib_to_chars
+        return std::to_chars(out, out + 32, f).ptr;
+#else
+        // no floating-point to_chars, fall back to the precision that always round-trips
+        const int len = ai_snprintf(out, 32, "%.*g", std::numeric_limits<Real>::max_digits10, static_cast<double>(f));
+        for (int i = 0; i < len; ++i) {
+            // independent of the user's locale
+            if (out[i] == ',') {
+                out[i] = '.';
+            }
         }
-
-        stream << f;
-        return stream;
+        return out + len;
+#endif
     }
 
 private:
@@ -234,7 +348,9 @@ private:
     std::string indent;
     std::string newline;
     std::string space;
-    std::stringstream buff;
+    std::vector<char> buff;
+    size_t used;
+    base64_encodestate base64;
     bool first;
 
     unsigned int flags;
@@ -304,6 +420,47 @@ static void Write(JSONWriter &out, const aiFace &ai, bool is_elem = true) {
     out.EndArray();
 }
 
+// Writes numComponents of every stride-sized item as flat list of numbers or, with
+// Flag_Base64Streams, as base64 string of little-endian 32 bit floats.
+static void WriteStream(JSONWriter &out, const ai_real *data, unsigned int count, unsigned int stride,
+        unsigned int numComponents, bool is_elem = false) {
+    if (!(out.GetFlags() & JSONWriter::Flag_Base64Streams)) {
+        out.StartArray(is_elem);
+        for (unsigned int i = 0; i < count; ++i) {
+            for (unsigned int c = 0; c < numComponents; ++c) {
+                out.Element(data[i * stride + c]);
+            }
+        }
+        out.EndArray();
+        return;
+    }
+
+    if (is_elem) {
+        out.AddIndentation();
+        out.Delimit();
+    }
+    if (std::is_same<ai_real, float>::value && stride == numComponents) {
+        out.SimpleValue(data, sizeof(float) * count * numComponents);
+        return;
+    }
+
+    // repack through a small block
+    float block[1024];
+    size_t filled = 0;
+    out.StartBinary();
+    for (unsigned int i = 0; i < count; ++i) {
+        for (unsigned int c = 0; c < numComponents; ++c) {
+            block[filled++] = static_cast<float>(data[i * stride + c]);
+            if (filled == sizeof(block) / sizeof(block[0])) {
+                out.AppendBinary(block, sizeof(block));
+                filled = 0;
+            }
+        }
+    }
+    out.AppendBinary(block, filled * sizeof(float));
+    out.EndBinary();
+}
+
 static void Write(JSONWriter &out, const aiMesh &ai, bool is_elem = true) {
     out.StartObj(is_elem);
 
@@ -317,43 +474,19 @@ static void Write(JSONWriter &out, const aiMesh &ai, bool is_elem = true) {
     out.SimpleValue(ai.mPrimitiveTypes);
 
     out.Key("vertices");
-    out.StartArray();
-    for (unsigned int i = 0; i < ai.mNumVertices; ++i) {
-        out.Element(ai.mVertices[i].x);
-        out.Element(ai.mVertices[i].y);
-        out.Element(ai.mVertices[i].z);
-    }
-    out.EndArray();
+    WriteStream(out, reinterpret_cast<const ai_real *>(ai.mVertices), ai.mNumVertices, 3, 3);
 
     if (ai.HasNormals()) {
         out.Key("normals");
-        out.StartArray();
-        for (unsigned int i = 0; i < ai.mNumVertices; ++i) {
-            out.Element(ai.mNormals[i].x);
-            out.Element(ai.mNormals[i].y);
-            out.Element(ai.mNormals[i].z);
-        }
-        out.EndArray();
+        WriteStream(out, reinterpret_cast<const ai_real *>(ai.mNormals), ai.mNumVertices, 3, 3);
     }
 
     if (ai.HasTangentsAndBitangents()) {
         out.Key("tangents");
-        out.StartArray();
-        for (unsigned int i = 0; i < ai.mNumVertices; ++i) {
-            out.Element(ai.mTangents[i].x);
-            out.Element(ai.mTangents[i].y);
-            out.Element(ai.mTangents[i].z);
-        }
-        out.EndArray();
+        WriteStream(out, reinterpret_cast<const ai_real *>(ai.mTangents), ai.mNumVertices, 3, 3);
 
         out.Key("bitangents");
-        out.StartArray();
-        for (unsigned int i = 0; i < ai.mNumVertices; ++i) {
-            out.Element(ai.mBitangents[i].x);
-            out.Element(ai.mBitangents[i].y);
-            out.Element(ai.mBitangents[i].z);
-        }
-        out.EndArray();
+        WriteStream(out, reinterpret_cast<const ai_real *>(ai.mBitangents), ai.mNumVertices, 3, 3);
     }
 
     if (ai.GetNumUVChannels()) {
@@ -368,14 +501,7 @@ static void Write(JSONWriter &out, const aiMesh &ai, bool is_elem = true) {
         out.StartArray();
         for (unsigned int n = 0; n < ai.GetNumUVChannels(); ++n) {
             const unsigned int numc = ai.mNumUVComponents[n] ? ai.mNumUVComponents[n] : 2;
-
-            out.StartArray(true);
-            for (unsigned int i = 0; i < ai.mNumVertices; ++i) {
-                for (unsigned int c = 0; c < numc; ++c) {
-                    out.Element(ai.mTextureCoords[n][i][c]);
-                }
-            }
-            out.EndArray();
+            WriteStream(out, reinterpret_cast<const ai_real *>(ai.mTextureCoords[n]), ai.mNumVertices, 3, numc, true);
         }
         out.EndArray();
     }
@@ -384,14 +510,7 @@ static void Write(JSONWriter &out, const aiMesh &ai, bool is_elem = true) {
         out.Key("colors");
         out.StartArray();
         for (unsigned int n = 0; n < ai.GetNumColorChannels(); ++n) {
-            out.StartArray(true);
-            for (unsigned int i = 0; i < ai.mNumVertices; ++i) {
-                out.Element(ai.mColors[n][i].r);
-                out.Element(ai.mColors[n][i].g);
-                out.Element(ai.mColors[n][i].b);
-                out.Element(ai.mColors[n][i].a);
-            }
-            out.EndArray();
+            WriteStream(out, reinterpret_cast<const ai_real *>(ai.mColors[n]), ai.mNumVertices, 4, 4, true);
         }
         out.EndArray();
     }
@@ -415,7 +534,8 @@ static void Write(JSONWriter &out, const aiMesh &ai, bool is_elem = true) {
     out.EndObj();
 }
 
-static void Write(JSONWriter &out, const aiNode &ai, bool is_elem = true) {
+// firstSubMesh[i] is the index of the first mesh written for scene mesh i, see MeshSplitter
+static void Write(JSONWriter &out, const aiNode &ai, const std::vector<unsigned int> &firstSubMesh, bool is_elem = true) {
     out.StartObj(is_elem);
 
     out.Key("name");
@@ -428,7 +548,9 @@ static void Write(JSONWriter &out, const aiNode &ai, bool is_elem = true) {
         out.Key("meshes");
         out.StartArray();
         for (unsigned int n = 0; n < ai.mNumMeshes; ++n) {
-            out.Element(ai.mMeshes[n]);
+            for (unsigned int m = firstSubMesh[ai.mMeshes[n]]; m < firstSubMesh[ai.mMeshes[n] + 1]; ++m) {
+                out.Element(m);
+            }
         }
         out.EndArray();
     }
@@ -437,7 +559,7 @@ static void Write(JSONWriter &out, const aiNode &ai, bool is_elem = true) {
         out.Key("children");
         out.StartArray();
         for (unsigned int n = 0; n < ai.mNumChildren; ++n) {
-            Write(out, *ai.mChildren[n]);
+            Write(out, *ai.mChildren[n], firstSubMesh);
         }
         out.EndArray();
     }
@@ -714,17 +836,31 @@ static void WriteFormatInfo(JSONWriter &out) {
     out.SimpleValue("\"assimp2json\"");
     out.Key("version");
     out.SimpleValue(CURRENT_FORMAT_VERSION);
+    if (out.GetFlags() & JSONWriter::Flag_Base64Streams) {
+        // vertex streams are base64 strings of little-endian 32 bit floats
+        out.Key("streams");
+        out.SimpleValue("\"base64\"");
+    }
     out.EndObj();
 }
 
 static void Write(JSONWriter &out, const aiScene &ai) {
+    // meshes are split so they fit into a 16 bit index buffer. This happens while writing,
+    // one mesh at a time, so only the node's mesh indices need to be known upfront.
+    MeshSplitter splitter;
+    splitter.SetLimit(1 << 16);
+    std::vector<unsigned int> firstSubMesh(ai.mNumMeshes + 1, 0);
+    for (unsigned int n = 0; n < ai.mNumMeshes; ++n) {
+        firstSubMesh[n + 1] = firstSubMesh[n] + splitter.CountSubMeshes(ai.mMeshes[n]);
+    }
+
     out.StartObj();
 
     out.Key("__metadata__");
     WriteFormatInfo(out);
 
     out.Key("rootnode");
-    Write(out, *ai.mRootNode, false);
+    Write(out, *ai.mRootNode, firstSubMesh, false);
 
     out.Key("flags");
     out.SimpleValue(ai.mFlags);
@@ -733,7 +869,14 @@ static void Write(JSONWriter &out, const aiScene &ai) {
         out.Key("meshes");
         out.StartArray();
         for (unsigned int n = 0; n < ai.mNumMeshes; ++n) {
-            Write(out, *ai.mMeshes[n]);
+            if (firstSubMesh[n + 1] - firstSubMesh[n] == 1) {
+                Write(out, *ai.mMeshes[n]);
+                continue;
+            }
+            splitter.SplitMesh(ai.mMeshes[n], [&out](aiMesh *subMesh) {
+                Write(out, *subMesh);
+                delete subMesh;
+            });
         }
         out.EndArray();
     }
@@ -791,30 +934,17 @@ void ExportAssimp2Json(const char *file, Assimp::IOSystem *io, const aiScene *sc
         throw DeadlyExportError("could not open output file");
     }
 
-    // get a copy of the scene so we can modify it
-    aiScene *scenecopy_tmp;
-    aiCopyScene(scene, &scenecopy_tmp);
+    // XXX Flag_WriteSpecialFloats is turned on by default, right now we don't have a configuration interface for exporters
 
-    try {
-        // split meshes so they fit into a 16 bit index buffer
-        MeshSplitter splitter;
-        splitter.SetLimit(1 << 16);
-        splitter.Execute(scenecopy_tmp);
-
-        // XXX Flag_WriteSpecialFloats is turned on by default, right now we don't have a configuration interface for exporters
-
-        unsigned int flags = JSONWriter::Flag_WriteSpecialFloats;
-        if (pProperties->GetPropertyBool("JSON_SKIP_WHITESPACES", false)) {
-            flags |= JSONWriter::Flag_SkipWhitespaces;
-        }
-        JSONWriter s(*str, flags);
-        Write(s, *scenecopy_tmp);
-
-    } catch (...) {
-        aiFreeScene(scenecopy_tmp);
-        throw;
+    unsigned int flags = JSONWriter::Flag_WriteSpecialFloats;
+    if (pProperties->GetPropertyBool("JSON_SKIP_WHITESPACES", false)) {
+        flags |= JSONWriter::Flag_SkipWhitespaces;
+    }
+    if (pProperties->GetPropertyBool("JSON_BASE64_STREAMS", false)) {
+        flags |= JSONWriter::Flag_Base64Streams;
     }
-    aiFreeScene(scenecopy_tmp);
+    JSONWriter s(*str, flags);
+    Write(s, *scene);
 }
 
 } // namespace Assimp
@@ -14,15 +14,17 @@ Licensed under a 3-clause BSD license. See the LICENSE file for more information
 // it is refactored and the coding style is slightly improved, though.
 // ----------------------------------------------------------------------------
 
+#include <functional>
 #include <vector>
 
-struct aiScene;
 struct aiMesh;
-struct aiNode;
 
 // ---------------------------------------------------------------------------
 /** Splits meshes of unique vertices into meshes with no more vertices than
  *  a given, configurable threshold value.
+ *
+ *  The meshes are split one at a time, so only a single sub mesh needs to
+ *  exist at any time and the source scene is left untouched.
  */
 class MeshSplitter {
 public:
@@ -37,16 +39,23 @@ public:
     }
 
     // -------------------------------------------------------------------
-    /** Executes the post processing step on the given imported data.
-	 * At the moment a process is not supposed to fail.
-	 * @param pScene The imported data to work at.
+    /** Returns the number of sub meshes SplitMesh() creates for a mesh,
+     *  1 if the mesh is within the limit.
+	 * @param mesh The mesh to check.
 	 */
-    void Execute(aiScene *pScene);
+    unsigned int CountSubMeshes(const aiMesh *mesh) const;
 
-private:
-    void UpdateNode(aiNode *pcNode, const std::vector<std::pair<aiMesh *, unsigned int>> &source_mesh_map);
-    void SplitMesh(unsigned int index, aiMesh *mesh, std::vector<std::pair<aiMesh *, unsigned int>> &source_mesh_map);
+    // -------------------------------------------------------------------
+    /** Splits a mesh that exceeds the limit.
+	 * @param mesh The mesh to split.
+	 * @param callback Receives every sub mesh as soon as it is complete and
+	 *  takes ownership of it.
+	 */
+    void SplitMesh(const aiMesh *mesh, const std::function<void(aiMesh *)> &callback) const;
 
+private:
+    unsigned int NextSubMesh(const aiMesh *mesh, unsigned int base, std::vector<unsigned int> &was_copied_to,
+            unsigned int &num_vertices) const;
 };
 
 #endif // INCLUDED_MESH_SPLITTER
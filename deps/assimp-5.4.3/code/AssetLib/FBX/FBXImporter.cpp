@@ -57,6 +57,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/StreamReader.h>
 #include <assimp/importerdesc.h>
 #include <assimp/Importer.hpp>
+#include <assimp/MemoryAllocator.hpp>
 
 namespace Assimp {
 
@@ -138,7 +139,7 @@ void FBXImporter::InternReadFile(const std::string &pFile, aiScene *pScene, IOSy
 	// then becomes very large, too. Assimp doesn't support
 	// streaming for its output data structures so the net win with
 	// streaming input data would be very low.
-	std::vector<char> contents;
+	std::vector<char, TrackedAllocator<char>> contents;
 	contents.resize(stream->FileSize() + 1);
 	stream->Read(&*contents.begin(), 1, contents.size() - 1);
 	contents[contents.size() - 1] = 0;
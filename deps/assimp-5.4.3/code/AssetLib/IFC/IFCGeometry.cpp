@@ -870,16 +870,23 @@ bool ProcessRepresentationItem(const Schema_2x3::IfcRepresentationItem& item,
     // determine material
     unsigned int localmatid = ProcessMaterials(item.GetID(), matid, conv, true);
 
-    if (!TryQueryMeshCache(item,mesh_indices,localmatid,conv)) {
-        if(ProcessGeometricItem(item,localmatid,mesh_indices,conv)) {
-            if(mesh_indices.size()) {
-                PopulateMeshCache(item,mesh_indices,localmatid,conv);
-            }
-        } else {
-            return false;
+    const size_t firstMesh = conv.meshes.size();
+    const bool openings = conv.collect_openings || (conv.apply_openings && !conv.apply_openings->empty());
+    const bool cached = TryQueryMeshCache(item,mesh_indices,localmatid,conv);
+    bool result = true;
+    if (!cached) {
+        result = ProcessGeometricItem(item,localmatid,mesh_indices,conv);
+        if(result && mesh_indices.size()) {
+            PopulateMeshCache(item,mesh_indices,localmatid,conv);
         }
     }
-    return true;
+
+    if (conv.trace) {
+        const GeometryTrace::Item traced = { &item, localmatid, conv.trace->sets.at(&mesh_indices),
+            cached, result, openings, firstMesh, conv.meshes.size() };
+        conv.trace->items.push_back(traced);
+    }
+    return result;
 }
 
 
@@ -44,6 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef ASSIMP_BUILD_NO_IFC_IMPORTER
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -58,6 +59,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include "../STEPParser/STEPFileReader.h"
+#include "Common/ParallelFor.h"
 #include "IFCLoader.h"
 
 #include "IFCUtil.h"
@@ -140,6 +142,7 @@ void IFCImporter::SetupProperties(const Importer *pImp) {
     settings.conicSamplingAngle = std::min(std::max((float)pImp->GetPropertyFloat(AI_CONFIG_IMPORT_IFC_SMOOTHING_ANGLE, AI_IMPORT_IFC_DEFAULT_SMOOTHING_ANGLE), 5.0f), 120.0f);
     settings.cylindricalTessellation = std::min(std::max(pImp->GetPropertyInteger(AI_CONFIG_IMPORT_IFC_CYLINDRICAL_TESSELLATION, AI_IMPORT_IFC_DEFAULT_CYLINDRICAL_TESSELLATION), 3), 180);
     settings.skipAnnotations = true;
+    settings.numThreads = GetWorkerThreadCount(pImp->GetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 0));
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -254,17 +257,60 @@ void IFCImporter::InternReadFile(const std::string &pFile, aiScene *pScene, IOSy
     };
 
     // feed the IFC schema into the reader and pre-parse all lines
-    STEP::ReadFile(*db, schema, types_to_track, inverse_indices_to_track);
+    STEP::ReadFile(*db, schema, types_to_track, inverse_indices_to_track, settings.numThreads);
     const STEP::LazyObject *proj = db->GetObject("ifcproject");
     if (!proj) {
         ThrowException("missing IfcProject entity");
     }
 
-    
+    // the bulk of a building model are geometric entities, which are needed anyway
+    // to generate the product meshes. Convert them in parallel up-front, so the
+    // product workers below rarely have to wait for each other to evaluate one.
+    static const char *const types_to_preevaluate[] = {
+        "ifccartesianpoint",
+        "ifcdirection",
+        "ifcvector",
+        "ifcpolyloop",
+        "ifcfacebound",
+        "ifcfaceouterbound",
+        "ifcface",
+        "ifcclosedshell",
+        "ifcopenshell",
+        "ifcconnectedfaceset",
+        "ifcfacetedbrep",
+        "ifcpolyline",
+        "ifcline",
+        "ifccircle",
+        "ifctrimmedcurve",
+        "ifccompositecurve",
+        "ifccompositecurvesegment",
+        "ifcaxis1placement",
+        "ifcaxis2placement2d",
+        "ifcaxis2placement3d",
+        "ifclocalplacement",
+        "ifccartesiantransformationoperator3d",
+        "ifcplane",
+        "ifchalfspacesolid",
+        "ifcpolygonalboundedhalfspace",
+        "ifcextrudedareasolid",
+        "ifcrevolvedareasolid",
+        "ifcarbitraryclosedprofiledef",
+        "ifcarbitraryprofiledefwithvoids",
+        "ifcrectangleprofiledef",
+        "ifccircleprofiledef",
+        "ifcmappeditem",
+        "ifcrepresentationmap",
+        "ifcshaperepresentation",
+        "ifcproductdefinitionshape"
+    };
+    if (settings.numThreads > 1) {
+        db->EvaluateParallel(types_to_preevaluate, settings.numThreads);
+    }
 
     ConversionData conv(*db, proj->To<Schema_2x3::IfcProject>(), pScene, settings);
     SetUnits(conv);
     SetCoordinateSpace(conv);
+
     ProcessSpatialStructures(conv);
     MakeTreeRelative(conv);
 
@@ -417,6 +463,7 @@ bool ProcessMappedItem(const Schema_2x3::IfcMappedItem &mapped, aiNode *nd_src,
     msrc = m * msrc;
 
     std::set<unsigned int> meshes;
+    const unsigned int set = conv.trace ? conv.trace->AddMeshSet(meshes) : 0;
     const size_t old_openings = conv.collect_openings ? conv.collect_openings->size() : 0;
     if (conv.apply_openings) {
         IfcMatrix4 minv = msrc;
@@ -456,6 +503,9 @@ bool ProcessMappedItem(const Schema_2x3::IfcMappedItem &mapped, aiNode *nd_src,
 
     nd->mTransformation = nd_src->mTransformation * static_cast<aiMatrix4x4>(msrc);
     subnodes_src.push_back(nd.release());
+    if (conv.trace) {
+        conv.trace->mappedSets.push_back(set);
+    }
 
     return true;
 }
@@ -530,6 +580,9 @@ void ProcessProductRepresentation(const Schema_2x3::IfcProduct &el, aiNode *nd,
     // extract Color from metadata, if present
     unsigned int matid = ProcessMaterials(el.GetID(), std::numeric_limits<uint32_t>::max(), conv, false);
     std::set<unsigned int> meshes;
+    if (conv.trace) {
+        conv.trace->AddMeshSet(meshes);
+    }
 
     // we want only one representation type, so bring them in a suitable order (i.e try those
     // that look as if we could read them quickly at first). This way of reading
@@ -626,9 +679,278 @@ void ProcessMetadata(uint64_t relDefinesByPropertiesID, ConversionData &conv, Me
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// The representation of a product, converted once the spatial structure is complete. Each
+// product is converted on a worker thread together with the openings poured into it, into
+// a ConversionData of their own. The results are merged in product order afterwards, which
+// is the order the serial conversion goes through them.
+struct ProductGeometry {
+    ProductGeometry(const Schema_2x3::IfcProduct &el, aiNode *nd, bool collect) :
+            el(&el), nd(nd), collect(collect), wall(), firstMaterial(), endMaterial(), live() {}
+
+    ~ProductGeometry() {
+        std::for_each(subnodes.begin(), subnodes.end(), delete_fun<aiNode>());
+        std::for_each(mapped.begin(), mapped.end(), delete_fun<aiNode>());
+    }
+
+    // the product that starts the group this product is converted in
+    ProductGeometry &Group() {
+        return wall ? wall->Group() : *this;
+    }
+
+    const Schema_2x3::IfcProduct *el;
+    aiNode *nd;
+
+    // children of nd found by the traversal, the IfcMappedItem nodes go behind them
+    std::vector<aiNode *> subnodes;
+
+    // an IfcOpeningElement collects its geometry for the element it voids
+    bool collect;
+    ProductGeometry *wall;
+    IfcMatrix4 toWall;
+    std::vector<ProductGeometry *> openings;
+
+    // conversion results of the worker. Only the group keeps scratch, styles and materialMap.
+    std::unique_ptr<ConversionData> scratch;
+    std::unique_ptr<aiNode> node;
+    std::vector<aiNode *> mapped;
+    std::vector<TempOpening> collected;
+    GeometryTrace trace;
+    size_t firstMaterial, endMaterial;
+    std::vector<const Schema_2x3::IfcSurfaceStyle *> styles;
+    std::vector<unsigned int> materialMap;
+
+    // the worker's results are unusable, convert it again during the merge
+    bool live;
+};
+
+typedef std::vector<std::unique_ptr<ProductGeometry>> ProductQueue;
+
+// ------------------------------------------------------------------------------------------------
+void ConvertProductRepresentation(const ProductGeometry &product, aiNode *nd, std::vector<aiNode *> &subnodes,
+        std::vector<TempOpening> &openings, ConversionData &conv) {
+    conv.collect_openings = product.collect ? &openings : nullptr;
+    conv.apply_openings = product.collect ? nullptr : &openings;
+    ProcessProductRepresentation(*product.el, nd, subnodes, conv);
+    conv.apply_openings = conv.collect_openings = nullptr;
+}
+
+// ------------------------------------------------------------------------------------------------
+TempOpening CopyOpening(const TempOpening &opening) {
+    // the meshes are shared by all copies and get modified by the wall that uses them
+    TempOpening copy(opening);
+    if (copy.profileMesh) {
+        copy.profileMesh = std::make_shared<TempMesh>(*copy.profileMesh);
+    }
+    if (copy.profileMesh2D) {
+        copy.profileMesh2D = std::make_shared<TempMesh>(*copy.profileMesh2D);
+    }
+    return copy;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ConvertProductGroup(ProductGeometry &product, ConversionData &scratch) {
+    // the openings keep what they collected, in case the wall has to be converted again
+    std::vector<TempOpening> openings;
+    for (ProductGeometry *opening : product.openings) {
+        ConvertProductGroup(*opening, scratch);
+        std::transform(opening->collected.begin(), opening->collected.end(), std::back_inserter(openings), CopyOpening);
+    }
+
+    product.node.reset(new aiNode());
+    product.node->mTransformation = product.nd->mTransformation;
+    product.firstMaterial = scratch.materials.size();
+
+    scratch.trace = &product.trace;
+    ConvertProductRepresentation(product, product.node.get(), product.mapped, product.collect ? product.collected : openings, scratch);
+    scratch.trace = nullptr;
+
+    product.endMaterial = scratch.materials.size();
+    for (TempOpening &op : product.collected) {
+        op.Transform(product.toWall);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void MarkLive(ProductGeometry &product) {
+    product.live = true;
+    for (ProductGeometry *opening : product.openings) {
+        MarkLive(*opening);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Index of the material ProcessMaterials() returns for a surface style, nullptr standing for
+// the default material. UINT32_MAX if conv doesn't have it yet.
+unsigned int FindMaterial(const Schema_2x3::IfcSurfaceStyle *style, const ConversionData &conv) {
+    if (style) {
+        const ConversionData::MaterialCache::const_iterator it = conv.cached_materials.find(style);
+        return it != conv.cached_materials.end() ? it->second : std::numeric_limits<uint32_t>::max();
+    }
+
+    aiString name;
+    name.Set("<IFCDefault>");
+    for (size_t a = 0; a < conv.materials.size(); ++a) {
+        aiString mname;
+        conv.materials[a]->Get(AI_MATKEY_NAME, mname);
+        if (name == mname) {
+            return static_cast<unsigned int>(a);
+        }
+    }
+    return std::numeric_limits<uint32_t>::max();
+}
+
+// ------------------------------------------------------------------------------------------------
+// The worker converted every item its own mesh cache didn't have. The serial conversion
+// instead reuses the meshes of items converted for an earlier product, which makes no
+// difference unless converting the item failed or changed the openings in use.
+bool CanMergeProduct(const ProductGeometry &product, const ProductGeometry &group, const ConversionData &conv) {
+    for (const GeometryTrace::Item &item : product.trace.items) {
+        if (item.cached || (item.result && !item.openings)) {
+            continue;
+        }
+        unsigned int matindex = group.materialMap[item.matindex];
+        if (matindex == std::numeric_limits<uint32_t>::max()) {
+            matindex = FindMaterial(group.styles[item.matindex], conv);
+        }
+        if (matindex != std::numeric_limits<uint32_t>::max() &&
+                conv.cached_meshes.count(ConversionData::MeshCacheIndex(item.item, matindex))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MergeProduct(ProductGeometry &product, ProductGeometry &group, ConversionData &conv) {
+    ConversionData &scratch = *group.scratch;
+
+    // materials in the order ProcessMaterials() would have created them
+    for (size_t i = product.firstMaterial; i < product.endMaterial; ++i) {
+        unsigned int matindex = FindMaterial(group.styles[i], conv);
+        if (matindex == std::numeric_limits<uint32_t>::max()) {
+            matindex = static_cast<unsigned int>(conv.materials.size());
+            conv.materials.push_back(scratch.materials[i]);
+            scratch.materials[i] = nullptr;
+            if (group.styles[i]) {
+                conv.cached_materials[group.styles[i]] = matindex;
+            }
+        }
+        group.materialMap[i] = matindex;
+    }
+
+    // replay the items against the mesh cache of the import
+    std::vector<std::set<unsigned int>> sets(product.trace.numSets);
+    for (const GeometryTrace::Item &item : product.trace.items) {
+        const unsigned int matindex = group.materialMap[item.matindex];
+        std::set<unsigned int> &mesh_indices = sets[item.set];
+        if (TryQueryMeshCache(*item.item, mesh_indices, matindex, conv)) {
+            continue;
+        }
+        ai_assert(!item.cached);
+
+        for (size_t i = item.firstMesh; i < item.endMesh; ++i) {
+            aiMesh *const mesh = scratch.meshes[i];
+            scratch.meshes[i] = nullptr;
+            mesh->mMaterialIndex = matindex;
+            mesh_indices.insert(static_cast<unsigned int>(conv.meshes.size()));
+            conv.meshes.push_back(mesh);
+        }
+        if (item.result && mesh_indices.size()) {
+            PopulateMeshCache(*item.item, mesh_indices, matindex, conv);
+        }
+    }
+
+    if (!sets.empty()) {
+        AssignAddedMeshes(sets[0], product.nd, conv);
+    }
+    for (size_t i = 0; i < product.mapped.size(); ++i) {
+        aiNode *const nd = product.mapped[i];
+        delete[] nd->mMeshes;
+        nd->mMeshes = nullptr;
+        nd->mNumMeshes = 0;
+        AssignAddedMeshes(sets[product.trace.mappedSets[i]], nd, conv);
+    }
+    product.subnodes.insert(product.subnodes.end(), product.mapped.begin(), product.mapped.end());
+    product.mapped.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void ConvertProductAgain(ProductGeometry &product, ConversionData &conv) {
+    std::vector<TempOpening> openings;
+    for (ProductGeometry *opening : product.openings) {
+        std::move(opening->collected.begin(), opening->collected.end(), std::back_inserter(openings));
+        opening->collected.clear();
+    }
+
+    std::for_each(product.mapped.begin(), product.mapped.end(), delete_fun<aiNode>());
+    product.mapped.clear();
+    product.collected.clear();
+
+    ConvertProductRepresentation(product, product.nd, product.subnodes, product.collect ? product.collected : openings, conv);
+    for (TempOpening &op : product.collected) {
+        op.Transform(product.toWall);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void ConvertProducts(ProductQueue &products, ConversionData &conv) {
+    std::vector<ProductGeometry *> groups;
+    for (const std::unique_ptr<ProductGeometry> &product : products) {
+        if (!product->wall) {
+            groups.push_back(product.get());
+        }
+    }
+
+    ParallelFor(groups.size(), conv.settings.numThreads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ProductGeometry &group = *groups[i];
+            group.scratch.reset(new ConversionData(conv.db, conv.proj, conv.out, conv.settings));
+            group.scratch->len_scale = conv.len_scale;
+            group.scratch->angle_scale = conv.angle_scale;
+            group.scratch->plane_angle_in_radians = conv.plane_angle_in_radians;
+            group.scratch->wcs = conv.wcs;
+            try {
+                ConvertProductGroup(group, *group.scratch);
+            } catch (...) {
+                // converting it again in product order raises the error where the serial conversion would
+                MarkLive(group);
+                continue;
+            }
+
+            group.styles.assign(group.scratch->materials.size(), nullptr);
+            for (const ConversionData::MaterialCache::value_type &m : group.scratch->cached_materials) {
+                group.styles[m.second] = m.first;
+            }
+            group.materialMap.assign(group.scratch->materials.size(), std::numeric_limits<uint32_t>::max());
+        }
+    });
+
+    for (const std::unique_ptr<ProductGeometry> &product : products) {
+        ProductGeometry &group = product->Group();
+        if (!product->live && CanMergeProduct(*product, group, conv)) {
+            MergeProduct(*product, group, conv);
+        } else {
+            // the materials of all later products in the group depend on this one
+            MarkLive(group);
+            ConvertProductAgain(*product, conv);
+        }
+
+        aiNode *const nd = product->nd;
+        if (product->subnodes.size()) {
+            nd->mChildren = new aiNode *[product->subnodes.size()]();
+            for (aiNode *nd2 : product->subnodes) {
+                nd->mChildren[nd->mNumChildren++] = nd2;
+                nd2->mParent = nd;
+            }
+            product->subnodes.clear();
+        }
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 aiNode *ProcessSpatialStructure(aiNode *parent, const Schema_2x3::IfcProduct &el, ConversionData &conv,
-        std::vector<TempOpening> *collect_openings = nullptr) {
+        std::vector<TempOpening> *collect_openings = nullptr, ProductQueue *products = nullptr) {
     const STEP::DB::RefMap &refs = conv.db.GetRefs();
 
     // skip over space and annotation nodes - usually, these have no meaning in Assimp's context
@@ -684,6 +1006,7 @@ aiNode *ProcessSpatialStructure(aiNode *parent, const Schema_2x3::IfcProduct &el
     }
 
     std::vector<TempOpening> openings;
+    std::vector<ProductGeometry *> opening_products;
 
     IfcMatrix4 myInv;
     bool didinv = false;
@@ -718,7 +1041,7 @@ aiNode *ProcessSpatialStructure(aiNode *parent, const Schema_2x3::IfcProduct &el
                         continue;
                     }
 
-                    aiNode *const ndnew = ProcessSpatialStructure(nd, pro, conv, nullptr);
+                    aiNode *const ndnew = ProcessSpatialStructure(nd, pro, conv, nullptr, products);
                     if (ndnew) {
                         subnodes.push_back(ndnew);
                     }
@@ -737,7 +1060,7 @@ aiNode *ProcessSpatialStructure(aiNode *parent, const Schema_2x3::IfcProduct &el
                     nd_aggr->mTransformation = nd->mTransformation;
 
                     std::vector<TempOpening> openings_local;
-                    aiNode *const ndnew = ProcessSpatialStructure(nd_aggr.get(), open, conv, &openings_local);
+                    aiNode *const ndnew = ProcessSpatialStructure(nd_aggr.get(), open, conv, &openings_local, products);
                     if (ndnew) {
 
                         nd_aggr->mNumChildren = 1;
@@ -745,6 +1068,17 @@ aiNode *ProcessSpatialStructure(aiNode *parent, const Schema_2x3::IfcProduct &el
 
                         nd_aggr->mChildren[0] = ndnew;
 
+                        if (products && !products->empty() && products->back()->nd == ndnew) {
+                            if (!didinv) {
+                                myInv = aiMatrix4x4(nd->mTransformation).Inverse();
+                                didinv = true;
+                            }
+
+                            // the opening collects its geometry later, see ConvertProducts()
+                            products->back()->toWall = myInv * nd_aggr->mChildren[0]->mTransformation;
+                            opening_products.push_back(products->back().get());
+                        }
+
                         if (openings_local.size()) {
                             if (!didinv) {
                                 myInv = aiMatrix4x4(nd->mTransformation).Inverse();
@@ -784,7 +1118,7 @@ aiNode *ProcessSpatialStructure(aiNode *parent, const Schema_2x3::IfcProduct &el
                 for (const Schema_2x3::IfcObjectDefinition &def : aggr->RelatedObjects) {
                     if (const Schema_2x3::IfcProduct *const prod = def.ToPtr<Schema_2x3::IfcProduct>()) {
 
-                        aiNode *const ndnew = ProcessSpatialStructure(nd_aggr.get(), *prod, conv, nullptr);
+                        aiNode *const ndnew = ProcessSpatialStructure(nd_aggr.get(), *prod, conv, nullptr, products);
                         if (ndnew) {
                             nd_aggr->mChildren[nd_aggr->mNumChildren++] = ndnew;
                         }
@@ -795,14 +1129,26 @@ aiNode *ProcessSpatialStructure(aiNode *parent, const Schema_2x3::IfcProduct &el
             }
         }
 
-        conv.collect_openings = collect_openings;
-        if (!conv.collect_openings) {
-            conv.apply_openings = &openings;
-        }
+        if (products) {
+            if (!skipGeometry) {
+                std::unique_ptr<ProductGeometry> product(new ProductGeometry(el, nd, collect_openings != nullptr));
+                product->subnodes.swap(subnodes);
+                product->openings = opening_products;
+                for (ProductGeometry *opening : opening_products) {
+                    opening->wall = product.get();
+                }
+                products->push_back(std::move(product));
+            }
+        } else {
+            conv.collect_openings = collect_openings;
+            if (!conv.collect_openings) {
+                conv.apply_openings = &openings;
+            }
 
-        if (!skipGeometry) {
-            ProcessProductRepresentation(el, nd, subnodes, conv);
-            conv.apply_openings = conv.collect_openings = nullptr;
+            if (!skipGeometry) {
+                ProcessProductRepresentation(el, nd, subnodes, conv);
+                conv.apply_openings = conv.collect_openings = nullptr;
+            }
         }
 
         if (subnodes.size()) {
@@ -843,6 +1189,9 @@ void ProcessSpatialStructures(ConversionData &conv) {
         }
     }
 
+    // with several threads, product geometry is converted after the traversal
+    ProductQueue products;
+    ProductQueue *const queue = conv.settings.numThreads > 1 ? &products : nullptr;
     std::vector<aiNode *> nodes;
 
     for (const STEP::LazyObject *lz : *range) {
@@ -864,7 +1213,7 @@ void ProcessSpatialStructures(ConversionData &conv) {
                     if (def.GetID() == prod->GetID()) {
                         IFCImporter::LogVerboseDebug("selecting this spatial structure as root structure");
                         // got it, this is one primary site.
-                        nodes.push_back(ProcessSpatialStructure(nullptr, *prod, conv, nullptr));
+                        nodes.push_back(ProcessSpatialStructure(nullptr, *prod, conv, nullptr, queue));
                     }
                 }
             }
@@ -881,7 +1230,7 @@ void ProcessSpatialStructures(ConversionData &conv) {
                 continue;
             }
 
-            nodes.push_back(ProcessSpatialStructure(nullptr, *prod, conv, nullptr));
+            nodes.push_back(ProcessSpatialStructure(nullptr, *prod, conv, nullptr, queue));
         }
 
         nb_nodes = nodes.size();
@@ -905,6 +1254,8 @@ void ProcessSpatialStructures(ConversionData &conv) {
     } else {
         IFCImporter::ThrowException("failed to determine primary site element");
     }
+
+    ConvertProducts(products, conv);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -54,6 +54,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/mesh.h>
 #include <assimp/material.h>
 
+#include <map>
+#include <set>
 #include <utility>
 
 struct aiNode;
@@ -165,6 +167,38 @@ struct TempOpening
 };
 
 
+// ------------------------------------------------------------------------------------------------
+// Log of the representation items converted for one product on a worker thread. The loader
+// replays it against the mesh and material caches of the import, in product order, to get
+// the same meshes and mesh indices a serial conversion would have produced.
+// ------------------------------------------------------------------------------------------------
+struct GeometryTrace
+{
+    struct Item {
+        const IFC::Schema_2x3::IfcRepresentationItem* item;
+        unsigned int matindex;
+        unsigned int set;           // mesh index set the item was added to
+        bool cached;                // served from the mesh cache
+        bool result;                // return value of ProcessRepresentationItem()
+        bool openings;              // openings were collected or applied while converting it
+        size_t firstMesh, endMesh;  // meshes generated for it
+    };
+
+    // register a set of mesh indices which representation items are added to. Sets are
+    // numbered in creation order, a product's own set comes first.
+    unsigned int AddMeshSet(const std::set<unsigned int>& mesh_indices) {
+        return sets[&mesh_indices] = numSets++;
+    }
+
+    std::vector<Item> items;
+    std::map<const std::set<unsigned int>*, unsigned int> sets;
+    unsigned int numSets = 0;
+
+    // the set of each IfcMappedItem node, in the order the nodes were added
+    std::vector<unsigned int> mappedSets;
+};
+
+
 // ------------------------------------------------------------------------------------------------
 // Intermediate data storage during conversion. Keeps everything and a bit more.
 // ------------------------------------------------------------------------------------------------
@@ -179,6 +213,7 @@ struct ConversionData
         , settings(settings)
         , apply_openings()
         , collect_openings()
+        , trace()
     {}
 
     ~ConversionData() {
@@ -221,6 +256,9 @@ struct ConversionData
     std::vector<TempOpening>* apply_openings;
     std::vector<TempOpening>* collect_openings;
 
+    // set while the representation of a product is converted on a worker thread
+    GeometryTrace* trace;
+
     std::set<uint64_t> already_processed;
 };
 
@@ -282,6 +320,8 @@ unsigned int ProcessMaterials(uint64_t id, unsigned int prevMatId, ConversionDat
 IfcMatrix3 DerivePlaneCoordinateSpace(const TempMesh& curmesh, bool& ok, IfcVector3& norOut);
 bool ProcessRepresentationItem(const Schema_2x3::IfcRepresentationItem& item, unsigned int matid, std::set<unsigned int>& mesh_indices, ConversionData& conv);
 void AssignAddedMeshes(std::set<unsigned int>& mesh_indices,aiNode* nd,ConversionData& /*conv*/);
+bool TryQueryMeshCache(const Schema_2x3::IfcRepresentationItem& item, std::set<unsigned int>& mesh_indices, unsigned int mat_index, ConversionData& conv);
+void PopulateMeshCache(const Schema_2x3::IfcRepresentationItem& item, const std::set<unsigned int>& mesh_indices, unsigned int mat_index, ConversionData& conv);
 
 void ProcessSweptAreaSolid(const Schema_2x3::IfcSweptAreaSolid& swept, TempMesh& meshout,
                            ConversionData& conv);
@@ -49,6 +49,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AssetLib/Irr/IRRLoader.h"
 #include "Common/Importer.h"
+#include "Material/MaterialSystem.h"
 
 #include <assimp/GenericProperty.h>
 #include <assimp/MathFunctions.h>
@@ -597,6 +598,9 @@ void SetupMapping(aiMaterial *mat, aiTextureMapping mode, const aiVector3D &axis
     }
     mat->mNumProperties = (unsigned int)p.size();
     ::memcpy(mat->mProperties, &p[0], sizeof(void *) * mat->mNumProperties);
+
+    // the list has been rewritten in place
+    BuildMaterialPropertyIndex(mat);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -78,7 +78,8 @@ using namespace std;
 ObjFileImporter::ObjFileImporter() :
         m_Buffer(),
         m_pRootObject(nullptr),
-        m_strAbsPath(std::string(1, DefaultIOSystem().getOsSeparator())) {
+        m_strAbsPath(std::string(1, DefaultIOSystem().getOsSeparator())),
+        m_flatIndexBuffer(false) {
     // empty
 }
 
@@ -95,6 +96,12 @@ bool ObjFileImporter::CanRead(const std::string &pFile, IOSystem *pIOHandler, bo
     return BaseImporter::SearchFileHeaderForToken(pIOHandler, pFile, tokens, AI_COUNT_OF(tokens), 200, false, true);
 }
 
+// ------------------------------------------------------------------------------------------------
+void ObjFileImporter::SetupProperties(const Importer *pImp) {
+    m_pointCloud.Setup(pImp);
+    m_flatIndexBuffer = pImp->GetPropertyBool(AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER, false);
+}
+
 // ------------------------------------------------------------------------------------------------
 const aiImporterDesc *ObjFileImporter::GetInfo() const {
     return &desc;
@@ -148,6 +155,7 @@ void ObjFileImporter::InternReadFile(const std::string &file, aiScene *pScene, I
 
     // And create the proper return structures out of it
     CreateDataFromImport(parser.GetModel(), pScene);
+    ProcessPointClouds(pScene, m_pointCloud);
 
     streamedBuffer.close();
 
@@ -277,7 +285,7 @@ aiNode *ObjFileImporter::createNodes(const ObjFile::Model *pModel, const ObjFile
         unsigned int meshId = pObject->m_Meshes[i];
         std::unique_ptr<aiMesh> pMesh = createTopology(pModel, pObject, meshId);
         if (pMesh != nullptr) {
-            if (pMesh->mNumFaces > 0) {
+            if (pMesh->mNumFaces > 0 || IsPointCloud(pMesh.get())) {
                 MeshArray.push_back(std::move(pMesh));
             }
         }
@@ -333,17 +341,21 @@ std::unique_ptr<aiMesh> ObjFileImporter::createTopology(const ObjFile::Model *pM
         pMesh->mName.Set(pObjMesh->m_name);
     }
 
+    size_t numIndices = 0;
     for (size_t index = 0; index < pObjMesh->m_Faces.size(); index++) {
         const ObjFile::Face *inp = pObjMesh->m_Faces[index];
 
         if (inp->mPrimitiveType == aiPrimitiveType_LINE) {
             pMesh->mNumFaces += static_cast<unsigned int>(inp->m_vertices.size() - 1);
             pMesh->mPrimitiveTypes |= aiPrimitiveType_LINE;
+            numIndices += (inp->m_vertices.size() - 1) * 2;
         } else if (inp->mPrimitiveType == aiPrimitiveType_POINT) {
             pMesh->mNumFaces += static_cast<unsigned int>(inp->m_vertices.size());
             pMesh->mPrimitiveTypes |= aiPrimitiveType_POINT;
+            numIndices += inp->m_vertices.size();
         } else {
             ++pMesh->mNumFaces;
+            numIndices += inp->m_vertices.size();
             if (inp->m_vertices.size() > 3) {
                 pMesh->mPrimitiveTypes |= aiPrimitiveType_POLYGON;
             } else {
@@ -353,12 +365,30 @@ std::unique_ptr<aiMesh> ObjFileImporter::createTopology(const ObjFile::Model *pM
     }
 
     unsigned int uiIdxCount(0u);
-    if (pMesh->mNumFaces > 0) {
+    if (m_pointCloud.mEnabled && pMesh->mPrimitiveTypes == aiPrimitiveType_POINT) {
+        // point clouds store the vertices only, one for each point
+        uiIdxCount = pMesh->mNumFaces;
+        pMesh->mNumFaces = 0;
+        if (pObjMesh->m_uiMaterialIndex != ObjFile::Mesh::NoMaterial) {
+            pMesh->mMaterialIndex = pObjMesh->m_uiMaterialIndex;
+        }
+    } else if (pMesh->mNumFaces > 0) {
         pMesh->mFaces = new aiFace[pMesh->mNumFaces];
         if (pObjMesh->m_uiMaterialIndex != ObjFile::Mesh::NoMaterial) {
             pMesh->mMaterialIndex = pObjMesh->m_uiMaterialIndex;
         }
 
+        // with a flat index buffer all faces are views into one allocation
+        if (m_flatIndexBuffer && numIndices > 0) {
+            pMesh->mIndexBufferSize = static_cast<unsigned int>(numIndices);
+            pMesh->mIndexBuffer = new unsigned int[numIndices];
+        }
+        auto allocIndices = [&pMesh, &uiIdxCount](unsigned int n) {
+            unsigned int *indices = pMesh->mIndexBuffer ? pMesh->mIndexBuffer + uiIdxCount : new unsigned int[n];
+            uiIdxCount += n;
+            return indices;
+        };
+
         unsigned int outIndex(0);
 
         // Copy all data from all stored meshes
@@ -367,24 +397,24 @@ std::unique_ptr<aiMesh> ObjFileImporter::createTopology(const ObjFile::Model *pM
             if (inp->mPrimitiveType == aiPrimitiveType_LINE) {
                 for (size_t i = 0; i < inp->m_vertices.size() - 1; ++i) {
                     aiFace &f = pMesh->mFaces[outIndex++];
-                    uiIdxCount += f.mNumIndices = 2;
-                    f.mIndices = new unsigned int[2];
+                    f.mNumIndices = 2;
+                    f.mIndices = allocIndices(2);
                 }
                 continue;
             } else if (inp->mPrimitiveType == aiPrimitiveType_POINT) {
                 for (size_t i = 0; i < inp->m_vertices.size(); ++i) {
                     aiFace &f = pMesh->mFaces[outIndex++];
-                    uiIdxCount += f.mNumIndices = 1;
-                    f.mIndices = new unsigned int[1];
+                    f.mNumIndices = 1;
+                    f.mIndices = allocIndices(1);
                 }
                 continue;
             }
 
             aiFace *pFace = &pMesh->mFaces[outIndex++];
             const unsigned int uiNumIndices = (unsigned int)face->m_vertices.size();
-            uiIdxCount += pFace->mNumIndices = (unsigned int)uiNumIndices;
+            pFace->mNumIndices = uiNumIndices;
             if (pFace->mNumIndices > 0) {
-                pFace->mIndices = new unsigned int[uiNumIndices];
+                pFace->mIndices = allocIndices(uiNumIndices);
             }
         }
     }
@@ -483,6 +513,12 @@ void ObjFileImporter::createVertexArray(const ObjFile::Model *pModel,
                 }
             }
 
+            // Point clouds have no faces
+            if (nullptr == pMesh->mFaces) {
+                ++newIndex;
+                continue;
+            }
+
             // Get destination face
             aiFace *pDestFace = &pMesh->mFaces[outIndex];
 
@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef OBJ_FILE_IMPORTER_H_INC
 #define OBJ_FILE_IMPORTER_H_INC
 
+#include "Common/PointCloud.h"
 #include <assimp/BaseImporter.h>
 #include <assimp/material.h>
 #include <memory>
@@ -73,6 +74,10 @@ public:
     /// \remark See BaseImporter::CanRead() for details.
     bool CanRead(const std::string &pFile, IOSystem *pIOHandler, bool checkSig) const override;
 
+    /// \brief  Reads the point cloud settings.
+    /// \remark See BaseImporter::SetupProperties() for details.
+    void SetupProperties(const Importer *pImp) override;
+
 protected:
     //! \brief  Appends the supported extension.
     const aiImporterDesc *GetInfo() const override;
@@ -114,6 +119,10 @@ private:
     ObjFile::Object *m_pRootObject;
     //! Absolute pathname of model in file system
     std::string m_strAbsPath;
+    //! Point cloud settings
+    PointCloudConfig m_pointCloud;
+    //! Store the faces in one flat index buffer
+    bool m_flatIndexBuffer;
 };
 
 // ------------------------------------------------------------------------------------------------
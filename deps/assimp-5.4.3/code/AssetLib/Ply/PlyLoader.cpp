@@ -51,7 +51,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/importerdesc.h>
 #include <assimp/scene.h>
 #include <assimp/IOSystem.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/ByteSwapper.h>
+#include <cstring>
 #include <memory>
+#include <type_traits>
 
 namespace Assimp {
 
@@ -102,6 +106,154 @@ namespace {
         return isBigEndian;
     }
 
+    // ------------------------------------------------------------------------------------------------
+    // Reads a value from a binary record
+    inline void SwapBinaryValue(int8_t *) {}
+    inline void SwapBinaryValue(uint8_t *) {}
+
+    template <typename T>
+    inline void SwapBinaryValue(T *value) {
+        ByteSwap::Swap(value);
+    }
+
+    template <typename T>
+    inline T ReadBinaryValue(const char *src, bool bigEndian) {
+        T value;
+        ::memcpy(&value, src, sizeof(T));
+        if (bigEndian) {
+            SwapBinaryValue(&value);
+        }
+        return value;
+    }
+
+    // ------------------------------------------------------------------------------------------------
+    // Stores a value in the union member matching its type
+    template <typename T>
+    inline PLY::PropertyInstance::ValueUnion MakeValue(T value) {
+        PLY::PropertyInstance::ValueUnion out;
+        if (std::is_same<T, double>::value) {
+            out.fDouble = static_cast<double>(value);
+        } else if (std::is_same<T, float>::value) {
+            out.fFloat = static_cast<float>(value);
+        } else if (std::is_signed<T>::value) {
+            out.iInt = static_cast<int32_t>(value);
+        } else {
+            out.iUInt = static_cast<uint32_t>(value);
+        }
+        return out;
+    }
+
+    // ------------------------------------------------------------------------------------------------
+    // Offset and type of a scalar property inside of a binary record
+    struct BinaryChannel {
+        unsigned int offset = 0;
+        PLY::EDataType type = EDT_INVALID;
+
+        bool IsSet() const {
+            return EDT_INVALID != type;
+        }
+    };
+
+    // Converts color channels to [0...1], see PLYImporter::NormalizeColorValue()
+    using ColorNormalizer = ai_real (*)(PLY::PropertyInstance::ValueUnion, PLY::EDataType);
+
+    template <typename T, typename TStore>
+    void DecodeChannel(const char *src, unsigned int recordSize, unsigned int count, bool bigEndian,
+            PLY::EDataType eType, ColorNormalizer normalize, TStore store) {
+        if (nullptr != normalize) {
+            for (unsigned int i = 0; i < count; ++i, src += recordSize) {
+                store(i, normalize(MakeValue(ReadBinaryValue<T>(src, bigEndian)), eType));
+            }
+        } else {
+            for (unsigned int i = 0; i < count; ++i, src += recordSize) {
+                store(i, static_cast<ai_real>(ReadBinaryValue<T>(src, bigEndian)));
+            }
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------------
+    // Decodes one property of count records, the data type is resolved once per block
+    template <typename TStore>
+    void DecodeChannel(const BinaryChannel &channel, const char *data, unsigned int recordSize, unsigned int count,
+            bool bigEndian, ColorNormalizer normalize, TStore store) {
+        const char *src = data + channel.offset;
+        switch (channel.type) {
+        case EDT_Char:
+            DecodeChannel<int8_t>(src, recordSize, count, bigEndian, channel.type, normalize, store);
+            break;
+        case EDT_UChar:
+            DecodeChannel<uint8_t>(src, recordSize, count, bigEndian, channel.type, normalize, store);
+            break;
+        case EDT_Short:
+            DecodeChannel<int16_t>(src, recordSize, count, bigEndian, channel.type, normalize, store);
+            break;
+        case EDT_UShort:
+            DecodeChannel<uint16_t>(src, recordSize, count, bigEndian, channel.type, normalize, store);
+            break;
+        case EDT_Int:
+            DecodeChannel<int32_t>(src, recordSize, count, bigEndian, channel.type, normalize, store);
+            break;
+        case EDT_UInt:
+            DecodeChannel<uint32_t>(src, recordSize, count, bigEndian, channel.type, normalize, store);
+            break;
+        case EDT_Float:
+            DecodeChannel<float>(src, recordSize, count, bigEndian, channel.type, normalize, store);
+            break;
+        case EDT_Double:
+            DecodeChannel<double>(src, recordSize, count, bigEndian, channel.type, normalize, store);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // ------------------------------------------------------------------------------------------------
+    // Decodes three consecutive components of a vector, plain little endian floats are copied as is
+    void DecodeVectors(const BinaryChannel channels[3], const char *data, unsigned int recordSize, unsigned int count,
+            bool bigEndian, aiVector3D *out) {
+        if (!bigEndian && std::is_same<ai_real, float>::value &&
+                EDT_Float == channels[0].type && EDT_Float == channels[1].type && EDT_Float == channels[2].type &&
+                channels[1].offset == channels[0].offset + 4 && channels[2].offset == channels[0].offset + 8) {
+            const char *src = data + channels[0].offset;
+            if (recordSize == sizeof(aiVector3D)) {
+                ::memcpy(out, src, sizeof(aiVector3D) * count);
+                return;
+            }
+            for (unsigned int i = 0; i < count; ++i, src += recordSize) {
+                ::memcpy(&out[i], src, sizeof(aiVector3D));
+            }
+            return;
+        }
+
+        DecodeChannel(channels[0], data, recordSize, count, bigEndian, nullptr, [out](unsigned int i, ai_real v) { out[i].x = v; });
+        DecodeChannel(channels[1], data, recordSize, count, bigEndian, nullptr, [out](unsigned int i, ai_real v) { out[i].y = v; });
+        DecodeChannel(channels[2], data, recordSize, count, bigEndian, nullptr, [out](unsigned int i, ai_real v) { out[i].z = v; });
+    }
+
+    // ------------------------------------------------------------------------------------------------
+    template <typename T>
+    void DecodeIndices(const char *src, unsigned int count, bool bigEndian, unsigned int *out) {
+        for (unsigned int i = 0; i < count; ++i, src += sizeof(T)) {
+            out[i] = static_cast<unsigned int>(ReadBinaryValue<T>(src, bigEndian));
+        }
+    }
+
+    unsigned int ReadBinaryIndex(const char *src, PLY::EDataType eType, bool bigEndian) {
+        unsigned int out = 0;
+        switch (eType) {
+        case EDT_Char: DecodeIndices<int8_t>(src, 1, bigEndian, &out); break;
+        case EDT_UChar: DecodeIndices<uint8_t>(src, 1, bigEndian, &out); break;
+        case EDT_Short: DecodeIndices<int16_t>(src, 1, bigEndian, &out); break;
+        case EDT_UShort: DecodeIndices<uint16_t>(src, 1, bigEndian, &out); break;
+        case EDT_Int: DecodeIndices<int32_t>(src, 1, bigEndian, &out); break;
+        case EDT_UInt: DecodeIndices<uint32_t>(src, 1, bigEndian, &out); break;
+        case EDT_Float: DecodeIndices<float>(src, 1, bigEndian, &out); break;
+        case EDT_Double: DecodeIndices<double>(src, 1, bigEndian, &out); break;
+        default: break;
+        }
+        return out;
+    }
+
 } // namespace
 
 // ------------------------------------------------------------------------------------------------
@@ -113,6 +265,11 @@ PLYImporter::PLYImporter() :
     // empty
 }
 
+// ------------------------------------------------------------------------------------------------
+void PLYImporter::SetupProperties(const Importer *pImp) {
+    mPointCloud.Setup(pImp);
+}
+
 // ------------------------------------------------------------------------------------------------
 PLYImporter::~PLYImporter() {
     delete mGeneratedMesh;
@@ -260,6 +417,10 @@ void PLYImporter::InternReadFile(const std::string &pFile, aiScene *pScene, IOSy
     for (unsigned int i = 0; i < pScene->mRootNode->mNumMeshes; ++i) {
         pScene->mRootNode->mMeshes[i] = i;
     }
+
+    if (pointsOnly) {
+        ProcessPointClouds(pScene, mPointCloud);
+    }
 }
 
 static constexpr ai_uint NotSet = 0xFFFFFFFF;
@@ -476,6 +637,162 @@ void PLYImporter::LoadVertex(const PLY::Element *pcElement, const PLY::ElementIn
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// Bulk version of LoadVertex() for binary files, decodes one property of all records at a time
+void PLYImporter::LoadVertexBlock(const PLY::Element *pcElement, const char *data, unsigned int recordSize,
+        unsigned int first, unsigned int count, bool bigEndian) {
+    ai_assert(nullptr != pcElement);
+    ai_assert(nullptr != data);
+
+    BinaryChannel positions[3], normals[3], colors[4], texcoords[2];
+    bool haveNormal = false, haveColor = false, haveTextureCoords = false;
+    unsigned int offset = 0;
+    for (const PLY::Property &prop : pcElement->alProperties) {
+        BinaryChannel *channel = nullptr;
+        switch (prop.Semantic) {
+        case PLY::EST_XCoord: channel = &positions[0]; break;
+        case PLY::EST_YCoord: channel = &positions[1]; break;
+        case PLY::EST_ZCoord: channel = &positions[2]; break;
+        case PLY::EST_XNormal: channel = &normals[0]; haveNormal = true; break;
+        case PLY::EST_YNormal: channel = &normals[1]; haveNormal = true; break;
+        case PLY::EST_ZNormal: channel = &normals[2]; haveNormal = true; break;
+        case PLY::EST_Red: channel = &colors[0]; haveColor = true; break;
+        case PLY::EST_Green: channel = &colors[1]; haveColor = true; break;
+        case PLY::EST_Blue: channel = &colors[2]; haveColor = true; break;
+        case PLY::EST_Alpha: channel = &colors[3]; haveColor = true; break;
+        case PLY::EST_UTextureCoord: channel = &texcoords[0]; haveTextureCoords = true; break;
+        case PLY::EST_VTextureCoord: channel = &texcoords[1]; haveTextureCoords = true; break;
+        default: break;
+        }
+        if (nullptr != channel) {
+            channel->offset = offset;
+            channel->type = prop.eType;
+        }
+        offset += PLY::Property::GetBinarySize(prop.eType);
+    }
+
+    // check whether we have a valid source for the vertex data
+    const bool havePosition = positions[0].IsSet() || positions[1].IsSet() || positions[2].IsSet();
+    if (!havePosition && !haveNormal && !haveColor && !haveTextureCoords) {
+        return;
+    }
+
+    // create aiMesh if needed
+    if (nullptr == mGeneratedMesh) {
+        mGeneratedMesh = new aiMesh();
+        mGeneratedMesh->mMaterialIndex = 0;
+    }
+
+    if (nullptr == mGeneratedMesh->mVertices) {
+        mGeneratedMesh->mNumVertices = pcElement->NumOccur;
+        mGeneratedMesh->mVertices = new aiVector3D[mGeneratedMesh->mNumVertices];
+    }
+    if (first + count > mGeneratedMesh->mNumVertices) {
+        throw DeadlyImportError("Invalid .ply file: Too many vertices");
+    }
+
+    DecodeVectors(positions, data, recordSize, count, bigEndian, mGeneratedMesh->mVertices + first);
+
+    if (haveNormal) {
+        if (nullptr == mGeneratedMesh->mNormals)
+            mGeneratedMesh->mNormals = new aiVector3D[mGeneratedMesh->mNumVertices];
+        DecodeVectors(normals, data, recordSize, count, bigEndian, mGeneratedMesh->mNormals + first);
+    }
+
+    if (haveColor) {
+        if (nullptr == mGeneratedMesh->mColors[0])
+            mGeneratedMesh->mColors[0] = new aiColor4D[mGeneratedMesh->mNumVertices];
+        aiColor4D *out = mGeneratedMesh->mColors[0] + first;
+        DecodeChannel(colors[0], data, recordSize, count, bigEndian, &NormalizeColorValue, [out](unsigned int i, ai_real v) { out[i].r = v; });
+        DecodeChannel(colors[1], data, recordSize, count, bigEndian, &NormalizeColorValue, [out](unsigned int i, ai_real v) { out[i].g = v; });
+        DecodeChannel(colors[2], data, recordSize, count, bigEndian, &NormalizeColorValue, [out](unsigned int i, ai_real v) { out[i].b = v; });
+
+        // assume 1.0 for the alpha channel if it is not set
+        if (colors[3].IsSet()) {
+            DecodeChannel(colors[3], data, recordSize, count, bigEndian, &NormalizeColorValue, [out](unsigned int i, ai_real v) { out[i].a = v; });
+        } else {
+            for (unsigned int i = 0; i < count; ++i) {
+                out[i].a = 1.0;
+            }
+        }
+    }
+
+    if (haveTextureCoords) {
+        if (nullptr == mGeneratedMesh->mTextureCoords[0]) {
+            mGeneratedMesh->mNumUVComponents[0] = 2;
+            mGeneratedMesh->mTextureCoords[0] = new aiVector3D[mGeneratedMesh->mNumVertices];
+        }
+        aiVector3D *out = mGeneratedMesh->mTextureCoords[0] + first;
+        DecodeChannel(texcoords[0], data, recordSize, count, bigEndian, nullptr, [out](unsigned int i, ai_real v) { out[i].x = v; });
+        DecodeChannel(texcoords[1], data, recordSize, count, bigEndian, nullptr, [out](unsigned int i, ai_real v) { out[i].y = v; });
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Bulk version of LoadFace() for binary faces consisting of scalars and the vertex index list
+unsigned int PLYImporter::LoadFaceBlock(const PLY::Element *pcElement, const char *data, size_t size,
+        unsigned int first, unsigned int count, bool bigEndian, size_t &consumed) {
+    ai_assert(nullptr != pcElement);
+
+    consumed = 0;
+    if (mGeneratedMesh == nullptr) {
+        throw DeadlyImportError("Invalid .ply file: Vertices should be declared before faces");
+    }
+
+    const int listIndex = pcElement->GetVertexIndexList();
+    ai_assert(-1 != listIndex);
+    const PLY::Property &list = pcElement->alProperties[listIndex];
+    unsigned int before = 0, after = 0;
+    for (int i = 0; i < static_cast<int>(pcElement->alProperties.size()); ++i) {
+        if (i != listIndex) {
+            (i < listIndex ? before : after) += PLY::Property::GetBinarySize(pcElement->alProperties[i].eType);
+        }
+    }
+    const unsigned int countSize = PLY::Property::GetBinarySize(list.eFirstType);
+    const unsigned int indexSize = PLY::Property::GetBinarySize(list.eType);
+
+    if (mGeneratedMesh->mFaces == nullptr) {
+        mGeneratedMesh->mNumFaces = pcElement->NumOccur;
+        mGeneratedMesh->mFaces = new aiFace[mGeneratedMesh->mNumFaces];
+    } else if (mGeneratedMesh->mNumFaces < pcElement->NumOccur) {
+        throw DeadlyImportError("Invalid .ply file: Too many faces");
+    }
+
+    size_t pos = 0;
+    unsigned int n = 0;
+    for (; n < count; ++n) {
+        if (pos + before + countSize > size) {
+            break;
+        }
+        const unsigned int iNum = ReadBinaryIndex(data + pos + before, list.eFirstType, bigEndian);
+        const size_t indexData = pos + before + countSize;
+        const size_t recordEnd = indexData + static_cast<size_t>(iNum) * indexSize + after;
+        if (recordEnd > size) {
+            break;
+        }
+
+        aiFace &face = mGeneratedMesh->mFaces[first + n];
+        delete[] face.mIndices;
+        face.mNumIndices = iNum;
+        face.mIndices = new unsigned int[iNum];
+        switch (list.eType) {
+        case EDT_Char: DecodeIndices<int8_t>(data + indexData, iNum, bigEndian, face.mIndices); break;
+        case EDT_UChar: DecodeIndices<uint8_t>(data + indexData, iNum, bigEndian, face.mIndices); break;
+        case EDT_Short: DecodeIndices<int16_t>(data + indexData, iNum, bigEndian, face.mIndices); break;
+        case EDT_UShort: DecodeIndices<uint16_t>(data + indexData, iNum, bigEndian, face.mIndices); break;
+        case EDT_Int: DecodeIndices<int32_t>(data + indexData, iNum, bigEndian, face.mIndices); break;
+        case EDT_UInt: DecodeIndices<uint32_t>(data + indexData, iNum, bigEndian, face.mIndices); break;
+        case EDT_Float: DecodeIndices<float>(data + indexData, iNum, bigEndian, face.mIndices); break;
+        case EDT_Double: DecodeIndices<double>(data + indexData, iNum, bigEndian, face.mIndices); break;
+        default: break;
+        }
+        pos = recordEnd;
+    }
+
+    consumed = pos;
+    return n;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Convert a color component to [0...1]
 ai_real PLYImporter::NormalizeColorValue(PLY::PropertyInstance::ValueUnion val, PLY::EDataType eType) {
@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define AI_PLYLOADER_H_INCLUDED
 
 #include "PlyParser.h"
+#include "Common/PointCloud.h"
 #include <assimp/BaseImporter.h>
 #include <assimp/types.h>
 #include <vector>
@@ -74,6 +75,13 @@ public:
     bool CanRead(const std::string &pFile, IOSystem *pIOHandler,
             bool checkSig) const override;
 
+    // -------------------------------------------------------------------
+    /** Called prior to ReadFile().
+     * The function is a request to the importer to update its configuration
+     * basing on the Importer's configuration property list.
+     */
+    void SetupProperties(const Importer *pImp) override;
+
     // -------------------------------------------------------------------
     /** Extract a vertex from the DOM
     */
@@ -84,6 +92,20 @@ public:
     */
     void LoadFace(const PLY::Element *pcElement, const PLY::ElementInstance *instElement, unsigned int pos);
 
+    // -------------------------------------------------------------------
+    /** Extract a block of binary vertices with a fixed record size
+    */
+    void LoadVertexBlock(const PLY::Element *pcElement, const char *data, unsigned int recordSize,
+            unsigned int first, unsigned int count, bool bigEndian);
+
+    // -------------------------------------------------------------------
+    /** Extract binary faces which only contain scalars and the vertex
+     *  index list. Stops at the first incomplete record and returns the
+     *  number of faces read, consumed receives the number of bytes.
+    */
+    unsigned int LoadFaceBlock(const PLY::Element *pcElement, const char *data, size_t size,
+            unsigned int first, unsigned int count, bool bigEndian, size_t &consumed);
+
 protected:
     // -------------------------------------------------------------------
     /** Return importer meta information.
@@ -124,6 +146,7 @@ private:
     unsigned char *mBuffer;
     PLY::DOM *pcDOM;
     aiMesh *mGeneratedMesh;
+    PointCloudConfig mPointCloud;
 };
 
 } // end of namespace Assimp
@@ -48,10 +48,29 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/ByteSwapper.h>
 #include <assimp/fast_atof.h>
 #include <assimp/DefaultLogger.hpp>
+#include <algorithm>
 #include <utility>
 
 namespace Assimp {
 
+// ------------------------------------------------------------------------------------------------
+// Makes sure that at least 'required' bytes of binary data are available at pCur
+static void EnsureBinaryData(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer,
+        const char *&pCur, unsigned int &bufferSize, size_t required) {
+    while (bufferSize < required) {
+        std::vector<char> nbuffer;
+        if (!streamBuffer.getNextBlock(nbuffer)) {
+            throw DeadlyImportError("Invalid .ply file: File corrupted");
+        }
+
+        // concat buffer contents
+        buffer = std::vector<char>(buffer.end() - bufferSize, buffer.end());
+        buffer.insert(buffer.end(), nbuffer.begin(), nbuffer.end());
+        bufferSize = static_cast<unsigned int>(buffer.size());
+        pCur = (char *)&buffer[0];
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 PLY::EDataType PLY::Property::ParseDataType(std::vector<char> &buffer) {
     ai_assert(!buffer.empty());
@@ -256,6 +275,71 @@ PLY::EElementSemantic PLY::Element::ParseSemantic(std::vector<char> &buffer) {
     return eOut;
 }
 
+// ------------------------------------------------------------------------------------------------
+unsigned int PLY::Property::GetBinarySize(PLY::EDataType eType) {
+    switch (eType) {
+    case EDT_Char:
+    case EDT_UChar:
+        return 1;
+
+    case EDT_UShort:
+    case EDT_Short:
+        return 2;
+
+    case EDT_UInt:
+    case EDT_Int:
+    case EDT_Float:
+        return 4;
+
+    case EDT_Double:
+        return 8;
+
+    case EDT_INVALID:
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+unsigned int PLY::Element::GetBinarySize() const {
+    unsigned int size = 0;
+    for (const PLY::Property &prop : alProperties) {
+        const unsigned int propSize = PLY::Property::GetBinarySize(prop.eType);
+        if (prop.bIsList || 0 == propSize) {
+            return 0;
+        }
+        size += propSize;
+    }
+
+    return size;
+}
+
+// ------------------------------------------------------------------------------------------------
+int PLY::Element::GetVertexIndexList() const {
+    if (EEST_Face != eSemantic) {
+        return -1;
+    }
+
+    int listIndex = -1;
+    for (size_t i = 0; i < alProperties.size(); ++i) {
+        const PLY::Property &prop = alProperties[i];
+        if (0 == PLY::Property::GetBinarySize(prop.eType)) {
+            return -1;
+        }
+        if (!prop.bIsList) {
+            continue;
+        }
+        if (-1 != listIndex || EST_VertexIndex != prop.Semantic || 0 == PLY::Property::GetBinarySize(prop.eFirstType)) {
+            return -1;
+        }
+        listIndex = static_cast<int>(i);
+    }
+
+    return listIndex;
+}
+
 // ------------------------------------------------------------------------------------------------
 bool PLY::Element::ParseElement(IOStreamBuffer<char> &streamBuffer, std::vector<char> &buffer, PLY::Element *pOut) {
     ai_assert(nullptr != pOut);
@@ -601,6 +685,41 @@ bool PLY::ElementInstanceList::ParseInstanceListBinary(
         bool p_bBE /* = false */) {
     ai_assert(nullptr != pcElement);
 
+    // vertices with a fixed record size and plain faces are decoded a
+    // whole buffer at a time instead of property by property
+    if (nullptr == p_pcOut && nullptr != loader) {
+        const unsigned int recordSize = pcElement->GetBinarySize();
+        if (EEST_Vertex == pcElement->eSemantic && 0 != recordSize) {
+            for (unsigned int i = 0; i < pcElement->NumOccur;) {
+                EnsureBinaryData(streamBuffer, buffer, pCur, bufferSize, recordSize);
+                const unsigned int count = std::min(pcElement->NumOccur - i, bufferSize / recordSize);
+                loader->LoadVertexBlock(pcElement, pCur, recordSize, i, count, p_bBE);
+
+                pCur += count * recordSize;
+                bufferSize -= count * recordSize;
+                i += count;
+            }
+            return true;
+        }
+
+        if (-1 != pcElement->GetVertexIndexList()) {
+            for (unsigned int i = 0; i < pcElement->NumOccur;) {
+                size_t consumed = 0;
+                const unsigned int count = loader->LoadFaceBlock(pcElement, pCur, bufferSize, i, pcElement->NumOccur - i, p_bBE, consumed);
+                if (0 == count) {
+                    // the next record is incomplete
+                    EnsureBinaryData(streamBuffer, buffer, pCur, bufferSize, bufferSize + 1);
+                    continue;
+                }
+
+                pCur += consumed;
+                bufferSize -= static_cast<unsigned int>(consumed);
+                i += count;
+            }
+            return true;
+        }
+    }
+
     // we can add special handling code for unknown element semantics since
     // we can't skip it as a whole block (we don't know its exact size
     // due to the fact that lists could be contained in the property list
@@ -827,48 +946,9 @@ bool PLY::PropertyInstance::ParseValueBinary(IOStreamBuffer<char> &streamBuffer,
         bool p_bBE) {
     ai_assert(nullptr != out);
 
-    // calc element size
-    unsigned int lsize = 0;
-    switch (eType) {
-    case EDT_Char:
-    case EDT_UChar:
-        lsize = 1;
-        break;
-
-    case EDT_UShort:
-    case EDT_Short:
-        lsize = 2;
-        break;
-
-    case EDT_UInt:
-    case EDT_Int:
-    case EDT_Float:
-        lsize = 4;
-        break;
-
-    case EDT_Double:
-        lsize = 8;
-        break;
-
-    case EDT_INVALID:
-    default:
-        break;
-    }
-
     // read the next file block if needed
-    if (bufferSize < lsize) {
-        std::vector<char> nbuffer;
-        if (streamBuffer.getNextBlock(nbuffer)) {
-            // concat buffer contents
-            buffer = std::vector<char>(buffer.end() - bufferSize, buffer.end());
-            buffer.insert(buffer.end(), nbuffer.begin(), nbuffer.end());
-            nbuffer.clear();
-            bufferSize = static_cast<unsigned int>(buffer.size());
-            pCur = (char *)&buffer[0];
-        } else {
-            throw DeadlyImportError("Invalid .ply file: File corrupted");
-        }
-    }
+    const unsigned int lsize = PLY::Property::GetBinarySize(eType);
+    EnsureBinaryData(streamBuffer, buffer, pCur, bufferSize, lsize);
 
     bool ret = true;
     switch (eType) {
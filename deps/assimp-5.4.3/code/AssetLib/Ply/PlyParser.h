@@ -245,6 +245,10 @@ public:
     // -------------------------------------------------------------------
     //! Parse a semantic from a string
     static ESemantic ParseSemantic(std::vector<char> &buffer);
+
+    // -------------------------------------------------------------------
+    //! Size of a value of the given type in a binary file, 0 if invalid
+    static unsigned int GetBinarySize(EDataType eType);
 };
 
 // ---------------------------------------------------------------------------------
@@ -286,6 +290,16 @@ public:
     // -------------------------------------------------------------------
     //! Parse a semantic from a string
     static EElementSemantic ParseSemantic(std::vector<char> &buffer);
+
+    // -------------------------------------------------------------------
+    //! Size of one binary instance of the element in bytes. Returns 0
+    //! if the element contains lists and has no fixed size.
+    unsigned int GetBinarySize() const;
+
+    // -------------------------------------------------------------------
+    //! Index of the vertex index list of a face element, if this list
+    //! is the only list property of the element. -1 otherwise.
+    int GetVertexIndexList() const;
 };
 
 // ---------------------------------------------------------------------------------
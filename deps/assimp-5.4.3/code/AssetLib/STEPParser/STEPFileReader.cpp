@@ -47,10 +47,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "STEPFileReader.h"
 #include "STEPFileEncoding.h"
+#include "Common/ParallelFor.h"
 #include <assimp/TinyFormatter.h>
 #include <assimp/fast_atof.h>
+#include <exception>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <tuple>
 #include <utility>
 
 using namespace Assimp;
@@ -140,13 +145,14 @@ STEP::DB* STEP::ReadFileHeader(std::shared_ptr<IOStream> stream) {
 namespace {
 
 // ------------------------------------------------------------------------------------------------
-// check whether the given line contains an entity definition (i.e. starts with "#<number>=")
-bool IsEntityDef(const std::string& snext)
+// check whether the line starting at the given position contains an entity definition
+// (i.e. starts with "#<number>=")
+bool IsEntityDef(const char *it, const char *end)
 {
-    if (snext[0] == '#') {
+    if (it != end && *it == '#') {
         // it is only a new entity if it has a '=' after the
         // entity ID.
-        for(std::string::const_iterator it = snext.begin()+1; it != snext.end(); ++it) {
+        for(++it; it != end; ++it) {
             if (*it == '=') {
                 return true;
             }
@@ -158,52 +164,174 @@ bool IsEntityDef(const std::string& snext)
     return false;
 }
 
+// ------------------------------------------------------------------------------------------------
+bool IsEntityDef(const std::string& snext)
+{
+    return IsEntityDef(snext.c_str(), snext.c_str() + snext.length());
 }
 
+// ------------------------------------------------------------------------------------------------
+// minimum number of bytes per chunk when scanning the data section with several threads
+constexpr size_t MinChunkSize = 1024 * 1024;
 
 // ------------------------------------------------------------------------------------------------
-void STEP::ReadFile(DB& db,const EXPRESS::ConversionSchema& scheme,
-    const char* const* types_to_track, size_t len,
-    const char* const* inverse_indices_to_track, size_t len2)
-{
-    db.SetSchema(scheme);
-    db.SetTypesToTrack(types_to_track,len);
-    db.SetInverseIndicesToTrack(inverse_indices_to_track,len2);
+// Splits a chunk of the data section into lines exactly like the LineSplitter the DB was
+// constructed with does (skipping empty lines, trimming leading blanks), so both entity
+// continuation and line numbers stay the same regardless of how the input is chunked.
+class ChunkLineReader {
+public:
+    ChunkLineReader(const char *begin, const char *end, bool lastChunk, const std::string *firstLine) :
+            mCur(begin), mEnd(end), mLastChunk(lastChunk), mCount(0), mValid(true) {
+        if (firstLine) {
+            // the DB's splitter already consumed the first line of the data section
+            mLine = *firstLine;
+            mCount = 1;
+            mValid = !mLastChunk || mCur < mEnd;
+        } else {
+            ++(*this);
+        }
+    }
 
-    const DB::ObjectMap& map = db.GetObjects();
-    LineSplitter& splitter = db.GetSplitter();
+    ChunkLineReader &operator++() {
+        if (mCur >= mEnd) {
+            mValid = false;
+            return *this;
+        }
+
+        mLine.clear();
+        while (mCur < mEnd) {
+            const char c = *mCur++;
+            if (c == '\n' || c == '\r') {
+                while (mCur < mEnd && (*mCur == ' ' || *mCur == '\r' || *mCur == '\n')) {
+                    ++mCur;
+                }
+                break;
+            }
+            mLine += c;
+        }
+        ++mCount;
+
+        // like LineSplitter, never hand out the very last line of the file
+        if (mLastChunk && mCur >= mEnd) {
+            mValid = false;
+        }
+        return *this;
+    }
+
+    operator bool() const {
+        return mValid;
+    }
+
+    const std::string &operator*() const {
+        return mLine;
+    }
 
+    // zero-based index of the current line, relative to the start of the chunk
+    uint64_t get_index() const {
+        return mCount - 1;
+    }
+
+    uint64_t get_count() const {
+        return mCount;
+    }
+
+private:
+    const char *mCur;
+    const char *const mEnd;
+    const bool mLastChunk;
+    std::string mLine;
+    uint64_t mCount;
+    bool mValid;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Entity records and warnings collected from one chunk of the data section. Line numbers
+// are relative to the chunk, they are fixed up once all chunks have been scanned.
+struct ChunkResult {
+    struct Record {
+        uint64_t id;
+        uint64_t line;
+        const char *type; // nullptr if the type is not part of the schema
+        char *args;
+    };
+
+    std::vector<Record> records;
+
+    // warnings, each one to be printed before the record with the given index
+    std::vector<std::tuple<size_t, uint64_t, std::string>> warnings;
+
+    uint64_t lineCount = 0;
+    bool endOfSection = false;
+    std::exception_ptr error;
+
+    ChunkResult() = default;
+    ChunkResult(const ChunkResult &) = delete;
+    ChunkResult &operator=(const ChunkResult &) = delete;
+
+    ~ChunkResult() {
+        // argument strings not handed over to a LazyObject
+        for (Record &r : records) {
+            delete[] r.args;
+        }
+    }
+
+    void Warn(const char *message, uint64_t line) {
+        warnings.emplace_back(records.size(), line, message);
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Find the next line at or after the given position which starts an entity definition.
+const char *FindEntityLineStart(const char *cur, const char *end) {
+    while (cur < end) {
+        while (cur < end && *cur != '\n' && *cur != '\r') {
+            ++cur;
+        }
+        while (cur < end && (*cur == ' ' || *cur == '\r' || *cur == '\n')) {
+            ++cur;
+        }
+        const char *eol = cur;
+        while (eol < end && *eol != '\n' && *eol != '\r') {
+            ++eol;
+        }
+        if (IsEntityDef(cur, eol)) {
+            return cur;
+        }
+    }
+    return end;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Extract id, entity class name and argument string of all entities in a chunk,
+// but don't create the actual objects yet.
+void ScanChunk(ChunkLineReader &splitter, const EXPRESS::ConversionSchema &scheme, ChunkResult &result) {
     while (splitter) {
         bool has_next = false;
         std::string s = *splitter;
         if (s == "ENDSEC;") {
+            result.endOfSection = true;
             break;
         }
         s.erase(std::remove(s.begin(), s.end(), ' '), s.end());
 
-        // want one-based line numbers for human readers, so +1
-        const uint64_t line = splitter.get_index()+1;
-        // LineSplitter already ignores empty lines
+        const uint64_t line = splitter.get_index();
+        // ChunkLineReader already ignores empty lines
         ai_assert(s.length());
         if (s[0] != '#') {
-            ASSIMP_LOG_WARN(AddLineNumber("expected token \'#\'",line));
+            result.Warn("expected token \'#\'", line);
             ++splitter;
             continue;
         }
-        // ---
-        // extract id, entity class name and argument string,
-        // but don't create the actual object yet.
-        // ---
         const std::string::size_type n0 = s.find_first_of('=');
         if (n0 == std::string::npos) {
-            ASSIMP_LOG_WARN(AddLineNumber("expected token \'=\'",line));
+            result.Warn("expected token \'=\'", line);
             ++splitter;
             continue;
         }
 
         const uint64_t id = strtoul10_64(s.substr(1,n0-1).c_str());
         if (!id) {
-            ASSIMP_LOG_WARN(AddLineNumber("expected positive, numeric entity id",line));
+            result.Warn("expected positive, numeric entity id", line);
             ++splitter;
             continue;
         }
@@ -230,7 +358,7 @@ void STEP::ReadFile(DB& db,const EXPRESS::ConversionSchema& scheme,
             }
 
             if(!ok) {
-                ASSIMP_LOG_WARN(AddLineNumber("expected token \'(\'",line));
+                result.Warn("expected token \'(\'", line);
                 continue;
             }
         }
@@ -256,15 +384,11 @@ void STEP::ReadFile(DB& db,const EXPRESS::ConversionSchema& scheme,
                 }
             }
             if(!ok) {
-                ASSIMP_LOG_WARN(AddLineNumber("expected token \')\'",line));
+                result.Warn("expected token \')\'", line);
                 continue;
             }
         }
 
-        if (map.find(id) != map.end()) {
-            ASSIMP_LOG_WARN(AddLineNumber((Formatter::format(),"an object with the id #",id," already exists"),line));
-        }
-
         std::string::size_type ns = n0;
         do {
             ++ns;
@@ -275,20 +399,113 @@ void STEP::ReadFile(DB& db,const EXPRESS::ConversionSchema& scheme,
         } while (IsSpace(s.at(ne)));
         std::string type = s.substr(ns, ne - ns + 1);
         type = ai_tolower(type);
-        const char* sz = scheme.GetStaticStringForToken(type);
-        if(sz) {
+
+        // unknown types are recorded nevertheless to check for duplicate ids
+        ChunkResult::Record record = { id, line, scheme.GetStaticStringForToken(type), nullptr };
+        if (record.type) {
             const std::string::size_type szLen = n2-n1+1;
-            char* const copysz = new char[szLen+1];
-            std::copy(s.c_str()+n1,s.c_str()+n2+1,copysz);
-            copysz[szLen] = '\0';
-            db.InternInsert(new LazyObject(db,id,line,sz,copysz));
+            record.args = new char[szLen+1];
+            std::copy(s.c_str()+n1,s.c_str()+n2+1,record.args);
+            record.args[szLen] = '\0';
         }
+        result.records.push_back(record);
+
         if(!has_next) {
             ++splitter;
         }
     }
+}
+
+} // namespace
 
-    if (!splitter) {
+// ------------------------------------------------------------------------------------------------
+void STEP::ReadFile(DB& db,const EXPRESS::ConversionSchema& scheme,
+    const char* const* types_to_track, size_t len,
+    const char* const* inverse_indices_to_track, size_t len2,
+    unsigned int numThreads)
+{
+    db.SetSchema(scheme);
+    db.SetTypesToTrack(types_to_track,len);
+    db.SetInverseIndicesToTrack(inverse_indices_to_track,len2);
+
+    const DB::ObjectMap& map = db.GetObjects();
+    LineSplitter& splitter = db.GetSplitter();
+    StreamReaderLE& stream = splitter.get_stream();
+
+    // the splitter holds the first line of the data section, everything
+    // behind it is still untouched in the stream's buffer.
+    const char* const begin = reinterpret_cast<const char*>(stream.GetPtr());
+    const char* const end = begin + stream.GetRemainingSize();
+
+    // split the data section at entity boundaries, entities never span chunks
+    std::vector<const char*> bounds(1, begin);
+    const size_t size = static_cast<size_t>(end - begin);
+    if (numThreads > 1 && size >= 2 * MinChunkSize) {
+        const size_t chunkCount = std::min(static_cast<size_t>(numThreads) * 4, size / MinChunkSize);
+        for (size_t i = 1; i < chunkCount; ++i) {
+            const char* const b = FindEntityLineStart(std::max(begin + i * (size / chunkCount), bounds.back()), end);
+            if (b >= end) {
+                break;
+            }
+            if (b > bounds.back()) {
+                bounds.push_back(b);
+            }
+        }
+    }
+    bounds.push_back(end);
+
+    const std::string firstLine = *splitter;
+    const size_t chunkCount = bounds.size() - 1;
+    std::vector<ChunkResult> chunks(chunkCount);
+    ParallelFor(chunkCount, numThreads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            ChunkLineReader reader(bounds[i], bounds[i + 1], i == chunkCount - 1, i == 0 ? &firstLine : nullptr);
+            try {
+                ScanChunk(reader, scheme, chunks[i]);
+            } catch (...) {
+                // rethrown in order while merging, so the outcome does not depend on timing
+                chunks[i].error = std::current_exception();
+            }
+            chunks[i].lineCount = reader.get_count();
+        }
+    });
+
+    // merge the chunks in file order, creating the actual LazyObjects
+    bool endOfSection = false;
+    // want one-based line numbers for human readers, so +1
+    uint64_t lineBase = splitter.get_index() + 1;
+    for (ChunkResult& chunk : chunks) {
+        size_t w = 0;
+        for (size_t r = 0; r <= chunk.records.size(); ++r) {
+            for (; w < chunk.warnings.size() && std::get<0>(chunk.warnings[w]) <= r; ++w) {
+                ASSIMP_LOG_WARN(AddLineNumber(std::get<2>(chunk.warnings[w]), lineBase + std::get<1>(chunk.warnings[w])));
+            }
+            if (r == chunk.records.size()) {
+                break;
+            }
+
+            ChunkResult::Record& record = chunk.records[r];
+            const uint64_t line = lineBase + record.line;
+            if (map.find(record.id) != map.end()) {
+                ASSIMP_LOG_WARN(AddLineNumber((Formatter::format(),"an object with the id #",record.id," already exists"),line));
+            }
+            if (record.type) {
+                db.InternInsert(new LazyObject(db,record.id,line,record.type,record.args));
+                record.args = nullptr;
+            }
+        }
+
+        if (chunk.error) {
+            std::rethrow_exception(chunk.error);
+        }
+        if (chunk.endOfSection) {
+            endOfSection = true;
+            break;
+        }
+        lineBase += chunk.lineCount;
+    }
+
+    if (!endOfSection) {
         ASSIMP_LOG_WARN("STEP: ignoring unexpected EOF");
     }
 
@@ -298,6 +515,52 @@ void STEP::ReadFile(DB& db,const EXPRESS::ConversionSchema& scheme,
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+void STEP::DB::EvaluateParallel(const char *const *types, size_t N, unsigned int numThreads) {
+    std::set<const char *> whitelist;
+    for (size_t i = 0; i < N; ++i) {
+        if (const char *const sz = schema->GetStaticStringForToken(types[i])) {
+            whitelist.insert(sz);
+        }
+    }
+
+    std::vector<const LazyObject *> pending;
+    for (const ObjectMap::value_type &o : objects) {
+        if (!o.second->obj && whitelist.find(o.second->type) != whitelist.end()) {
+            pending.push_back(o.second);
+        }
+    }
+
+    // converting an object only reads from the DB and never touches the objects
+    // it references, so distinct objects can safely be evaluated concurrently.
+    // Messages are kept per range and printed in object order after the join.
+    std::map<size_t, MessageBuffer> messages;
+    std::mutex messagesMutex;
+    ParallelFor(pending.size(), numThreads, [&](size_t begin, size_t end) {
+        MessageBuffer buffer;
+        MessageBuffer::Current() = &buffer;
+        for (size_t i = begin; i < end; ++i) {
+            try {
+                pending[i]->LazyInit();
+            } catch (const std::exception &) {
+                // keep it lazy, the caller gets the error if it needs the object
+            }
+        }
+        MessageBuffer::Current() = nullptr;
+
+        std::lock_guard<std::mutex> lock(messagesMutex);
+        messages[begin] = std::move(buffer);
+    }, 256);
+
+    for (auto &m : messages) {
+        m.second.Flush();
+    }
+
+    if (!DefaultLogger::isNullLogger()) {
+        ASSIMP_LOG_DEBUG("STEP: pre-evaluated ", pending.size(), " object records");
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 std::shared_ptr<const EXPRESS::DataType> EXPRESS::DataType::Parse(const char*& inout, const char *end, uint64_t line, const EXPRESS::ConversionSchema* schema /*= nullptr*/)
 {
@@ -389,7 +652,7 @@ std::shared_ptr<const EXPRESS::DataType> EXPRESS::DataType::Parse(const char*& i
         std::string stemp = std::string(start, static_cast<size_t>(cur - start));
         if(!StringToUTF8(stemp)) {
             // TODO: route this to a correct logger with line numbers etc., better error messages
-            ASSIMP_LOG_ERROR("an error occurred reading escape sequences in ASCII text");
+            STEP::LogError("an error occurred reading escape sequences in ASCII text");
         }
 
         return std::make_shared<EXPRESS::STRING>(stemp);
@@ -487,7 +750,7 @@ STEP::LazyObject::LazyObject(DB& db, uint64_t id,uint64_t /*line*/, const char*
 , type(type)
 , db(db)
 , args(args)
-, obj() {
+, obj(nullptr) {
     // find any external references and store them in the database.
     // this helps us emulate STEPs INVERSE fields.
     if (!db.KeepInverseIndicesForType(type)) {
@@ -522,8 +785,8 @@ STEP::LazyObject::LazyObject(DB& db, uint64_t id,uint64_t /*line*/, const char*
 // ------------------------------------------------------------------------------------------------
 STEP::LazyObject::~LazyObject() {
     // make sure the right dtor/operator delete get called
-    if (obj) {
-        delete obj;
+    if (Object *const o = obj.load()) {
+        delete o;
     } else {
         delete[] args;
     }
@@ -541,20 +804,36 @@ void STEP::LazyObject::LazyInit() const {
     const char* acopy = args;
     const char *end = acopy + std::strlen(args);
     std::shared_ptr<const EXPRESS::LIST> conv_args = EXPRESS::LIST::Parse(acopy, end, (uint64_t)STEP::SyntaxError::LINE_NOT_SPECIFIED,&db.GetSchema());
-    delete[] args;
-    args = nullptr;
 
     // if the converter fails, it should throw an exception, but it should never return nullptr
+    Object *result = nullptr;
     try {
-        obj = proc(db,*conv_args);
+        result = proc(db,*conv_args);
     }
     catch(const TypeError& t) {
         // augment line and entity information
         throw TypeError(t.what(),id);
     }
+
+    // keep the arguments until conversion succeeded, a failed evaluation may be repeated
+    delete[] args;
+    args = nullptr;
     ++db.evaluated_count;
-    ai_assert(obj);
+    ai_assert(result);
+
+    // store the original id in the object instance, then publish it
+    result->SetID(id);
+    obj.store(result, std::memory_order_release);
+}
 
-    // store the original id in the object instance
-    obj->SetID(id);
+// ------------------------------------------------------------------------------------------------
+void STEP::LazyObject::SharedLazyInit() const {
+    // the IFC loader converts products on several threads, which may reach the same
+    // object at once, so first evaluations are serialized over the whole DB.
+    // DB::EvaluateParallel() only hands out distinct objects and calls LazyInit()
+    // without the lock.
+    std::lock_guard<std::recursive_mutex> lock(db.evaluation_mutex);
+    if (!obj.load(std::memory_order_acquire)) {
+        LazyInit();
+    }
 }
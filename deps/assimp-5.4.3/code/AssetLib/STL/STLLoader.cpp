@@ -50,6 +50,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/scene.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/IOSystem.hpp>
+#include <assimp/Importer.hpp>
+#include <algorithm>
 #include <memory>
 
 namespace Assimp {
@@ -86,6 +88,96 @@ static bool IsBinarySTL(const char *buffer, size_t fileSize) {
     return expectedBinaryFileSize == fileSize;
 }
 
+// size of the header and of one facet record of a binary file
+static constexpr size_t BinaryHeaderSize = 84;
+static constexpr size_t FacetSize = 50;
+
+// binary facets are read and decoded in blocks of this many facets
+static constexpr unsigned int FacetsPerBlock = 1u << 16;
+
+// ------------------------------------------------------------------------------------------------
+// Welds bitwise identical vertices (position and color) of a binary file while it is decoded,
+// using an open addressing hash table of vertex indices.
+class VertexWelder {
+public:
+    explicit VertexWelder(size_t numFaces) {
+        size_t capacity = 64;
+        while (capacity < numFaces) {
+            capacity <<= 1;
+        }
+        mTable.resize(capacity, Empty);
+        mPositions.reserve(numFaces / 2 + 3);
+        mColors.reserve(numFaces / 2 + 3);
+    }
+
+    unsigned int Add(aiVector3D position, const aiColor4D &color) {
+        // +0 and -0 are the same position
+        position.x = position.x == 0 ? 0 : position.x;
+        position.y = position.y == 0 ? 0 : position.y;
+        position.z = position.z == 0 ? 0 : position.z;
+
+        const size_t mask = mTable.size() - 1;
+        for (size_t slot = Hash(position, color) & mask;; slot = (slot + 1) & mask) {
+            const unsigned int index = mTable[slot];
+            if (Empty == index) {
+                const unsigned int newIndex = static_cast<unsigned int>(mPositions.size());
+                mPositions.push_back(position);
+                mColors.push_back(color);
+                mTable[slot] = newIndex;
+                if (mPositions.size() * 2 > mTable.size()) {
+                    Grow();
+                }
+                return newIndex;
+            }
+            if (mPositions[index] == position && mColors[index] == color) {
+                return index;
+            }
+        }
+    }
+
+    std::vector<aiVector3D> mPositions;
+    std::vector<aiColor4D> mColors;
+
+private:
+    static constexpr unsigned int Empty = 0xffffffffu;
+
+    static size_t Hash(const aiVector3D &position, const aiColor4D &color) {
+        // FNV-1a over the raw bytes
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](const void *data, size_t size) {
+            const unsigned char *bytes = static_cast<const unsigned char *>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+        };
+        mix(&position, sizeof(aiVector3D));
+        mix(&color, sizeof(aiColor4D));
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+
+    void Grow() {
+        std::vector<unsigned int> table(mTable.size() * 2, Empty);
+        const size_t mask = table.size() - 1;
+        for (unsigned int index = 0; index < mPositions.size(); ++index) {
+            size_t slot = Hash(mPositions[index], mColors[index]) & mask;
+            while (Empty != table[slot]) {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = index;
+        }
+        mTable.swap(table);
+    }
+
+    std::vector<unsigned int> mTable;
+};
+
+// ------------------------------------------------------------------------------------------------
+inline aiVector3D ReadBinaryVector(const unsigned char *src) {
+    aiVector3f vec;
+    ::memcpy(&vec, src, sizeof(aiVector3f));
+    return aiVector3D(vec.x, vec.y, vec.z);
+}
+
 static const size_t BufferSize = 500;
 static const char UnicodeBoundary = 127;
 
@@ -128,7 +220,9 @@ static bool IsAsciiSTL(const char *buffer, size_t fileSize) {
 STLImporter::STLImporter() :
         mBuffer(),
         mFileSize(0),
-        mScene() {
+        mScene(),
+        mWeldVertices(false),
+        mFlatIndexBuffer(false) {
     // empty
 }
 
@@ -143,19 +237,39 @@ bool STLImporter::CanRead(const std::string &pFile, IOSystem *pIOHandler, bool /
     return SearchFileHeaderForToken(pIOHandler, pFile, tokens, AI_COUNT_OF(tokens));
 }
 
+// ------------------------------------------------------------------------------------------------
+void STLImporter::SetupProperties(const Importer *pImp) {
+    mWeldVertices = pImp->GetPropertyBool(AI_CONFIG_IMPORT_STL_WELD_VERTICES, false);
+    mFlatIndexBuffer = pImp->GetPropertyBool(AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER, false);
+}
+
 // ------------------------------------------------------------------------------------------------
 const aiImporterDesc *STLImporter::GetInfo() const {
     return &desc;
 }
 
-void addFacesToMesh(aiMesh *pMesh) {
+// ------------------------------------------------------------------------------------------------
+// Creates the triangle list, the faces view into one index buffer if requested
+void addFacesToMesh(aiMesh *pMesh, const unsigned int *indices, bool flat) {
     pMesh->mFaces = new aiFace[pMesh->mNumFaces];
+    if (flat) {
+        pMesh->mIndexBufferSize = pMesh->mNumFaces * 3;
+        pMesh->mIndexBuffer = new unsigned int[pMesh->mIndexBufferSize];
+        for (unsigned int p = 0; p < pMesh->mIndexBufferSize; ++p) {
+            pMesh->mIndexBuffer[p] = indices ? indices[p] : p;
+        }
+        for (unsigned int i = 0; i < pMesh->mNumFaces; ++i) {
+            pMesh->mFaces[i].mNumIndices = 3;
+            pMesh->mFaces[i].mIndices = pMesh->mIndexBuffer + i * 3ull;
+        }
+        return;
+    }
     for (unsigned int i = 0, p = 0; i < pMesh->mNumFaces; ++i) {
 
         aiFace &face = pMesh->mFaces[i];
         face.mIndices = new unsigned int[face.mNumIndices = 3];
         for (unsigned int o = 0; o < 3; ++o, ++p) {
-            face.mIndices[o] = p;
+            face.mIndices[o] = indices ? indices[p] : p;
         }
     }
 }
@@ -171,14 +285,7 @@ void STLImporter::InternReadFile(const std::string &pFile, aiScene *pScene, IOSy
     }
 
     mFileSize = file->FileSize();
-
-    // allocate storage and copy the contents of the file to a memory buffer
-    // (terminate it with zero)
-    std::vector<char> buffer2;
-    TextFileToBuffer(file.get(), buffer2);
-
     mScene = pScene;
-    mBuffer = &buffer2[0];
 
     // the default vertex color is light gray.
     mClrColorDefault.r = mClrColorDefault.g = mClrColorDefault.b = mClrColorDefault.a = 0.6f;
@@ -188,12 +295,25 @@ void STLImporter::InternReadFile(const std::string &pFile, aiScene *pScene, IOSy
 
     bool bMatClr = false;
 
-    if (IsBinarySTL(mBuffer, mFileSize)) {
-        bMatClr = LoadBinaryFile();
-    } else if (IsAsciiSTL(mBuffer, mFileSize)) {
-        LoadASCIIFile(mScene->mRootNode);
+    // binary files are decoded while they are read, there is no need
+    // for a copy of the whole file
+    char header[BinaryHeaderSize];
+    if (mFileSize >= BinaryHeaderSize && file->Read(header, 1, BinaryHeaderSize) == BinaryHeaderSize &&
+            IsBinarySTL(header, mFileSize)) {
+        bMatClr = LoadBinaryFile(file.get(), header);
     } else {
-        throw DeadlyImportError("Failed to determine STL storage representation for ", pFile, ".");
+        // allocate storage and copy the contents of the file to a memory buffer
+        // (terminate it with zero)
+        file->Seek(0, aiOrigin_SET);
+        std::vector<char> buffer2;
+        TextFileToBuffer(file.get(), buffer2);
+        mBuffer = &buffer2[0];
+
+        if (IsAsciiSTL(mBuffer, mFileSize)) {
+            LoadASCIIFile(mScene->mRootNode);
+        } else {
+            throw DeadlyImportError("Failed to determine STL storage representation for ", pFile, ".");
+        }
     }
 
     // create a single default material, using a white diffuse color for consistency with
@@ -375,7 +495,7 @@ void STLImporter::LoadASCIIFile(aiNode *root) {
         }
 
         // now copy faces
-        addFacesToMesh(pMesh);
+        addFacesToMesh(pMesh, nullptr, mFlatIndexBuffer);
 
         // assign the meshes to the current node
         pushMeshesToNode(meshIndices, node);
@@ -397,7 +517,10 @@ void STLImporter::LoadASCIIFile(aiNode *root) {
 
 // ------------------------------------------------------------------------------------------------
 // Read a binary STL file
-bool STLImporter::LoadBinaryFile() {
+bool STLImporter::LoadBinaryFile(IOStream *stream, const char *header) {
+    ai_assert(nullptr != stream);
+    ai_assert(nullptr != header);
+
     // allocate one mesh
     mScene->mNumMeshes = 1;
     mScene->mMeshes = new aiMesh *[1];
@@ -405,13 +528,13 @@ bool STLImporter::LoadBinaryFile() {
     pMesh->mMaterialIndex = 0;
 
     // skip the first 80 bytes
-    if (mFileSize < 84) {
+    if (mFileSize < BinaryHeaderSize) {
         throw DeadlyImportError("STL: file is too small for the header");
     }
     bool bIsMaterialise = false;
 
     // search for an occurrence of "COLOR=" in the header
-    const unsigned char *sz2 = (const unsigned char *)mBuffer;
+    const unsigned char *sz2 = (const unsigned char *)header;
     const unsigned char *const szEnd = sz2 + 80;
     while (sz2 < szEnd) {
 
@@ -429,15 +552,15 @@ bool STLImporter::LoadBinaryFile() {
             break;
         }
     }
-    const unsigned char *sz = (const unsigned char *)mBuffer + 80;
 
     // now read the number of facets
     mScene->mRootNode->mName.Set("<STL_BINARY>");
 
-    pMesh->mNumFaces = *((uint32_t *)sz);
-    sz += 4;
+    uint32_t numFaces = 0;
+    ::memcpy(&numFaces, header + 80, sizeof(uint32_t));
+    pMesh->mNumFaces = numFaces;
 
-    if (mFileSize < 84ull + pMesh->mNumFaces * 50ull) {
+    if (mFileSize < BinaryHeaderSize + pMesh->mNumFaces * static_cast<unsigned long long>(FacetSize)) {
         throw DeadlyImportError("STL: file is too small to hold all facets");
     }
 
@@ -445,91 +568,101 @@ bool STLImporter::LoadBinaryFile() {
         throw DeadlyImportError("STL: file is empty. There are no facets defined");
     }
 
-    pMesh->mNumVertices = pMesh->mNumFaces * 3;
-
-    aiVector3D *vp = pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
-    aiVector3D *vn = pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
+    // the facets are decoded block by block into the output arrays, either
+    // three vertices per facet or welded through a hash table
+    std::unique_ptr<VertexWelder> welder;
+    std::vector<unsigned int> indices;
+    aiVector3D *vp = nullptr, *vn = nullptr;
+    if (mWeldVertices) {
+        welder.reset(new VertexWelder(pMesh->mNumFaces));
+        indices.reserve(pMesh->mNumFaces * 3ull);
+    } else {
+        pMesh->mNumVertices = pMesh->mNumFaces * 3;
+        vp = pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
+        vn = pMesh->mNormals = new aiVector3D[pMesh->mNumVertices];
+    }
 
-    aiVector3f *theVec;
-    aiVector3f theVec3F;
+    bool hasColors = false;
+    const ai_real invVal((ai_real)1.0 / (ai_real)31.0);
+    std::vector<unsigned char> block(FacetSize * std::min(pMesh->mNumFaces, FacetsPerBlock));
+    for (unsigned int first = 0; first < pMesh->mNumFaces;) {
+        const unsigned int count = std::min(pMesh->mNumFaces - first, FacetsPerBlock);
+        if (stream->Read(block.data(), FacetSize, count) != count) {
+            throw DeadlyImportError("STL: unexpected end of file");
+        }
 
-    for (unsigned int i = 0; i < pMesh->mNumFaces; ++i) {
         // NOTE: Blender sometimes writes empty normals ... this is not
         // our fault ... the RemoveInvalidData helper step should fix that
-
-        // There's one normal for the face in the STL; use it three times
-        // for vertex normals
-        theVec = (aiVector3f *)sz;
-        ::memcpy(&theVec3F, theVec, sizeof(aiVector3f));
-        vn->x = theVec3F.x;
-        vn->y = theVec3F.y;
-        vn->z = theVec3F.z;
-        *(vn + 1) = *vn;
-        *(vn + 2) = *vn;
-        ++theVec;
-        vn += 3;
-
-        // vertex 1
-        ::memcpy(&theVec3F, theVec, sizeof(aiVector3f));
-        vp->x = theVec3F.x;
-        vp->y = theVec3F.y;
-        vp->z = theVec3F.z;
-        ++theVec;
-        ++vp;
-
-        // vertex 2
-        ::memcpy(&theVec3F, theVec, sizeof(aiVector3f));
-        vp->x = theVec3F.x;
-        vp->y = theVec3F.y;
-        vp->z = theVec3F.z;
-        ++theVec;
-        ++vp;
-
-        // vertex 3
-        ::memcpy(&theVec3F, theVec, sizeof(aiVector3f));
-        vp->x = theVec3F.x;
-        vp->y = theVec3F.y;
-        vp->z = theVec3F.z;
-        ++theVec;
-        ++vp;
-
-        sz = (const unsigned char *)theVec;
-
-        uint16_t color = *((uint16_t *)sz);
-        sz += 2;
-
-        if (color & (1 << 15)) {
-            // seems we need to take the color
-            if (!pMesh->mColors[0]) {
-                pMesh->mColors[0] = new aiColor4D[pMesh->mNumVertices];
-                for (unsigned int j = 0; j < pMesh->mNumVertices; ++j) {
-                    *pMesh->mColors[0]++ = mClrColorDefault;
+        const unsigned char *sz = block.data();
+        for (unsigned int i = first; i < first + count; ++i, sz += FacetSize) {
+            uint16_t color = 0;
+            ::memcpy(&color, sz + 48, sizeof(uint16_t));
+
+            aiColor4D clr = mClrColorDefault;
+            if (color & (1 << 15)) {
+                // seems we need to take the color
+                if (!hasColors) {
+                    hasColors = true;
+                    ASSIMP_LOG_INFO("STL: Mesh has vertex colors");
                 }
-                pMesh->mColors[0] -= pMesh->mNumVertices;
+                clr.a = 1.0;
+                if (bIsMaterialise) // this is reversed
+                {
+                    clr.r = (color & 0x1fu) * invVal;
+                    clr.g = ((color & (0x1fu << 5)) >> 5u) * invVal;
+                    clr.b = ((color & (0x1fu << 10)) >> 10u) * invVal;
+                } else {
+                    clr.b = (color & 0x1fu) * invVal;
+                    clr.g = ((color & (0x1fu << 5)) >> 5u) * invVal;
+                    clr.r = ((color & (0x1fu << 10)) >> 10u) * invVal;
+                }
+            }
 
-                ASSIMP_LOG_INFO("STL: Mesh has vertex colors");
+            if (welder) {
+                indices.push_back(welder->Add(ReadBinaryVector(sz + 12), clr));
+                indices.push_back(welder->Add(ReadBinaryVector(sz + 24), clr));
+                indices.push_back(welder->Add(ReadBinaryVector(sz + 36), clr));
+                continue;
             }
-            aiColor4D *clr = &pMesh->mColors[0][i * 3];
-            clr->a = 1.0;
-            const ai_real invVal((ai_real)1.0 / (ai_real)31.0);
-            if (bIsMaterialise) // this is reversed
-            {
-                clr->r = (color & 0x1fu) * invVal;
-                clr->g = ((color & (0x1fu << 5)) >> 5u) * invVal;
-                clr->b = ((color & (0x1fu << 10)) >> 10u) * invVal;
-            } else {
-                clr->b = (color & 0x1fu) * invVal;
-                clr->g = ((color & (0x1fu << 5)) >> 5u) * invVal;
-                clr->r = ((color & (0x1fu << 10)) >> 10u) * invVal;
+
+            // There's one normal for the face in the STL; use it three times
+            // for vertex normals
+            vn[0] = vn[1] = vn[2] = ReadBinaryVector(sz);
+            vp[0] = ReadBinaryVector(sz + 12);
+            vp[1] = ReadBinaryVector(sz + 24);
+            vp[2] = ReadBinaryVector(sz + 36);
+            vn += 3;
+            vp += 3;
+
+            if (color & (1 << 15)) {
+                if (!pMesh->mColors[0]) {
+                    pMesh->mColors[0] = new aiColor4D[pMesh->mNumVertices];
+                    std::fill(pMesh->mColors[0], pMesh->mColors[0] + pMesh->mNumVertices, mClrColorDefault);
+                }
+                // assign the color to all vertices of the face
+                aiColor4D *out = &pMesh->mColors[0][i * 3];
+                out[0] = out[1] = out[2] = clr;
             }
-            // assign the color to all vertices of the face
-            *(clr + 1) = *clr;
-            *(clr + 2) = *clr;
         }
+        first += count;
     }
 
-    // now copy faces
-    addFacesToMesh(pMesh);
+    if (welder) {
+        pMesh->mNumVertices = static_cast<unsigned int>(welder->mPositions.size());
+        pMesh->mVertices = new aiVector3D[pMesh->mNumVertices];
+        std::copy(welder->mPositions.begin(), welder->mPositions.end(), pMesh->mVertices);
+        if (hasColors) {
+            pMesh->mColors[0] = new aiColor4D[pMesh->mNumVertices];
+            std::copy(welder->mColors.begin(), welder->mColors.end(), pMesh->mColors[0]);
+        }
+        welder.reset();
+
+        addFacesToMesh(pMesh, indices.data(), mFlatIndexBuffer);
+        ASSIMP_LOG_DEBUG("STL: welded ", pMesh->mNumFaces * 3ull, " vertices into ", pMesh->mNumVertices);
+    } else {
+        // now copy faces
+        addFacesToMesh(pMesh, nullptr, mFlatIndexBuffer);
+    }
 
     aiNode *root = mScene->mRootNode;
 
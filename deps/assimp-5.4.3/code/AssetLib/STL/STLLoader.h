@@ -75,6 +75,11 @@ public:
      */
     bool CanRead( const std::string& pFile, IOSystem* pIOHandler, bool checkSig) const override;
 
+    /**
+     * @brief   Reads the importer configuration.
+     */
+    void SetupProperties(const Importer *pImp) override;
+
 protected:
 
     /**
@@ -91,10 +96,13 @@ protected:
         IOSystem* pIOHandler) override;
 
     /**
-     * @brief   Loads a binary .stl file
+     * @brief   Loads a binary .stl file, the facets are decoded block by
+     *          block while they are read from the stream.
+     * @param   stream  The file, positioned behind the header.
+     * @param   header  The 84 bytes of header and facet count.
      * @return true if the default vertex color must be used as material color
      */
-    bool LoadBinaryFile();
+    bool LoadBinaryFile(IOStream *stream, const char *header);
 
     /**
      * @brief   Loads a ASCII text .stl file
@@ -116,6 +124,12 @@ protected:
 
     /** Default vertex color */
     aiColor4D mClrColorDefault;
+
+    /** Weld identical vertices of binary files */
+    bool mWeldVertices;
+
+    /** Store the faces in one flat index buffer */
+    bool mFlatIndexBuffer;
 };
 
 } // end of namespace Assimp
@@ -42,9 +42,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef INCLUDED_AI_STEPFILE_H
 #define INCLUDED_AI_STEPFILE_H
 
+#include <atomic>
 #include <bitset>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <typeinfo>
 #include <vector>
@@ -145,6 +147,60 @@ struct TypeError : DeadlyImportError {
     TypeError(const std::string &s, uint64_t entity = ENTITY_NOT_SPECIFIED, uint64_t line = SyntaxError::LINE_NOT_SPECIFIED);
 };
 
+// -------------------------------------------------------------------------------
+/** Collects the messages raised while objects are evaluated on a worker thread.
+ *  The logger may only be used by the importing thread, so workers install a
+ *  buffer and the caller prints its contents after joining them.
+ */
+// -------------------------------------------------------------------------------
+class MessageBuffer {
+public:
+    void Warn(const std::string &message) {
+        messages.emplace_back(Logger::Warn, message);
+    }
+
+    void Error(const std::string &message) {
+        messages.emplace_back(Logger::Err, message);
+    }
+
+    // print all collected messages on the calling thread
+    void Flush() {
+        for (const auto &m : messages) {
+            if (m.first == Logger::Err) {
+                ASSIMP_LOG_ERROR(m.second);
+            } else {
+                ASSIMP_LOG_WARN(m.second);
+            }
+        }
+        messages.clear();
+    }
+
+    // the buffer of the calling thread, nullptr to log directly
+    static MessageBuffer *&Current() {
+        static thread_local MessageBuffer *current = nullptr;
+        return current;
+    }
+
+private:
+    std::vector<std::pair<Logger::ErrorSeverity, std::string>> messages;
+};
+
+inline void LogWarn(const std::string &message) {
+    if (MessageBuffer *const buffer = MessageBuffer::Current()) {
+        buffer->Warn(message);
+    } else {
+        ASSIMP_LOG_WARN(message);
+    }
+}
+
+inline void LogError(const std::string &message) {
+    if (MessageBuffer *const buffer = MessageBuffer::Current()) {
+        buffer->Error(message);
+    } else {
+        ASSIMP_LOG_ERROR(message);
+    }
+}
+
 // hack to make a given member template-dependent
 template <typename T, typename T2>
 T2 &Couple(T2 &in) {
@@ -512,16 +568,16 @@ public:
     ~LazyObject();
 
     Object &operator*() {
-        if (!obj) {
-            LazyInit();
+        if (!obj.load(std::memory_order_acquire)) {
+            SharedLazyInit();
             ai_assert(obj);
         }
         return *obj;
     }
 
     const Object &operator*() const {
-        if (!obj) {
-            LazyInit();
+        if (!obj.load(std::memory_order_acquire)) {
+            SharedLazyInit();
             ai_assert(obj);
         }
         return *obj;
@@ -571,12 +627,15 @@ public:
 private:
     void LazyInit() const;
 
+    // LazyInit() for objects that other threads may access at the same time
+    void SharedLazyInit() const;
+
 private:
     mutable uint64_t id;
     const char *const type;
     DB &db;
     mutable const char *args;
-    mutable Object *obj;
+    mutable std::atomic<Object *> obj;
 };
 
 template <typename T>
@@ -699,9 +758,9 @@ struct InternGenericConvertList {
         // XXX is this really how the EXPRESS notation ([?:3],[1:3]) is intended?
         const size_t len = inp->GetSize();
         if (0 != max_cnt && len > max_cnt) {
-            ASSIMP_LOG_WARN("too many aggregate elements");
+            LogWarn("too many aggregate elements");
         } else if (len < min_cnt) {
-            ASSIMP_LOG_WARN("too few aggregate elements");
+            LogWarn("too few aggregate elements");
         }
 
         out.reserve(inp->GetSize());
@@ -748,7 +807,8 @@ class DB {
     friend DB *ReadFileHeader(std::shared_ptr<IOStream> stream);
     friend void ReadFile(DB &db, const EXPRESS::ConversionSchema &scheme,
             const char *const *types_to_track, size_t len,
-            const char *const *inverse_indices_to_track, size_t len2);
+            const char *const *inverse_indices_to_track, size_t len2,
+            unsigned int numThreads);
 
     friend class LazyObject;
 
@@ -773,7 +833,7 @@ public:
 
 private:
     DB(const std::shared_ptr<StreamReaderLE> &reader) :
-            reader(reader), splitter(*reader, true, true), evaluated_count(), schema(nullptr) {}
+            reader(reader), splitter(*reader, true, true), evaluated_count(0), schema(nullptr) {}
 
 public:
     ~DB() {
@@ -849,6 +909,16 @@ public:
         return *o;
     }
 
+    // evaluate all yet unevaluated objects of the given types up-front, spreading the
+    // work over up to numThreads threads. Objects failing to convert are left alone,
+    // so the error is raised again when they are accessed the regular way.
+    void EvaluateParallel(const char *const *types, size_t N, unsigned int numThreads);
+
+    template <size_t N>
+    void EvaluateParallel(const char *const (&types)[N], unsigned int numThreads) {
+        EvaluateParallel(types, N, numThreads);
+    }
+
 #ifdef ASSIMP_IFC_TEST
 
     // evaluate *all* entities in the file. this is a power test for the loader
@@ -912,7 +982,8 @@ private:
     InverseWhitelist inv_whitelist;
     std::shared_ptr<StreamReaderLE> reader;
     LineSplitter splitter;
-    uint64_t evaluated_count;
+    std::atomic<uint64_t> evaluated_count;
+    std::recursive_mutex evaluation_mutex;
     const EXPRESS::ConversionSchema *schema;
 };
 
@@ -53,6 +53,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *   KHR_materials_volume full
  *   KHR_materials_ior full
  *   KHR_materials_emissive_strength full
+ *   KHR_mesh_quantization full
+ *   EXT_meshopt_compression ATTRIBUTES and INDICES modes, no filters
  */
 #ifndef GLTF2ASSET_H_INC
 #define GLTF2ASSET_H_INC
@@ -60,6 +62,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #if !defined(ASSIMP_BUILD_NO_GLTF_IMPORTER) && !defined(ASSIMP_BUILD_NO_GLTF2_IMPORTER)
 
 #include <assimp/Exceptional.h>
+#include <assimp/MemoryAllocator.hpp>
 
 #include <algorithm>
 #include <list>
@@ -218,6 +221,13 @@ enum BufferViewTarget {
     BufferViewTarget_ELEMENT_ARRAY_BUFFER = 34963
 };
 
+//! Values for the EXT_meshopt_compression mode field
+enum MeshoptMode {
+    MeshoptMode_ATTRIBUTES,
+    MeshoptMode_TRIANGLES,
+    MeshoptMode_INDICES
+};
+
 //! Values for the Sampler::magFilter field
 enum class SamplerMagFilter : unsigned int {
     UNSET = 0,
@@ -459,6 +469,8 @@ public:
 
     Type type;
 
+    bool meshoptFallback = false; //!< EXT_meshopt_compression fallback buffer: has a length, but no data
+
     /// \var EncodedRegion_Current
     /// Pointer to currently active encoded region.
     /// Why not decoding all regions at once and not to set one buffer with decoded data?
@@ -546,8 +558,23 @@ struct BufferView : public Object {
 
     BufferViewTarget target; //! The target that the WebGL buffer should be bound to.
 
+    //! EXT_meshopt_compression: the compressed copy of the view's data
+    struct MeshoptCompression {
+        Ref<Buffer> buffer; //!< The buffer holding the compressed data
+        size_t byteOffset = 0; //!< Offset of the compressed data in the buffer
+        size_t byteLength = 0; //!< Length of the compressed data
+        unsigned int byteStride = 0; //!< Size of one element of the decoded data
+        size_t count = 0; //!< Number of elements
+        MeshoptMode mode = MeshoptMode_ATTRIBUTES;
+    };
+    std::unique_ptr<MeshoptCompression> meshopt;
+    std::vector<uint8_t> decodedData; //!< Decompressed contents, used instead of the buffer if not empty
+
     void Read(Value &obj, Asset &r);
     uint8_t *GetPointerAndTailSize(size_t accOffset, size_t& outTailSize);
+
+private:
+    void ReadMeshoptCompression(Value &ext, Asset &r);
 };
 
 //! A typed view into a BufferView. A BufferView contains raw binary data.
@@ -561,6 +588,7 @@ struct Accessor : public Object {
     ComponentType componentType; //!< The datatype of components in the attribute. (required)
     size_t count; //!< The number of attributes referenced by this accessor. (required)
     AttribType::Value type; //!< Specifies if the attribute is a scalar, vector, or matrix. (required)
+    bool normalized = false; //!< Integer values are mapped to [0, 1] or [-1, 1]. (default: false)
     std::vector<double> max; //!< Maximum value of each component in this attribute.
     std::vector<double> min; //!< Minimum value of each component in this attribute.
     std::unique_ptr<Sparse> sparse;
@@ -577,6 +605,11 @@ struct Accessor : public Object {
     template <class T>
     size_t ExtractData(T *&outData, const std::vector<unsigned int> *remappingIndices = nullptr);
 
+    //! Like ExtractData, but converts integer components (KHR_mesh_quantization) to the
+    //! floating point components of T
+    template <class T>
+    size_t ExtractFloatData(T *&outData, const std::vector<unsigned int> *remappingIndices = nullptr);
+
     void WriteData(size_t count, const void *src_buffer, size_t src_stride);
     void WriteSparseValues(size_t count, const void *src_data, size_t src_dataStride);
     void WriteSparseIndices(size_t count, const void *src_idx, size_t src_idxStride);
@@ -1136,6 +1169,8 @@ public:
         bool KHR_draco_mesh_compression;
         bool FB_ngon_encoding;
         bool KHR_texture_basisu;
+        bool KHR_mesh_quantization;
+        bool EXT_meshopt_compression;
 
         Extensions() :
                 KHR_materials_pbrSpecularGlossiness(false), 
@@ -1151,7 +1186,9 @@ public:
                 KHR_materials_emissive_strength(false),
                 KHR_draco_mesh_compression(false),
                 FB_ngon_encoding(false),
-                KHR_texture_basisu(false) {
+                KHR_texture_basisu(false),
+                KHR_mesh_quantization(false),
+                EXT_meshopt_compression(false) {
             // empty
         }
     } extensionsUsed;
@@ -1160,8 +1197,14 @@ public:
     struct RequiredExtensions {
         bool KHR_draco_mesh_compression;
         bool KHR_texture_basisu;
+        bool KHR_mesh_quantization;
+        bool EXT_meshopt_compression;
 
-        RequiredExtensions() : KHR_draco_mesh_compression(false), KHR_texture_basisu(false) {
+        RequiredExtensions() :
+                KHR_draco_mesh_compression(false),
+                KHR_texture_basisu(false),
+                KHR_mesh_quantization(false),
+                EXT_meshopt_compression(false) {
             // empty
         }
     } extensionsRequired;
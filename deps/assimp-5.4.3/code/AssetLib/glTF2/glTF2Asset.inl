@@ -40,6 +40,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "AssetLib/glTF/glTFCommon.h"
+#include "AssetLib/glTF2/glTF2Meshopt.h"
 
 #include <assimp/MemoryIOWrapper.h>
 #include <assimp/StringUtils.h>
@@ -579,6 +580,14 @@ inline void Buffer::Read(Value &obj, Asset &r) {
 
     Value *it = FindString(obj, "uri");
     if (!it) {
+        // The fallback buffer of EXT_meshopt_compression only provides the address space
+        // for the compressed buffer views, it doesn't have any data
+        if (Value *meshoptExt = FindExtension(obj, "EXT_meshopt_compression")) {
+            meshoptFallback = MemberOrDefault(*meshoptExt, "fallback", false);
+            if (meshoptFallback) {
+                return;
+            }
+        }
         if (statedLength > 0) {
             throw DeadlyImportError("GLTF: buffer with non-zero length missing the \"uri\" attribute");
         }
@@ -636,7 +645,12 @@ inline bool Buffer::LoadFromStream(IOStream &stream, size_t length, size_t baseO
         stream.Seek(baseOffset, aiOrigin_SET);
     }
 
-    mData.reset(new uint8_t[byteLength], std::default_delete<uint8_t[]>());
+    // the binary data is the bulk of an import, so it goes through the import's allocator
+    MemoryAllocator *allocator = MemoryAllocator::GetCurrent();
+    const size_t size = byteLength;
+    mData.reset(static_cast<uint8_t *>(MemoryAllocator::AllocateTracked(allocator, size, 1)), [allocator, size](uint8_t *data) {
+        MemoryAllocator::FreeTracked(allocator, data, size, 1);
+    });
 
     if (stream.Read(mData.get(), byteLength, 1) != 1) {
         return false;
@@ -706,6 +720,7 @@ inline bool Buffer::ReplaceData(const size_t pBufferData_Offset, const size_t pB
     // Apply new data
     mData.reset(new_data, std::default_delete<uint8_t[]>());
     byteLength = new_data_size;
+    capacity = new_data_size;
 
     return true;
 }
@@ -726,6 +741,7 @@ inline bool Buffer::ReplaceData_joint(const size_t pBufferData_Offset, const siz
     // Apply new data
     mData.reset(new_data, std::default_delete<uint8_t[]>());
     byteLength = new_data_size;
+    capacity = new_data_size;
 
     return true;
 }
@@ -752,8 +768,8 @@ inline void Buffer::Grow(size_t amount) {
         return;
     }
 
-    // Just allocate data which we need
-    capacity = byteLength + amount;
+    // Grow geometrically, exporters append one accessor at a time
+    capacity = std::max(byteLength + amount, capacity + capacity / 2);
 
     uint8_t *b = new uint8_t[capacity];
     if (nullptr != mData) {
@@ -783,9 +799,71 @@ inline void BufferView::Read(Value &obj, Asset &r) {
     if ((byteOffset + byteLength) > buffer->byteLength) {
         throw DeadlyImportError("GLTF: Buffer view with offset/length (", byteOffset, "/", byteLength, ") is out of range.");
     }
+
+    if (Value *meshoptExt = FindExtension(obj, "EXT_meshopt_compression")) {
+        ReadMeshoptCompression(*meshoptExt, r);
+    }
+}
+
+inline void BufferView::ReadMeshoptCompression(Value &ext, Asset &r) {
+    meshopt.reset(new MeshoptCompression);
+    if (Value *bufferVal = FindUInt(ext, "buffer")) {
+        meshopt->buffer = r.buffers.Retrieve(bufferVal->GetUint());
+    }
+    if (!meshopt->buffer || !meshopt->buffer->GetPointer()) {
+        throw DeadlyImportError("GLTF: EXT_meshopt_compression in buffer view ", id, " without valid buffer.");
+    }
+
+    meshopt->byteOffset = MemberOrDefault(ext, "byteOffset", size_t(0));
+    meshopt->byteLength = MemberOrDefault(ext, "byteLength", size_t(0));
+    meshopt->byteStride = MemberOrDefault(ext, "byteStride", 0u);
+    meshopt->count = MemberOrDefault(ext, "count", size_t(0));
+
+    const char *mode = "";
+    ReadMember(ext, "mode", mode);
+    if (strcmp(mode, "ATTRIBUTES") == 0) {
+        meshopt->mode = MeshoptMode_ATTRIBUTES;
+    } else if (strcmp(mode, "INDICES") == 0) {
+        meshopt->mode = MeshoptMode_INDICES;
+    } else {
+        throw DeadlyImportError("GLTF: EXT_meshopt_compression mode \"", mode, "\" of buffer view ", id, " is not supported.");
+    }
+
+    const char *filter = "NONE";
+    ReadMember(ext, "filter", filter);
+    if (strcmp(filter, "NONE") != 0) {
+        throw DeadlyImportError("GLTF: EXT_meshopt_compression filter \"", filter, "\" of buffer view ", id, " is not supported.");
+    }
+
+    if ((meshopt->byteOffset + meshopt->byteLength) > meshopt->buffer->byteLength) {
+        throw DeadlyImportError("GLTF: EXT_meshopt_compression in buffer view ", id, " with offset/length (",
+                meshopt->byteOffset, "/", meshopt->byteLength, ") is out of range.");
+    }
+    if (meshopt->count * meshopt->byteStride > byteLength) {
+        throw DeadlyImportError("GLTF: EXT_meshopt_compression in buffer view ", id, " decodes to more than ", byteLength, " bytes.");
+    }
+
+    // Decode right away, accessors then simply read from decodedData
+    decodedData.resize(byteLength, 0);
+    const uint8_t *encoded = meshopt->buffer->GetPointer() + meshopt->byteOffset;
+    const bool decoded = (meshopt->mode == MeshoptMode_ATTRIBUTES) ?
+            Meshopt::DecodeVertexBuffer(decodedData.data(), meshopt->count, meshopt->byteStride, encoded, meshopt->byteLength) :
+            Meshopt::DecodeIndexSequence(decodedData.data(), meshopt->count, meshopt->byteStride, encoded, meshopt->byteLength);
+    if (!decoded) {
+        throw DeadlyImportError("GLTF: Failed to decode the EXT_meshopt_compression data of buffer view ", id, ".");
+    }
 }
 
 inline uint8_t *BufferView::GetPointerAndTailSize(size_t accOffset, size_t& outTailSize) {
+    if (!decodedData.empty()) {
+        if (accOffset >= decodedData.size()) {
+            outTailSize = 0;
+            return nullptr;
+        }
+        outTailSize = decodedData.size() - accOffset;
+        return decodedData.data() + accOffset;
+    }
+
     if (!buffer) {
         outTailSize = 0;
         return nullptr;
@@ -890,6 +968,7 @@ inline void Accessor::Read(Value &obj, Asset &r) {
 
     const char *typestr;
     type = ReadMember(obj, "type", typestr) ? AttribType::FromString(typestr) : AttribType::SCALAR;
+    normalized = MemberOrDefault(obj, "normalized", false);
 
     if (bufferView) {
         // Check length
@@ -978,6 +1057,10 @@ inline uint8_t *Accessor::GetPointer() {
     if (sparse)
         return sparse->data.data();
 
+    if (bufferView && !bufferView->decodedData.empty()) {
+        return byteOffset < bufferView->decodedData.size() ? bufferView->decodedData.data() + byteOffset : nullptr;
+    }
+
     if (!bufferView || !bufferView->buffer) return nullptr;
     uint8_t *basePtr = bufferView->buffer->GetPointer();
     if (!basePtr) return nullptr;
@@ -1059,11 +1142,84 @@ size_t Accessor::ExtractData(T *&outData, const std::vector<unsigned int> *remap
     return usedCount;
 }
 
+namespace {
+
+// Reads one component as float, integers are mapped as required by KHR_mesh_quantization
+inline ai_real ReadFloatComponent(const uint8_t *src, ComponentType componentType, bool normalized) {
+    switch (componentType) {
+    case ComponentType_BYTE: {
+        int8_t value = int8_t(*src);
+        return normalized ? std::max(ai_real(value) / ai_real(127), ai_real(-1)) : ai_real(value);
+    }
+    case ComponentType_UNSIGNED_BYTE:
+        return normalized ? ai_real(*src) / ai_real(255) : ai_real(*src);
+    case ComponentType_SHORT: {
+        int16_t value;
+        memcpy(&value, src, sizeof(value));
+        return normalized ? std::max(ai_real(value) / ai_real(32767), ai_real(-1)) : ai_real(value);
+    }
+    case ComponentType_UNSIGNED_SHORT: {
+        uint16_t value;
+        memcpy(&value, src, sizeof(value));
+        return normalized ? ai_real(value) / ai_real(65535) : ai_real(value);
+    }
+    case ComponentType_UNSIGNED_INT: {
+        uint32_t value;
+        memcpy(&value, src, sizeof(value));
+        return ai_real(value);
+    }
+    case ComponentType_FLOAT: {
+        float value;
+        memcpy(&value, src, sizeof(value));
+        return ai_real(value);
+    }
+    }
+    return ai_real(0);
+}
+
+} // namespace
+
+template <class T>
+size_t Accessor::ExtractFloatData(T *&outData, const std::vector<unsigned int> *remappingIndices) {
+    if (componentType == ComponentType_FLOAT) {
+        return ExtractData(outData, remappingIndices);
+    }
+
+    uint8_t *data = GetPointer();
+    if (!data) {
+        throw DeadlyImportError("GLTF2: data is null when extracting data from ", getContextForErrorMessages(id, name));
+    }
+
+    const size_t usedCount = (remappingIndices != nullptr) ? remappingIndices->size() : count;
+    const size_t elemSize = GetElementSize();
+    const size_t stride = GetStride();
+    const size_t maxSize = GetMaxByteSize();
+    const unsigned int bytesPerComponent = GetBytesPerComponent();
+    const unsigned int numComponents = std::min(GetNumComponents(), static_cast<unsigned int>(sizeof(T) / sizeof(ai_real)));
+
+    outData = new T[usedCount];
+    for (size_t i = 0; i < usedCount; ++i) {
+        const size_t srcIdx = (remappingIndices != nullptr) ? (*remappingIndices)[i] : i;
+        if (srcIdx * stride + elemSize > maxSize) {
+            delete[] outData;
+            outData = nullptr;
+            throw DeadlyImportError("GLTF: index*stride ", (srcIdx * stride), " > maxSize ", maxSize, " in ", getContextForErrorMessages(id, name));
+        }
+
+        const uint8_t *src = data + srcIdx * stride;
+        ai_real *dst = reinterpret_cast<ai_real *>(outData + i);
+        for (unsigned int c = 0; c < numComponents; ++c) {
+            dst[c] = ReadFloatComponent(src + c * bytesPerComponent, componentType, normalized);
+        }
+    }
+    return usedCount;
+}
+
 inline void Accessor::WriteData(size_t _count, const void *src_buffer, size_t src_stride) {
     uint8_t *buffer_ptr = bufferView->buffer->GetPointer();
     size_t offset = byteOffset + bufferView->byteOffset;
 
-    size_t dst_stride = GetNumComponents() * GetBytesPerComponent();
+    size_t dst_stride = bufferView->byteStride ? bufferView->byteStride : GetNumComponents() * GetBytesPerComponent();
 
     const uint8_t *src = reinterpret_cast<const uint8_t *>(src_buffer);
     uint8_t *dst = reinterpret_cast<uint8_t *>(buffer_ptr + offset);
@@ -2116,6 +2272,8 @@ inline void Asset::ReadExtensionsRequired(Document &doc) {
     }
 
     CHECK_REQUIRED_EXT(KHR_draco_mesh_compression);
+    CHECK_REQUIRED_EXT(KHR_mesh_quantization);
+    CHECK_REQUIRED_EXT(EXT_meshopt_compression);
 
 #undef CHECK_REQUIRED_EXT
 }
@@ -2145,6 +2303,8 @@ inline void Asset::ReadExtensionsUsed(Document &doc) {
     CHECK_EXT(KHR_materials_emissive_strength);
     CHECK_EXT(KHR_draco_mesh_compression);
     CHECK_EXT(KHR_texture_basisu);
+    CHECK_EXT(KHR_mesh_quantization);
+    CHECK_EXT(EXT_meshopt_compression);
 
 #undef CHECK_EXT
 }
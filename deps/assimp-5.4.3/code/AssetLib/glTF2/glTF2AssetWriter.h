@@ -84,10 +84,11 @@ private:
 public:
     Document mDoc;
     Asset& mAsset;
+    bool mCompactJson; //!< Write .gltf files without indentation
 
     MemoryPoolAllocator<>& mAl;
 
-    AssetWriter(Asset& asset);
+    AssetWriter(Asset& asset, bool compactJson = false);
 
     void WriteFile(const char* path);
     void WriteGLBFile(const char* path);
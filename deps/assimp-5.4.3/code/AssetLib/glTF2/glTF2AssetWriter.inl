@@ -54,6 +54,42 @@ namespace glTF2 {
 
     namespace {
 
+        // rapidjson output stream which hands the JSON to an IOStream in blocks,
+        // so the document is never serialized into memory as a whole
+        class IOStreamJsonOutput {
+        public:
+            typedef char Ch;
+
+            explicit IOStreamJsonOutput(IOStream& stream)
+                : mStream(stream), mFill(0), mWritten(0), mFailed(false) {}
+
+            void Put(Ch c) {
+                if (mFill == sizeof(mBuffer)) {
+                    Flush();
+                }
+                mBuffer[mFill++] = c;
+            }
+
+            void Flush() {
+                if (mFill > 0 && mStream.Write(mBuffer, 1, mFill) != mFill) {
+                    mFailed = true;
+                }
+                mWritten += mFill;
+                mFill = 0;
+            }
+
+            //! Number of bytes passed to the stream so far, excluding unflushed ones
+            size_t GetWritten() const { return mWritten; }
+            bool HasFailed() const { return mFailed; }
+
+        private:
+            IOStream& mStream;
+            char mBuffer[16384];
+            size_t mFill;
+            size_t mWritten;
+            bool mFailed;
+        };
+
         template<typename T, size_t N>
         inline Value& MakeValue(Value& val, T(&r)[N], MemoryPoolAllocator<>& al) {
             val.SetArray();
@@ -115,6 +151,9 @@ namespace glTF2 {
         obj.AddMember("componentType", int(a.componentType), w.mAl);
         obj.AddMember("count", (unsigned int)a.count, w.mAl);
         obj.AddMember("type", StringRef(AttribType::ToString(a.type)), w.mAl);
+        if (a.normalized) {
+            obj.AddMember("normalized", true, w.mAl);
+        }
         Value vTmpMax, vTmpMin;
         if (a.componentType == ComponentType_FLOAT) {
             obj.AddMember("max", MakeValue(vTmpMax, a.max, w.mAl), w.mAl);
@@ -221,6 +260,18 @@ namespace glTF2 {
     {
         obj.AddMember("byteLength", static_cast<uint64_t>(b.byteLength), w.mAl);
 
+        if (b.meshoptFallback) {
+            Value meshoptExt;
+            meshoptExt.SetObject();
+            meshoptExt.AddMember("fallback", true, w.mAl);
+
+            Value exts;
+            exts.SetObject();
+            exts.AddMember("EXT_meshopt_compression", meshoptExt, w.mAl);
+            obj.AddMember("extensions", exts, w.mAl);
+            return;
+        }
+
         const auto uri = b.GetURI();
         const auto relativeUri = uri.substr(uri.find_last_of("/\\") + 1u);
         obj.AddMember("uri", Value(relativeUri, w.mAl).Move(), w.mAl);
@@ -237,6 +288,24 @@ namespace glTF2 {
         if (bv.target != BufferViewTarget_NONE) {
             obj.AddMember("target", int(bv.target), w.mAl);
         }
+
+        if (bv.meshopt) {
+            BufferView::MeshoptCompression &meshopt = *bv.meshopt;
+
+            Value meshoptExt;
+            meshoptExt.SetObject();
+            meshoptExt.AddMember("buffer", meshopt.buffer->index, w.mAl);
+            meshoptExt.AddMember("byteOffset", static_cast<uint64_t>(meshopt.byteOffset), w.mAl);
+            meshoptExt.AddMember("byteLength", static_cast<uint64_t>(meshopt.byteLength), w.mAl);
+            meshoptExt.AddMember("byteStride", meshopt.byteStride, w.mAl);
+            meshoptExt.AddMember("count", static_cast<uint64_t>(meshopt.count), w.mAl);
+            meshoptExt.AddMember("mode", StringRef(meshopt.mode == MeshoptMode_INDICES ? "INDICES" : "ATTRIBUTES"), w.mAl);
+
+            Value exts;
+            exts.SetObject();
+            exts.AddMember("EXT_meshopt_compression", meshoptExt, w.mAl);
+            obj.AddMember("extensions", exts, w.mAl);
+        }
     }
 
     inline void Write(Value& /*obj*/, Camera& /*c*/, AssetWriter& /*w*/)
@@ -803,9 +872,10 @@ namespace glTF2 {
         }
     }
 
-    inline AssetWriter::AssetWriter(Asset& a)
+    inline AssetWriter::AssetWriter(Asset& a, bool compactJson)
         : mDoc()
         , mAsset(a)
+        , mCompactJson(compactJson)
         , mAl(mDoc.GetAllocator())
     {
         mDoc.SetObject();
@@ -836,20 +906,27 @@ namespace glTF2 {
             throw DeadlyExportError("Could not open output file: " + std::string(path));
         }
 
-        StringBuffer docBuffer;
-
-        PrettyWriter<StringBuffer> writer(docBuffer);
-        if (!mDoc.Accept(writer)) {
-            throw DeadlyExportError("Failed to write scene data!");
+        IOStreamJsonOutput jsonOut(*jsonOutFile);
+        bool accepted;
+        if (mCompactJson) {
+            Writer<IOStreamJsonOutput> writer(jsonOut);
+            accepted = mDoc.Accept(writer);
+        } else {
+            PrettyWriter<IOStreamJsonOutput> writer(jsonOut);
+            accepted = mDoc.Accept(writer);
         }
+        jsonOut.Flush();
 
-        if (jsonOutFile->Write(docBuffer.GetString(), docBuffer.GetSize(), 1) != 1) {
+        if (!accepted || jsonOut.HasFailed()) {
             throw DeadlyExportError("Failed to write scene data!");
         }
 
         // Write buffer data to separate .bin files
         for (unsigned int i = 0; i < mAsset.buffers.Size(); ++i) {
             Ref<Buffer> b = mAsset.buffers.Get(i);
+            if (b->meshoptFallback) {
+                continue;
+            }
 
             std::string binPath = b->GetURI();
 
@@ -880,43 +957,49 @@ namespace glTF2 {
             rapidjson::Value glbBodyBuffer;
             glbBodyBuffer.SetObject();
             glbBodyBuffer.AddMember("byteLength", static_cast<uint64_t>(bodyBuffer->byteLength), mAl);
-            mDoc["buffers"].PushBack(glbBodyBuffer, mAl);
+
+            // The BIN chunk belongs to the first buffer, so the body goes in front of any
+            // other buffers (e.g. the fallback buffer of EXT_meshopt_compression)
+            Value& buffers = mDoc["buffers"];
+            Value orderedBuffers;
+            orderedBuffers.SetArray();
+            orderedBuffers.PushBack(glbBodyBuffer, mAl);
+            for (Value& buffer : buffers.GetArray()) {
+                orderedBuffers.PushBack(buffer, mAl);
+            }
+            buffers = orderedBuffers;
         }
 
         // Padding with spaces as required by the spec
         uint32_t padding = 0x20202020;
 
         //
-        // JSON chunk
+        // JSON chunk, streamed behind the headers, which are written once the length is known
         //
 
-        StringBuffer docBuffer;
-        Writer<StringBuffer> writer(docBuffer);
-        if (!mDoc.Accept(writer)) {
+        outfile->Seek(sizeof(GLB_Header) + sizeof(GLB_Chunk), aiOrigin_SET);
+        IOStreamJsonOutput jsonOut(*outfile);
+        Writer<IOStreamJsonOutput> writer(jsonOut);
+        const bool accepted = mDoc.Accept(writer);
+        jsonOut.Flush();
+        if (!accepted || jsonOut.HasFailed()) {
             throw DeadlyExportError("Failed to write scene data!");
         }
 
-        uint32_t jsonChunkLength = static_cast<uint32_t>((docBuffer.GetSize() + 3) & ~3); // Round up to next multiple of 4
-        auto paddingLength = jsonChunkLength - docBuffer.GetSize();
+        uint32_t jsonChunkLength = static_cast<uint32_t>((jsonOut.GetWritten() + 3) & ~3); // Round up to next multiple of 4
+        auto paddingLength = jsonChunkLength - jsonOut.GetWritten();
+
+        if (paddingLength && outfile->Write(&padding, 1, paddingLength) != paddingLength) {
+            throw DeadlyExportError("Failed to write scene data padding!");
+        }
 
         GLB_Chunk jsonChunk;
         jsonChunk.chunkLength = jsonChunkLength;
         jsonChunk.chunkType = ChunkType_JSON;
         AI_SWAP4(jsonChunk.chunkLength);
 
-        outfile->Seek(sizeof(GLB_Header), aiOrigin_SET);
-        if (outfile->Write(&jsonChunk, 1, sizeof(GLB_Chunk)) != sizeof(GLB_Chunk)) {
-            throw DeadlyExportError("Failed to write scene data header!");
-        }
-        if (outfile->Write(docBuffer.GetString(), 1, docBuffer.GetSize()) != docBuffer.GetSize()) {
-            throw DeadlyExportError("Failed to write scene data!");
-        }
-        if (paddingLength && outfile->Write(&padding, 1, paddingLength) != paddingLength) {
-            throw DeadlyExportError("Failed to write scene data padding!");
-        }
-
         //
-        // Binary chunk
+        // Binary chunk, written from the body buffer the meshes were converted into
         //
 
         int GLB_Chunk_count = 1;
@@ -932,8 +1015,6 @@ namespace glTF2 {
             binaryChunk.chunkType = ChunkType_BIN;
             AI_SWAP4(binaryChunk.chunkLength);
 
-            size_t bodyOffset = sizeof(GLB_Header) + sizeof(GLB_Chunk) + jsonChunk.chunkLength;
-            outfile->Seek(bodyOffset, aiOrigin_SET);
             if (outfile->Write(&binaryChunk, 1, sizeof(GLB_Chunk)) != sizeof(GLB_Chunk)) {
                 throw DeadlyExportError("Failed to write body data header!");
             }
@@ -945,6 +1026,11 @@ namespace glTF2 {
             }
         }
 
+        outfile->Seek(sizeof(GLB_Header), aiOrigin_SET);
+        if (outfile->Write(&jsonChunk, 1, sizeof(GLB_Chunk)) != sizeof(GLB_Chunk)) {
+            throw DeadlyExportError("Failed to write scene data header!");
+        }
+
         //
         // Header
         //
@@ -1024,16 +1110,32 @@ namespace glTF2 {
             if (this->mAsset.extensionsUsed.KHR_texture_basisu) {
                 exts.PushBack(StringRef("KHR_texture_basisu"), mAl);
             }
+
+            if (this->mAsset.extensionsUsed.KHR_mesh_quantization) {
+                exts.PushBack(StringRef("KHR_mesh_quantization"), mAl);
+            }
+
+            if (this->mAsset.extensionsUsed.EXT_meshopt_compression) {
+                exts.PushBack(StringRef("EXT_meshopt_compression"), mAl);
+            }
         }
 
         if (!exts.Empty())
             mDoc.AddMember("extensionsUsed", exts, mAl);
 
-        //basisu extensionRequired
         Value extsReq;
         extsReq.SetArray();
+        //basisu extensionRequired
         if (this->mAsset.extensionsUsed.KHR_texture_basisu) {
             extsReq.PushBack(StringRef("KHR_texture_basisu"), mAl);
+        }
+        if (this->mAsset.extensionsRequired.KHR_mesh_quantization) {
+            extsReq.PushBack(StringRef("KHR_mesh_quantization"), mAl);
+        }
+        if (this->mAsset.extensionsRequired.EXT_meshopt_compression) {
+            extsReq.PushBack(StringRef("EXT_meshopt_compression"), mAl);
+        }
+        if (!extsReq.Empty()) {
             mDoc.AddMember("extensionsRequired", extsReq, mAl);
         }
     }
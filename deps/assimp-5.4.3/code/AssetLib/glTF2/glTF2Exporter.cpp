@@ -43,6 +43,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AssetLib/glTF2/glTF2Exporter.h"
 #include "AssetLib/glTF2/glTF2AssetWriter.h"
+#include "AssetLib/glTF2/glTF2Meshopt.h"
+#include "Common/ParallelFor.h"
 #include "PostProcessing/SplitLargeMeshes.h"
 
 #include <assimp/ByteSwapper.h>
@@ -58,6 +60,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/config.h>
 
 // Header files, standard library.
+#include <algorithm>
 #include <cinttypes>
 #include <limits>
 #include <memory>
@@ -94,6 +97,7 @@ glTF2Exporter::glTF2Exporter(const char *filename, IOSystem *pIOSystem, const ai
     configEpsilon = mProperties->GetPropertyFloat(
             AI_CONFIG_CHECK_IDENTITY_MATRIX_EPSILON,
                     (ai_real)AI_CONFIG_CHECK_IDENTITY_MATRIX_EPSILON_DEFAULT);
+    mNumThreads = GetWorkerThreadCount(mProperties->GetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 0));
 
     if (isBinary) {
         mAsset->SetAsBinary();
@@ -120,7 +124,7 @@ glTF2Exporter::glTF2Exporter(const char *filename, IOSystem *pIOSystem, const ai
         mAsset->extras = (rapidjson::Value *)ExportExtras(0);
     }
 
-    AssetWriter writer(*mAsset);
+    AssetWriter writer(*mAsset, mProperties->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_COMPACT_JSON, false));
 
     if (isBinary) {
         writer.WriteGLBFile(filename);
@@ -390,8 +394,33 @@ inline Ref<Accessor> ExportDataSparse(Asset &a, std::string &meshName, Ref<Buffe
     }
     return acc;
 }
+// Accessor data that has been laid out in the buffer but not written yet
+struct PendingAccessorData {
+    Ref<Accessor> acc;
+    const void *data;
+    size_t count;
+    unsigned int numCompsIn;
+};
+
+// Calculate the range of an accessor and copy its data into the buffer
+inline void WriteAccessorData(const PendingAccessorData &pending) {
+    Ref<Accessor> acc = pending.acc;
+    void *data = const_cast<void *>(pending.data);
+    const unsigned int numCompsOut = AttribType::GetNumComponents(acc->type);
+
+    // calculate min and max values
+    SetAccessorRange(acc->componentType, acc, data, pending.count, pending.numCompsIn, numCompsOut);
+
+    // copy the data
+    acc->WriteData(pending.count, data, pending.numCompsIn * ComponentTypeSize(acc->componentType));
+}
+
+// Create the accessor and reserve its data in the buffer. If pending is given, writing the
+// data is left to the caller, which allows filling the buffer in parallel once all accessors
+// have been laid out.
 inline Ref<Accessor> ExportData(Asset &a, std::string &meshName, Ref<Buffer> &buffer,
-        size_t count, void *data, AttribType::Value typeIn, AttribType::Value typeOut, ComponentType compType, BufferViewTarget target = BufferViewTarget_NONE) {
+        size_t count, const void *data, AttribType::Value typeIn, AttribType::Value typeOut, ComponentType compType,
+        BufferViewTarget target = BufferViewTarget_NONE, std::vector<PendingAccessorData> *pending = nullptr) {
     if (!count || !data) {
         return Ref<Accessor>();
     }
@@ -400,11 +429,17 @@ inline Ref<Accessor> ExportData(Asset &a, std::string &meshName, Ref<Buffer> &bu
     unsigned int numCompsOut = AttribType::GetNumComponents(typeOut);
     unsigned int bytesPerComp = ComponentTypeSize(compType);
 
+    // vertex attributes have to be aligned to 4 bytes, which pads e.g. 3 byte normals
+    const bool isVertexAttribute = (target == BufferViewTarget_ARRAY_BUFFER);
+    const size_t elementSize = numCompsOut * bytesPerComp;
+    const size_t alignment = isVertexAttribute ? 4 : bytesPerComp;
+    const unsigned int byteStride = (isVertexAttribute && elementSize % 4 != 0) ? unsigned((elementSize + 3) & ~size_t(3)) : 0;
+
     size_t offset = buffer->byteLength;
     // make sure offset is correctly byte-aligned, as required by spec
-    size_t padding = offset % bytesPerComp;
+    size_t padding = (alignment - offset % alignment) % alignment;
     offset += padding;
-    size_t length = count * numCompsOut * bytesPerComp;
+    size_t length = count * (byteStride ? byteStride : elementSize);
     buffer->Grow(length + padding);
 
     // bufferView
@@ -412,7 +447,7 @@ inline Ref<Accessor> ExportData(Asset &a, std::string &meshName, Ref<Buffer> &bu
     bv->buffer = buffer;
     bv->byteOffset = offset;
     bv->byteLength = length; //! The target that the WebGL buffer should be bound to.
-    bv->byteStride = 0;
+    bv->byteStride = byteStride;
     bv->target = target;
 
     // accessor
@@ -423,15 +458,48 @@ inline Ref<Accessor> ExportData(Asset &a, std::string &meshName, Ref<Buffer> &bu
     acc->count = count;
     acc->type = typeOut;
 
-    // calculate min and max values
-    SetAccessorRange(compType, acc, data, count, numCompsIn, numCompsOut);
-
-    // copy the data
-    acc->WriteData(count, data, numCompsIn * bytesPerComp);
+    const PendingAccessorData accessorData = { acc, data, count, numCompsIn };
+    if (pending) {
+        pending->push_back(accessorData);
+    } else {
+        WriteAccessorData(accessorData);
+    }
 
     return acc;
 }
 
+// Maps unit vectors to normalized signed bytes (KHR_mesh_quantization). Each element
+// gets a fourth, zero byte to keep the vertex attribute aligned.
+inline void QuantizeNormals(const aiVector3D *normals, size_t count, std::vector<int8_t> &out) {
+    out.resize(count * 4, 0);
+    for (size_t i = 0; i < count; ++i) {
+        out[i * 4 + 0] = int8_t(std::lround(std::max(ai_real(-1), std::min(ai_real(1), normals[i].x)) * 127));
+        out[i * 4 + 1] = int8_t(std::lround(std::max(ai_real(-1), std::min(ai_real(1), normals[i].y)) * 127));
+        out[i * 4 + 2] = int8_t(std::lround(std::max(ai_real(-1), std::min(ai_real(1), normals[i].z)) * 127));
+    }
+}
+
+// Maps the first numCompsOut of every numCompsIn values to normalized unsigned shorts.
+// Returns false, leaving out empty, if a value is outside of [0, 1].
+inline bool QuantizeUnorm16(const ai_real *values, size_t count, unsigned int numCompsIn, unsigned int numCompsOut, std::vector<uint16_t> &out) {
+    for (size_t i = 0; i < count; ++i) {
+        for (unsigned int c = 0; c < numCompsOut; ++c) {
+            const ai_real value = values[i * numCompsIn + c];
+            if (!(value >= 0 && value <= 1)) {
+                return false;
+            }
+        }
+    }
+
+    out.resize(count * numCompsOut);
+    for (size_t i = 0; i < count; ++i) {
+        for (unsigned int c = 0; c < numCompsOut; ++c) {
+            out[i * numCompsOut + c] = uint16_t(std::lround(values[i * numCompsIn + c] * 65535));
+        }
+    }
+    return true;
+}
+
 inline void ExportNodeExtras(const aiMetadataEntry &metadataEntry, aiString name, CustomExtension &value) {
 
     value.name = name.C_Str();
@@ -1155,6 +1223,11 @@ void glTF2Exporter::ExportMeshes() {
         b = mAsset->buffers.Create(bufferId);
     }
 
+    // Everything from here on is mesh data, which may get compressed at the end
+    const unsigned int firstView = unsigned(mAsset->bufferViews.Size());
+    const unsigned int firstAccessor = unsigned(mAsset->accessors.Size());
+    const size_t firstByte = b->byteLength;
+
     //----------------------------------------
     // Initialize variables for the skin
     bool createSkin = false;
@@ -1175,8 +1248,118 @@ void glTF2Exporter::ExportMeshes() {
     }
     //----------------------------------------
 
+    bool bUseSparse = this->mProperties->HasPropertyBool("GLTF2_SPARSE_ACCESSOR_EXP") &&
+                      this->mProperties->GetPropertyBool("GLTF2_SPARSE_ACCESSOR_EXP");
+    bool bIncludeNormal = this->mProperties->HasPropertyBool("GLTF2_TARGET_NORMAL_EXP") &&
+                          this->mProperties->GetPropertyBool("GLTF2_TARGET_NORMAL_EXP");
+    bool bExportTargetNames = this->mProperties->HasPropertyBool("GLTF2_TARGETNAMES_EXP") &&
+                              this->mProperties->GetPropertyBool("GLTF2_TARGETNAMES_EXP");
+    const bool bQuantize = mProperties->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_QUANTIZE, false);
+    const bool bCompress = mProperties->GetPropertyBool(AI_CONFIG_EXPORT_GLTF_MESHOPT_COMPRESSION, false);
+
+    //----------------------------------------
+    // Convert the vertex data of all meshes in parallel. This only touches the
+    // mesh itself and its entry in preparedMeshes.
+    struct PreparedMesh {
+        std::vector<IndicesType> indices;
+        std::vector<std::vector<aiVector3D>> positionDiffs;
+        std::vector<std::vector<aiVector3D>> normalDiffs;
+
+        // Normalized normals and flipped UVs, the scene itself is left untouched
+        std::vector<aiVector3D> normalsF;
+        std::vector<aiVector3D> texCoordsF[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+
+        // Quantized attributes, empty if the mesh data is exported as is
+        std::vector<int8_t> normals;
+        std::vector<uint16_t> indices16;
+        std::vector<uint16_t> texCoords[AI_MAX_NUMBER_OF_TEXTURECOORDS];
+        std::vector<uint16_t> colors[AI_MAX_NUMBER_OF_COLOR_SETS];
+    };
+    std::vector<PreparedMesh> preparedMeshes(mScene->mNumMeshes);
+
+    ParallelFor(mScene->mNumMeshes, mNumThreads, [&](size_t begin, size_t end) {
+        for (size_t idx_mesh = begin; idx_mesh < end; ++idx_mesh) {
+            const aiMesh *aim = mScene->mMeshes[idx_mesh];
+            PreparedMesh &prepared = preparedMeshes[idx_mesh];
+
+            // Normalize all normals as the validator can emit a warning otherwise
+            if (nullptr != aim->mNormals) {
+                prepared.normalsF.assign(aim->mNormals, aim->mNormals + aim->mNumVertices);
+                for (aiVector3D &normal : prepared.normalsF) {
+                    normal.NormalizeSafe();
+                }
+            }
+
+            // Flip UV y coords
+            for (int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+                if (aim->HasTextureCoords(i) && aim->mNumUVComponents[i] > 1) {
+                    prepared.texCoordsF[i].assign(aim->mTextureCoords[i], aim->mTextureCoords[i] + aim->mNumVertices);
+                    for (aiVector3D &uv : prepared.texCoordsF[i]) {
+                        uv.y = 1 - uv.y;
+                    }
+                }
+            }
+
+            if (aim->mNumFaces > 0) {
+                unsigned int nIndicesPerFace = aim->mFaces[0].mNumIndices;
+                prepared.indices.resize(aim->mNumFaces * nIndicesPerFace);
+                for (size_t i = 0; i < aim->mNumFaces; ++i) {
+                    for (size_t j = 0; j < nIndicesPerFace; ++j) {
+                        prepared.indices[i * nIndicesPerFace + j] = IndicesType(aim->mFaces[i].mIndices[j]);
+                    }
+                }
+            }
+
+            if (bQuantize) {
+                if (!prepared.normalsF.empty()) {
+                    QuantizeNormals(prepared.normalsF.data(), aim->mNumVertices, prepared.normals);
+                }
+                for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+                    if (!prepared.texCoordsF[i].empty() && aim->mNumUVComponents[i] == 2) {
+                        QuantizeUnorm16(&prepared.texCoordsF[i][0].x, aim->mNumVertices, 3, 2, prepared.texCoords[i]);
+                    }
+                }
+                for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+                    if (aim->HasVertexColors(i)) {
+                        QuantizeUnorm16(&aim->mColors[i][0].r, aim->mNumVertices, 4, 4, prepared.colors[i]);
+                    }
+                }
+                // 0xffff is the primitive restart value and can't be used
+                if (aim->mNumVertices < 0xffff && !prepared.indices.empty()) {
+                    prepared.indices16.assign(prepared.indices.begin(), prepared.indices.end());
+                    std::vector<IndicesType>().swap(prepared.indices);
+                }
+            }
+
+            // NOTE: in gltf it is the diff stored
+            prepared.positionDiffs.resize(aim->mNumAnimMeshes);
+            prepared.normalDiffs.resize(aim->mNumAnimMeshes);
+            for (unsigned int am = 0; am < aim->mNumAnimMeshes; ++am) {
+                const aiAnimMesh *pAnimMesh = aim->mAnimMeshes[am];
+                if (pAnimMesh->HasPositions()) {
+                    prepared.positionDiffs[am].resize(pAnimMesh->mNumVertices);
+                    for (unsigned int vt = 0; vt < pAnimMesh->mNumVertices; ++vt) {
+                        prepared.positionDiffs[am][vt] = pAnimMesh->mVertices[vt] - aim->mVertices[vt];
+                    }
+                }
+                if (pAnimMesh->HasNormals() && bIncludeNormal && !prepared.normalsF.empty()) {
+                    prepared.normalDiffs[am].resize(pAnimMesh->mNumVertices);
+                    for (unsigned int vt = 0; vt < pAnimMesh->mNumVertices; ++vt) {
+                        prepared.normalDiffs[am][vt] = pAnimMesh->mNormals[vt] - prepared.normalsF[vt];
+                    }
+                }
+            }
+        }
+    });
+
+    //----------------------------------------
+    // Create the glTF objects and lay out the buffer. Copying the data into the
+    // buffer is deferred until the buffer has its final size.
+    std::vector<PendingAccessorData> pending;
+
     for (unsigned int idx_mesh = 0; idx_mesh < mScene->mNumMeshes; ++idx_mesh) {
         const aiMesh *aim = mScene->mMeshes[idx_mesh];
+        PreparedMesh &prepared = preparedMeshes[idx_mesh];
 
         std::string name = aim->mName.C_Str();
 
@@ -1192,21 +1375,23 @@ void glTF2Exporter::ExportMeshes() {
 
         /******************* Vertices ********************/
         Ref<Accessor> v = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mVertices, AttribType::VEC3,
-                AttribType::VEC3, ComponentType_FLOAT, BufferViewTarget_ARRAY_BUFFER);
+                AttribType::VEC3, ComponentType_FLOAT, BufferViewTarget_ARRAY_BUFFER, &pending);
         if (v) {
             p.attributes.position.push_back(v);
         }
 
         /******************** Normals ********************/
-        // Normalize all normals as the validator can emit a warning otherwise
-        if (nullptr != aim->mNormals) {
-            for (auto i = 0u; i < aim->mNumVertices; ++i) {
-                aim->mNormals[i].NormalizeSafe();
-            }
+        Ref<Accessor> n;
+        if (!prepared.normals.empty()) {
+            n = ExportData(*mAsset, meshId, b, aim->mNumVertices, prepared.normals.data(), AttribType::VEC4,
+                    AttribType::VEC3, ComponentType_BYTE, BufferViewTarget_ARRAY_BUFFER, &pending);
+            n->normalized = true;
+            mAsset->extensionsUsed.KHR_mesh_quantization = true;
+            mAsset->extensionsRequired.KHR_mesh_quantization = true;
+        } else {
+            n = ExportData(*mAsset, meshId, b, aim->mNumVertices, prepared.normalsF.empty() ? nullptr : prepared.normalsF.data(), AttribType::VEC3,
+                    AttribType::VEC3, ComponentType_FLOAT, BufferViewTarget_ARRAY_BUFFER, &pending);
         }
-
-        Ref<Accessor> n = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mNormals, AttribType::VEC3,
-                AttribType::VEC3, ComponentType_FLOAT, BufferViewTarget_ARRAY_BUFFER);
         if (n) {
             p.attributes.normal.push_back(n);
         }
@@ -1217,18 +1402,19 @@ void glTF2Exporter::ExportMeshes() {
                 continue;
             }
 
-            // Flip UV y coords
-            if (aim->mNumUVComponents[i] > 1) {
-                for (unsigned int j = 0; j < aim->mNumVertices; ++j) {
-                    aim->mTextureCoords[i][j].y = 1 - aim->mTextureCoords[i][j].y;
-                }
-            }
-
             if (aim->mNumUVComponents[i] > 0) {
                 AttribType::Value type = (aim->mNumUVComponents[i] == 2) ? AttribType::VEC2 : AttribType::VEC3;
 
-                Ref<Accessor> tc = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mTextureCoords[i],
-                        AttribType::VEC3, type, ComponentType_FLOAT, BufferViewTarget_ARRAY_BUFFER);
+                Ref<Accessor> tc;
+                if (!prepared.texCoords[i].empty()) {
+                    tc = ExportData(*mAsset, meshId, b, aim->mNumVertices, prepared.texCoords[i].data(),
+                            AttribType::VEC2, AttribType::VEC2, ComponentType_UNSIGNED_SHORT, BufferViewTarget_ARRAY_BUFFER, &pending);
+                    tc->normalized = true;
+                } else {
+                    tc = ExportData(*mAsset, meshId, b, aim->mNumVertices,
+                            prepared.texCoordsF[i].empty() ? aim->mTextureCoords[i] : prepared.texCoordsF[i].data(),
+                            AttribType::VEC3, type, ComponentType_FLOAT, BufferViewTarget_ARRAY_BUFFER, &pending);
+                }
                 if (tc) {
                     p.attributes.texcoord.push_back(tc);
                 }
@@ -1237,26 +1423,27 @@ void glTF2Exporter::ExportMeshes() {
 
         /*************** Vertex colors ****************/
         for (unsigned int indexColorChannel = 0; indexColorChannel < aim->GetNumColorChannels(); ++indexColorChannel) {
-            Ref<Accessor> c = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mColors[indexColorChannel],
-                    AttribType::VEC4, AttribType::VEC4, ComponentType_FLOAT, BufferViewTarget_ARRAY_BUFFER);
+            Ref<Accessor> c;
+            if (!prepared.colors[indexColorChannel].empty()) {
+                c = ExportData(*mAsset, meshId, b, aim->mNumVertices, prepared.colors[indexColorChannel].data(),
+                        AttribType::VEC4, AttribType::VEC4, ComponentType_UNSIGNED_SHORT, BufferViewTarget_ARRAY_BUFFER, &pending);
+                c->normalized = true;
+            } else {
+                c = ExportData(*mAsset, meshId, b, aim->mNumVertices, aim->mColors[indexColorChannel],
+                        AttribType::VEC4, AttribType::VEC4, ComponentType_FLOAT, BufferViewTarget_ARRAY_BUFFER, &pending);
+            }
             if (c) {
                 p.attributes.color.push_back(c);
             }
         }
 
         /*************** Vertices indices ****************/
-        if (aim->mNumFaces > 0) {
-            std::vector<IndicesType> indices;
-            unsigned int nIndicesPerFace = aim->mFaces[0].mNumIndices;
-            indices.resize(aim->mNumFaces * nIndicesPerFace);
-            for (size_t i = 0; i < aim->mNumFaces; ++i) {
-                for (size_t j = 0; j < nIndicesPerFace; ++j) {
-                    indices[i * nIndicesPerFace + j] = IndicesType(aim->mFaces[i].mIndices[j]);
-                }
-            }
-
-            p.indices = ExportData(*mAsset, meshId, b, indices.size(), &indices[0], AttribType::SCALAR, AttribType::SCALAR,
-                    ComponentType_UNSIGNED_INT, BufferViewTarget_ELEMENT_ARRAY_BUFFER);
+        if (!prepared.indices16.empty()) {
+            p.indices = ExportData(*mAsset, meshId, b, prepared.indices16.size(), prepared.indices16.data(), AttribType::SCALAR, AttribType::SCALAR,
+                    ComponentType_UNSIGNED_SHORT, BufferViewTarget_ELEMENT_ARRAY_BUFFER, &pending);
+        } else if (!prepared.indices.empty()) {
+            p.indices = ExportData(*mAsset, meshId, b, prepared.indices.size(), prepared.indices.data(), AttribType::SCALAR, AttribType::SCALAR,
+                    ComponentType_UNSIGNED_INT, BufferViewTarget_ELEMENT_ARRAY_BUFFER, &pending);
         }
 
         switch (aim->mPrimitiveTypes) {
@@ -1291,13 +1478,6 @@ void glTF2Exporter::ExportMeshes() {
 
         /*************** Targets for blendshapes ****************/
         if (aim->mNumAnimMeshes > 0) {
-            bool bUseSparse = this->mProperties->HasPropertyBool("GLTF2_SPARSE_ACCESSOR_EXP") &&
-                              this->mProperties->GetPropertyBool("GLTF2_SPARSE_ACCESSOR_EXP");
-            bool bIncludeNormal = this->mProperties->HasPropertyBool("GLTF2_TARGET_NORMAL_EXP") &&
-                                  this->mProperties->GetPropertyBool("GLTF2_TARGET_NORMAL_EXP");
-            bool bExportTargetNames = this->mProperties->HasPropertyBool("GLTF2_TARGETNAMES_EXP") &&
-                                      this->mProperties->GetPropertyBool("GLTF2_TARGETNAMES_EXP");
-
             p.targets.resize(aim->mNumAnimMeshes);
             for (unsigned int am = 0; am < aim->mNumAnimMeshes; ++am) {
                 aiAnimMesh *pAnimMesh = aim->mAnimMeshes[am];
@@ -1305,48 +1485,39 @@ void glTF2Exporter::ExportMeshes() {
                     m->targetNames.emplace_back(pAnimMesh->mName.data);
                 }
                 // position
-                if (pAnimMesh->HasPositions()) {
-                    // NOTE: in gltf it is the diff stored
-                    aiVector3D *pPositionDiff = new aiVector3D[pAnimMesh->mNumVertices];
-                    for (unsigned int vt = 0; vt < pAnimMesh->mNumVertices; ++vt) {
-                        pPositionDiff[vt] = pAnimMesh->mVertices[vt] - aim->mVertices[vt];
-                    }
+                std::vector<aiVector3D> &positionDiff = prepared.positionDiffs[am];
+                if (!positionDiff.empty()) {
                     Ref<Accessor> vec;
                     if (bUseSparse) {
                         vec = ExportDataSparse(*mAsset, meshId, b,
-                                pAnimMesh->mNumVertices, pPositionDiff,
+                                pAnimMesh->mNumVertices, positionDiff.data(),
                                 AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT);
                     } else {
                         vec = ExportData(*mAsset, meshId, b,
-                                pAnimMesh->mNumVertices, pPositionDiff,
-                                AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT);
+                                pAnimMesh->mNumVertices, positionDiff.data(),
+                                AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT, BufferViewTarget_NONE, &pending);
                     }
                     if (vec) {
                         p.targets[am].position.push_back(vec);
                     }
-                    delete[] pPositionDiff;
                 }
 
                 // normal
-                if (pAnimMesh->HasNormals() && bIncludeNormal) {
-                    aiVector3D *pNormalDiff = new aiVector3D[pAnimMesh->mNumVertices];
-                    for (unsigned int vt = 0; vt < pAnimMesh->mNumVertices; ++vt) {
-                        pNormalDiff[vt] = pAnimMesh->mNormals[vt] - aim->mNormals[vt];
-                    }
+                std::vector<aiVector3D> &normalDiff = prepared.normalDiffs[am];
+                if (!normalDiff.empty()) {
                     Ref<Accessor> vec;
                     if (bUseSparse) {
                         vec = ExportDataSparse(*mAsset, meshId, b,
-                                pAnimMesh->mNumVertices, pNormalDiff,
+                                pAnimMesh->mNumVertices, normalDiff.data(),
                                 AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT);
                     } else {
                         vec = ExportData(*mAsset, meshId, b,
-                                pAnimMesh->mNumVertices, pNormalDiff,
-                                AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT);
+                                pAnimMesh->mNumVertices, normalDiff.data(),
+                                AttribType::VEC3, AttribType::VEC3, ComponentType_FLOAT, BufferViewTarget_NONE, &pending);
                     }
                     if (vec) {
                         p.targets[am].normal.push_back(vec);
                     }
-                    delete[] pNormalDiff;
                 }
 
                 // tangent?
@@ -1354,6 +1525,14 @@ void glTF2Exporter::ExportMeshes() {
         }
     }
 
+    //----------------------------------------
+    // The buffer doesn't grow any further, fill in the mesh data in parallel
+    ParallelFor(pending.size(), mNumThreads, [&pending](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            WriteAccessorData(pending[i]);
+        }
+    });
+
     //----------------------------------------
     // Finish the skin
     // Create the Accessor for skinRef->inverseBindMatrices
@@ -1400,6 +1579,119 @@ void glTF2Exporter::ExportMeshes() {
         }
         delete[] invBindMatrixData;
     }
+
+    if (bCompress) {
+        CompressBufferViews(b, firstView, firstAccessor, firstByte);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Encodes the buffer views from firstView on with EXT_meshopt_compression. Their data is at the
+// end of the buffer, starting at firstByte, and gets repacked: a compressed view moves to a fallback
+// buffer without data and only its encoded bytes stay in the buffer.
+void glTF2Exporter::CompressBufferViews(Ref<Buffer> &buffer, unsigned int firstView, unsigned int firstAccessor, size_t firstByte) {
+    struct EncodedView {
+        Ref<BufferView> view;
+        BufferView::MeshoptCompression meshopt;
+        std::vector<uint8_t> data;
+    };
+
+    // Any view that an accessor reads as a whole can be encoded
+    std::vector<EncodedView> encoded;
+    std::vector<int> encodedIndex(mAsset->bufferViews.Size() - firstView, -1);
+    for (unsigned int i = firstAccessor; i < mAsset->accessors.Size(); ++i) {
+        Ref<Accessor> acc = mAsset->accessors.Get(i);
+        Ref<BufferView> bv = acc->bufferView;
+        if (!bv || acc->sparse || bv->index < int(firstView) || bv->buffer->index != buffer->index ||
+                encodedIndex[bv->index - firstView] != -1 || acc->byteOffset != 0) {
+            continue;
+        }
+
+        EncodedView view;
+        view.view = bv;
+        view.meshopt.buffer = buffer;
+        view.meshopt.byteStride = bv->byteStride ? bv->byteStride : acc->GetElementSize();
+        view.meshopt.count = acc->count;
+        if (bv->target == BufferViewTarget_ELEMENT_ARRAY_BUFFER) {
+            view.meshopt.mode = MeshoptMode_INDICES;
+            if (view.meshopt.byteStride != 2 && view.meshopt.byteStride != 4) {
+                continue;
+            }
+        } else {
+            view.meshopt.mode = MeshoptMode_ATTRIBUTES;
+            if (view.meshopt.byteStride % 4 != 0 || view.meshopt.byteStride > 256) {
+                continue;
+            }
+        }
+        if (view.meshopt.count * view.meshopt.byteStride != bv->byteLength) {
+            continue;
+        }
+
+        encodedIndex[bv->index - firstView] = int(encoded.size());
+        encoded.push_back(std::move(view));
+    }
+
+    const uint8_t *source = buffer->GetPointer();
+    ParallelFor(encoded.size(), mNumThreads, [&encoded, source](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            EncodedView &view = encoded[i];
+            const uint8_t *viewData = source + view.view->byteOffset;
+            if (view.meshopt.mode == MeshoptMode_INDICES) {
+                Meshopt::EncodeIndexSequence(viewData, view.meshopt.count, view.meshopt.byteStride, view.data);
+            } else {
+                Meshopt::EncodeVertexBuffer(viewData, view.meshopt.count, view.meshopt.byteStride, view.data);
+            }
+        }
+    });
+
+    const bool anySmaller = std::any_of(encoded.begin(), encoded.end(), [](EncodedView &view) {
+        return view.data.size() < view.view->byteLength;
+    });
+    if (!anySmaller) {
+        return;
+    }
+
+    // Repack in view order, views that don't get any smaller keep their plain data
+    Ref<Buffer> fallback;
+    std::vector<uint8_t> packed;
+    for (unsigned int i = firstView; i < mAsset->bufferViews.Size(); ++i) {
+        Ref<BufferView> bv = mAsset->bufferViews.Get(i);
+        if (bv->buffer->index != buffer->index) {
+            continue;
+        }
+
+        packed.resize((firstByte + packed.size() + 3) / 4 * 4 - firstByte, 0);
+        const size_t offset = firstByte + packed.size();
+
+        const int index = encodedIndex[i - firstView];
+        if (index >= 0 && encoded[index].data.size() < bv->byteLength) {
+            EncodedView &view = encoded[index];
+            if (!fallback) {
+                fallback = mAsset->buffers.Create(mAsset->FindUniqueID("fallback", "buffer"));
+                fallback->meshoptFallback = true;
+            }
+
+            view.meshopt.byteOffset = offset;
+            view.meshopt.byteLength = view.data.size();
+            packed.insert(packed.end(), view.data.begin(), view.data.end());
+
+            bv->byteOffset = (fallback->byteLength + 3) & ~size_t(3);
+            fallback->byteLength = bv->byteOffset + bv->byteLength;
+            bv->buffer = fallback;
+            bv->meshopt.reset(new BufferView::MeshoptCompression(view.meshopt));
+        } else {
+            packed.insert(packed.end(), source + bv->byteOffset, source + bv->byteOffset + bv->byteLength);
+            bv->byteOffset = offset;
+        }
+    }
+
+    buffer->byteLength = firstByte;
+    if (!packed.empty()) {
+        buffer->AppendData(packed.data(), packed.size());
+    }
+
+    mAsset->extensionsUsed.EXT_meshopt_compression = true;
+    mAsset->extensionsRequired.EXT_meshopt_compression = true;
 }
 
 // Merges a node's multiple meshes (with one primitive each) into one mesh with multiple primitives
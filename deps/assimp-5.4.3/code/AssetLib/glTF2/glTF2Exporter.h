@@ -69,6 +69,7 @@ class Ref;
 namespace glTF2 {
 
 class Asset;
+struct Buffer;
 
 struct TexProperty;
 struct TextureInfo;
@@ -129,6 +130,7 @@ protected:
     void ExportMetadata();
     void ExportMaterials();
     void ExportMeshes();
+    void CompressBufferViews(glTFCommon::Ref<glTF2::Buffer> &buffer, unsigned int firstView, unsigned int firstAccessor, size_t firstByte);
     void MergeMeshes();
     unsigned int ExportNodeHierarchy(const aiNode *n);
     unsigned int ExportNode(const aiNode *node, glTFCommon::Ref<glTF2::Node> &parent);
@@ -144,6 +146,7 @@ private:
     std::shared_ptr<glTF2::Asset> mAsset;
     std::vector<unsigned char> mBodyData;
     ai_real configEpsilon;
+    unsigned int mNumThreads;
 };
 
 } // namespace Assimp
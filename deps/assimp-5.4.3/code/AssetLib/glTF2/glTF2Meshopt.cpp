@@ -0,0 +1,369 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+#ifndef ASSIMP_BUILD_NO_GLTF_IMPORTER
+
+#include "AssetLib/glTF2/glTF2Meshopt.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace glTF2 {
+namespace Meshopt {
+
+namespace {
+
+// ATTRIBUTES codec
+const uint8_t VertexHeader = 0xa0; // version 0
+const size_t VertexBlockSizeBytes = 8192;
+const size_t VertexBlockMaxSize = 256;
+const size_t ByteGroupSize = 16;
+const size_t TailMaxSize = 32;
+
+// INDICES codec
+const uint8_t SequenceHeader = 0xd0;
+const uint8_t SequenceVersion = 1;
+const size_t SequenceTailSize = 4;
+
+// Number of bits per value for each of the 2-bit group modes
+const int GroupBits[4] = { 0, 2, 4, 8 };
+
+size_t GetVertexBlockSize(size_t byteStride) {
+    size_t result = (VertexBlockSizeBytes / byteStride) & ~(ByteGroupSize - 1);
+    return std::min(result, VertexBlockMaxSize);
+}
+
+size_t GetVertexTailSize(size_t byteStride) {
+    return std::max(byteStride, TailMaxSize);
+}
+
+inline uint8_t ZigZag8(uint8_t v) {
+    return uint8_t((int8_t(v) >> 7) ^ (v << 1));
+}
+
+inline uint8_t UnZigZag8(uint8_t v) {
+    return uint8_t(-(v & 1) ^ (v >> 1));
+}
+
+inline uint32_t ZigZag32(uint32_t v) {
+    return (v << 1) ^ uint32_t(int32_t(v) >> 31);
+}
+
+inline uint32_t UnZigZag32(uint32_t v) {
+    return uint32_t(-int32_t(v & 1)) ^ (v >> 1);
+}
+
+// Encoded size of a group of 16 bytes with the given number of bits per value,
+// values that don't fit are stored as extra bytes behind the group
+size_t MeasureGroup(const uint8_t *group, int bits) {
+    if (bits == 0) {
+        for (size_t i = 0; i < ByteGroupSize; ++i) {
+            if (group[i] != 0) {
+                return ~size_t(0);
+            }
+        }
+        return 0;
+    }
+    if (bits == 8) {
+        return ByteGroupSize;
+    }
+
+    const unsigned int sentinel = (1u << bits) - 1;
+    size_t result = ByteGroupSize * bits / 8;
+    for (size_t i = 0; i < ByteGroupSize; ++i) {
+        result += group[i] >= sentinel;
+    }
+    return result;
+}
+
+void EncodeGroup(std::vector<uint8_t> &out, const uint8_t *group, int bits) {
+    if (bits == 0) {
+        return;
+    }
+    if (bits == 8) {
+        out.insert(out.end(), group, group + ByteGroupSize);
+        return;
+    }
+
+    const unsigned int sentinel = (1u << bits) - 1;
+    const size_t valuesPerByte = 8 / bits;
+    for (size_t i = 0; i < ByteGroupSize; i += valuesPerByte) {
+        unsigned int byte = 0;
+        for (size_t k = 0; k < valuesPerByte; ++k) {
+            byte = (byte << bits) | std::min<unsigned int>(group[i + k], sentinel);
+        }
+        out.push_back(uint8_t(byte));
+    }
+    for (size_t i = 0; i < ByteGroupSize; ++i) {
+        if (group[i] >= sentinel) {
+            out.push_back(group[i]);
+        }
+    }
+}
+
+// Encodes one byte plane of a block: the group modes first, then the groups
+void EncodeBytes(std::vector<uint8_t> &out, const uint8_t *bytes, size_t size) {
+    const size_t numGroups = size / ByteGroupSize;
+    const size_t headerOffset = out.size();
+    out.resize(out.size() + (numGroups + 3) / 4, 0);
+
+    for (size_t g = 0; g < numGroups; ++g) {
+        const uint8_t *group = bytes + g * ByteGroupSize;
+
+        int bestMode = 3;
+        size_t bestSize = MeasureGroup(group, GroupBits[bestMode]);
+        for (int mode = 0; mode < 3; ++mode) {
+            const size_t groupSize = MeasureGroup(group, GroupBits[mode]);
+            if (groupSize < bestSize) {
+                bestMode = mode;
+                bestSize = groupSize;
+            }
+        }
+
+        out[headerOffset + g / 4] |= uint8_t(bestMode << ((g % 4) * 2));
+        EncodeGroup(out, group, GroupBits[bestMode]);
+    }
+}
+
+const uint8_t *DecodeBytes(const uint8_t *data, const uint8_t *end, uint8_t *bytes, size_t size) {
+    const size_t numGroups = size / ByteGroupSize;
+    const size_t headerSize = (numGroups + 3) / 4;
+    if (size_t(end - data) < headerSize) {
+        return nullptr;
+    }
+    const uint8_t *header = data;
+    data += headerSize;
+
+    for (size_t g = 0; g < numGroups; ++g) {
+        uint8_t *group = bytes + g * ByteGroupSize;
+        const int bits = GroupBits[(header[g / 4] >> ((g % 4) * 2)) & 3];
+
+        if (bits == 0) {
+            memset(group, 0, ByteGroupSize);
+            continue;
+        }
+        if (bits == 8) {
+            if (size_t(end - data) < ByteGroupSize) {
+                return nullptr;
+            }
+            memcpy(group, data, ByteGroupSize);
+            data += ByteGroupSize;
+            continue;
+        }
+
+        const unsigned int sentinel = (1u << bits) - 1;
+        const size_t valuesPerByte = 8 / bits;
+        const size_t fixedSize = ByteGroupSize / valuesPerByte;
+        if (size_t(end - data) < fixedSize) {
+            return nullptr;
+        }
+        const uint8_t *extra = data + fixedSize;
+        for (size_t i = 0; i < fixedSize; ++i) {
+            unsigned int byte = data[i];
+            for (size_t k = 0; k < valuesPerByte; ++k) {
+                unsigned int value = (byte >> (8 - bits)) & sentinel;
+                byte <<= bits;
+                if (value == sentinel) {
+                    if (extra >= end) {
+                        return nullptr;
+                    }
+                    value = *extra++;
+                }
+                group[i * valuesPerByte + k] = uint8_t(value);
+            }
+        }
+        data = extra;
+    }
+    return data;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+void EncodeVertexBuffer(const uint8_t *data, size_t count, size_t byteStride, std::vector<uint8_t> &out) {
+    const size_t blockSize = GetVertexBlockSize(byteStride);
+
+    out.push_back(VertexHeader);
+
+    // Each byte of the element is delta coded against the previous element, the first
+    // element is the baseline and is stored in the tail
+    std::vector<uint8_t> lastVertex(data, data + (count ? byteStride : 0));
+    lastVertex.resize(byteStride, 0);
+    const std::vector<uint8_t> firstVertex = lastVertex;
+
+    uint8_t bytes[VertexBlockMaxSize];
+    for (size_t blockBegin = 0; blockBegin < count; blockBegin += blockSize) {
+        const size_t blockCount = std::min(blockSize, count - blockBegin);
+        const size_t paddedCount = (blockCount + ByteGroupSize - 1) & ~(ByteGroupSize - 1);
+        const uint8_t *block = data + blockBegin * byteStride;
+
+        for (size_t k = 0; k < byteStride; ++k) {
+            memset(bytes, 0, sizeof(bytes));
+            uint8_t previous = lastVertex[k];
+            for (size_t i = 0; i < blockCount; ++i) {
+                const uint8_t value = block[i * byteStride + k];
+                bytes[i] = ZigZag8(uint8_t(value - previous));
+                previous = value;
+            }
+            EncodeBytes(out, bytes, paddedCount);
+            lastVertex[k] = previous;
+        }
+    }
+
+    out.resize(out.size() + GetVertexTailSize(byteStride) - byteStride, 0);
+    out.insert(out.end(), firstVertex.begin(), firstVertex.end());
+}
+
+// ------------------------------------------------------------------------------------------------
+void EncodeIndexSequence(const uint8_t *data, size_t count, size_t byteStride, std::vector<uint8_t> &out) {
+    out.push_back(uint8_t(SequenceHeader | SequenceVersion));
+
+    // Two baselines, so that interleaved runs (e.g. strips of two rows) stay cheap
+    uint32_t last[2] = { 0, 0 };
+    int current = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t index;
+        if (byteStride == 2) {
+            uint16_t value;
+            memcpy(&value, data + i * 2, 2);
+            index = value;
+        } else {
+            memcpy(&index, data + i * 4, 4);
+        }
+
+        const int32_t toCurrent = int32_t(index - last[current]);
+        if ((toCurrent < 0 ? -int64_t(toCurrent) : int64_t(toCurrent)) >= 30) {
+            current ^= 1;
+        }
+
+        uint32_t value = (ZigZag32(index - last[current]) << 1) | uint32_t(current);
+        do {
+            out.push_back(uint8_t((value & 127) | (value > 127 ? 128 : 0)));
+            value >>= 7;
+        } while (value != 0);
+
+        last[current] = index;
+    }
+
+    out.resize(out.size() + SequenceTailSize, 0);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool DecodeVertexBuffer(uint8_t *dst, size_t count, size_t byteStride, const uint8_t *data, size_t size) {
+    if (byteStride == 0 || byteStride % 4 != 0 || byteStride > VertexBlockMaxSize) {
+        return false;
+    }
+    const size_t tailSize = GetVertexTailSize(byteStride);
+    if (size < 1 + tailSize || data[0] != VertexHeader) {
+        return false;
+    }
+
+    const uint8_t *end = data + size - tailSize;
+    std::vector<uint8_t> lastVertex(data + size - byteStride, data + size);
+    const size_t blockSize = GetVertexBlockSize(byteStride);
+
+    data += 1;
+    uint8_t bytes[VertexBlockMaxSize];
+    for (size_t blockBegin = 0; blockBegin < count; blockBegin += blockSize) {
+        const size_t blockCount = std::min(blockSize, count - blockBegin);
+        const size_t paddedCount = (blockCount + ByteGroupSize - 1) & ~(ByteGroupSize - 1);
+        uint8_t *block = dst + blockBegin * byteStride;
+
+        for (size_t k = 0; k < byteStride; ++k) {
+            data = DecodeBytes(data, end, bytes, paddedCount);
+            if (data == nullptr) {
+                return false;
+            }
+            uint8_t previous = lastVertex[k];
+            for (size_t i = 0; i < blockCount; ++i) {
+                previous = uint8_t(previous + UnZigZag8(bytes[i]));
+                block[i * byteStride + k] = previous;
+            }
+            lastVertex[k] = previous;
+        }
+    }
+    return data == end;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool DecodeIndexSequence(uint8_t *dst, size_t count, size_t byteStride, const uint8_t *data, size_t size) {
+    if (byteStride != 2 && byteStride != 4) {
+        return false;
+    }
+    // Version 0 and 1 streams only differ in the header
+    if (size < 1 + SequenceTailSize || (data[0] & 0xf0) != SequenceHeader || (data[0] & 0x0f) > SequenceVersion) {
+        return false;
+    }
+
+    const uint8_t *end = data + size - SequenceTailSize;
+    data += 1;
+
+    uint32_t last[2] = { 0, 0 };
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t value = 0;
+        for (unsigned int shift = 0;; shift += 7) {
+            if (data >= end || shift > 28) {
+                return false;
+            }
+            const uint8_t byte = *data++;
+            value |= uint32_t(byte & 127) << shift;
+            if ((byte & 128) == 0) {
+                break;
+            }
+        }
+
+        const int current = value & 1;
+        const uint32_t index = last[current] + UnZigZag32(value >> 1);
+        last[current] = index;
+
+        if (byteStride == 2) {
+            const uint16_t index16 = uint16_t(index);
+            memcpy(dst + i * 2, &index16, 2);
+        } else {
+            memcpy(dst + i * 4, &index, 4);
+        }
+    }
+    return data == end;
+}
+
+} // namespace Meshopt
+} // namespace glTF2
+
+#endif // ASSIMP_BUILD_NO_GLTF_IMPORTER
@@ -0,0 +1,83 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file glTF2Meshopt.h
+ *  Encoder and decoder for the buffer view codecs of EXT_meshopt_compression.
+ *
+ *  Only the byte streams are handled here, the glTF side (buffer views, fallback
+ *  buffers) lives in glTF2Asset and glTF2Exporter. The ATTRIBUTES codec (bitstream
+ *  version 0) and the INDICES codec are supported, filters and the TRIANGLES codec
+ *  are not.
+ */
+#ifndef GLTF2MESHOPT_H_INC
+#define GLTF2MESHOPT_H_INC
+
+#ifndef ASSIMP_BUILD_NO_GLTF_IMPORTER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace glTF2 {
+namespace Meshopt {
+
+//! Encodes count elements of byteStride bytes each with the ATTRIBUTES codec and appends
+//! the result to out. byteStride has to be a multiple of 4 and at most 256.
+void EncodeVertexBuffer(const uint8_t *data, size_t count, size_t byteStride, std::vector<uint8_t> &out);
+
+//! Encodes count indices of byteStride (2 or 4) bytes each with the INDICES codec and
+//! appends the result to out.
+void EncodeIndexSequence(const uint8_t *data, size_t count, size_t byteStride, std::vector<uint8_t> &out);
+
+//! Decodes an ATTRIBUTES stream into count * byteStride bytes at dst.
+//! Returns false if the stream is malformed or uses an unsupported bitstream version.
+bool DecodeVertexBuffer(uint8_t *dst, size_t count, size_t byteStride, const uint8_t *data, size_t size);
+
+//! Decodes an INDICES stream into count indices of byteStride bytes at dst.
+//! Returns false if the stream is malformed.
+bool DecodeIndexSequence(uint8_t *dst, size_t count, size_t byteStride, const uint8_t *data, size_t size);
+
+} // namespace Meshopt
+} // namespace glTF2
+
+#endif // ASSIMP_BUILD_NO_GLTF_IMPORTER
+
+#endif // GLTF2MESHOPT_H_INC
@@ -0,0 +1,125 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+----------------------------------------------------------------------
+*/
+
+/** @file  AllocationContext.h
+ *  @brief Per-import allocation statistics, see MemoryAllocator.
+ */
+#pragma once
+#ifndef AI_ALLOCATION_CONTEXT_H_INC
+#define AI_ALLOCATION_CONTEXT_H_INC
+
+#include <assimp/MemoryAllocator.hpp>
+
+#include <cstdint>
+
+namespace Assimp {
+
+struct ImporterPhase;
+
+// ---------------------------------------------------------------------------
+/** @brief The allocator of one import and the statistics of the tracked
+ *  allocations made for it, from any thread.
+ */
+class AllocationContext {
+public:
+    /// @brief Counters at the beginning of a phase, see BeginPhase().
+    struct Mark {
+        uint64_t mAllocations;
+        uint64_t mBytes;
+        int64_t mLive;
+    };
+
+    /// @brief The statistics. They are reference counted, every live
+    ///  allocation keeps the counters it was charged to.
+    struct Counters;
+
+    AllocationContext();
+    ~AllocationContext();
+
+    AllocationContext(const AllocationContext &) = delete;
+    AllocationContext &operator=(const AllocationContext &) = delete;
+
+    /// @brief Sets the allocator, nullptr selects the global heap.
+    void SetAllocator(MemoryAllocator *allocator);
+
+    /// @brief Returns the allocator, nullptr for the global heap.
+    MemoryAllocator *GetAllocator() const;
+
+    /// @brief Records an allocation of size bytes.
+    /// @return The counters to pass to OnFree() for it.
+    Counters *OnAllocate(size_t size);
+
+    /// @brief Records the release of size bytes and drops the reference
+    ///  taken by OnAllocate(). The context may be gone by then.
+    static void OnFree(Counters *counters, size_t size);
+
+    /// @brief Starts a phase. The peak is measured from here on.
+    Mark BeginPhase();
+
+    /// @brief Stores the statistics since mark in phase.
+    void EndPhase(const Mark &mark, ImporterPhase &phase) const;
+
+    /// @brief Returns the context bound to the calling thread, or nullptr.
+    static AllocationContext *GetCurrent();
+
+private:
+    MemoryAllocator *mAllocator = nullptr;
+    Counters *mCounters;
+};
+
+// ---------------------------------------------------------------------------
+/** @brief Binds a context to the calling thread for its lifetime, e.g.
+ *  during an import or in the worker threads of ParallelFor().
+ */
+class AllocationScope {
+public:
+    explicit AllocationScope(AllocationContext *context);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope &operator=(const AllocationScope &) = delete;
+
+private:
+    AllocationContext *mPrevious;
+};
+
+} // namespace Assimp
+
+#endif // AI_ALLOCATION_CONTEXT_H_INC
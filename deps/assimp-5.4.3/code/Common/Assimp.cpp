@@ -54,6 +54,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "CApi/CInterfaceIOWrapper.h"
 #include "Importer.h"
+#include "SceneNames.h"
 #include "ScenePrivate.h"
 
 #include <list>
@@ -512,6 +513,40 @@ void aiGetMemoryRequirements(const C_STRUCT aiScene *pIn,
     ASSIMP_END_EXCEPTION_REGION(void);
 }
 
+// ------------------------------------------------------------------------------------------------
+aiReturn aiBuildSceneNameTable(const C_STRUCT aiScene *pScene) {
+    ai_assert(nullptr != pScene);
+    ASSIMP_BEGIN_EXCEPTION_REGION();
+    if (pScene->mPrivate == nullptr) {
+        return AI_FAILURE;
+    }
+    InternSceneNames(pScene);
+    ASSIMP_END_EXCEPTION_REGION(aiReturn);
+    return AI_SUCCESS;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiStringHandle aiGetNameHandle(const C_STRUCT aiScene *pScene, const C_STRUCT aiString *pName) {
+    ai_assert(nullptr != pName);
+    const SceneNameTable *names = GetSceneNames(pScene);
+    return names != nullptr ? names->mStrings.Find(*pName) : AI_STRING_HANDLE_INVALID;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiStringHandle aiGetNodeNameHandle(const C_STRUCT aiScene *pScene, const C_STRUCT aiNode *pNode) {
+    ai_assert(nullptr != pNode);
+    return aiGetNameHandle(pScene, &pNode->mName);
+}
+
+// ------------------------------------------------------------------------------------------------
+const C_STRUCT aiNode *aiFindNodeByHandle(const C_STRUCT aiScene *pScene, aiStringHandle handle) {
+    const SceneNameTable *names = GetSceneNames(pScene);
+    if (names == nullptr || handle >= names->mNodes.size()) {
+        return nullptr;
+    }
+    return names->mNodes[handle];
+}
+
 // ------------------------------------------------------------------------------------------------
 ASSIMP_API const C_STRUCT aiTexture *aiGetEmbeddedTexture(const C_STRUCT aiScene *pIn, const char *filename) {
     return pIn->GetEmbeddedTexture(filename);
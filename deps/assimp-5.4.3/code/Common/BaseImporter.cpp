@@ -43,6 +43,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  @brief Implementation of BaseImporter
  */
 
+#include "BaseProcess.h"
 #include "FileSystemFilter.h"
 #include "Importer.h"
 #include <assimp/BaseImporter.h>
@@ -130,6 +131,11 @@ aiScene *BaseImporter::ReadFile(Importer *pImp, const std::string &pFile, IOSyst
     try {
         InternReadFile(pFile, sc.get(), &filter);
 
+        // importers which don't write index buffers themselves get them here
+        if (pImp->GetPropertyBool(AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER, false)) {
+            BaseProcess::CreateIndexBuffers(sc.get());
+        }
+
         // Calculate import scale hook - required because pImp not available anywhere else
         // passes scale into ScaleProcess
         UpdateImporterScale(pImp);
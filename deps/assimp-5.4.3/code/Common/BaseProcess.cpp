@@ -76,6 +76,9 @@ void BaseProcess::ExecuteOnScene(Importer *pImp) {
     }
 
     SetupProperties(pImp);
+    if (!SupportsIndexBuffer()) {
+        ReleaseIndexBuffers(pImp->Pimpl()->mScene);
+    }
 
     // catch exceptions thrown inside the PostProcess-Step
     try {
@@ -101,3 +104,26 @@ void BaseProcess::SetupProperties(const Importer * /*pImp*/) {
 bool BaseProcess::RequireVerboseFormat() const {
     return true;
 }
+
+// ------------------------------------------------------------------------------------------------
+bool BaseProcess::SupportsIndexBuffer() const {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::ReleaseIndexBuffers(aiScene *pScene) {
+    for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+        if (pScene->mMeshes[i] != nullptr) {
+            pScene->mMeshes[i]->ReleaseIndexBuffer();
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void BaseProcess::CreateIndexBuffers(aiScene *pScene) {
+    for (unsigned int i = 0; i < pScene->mNumMeshes; ++i) {
+        if (pScene->mMeshes[i] != nullptr) {
+            pScene->mMeshes[i]->CreateIndexBuffer();
+        }
+    }
+}
@@ -200,6 +200,24 @@ public:
      *  in verbose format. */
     virtual bool RequireVerboseFormat() const;
 
+    // -------------------------------------------------------------------
+    /** Check whether this step can work on meshes whose faces share one
+     *  index buffer (see aiMesh::mIndexBuffer). Steps which don't are
+     *  handed meshes with one index array per face. */
+    virtual bool SupportsIndexBuffer() const;
+
+    // -------------------------------------------------------------------
+    /** Gives each face of all meshes of the scene its own index array
+     *  again, see aiMesh::ReleaseIndexBuffer().
+     *  @param pScene The scene to work at. */
+    static void ReleaseIndexBuffers(aiScene *pScene);
+
+    // -------------------------------------------------------------------
+    /** Moves the face indices of all meshes of the scene into one index
+     *  buffer per mesh, see aiMesh::CreateIndexBuffer().
+     *  @param pScene The scene to work at. */
+    static void CreateIndexBuffers(aiScene *pScene);
+
     // -------------------------------------------------------------------
     /**
      * @brief Executes the post processing step on the given imported data.
@@ -104,9 +104,8 @@ bool DefaultIOSystem::Exists(const char *pFile) const {
     }
 #else
 	struct stat statbuf;
-    stat(pFile, &statbuf);
-    // test for a regular file
-    if (!S_ISREG(statbuf.st_mode)) {
+    // test for a regular file, statbuf is undefined if stat fails
+    if (stat(pFile, &statbuf) != 0 || !S_ISREG(statbuf.st_mode)) {
         return false;
     }
 #endif
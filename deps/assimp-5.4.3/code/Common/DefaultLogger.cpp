@@ -62,6 +62,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <mutex>
 #include <thread>
 std::mutex loggerMutex;
+
+// Guards the stream list and the repeated message state, importers running
+// on several threads share the one logger
+static std::mutex streamMutex;
+#define AI_LOCK_STREAMS() std::lock_guard<std::mutex> streamLock(streamMutex)
+#else
+#define AI_LOCK_STREAMS()
 #endif
 
 namespace Assimp {
@@ -323,6 +330,7 @@ bool DefaultLogger::attachStream(LogStream *pStream, unsigned int severity) {
         severity = Logger::Info | Logger::Err | Logger::Warn | Logger::Debugging;
     }
 
+    AI_LOCK_STREAMS();
     for (StreamIt it = m_StreamArray.begin();
             it != m_StreamArray.end();
             ++it) {
@@ -348,6 +356,7 @@ bool DefaultLogger::detachStream(LogStream *pStream, unsigned int severity) {
         severity = SeverityAll;
     }
 
+    AI_LOCK_STREAMS();
     bool res(false);
     for (StreamIt it = m_StreamArray.begin(); it != m_StreamArray.end(); ++it) {
         if ((*it)->m_pStream == pStream) {
@@ -386,6 +395,7 @@ DefaultLogger::~DefaultLogger() {
 //  Writes message to stream
 void DefaultLogger::WriteToStreams(const char *message, ErrorSeverity ErrorSev) {
     ai_assert(nullptr != message);
+    AI_LOCK_STREAMS();
 
     // Check whether this is a repeated message
     auto thisLen = ::strlen(message);
@@ -71,6 +71,7 @@ Here we implement only the C++ interface (Assimp::Exporter).
 #include "PostProcessing/PretransformVertices.h"
 
 #include <memory>
+#include <unordered_set>
 
 namespace Assimp {
 
@@ -361,6 +362,223 @@ const aiExportDataBlob* Exporter::ExportToBlob( const aiScene* pScene, const cha
     return pimpl->blob;
 }
 
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Parts of a scene the export pre-processing may write to. The exporters only get a const scene,
+// so every part that no step touches can be shared with the caller's scene instead of copied.
+enum ExportScenePart {
+    ExportScenePart_Meshes = 0x1, // meshes and the node graph
+    ExportScenePart_Materials = 0x2,
+    ExportScenePart_Textures = 0x4,
+    ExportScenePart_Animations = 0x8,
+    ExportScenePart_Lights = 0x10,
+    ExportScenePart_Cameras = 0x20,
+    ExportScenePart_ChangedMeshes = 0x40 // only the meshes IsMeshModified() reports
+};
+
+// ------------------------------------------------------------------------------------------------
+// Steps which work on one mesh at a time and leave the meshes they have nothing to do for
+// untouched. If no other step works on the meshes, only the meshes they change are copied.
+const unsigned int PerMeshSteps = aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_GenNormals |
+        aiProcess_GenSmoothNormals | aiProcess_ForceGenNormals;
+
+// ------------------------------------------------------------------------------------------------
+// Returns whether the per-mesh steps in pp would modify the mesh. This mirrors the checks the
+// steps do before they touch a mesh: TriangulateProcess::TriangulateMesh() skips meshes without
+// polygons, SortByPTypeProcess keeps meshes with a single primitive type (the exporter never
+// sets AI_CONFIG_PP_SBP_REMOVE), and the normal generators skip meshes which have normals or
+// no faces with a surface.
+bool IsMeshModified(const aiMesh *mesh, unsigned int pp) {
+    if (pp & aiProcess_Triangulate) {
+        if (mesh->mPrimitiveTypes != 0) {
+            if (mesh->mPrimitiveTypes & aiPrimitiveType_POLYGON) {
+                return true;
+            }
+        } else {
+            for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+                if (mesh->mFaces[i].mNumIndices != 3) {
+                    return true;
+                }
+            }
+        }
+    }
+    if (pp & aiProcess_SortByPType) {
+        const unsigned int types = mesh->mPrimitiveTypes &
+                (aiPrimitiveType_POINT | aiPrimitiveType_LINE | aiPrimitiveType_TRIANGLE | aiPrimitiveType_POLYGON);
+        if (types == 0 || (types & (types - 1)) != 0) {
+            return true;
+        }
+    }
+    if (pp & (aiProcess_GenNormals | aiProcess_GenSmoothNormals)) {
+        const bool keepsNormals = mesh->mNormals != nullptr && !(pp & aiProcess_ForceGenNormals);
+        if (!keepsNormals && (mesh->mPrimitiveTypes & (aiPrimitiveType_TRIANGLE | aiPrimitiveType_POLYGON))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns the ExportScenePart flags for the parts the given post-processing steps may modify.
+// This is conservative: every step but the validation and the per-mesh steps is assumed to
+// work on all meshes and the node graph, the other parts are only listed for the steps whose
+// sources touch them.
+unsigned int GetModifiedSceneParts(unsigned int pp) {
+    unsigned int parts = 0;
+    if (pp & ~(aiProcess_ValidateDataStructure | PerMeshSteps)) {
+        parts |= ExportScenePart_Meshes;
+    } else if (pp & PerMeshSteps) {
+        parts |= ExportScenePart_ChangedMeshes;
+    }
+    if (pp & (aiProcess_MakeLeftHanded | aiProcess_FlipUVs | aiProcess_GenUVCoords | aiProcess_TransformUVCoords |
+            aiProcess_RemoveRedundantMaterials | aiProcess_PreTransformVertices | aiProcess_EmbedTextures |
+            aiProcess_RemoveComponent)) {
+        parts |= ExportScenePart_Materials;
+    }
+    if (pp & (aiProcess_EmbedTextures | aiProcess_RemoveComponent)) {
+        parts |= ExportScenePart_Textures;
+    }
+    if (pp & (aiProcess_MakeLeftHanded | aiProcess_FindInvalidData | aiProcess_PreTransformVertices |
+            aiProcess_OptimizeGraph | aiProcess_GlobalScale | aiProcess_RemoveComponent)) {
+        parts |= ExportScenePart_Animations;
+    }
+    if (pp & (aiProcess_PreTransformVertices | aiProcess_OptimizeGraph | aiProcess_RemoveComponent)) {
+        parts |= ExportScenePart_Lights;
+    }
+    if (pp & (aiProcess_MakeLeftHanded | aiProcess_PreTransformVertices | aiProcess_OptimizeGraph |
+            aiProcess_RemoveComponent)) {
+        parts |= ExportScenePart_Cameras;
+    }
+    return parts;
+}
+
+// ------------------------------------------------------------------------------------------------
+template <typename Type>
+void CopyOrShareArray(Type **&dest, unsigned int &destNum, Type *const *src, unsigned int num, bool copy) {
+    destNum = num;
+    if (!copy || nullptr == src) {
+        dest = const_cast<Type **>(src);
+        return;
+    }
+    dest = new Type *[num];
+    for (unsigned int i = 0; i < num; ++i) {
+        SceneCombiner::Copy(&dest[i], src[i]);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// The scene handed to the pre-processing steps and the exporter. Parts listed in the copy mask
+// are deep copies owned by this scene, all others point into the source scene and are detached
+// again before the scene is destroyed. With ExportScenePart_ChangedMeshes the mesh array is
+// owned, but only holds copies of the meshes the steps in pp change.
+class ExportScene {
+public:
+    ExportScene(const aiScene *src, unsigned int copiedParts, unsigned int pp) :
+            mScene(new aiScene()), mCopiedParts(copiedParts), mOwnsRootNode(false) {
+        const bool copyMeshes = (copiedParts & ExportScenePart_Meshes) != 0;
+        mScene->mFlags = src->mFlags;
+        mScene->mName = src->mName;
+        if (copyMeshes) {
+            CopyOrShareArray(mScene->mMeshes, mScene->mNumMeshes, src->mMeshes, src->mNumMeshes, true);
+        } else if ((copiedParts & ExportScenePart_ChangedMeshes) && src->mMeshes != nullptr) {
+            // SortByPType writes the array and, if it splits a mesh, the node graph
+            mScene->mNumMeshes = src->mNumMeshes;
+            mScene->mMeshes = new aiMesh *[src->mNumMeshes];
+            for (unsigned int i = 0; i < src->mNumMeshes; ++i) {
+                if (IsMeshModified(src->mMeshes[i], pp)) {
+                    SceneCombiner::Copy(&mScene->mMeshes[i], src->mMeshes[i]);
+                    mOwnsRootNode = mOwnsRootNode || IsMeshModified(src->mMeshes[i], pp & aiProcess_SortByPType);
+                } else {
+                    mScene->mMeshes[i] = src->mMeshes[i];
+                    mSharedMeshes.insert(src->mMeshes[i]);
+                }
+            }
+        } else {
+            CopyOrShareArray(mScene->mMeshes, mScene->mNumMeshes, src->mMeshes, src->mNumMeshes, false);
+        }
+        mOwnsRootNode = mOwnsRootNode || copyMeshes;
+        if (mOwnsRootNode) {
+            SceneCombiner::Copy(&mScene->mRootNode, src->mRootNode);
+        } else {
+            mScene->mRootNode = src->mRootNode;
+        }
+        CopyOrShareArray(mScene->mMaterials, mScene->mNumMaterials, src->mMaterials, src->mNumMaterials,
+                (copiedParts & ExportScenePart_Materials) != 0);
+        CopyOrShareArray(mScene->mTextures, mScene->mNumTextures, src->mTextures, src->mNumTextures,
+                (copiedParts & ExportScenePart_Textures) != 0);
+        CopyOrShareArray(mScene->mAnimations, mScene->mNumAnimations, src->mAnimations, src->mNumAnimations,
+                (copiedParts & ExportScenePart_Animations) != 0);
+        CopyOrShareArray(mScene->mLights, mScene->mNumLights, src->mLights, src->mNumLights,
+                (copiedParts & ExportScenePart_Lights) != 0);
+        CopyOrShareArray(mScene->mCameras, mScene->mNumCameras, src->mCameras, src->mNumCameras,
+                (copiedParts & ExportScenePart_Cameras) != 0);
+
+        // no step touches these
+        mScene->mMetaData = src->mMetaData;
+        mScene->mSkeletons = src->mSkeletons;
+        mScene->mNumSkeletons = src->mNumSkeletons;
+
+        // source private data might be nullptr if the scene is user-allocated
+        const ScenePrivateData *priv = ScenePriv(src);
+        if (priv != nullptr) {
+            ScenePriv(mScene)->mPPStepsApplied = priv->mPPStepsApplied;
+        }
+    }
+
+    ~ExportScene() {
+        if (!mOwnsRootNode) {
+            mScene->mRootNode = nullptr;
+        }
+        if (mCopiedParts & ExportScenePart_ChangedMeshes) {
+            // the steps may have moved the shared meshes around, but never freed them
+            for (unsigned int i = 0; mScene->mMeshes != nullptr && i < mScene->mNumMeshes; ++i) {
+                if (mSharedMeshes.count(mScene->mMeshes[i]) != 0) {
+                    mScene->mMeshes[i] = nullptr;
+                }
+            }
+        } else if (!(mCopiedParts & ExportScenePart_Meshes)) {
+            Detach(mScene->mMeshes, mScene->mNumMeshes);
+        }
+        if (!(mCopiedParts & ExportScenePart_Materials)) {
+            Detach(mScene->mMaterials, mScene->mNumMaterials);
+        }
+        if (!(mCopiedParts & ExportScenePart_Textures)) {
+            Detach(mScene->mTextures, mScene->mNumTextures);
+        }
+        if (!(mCopiedParts & ExportScenePart_Animations)) {
+            Detach(mScene->mAnimations, mScene->mNumAnimations);
+        }
+        if (!(mCopiedParts & ExportScenePart_Lights)) {
+            Detach(mScene->mLights, mScene->mNumLights);
+        }
+        if (!(mCopiedParts & ExportScenePart_Cameras)) {
+            Detach(mScene->mCameras, mScene->mNumCameras);
+        }
+        mScene->mMetaData = nullptr;
+        Detach(mScene->mSkeletons, mScene->mNumSkeletons);
+        delete mScene;
+    }
+
+    aiScene *get() const {
+        return mScene;
+    }
+
+private:
+    template <typename Type>
+    static void Detach(Type **&array, unsigned int &num) {
+        array = nullptr;
+        num = 0;
+    }
+
+    aiScene *mScene;
+    unsigned int mCopiedParts;
+    bool mOwnsRootNode;
+    std::unordered_set<const aiMesh *> mSharedMeshes;
+};
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 aiReturn Exporter::Export( const aiScene* pScene, const char* pFormatId, const char* pPath,
         unsigned int pPreprocessing, const ExportProperties* pProperties) {
@@ -379,14 +597,6 @@ aiReturn Exporter::Export( const aiScene* pScene, const char* pFormatId, const c
         const Exporter::ExportFormatEntry& exp = pimpl->mExporters[i];
         if (!strcmp(exp.mDescription.id,pFormatId)) {
             try {
-                // Always create a full copy of the scene. We might optimize this one day,
-                // but for now it is the most pragmatic way.
-                aiScene* scenecopy_tmp = nullptr;
-                SceneCombiner::CopyScene(&scenecopy_tmp,pScene);
-
-                pimpl->mProgressHandler->UpdateFileWrite(1, 4);
-
-                std::unique_ptr<aiScene> scenecopy(scenecopy_tmp);
                 const ScenePrivateData* const priv = ScenePriv(pScene);
 
                 // steps that are not idempotent, i.e. we might need to run them again, usually to get back to the
@@ -408,9 +618,8 @@ aiReturn Exporter::Export( const aiScene* pScene, const char* pFormatId, const c
 
                 // If the input scene is not in verbose format, but there is at least post-processing step that relies on it,
                 // we need to run the MakeVerboseFormat step first.
-                bool must_join_again = false;
+                bool verbosify = false;
                 if (!is_verbose_format) {
-                    bool verbosify = false;
                     for( unsigned int a = 0; a < pimpl->mPostProcessingSteps.size(); a++) {
                         BaseProcess* const p = pimpl->mPostProcessingSteps[a];
 
@@ -419,16 +628,28 @@ aiReturn Exporter::Export( const aiScene* pScene, const char* pFormatId, const c
                             break;
                         }
                     }
+                    verbosify = verbosify || (exp.mEnforcePP & aiProcess_JoinIdenticalVertices);
+                }
 
-                    if (verbosify || (exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
-                        ASSIMP_LOG_DEBUG("export: Scene data not in verbose format, applying MakeVerboseFormat step first");
+                // Only copy what the steps below may modify, the rest of the scene is shared with
+                // the caller's one. The exporters themselves must not modify their input.
+                unsigned int copiedParts = GetModifiedSceneParts(pp);
+                if (verbosify) {
+                    copiedParts = (copiedParts & ~ExportScenePart_ChangedMeshes) | ExportScenePart_Meshes;
+                }
+                ExportScene scenecopy(pScene, copiedParts, pp);
 
-                        MakeVerboseFormatProcess proc;
-                        proc.Execute(scenecopy.get());
+                pimpl->mProgressHandler->UpdateFileWrite(1, 4);
 
-                        if(!(exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
-                            must_join_again = true;
-                        }
+                bool must_join_again = false;
+                if (verbosify) {
+                    ASSIMP_LOG_DEBUG("export: Scene data not in verbose format, applying MakeVerboseFormat step first");
+
+                    MakeVerboseFormatProcess proc;
+                    proc.Execute(scenecopy.get());
+
+                    if(!(exp.mEnforcePP & aiProcess_JoinIdenticalVertices)) {
+                        must_join_again = true;
                     }
                 }
 
@@ -473,6 +694,9 @@ aiReturn Exporter::Export( const aiScene* pScene, const char* pFormatId, const c
                             if (dynamic_cast<PretransformVertices*>(p) && exportPointCloud) {
                                 continue;
                             }
+                            if (!p->SupportsIndexBuffer()) {
+                                BaseProcess::ReleaseIndexBuffers(scenecopy.get());
+                            }
                             p->Execute(scenecopy.get());
                         }
                     }
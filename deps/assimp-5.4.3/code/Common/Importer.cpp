@@ -68,6 +68,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PostProcessing/ProcessHelper.h"
 #include "Common/ScenePreprocessor.h"
 #include "Common/ScenePrivate.h"
+#include "Common/SceneNames.h"
+#include "Material/MaterialSystem.h"
 
 #include <assimp/BaseImporter.h>
 #include <assimp/GenericProperty.h>
@@ -82,6 +84,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <set>
 #include <memory>
 #include <cctype>
+#include <chrono>
 
 #include <assimp/DefaultIOStream.h>
 #include <assimp/DefaultIOSystem.h>
@@ -144,6 +147,14 @@ void AllocateFromAssimpHeap::operator delete[] ( void* data)    {
     return ::operator delete[](data);
 }
 
+// ------------------------------------------------------------------------------------------------
+// Builds the lookup tables of materials whose property lists a loader assembled directly
+static void BuildMaterialPropertyIndices(const aiScene *scene) {
+    for (unsigned int i = 0; i < scene->mNumMaterials; ++i) {
+        BuildMaterialPropertyIndex(scene->mMaterials[i]);
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // Importer constructor.
 Importer::Importer()
@@ -363,6 +374,22 @@ bool Importer::IsDefaultProgressHandler() const {
     return pimpl->mIsDefaultProgressHandler;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Supplies a custom memory allocator
+void Importer::SetMemoryAllocator(MemoryAllocator *allocator) {
+    ai_assert(nullptr != pimpl);
+
+    pimpl->mAllocations.SetAllocator(allocator);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the currently set memory allocator
+MemoryAllocator *Importer::GetMemoryAllocator() const {
+    ai_assert(nullptr != pimpl);
+
+    return pimpl->mAllocations.GetAllocator();
+}
+
 // ------------------------------------------------------------------------------------------------
 // Validate post process step flags
 bool _ValidateFlags(unsigned int pFlags) {
@@ -377,6 +404,99 @@ bool _ValidateFlags(unsigned int pFlags) {
     return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+namespace {
+
+// Names of the aiProcess flags, indexed by bit
+const char *const PostProcessFlagNames[32] = {
+    "aiProcess_CalcTangentSpace",
+    "aiProcess_JoinIdenticalVertices",
+    "aiProcess_MakeLeftHanded",
+    "aiProcess_Triangulate",
+    "aiProcess_RemoveComponent",
+    "aiProcess_GenNormals",
+    "aiProcess_GenSmoothNormals",
+    "aiProcess_SplitLargeMeshes",
+    "aiProcess_PreTransformVertices",
+    "aiProcess_LimitBoneWeights",
+    "aiProcess_ValidateDataStructure",
+    "aiProcess_ImproveCacheLocality",
+    "aiProcess_RemoveRedundantMaterials",
+    "aiProcess_FixInfacingNormals",
+    "aiProcess_PopulateArmatureData",
+    "aiProcess_SortByPType",
+    "aiProcess_FindDegenerates",
+    "aiProcess_FindInvalidData",
+    "aiProcess_GenUVCoords",
+    "aiProcess_TransformUVCoords",
+    "aiProcess_FindInstances",
+    "aiProcess_OptimizeMeshes",
+    "aiProcess_OptimizeGraph",
+    "aiProcess_FlipUVs",
+    "aiProcess_FlipWindingOrder",
+    "aiProcess_SplitByBoneCount",
+    "aiProcess_Debone",
+    "aiProcess_GlobalScale",
+    "aiProcess_EmbedTextures",
+    "aiProcess_ForceGenNormals",
+    "aiProcess_DropNormals",
+    "aiProcess_GenBoundingBoxes"
+};
+
+// A step is named after the first of the requested flags it reacts to,
+// except for the helpers shared by several steps
+const char *GetStepName(const BaseProcess *process, unsigned int pFlags) {
+    if (dynamic_cast<const ComputeSpatialSortProcess *>(process) != nullptr) {
+        return "ComputeSpatialSort";
+    }
+    if (dynamic_cast<const DestroySpatialSortProcess *>(process) != nullptr) {
+        return "DestroySpatialSort";
+    }
+    for (unsigned int bit = 0; bit < 32; ++bit) {
+        const unsigned int flag = 1u << bit;
+        if ((pFlags & flag) && process->IsActive(flag)) {
+            return PostProcessFlagNames[bit];
+        }
+    }
+    return "postprocess";
+}
+
+// Appends the time and memory spent in its scope to the phase list of an
+// importer. The list is reserved up front so the destructor does not need
+// to allocate.
+class PhaseTimer {
+public:
+    PhaseTimer(ImporterPimpl *pimpl, const char *name) :
+            mPimpl(pimpl), mName(name), mMark(pimpl->mAllocations.BeginPhase()), mStart(std::chrono::steady_clock::now()) {
+        // empty
+    }
+
+    ~PhaseTimer() {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStart;
+        ImporterPhase phase;
+        phase.mName = mName;
+        phase.mSeconds = elapsed.count();
+        mPimpl->mAllocations.EndPhase(mMark, phase);
+        mPimpl->mPhases.push_back(phase);
+    }
+
+private:
+    ImporterPimpl *mPimpl;
+    const char *mName;
+    AllocationContext::Mark mMark;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+// Writes the phases of the last import to the log
+void LogPhases(const std::vector<ImporterPhase> &phases) {
+    for (const ImporterPhase &phase : phases) {
+        ASSIMP_LOG_DEBUG("Phase ", phase.mName, ": ", phase.mSeconds * 1000.0, " ms, ", phase.mAllocations,
+                " allocations, ", phase.mAllocatedBytes, " bytes, peak ", phase.mPeakBytes, " bytes");
+    }
+}
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 // Free the current scene
 void Importer::FreeScene( ) {
@@ -609,6 +729,9 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags) {
             ASSIMP_LOG_DEBUG("(Deleting previous scene)");
             FreeScene();
         }
+        pimpl->mPhases.clear();
+        pimpl->mPhases.reserve(pimpl->mPostProcessingSteps.size() + 8);
+        AllocationScope allocationScope(&pimpl->mAllocations);
 
         // First check if the file is accessible at all
         if( !pimpl->mIOHandler->Exists( pFile)) {
@@ -706,7 +829,10 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags) {
             profiler->BeginRegion("import");
         }
 
-        pimpl->mScene = imp->ReadFile( this, pFile, pimpl->mIOHandler);
+        {
+            PhaseTimer phase(pimpl, "import");
+            pimpl->mScene = imp->ReadFile( this, pFile, pimpl->mIOHandler);
+        }
         pimpl->mProgressHandler->UpdateFileRead( fileSize, fileSize );
 
         if (profiler) {
@@ -727,8 +853,11 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags) {
 #ifndef ASSIMP_BUILD_NO_VALIDATEDS_PROCESS
             // The ValidateDS process is an exception. It is executed first, even before ScenePreprocessor is called.
             if (pFlags & aiProcess_ValidateDataStructure) {
-                ValidateDSProcess ds;
-                ds.ExecuteOnScene (this);
+                {
+                    PhaseTimer phase(pimpl, "validate");
+                    ValidateDSProcess ds;
+                    ds.ExecuteOnScene (this);
+                }
                 if (!pimpl->mScene) {
                     return nullptr;
                 }
@@ -740,8 +869,11 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags) {
                 profiler->BeginRegion("preprocess");
             }
 
-            ScenePreprocessor pre(pimpl->mScene);
-            pre.ProcessScene();
+            {
+                PhaseTimer phase(pimpl, "preprocess");
+                ScenePreprocessor pre(pimpl->mScene);
+                pre.ProcessScene();
+            }
 
             if (profiler) {
                 profiler->EndRegion("preprocess");
@@ -759,6 +891,16 @@ const aiScene* Importer::ReadFile( const char* _pFile, unsigned int pFlags) {
         // clear any data allocated by post-process steps
         pimpl->mPPShared->Clean();
 
+        if (pimpl->mScene) {
+            PhaseTimer phase(pimpl, "finalize");
+            if (GetPropertyBool(AI_CONFIG_IMPORT_INTERN_NAMES, false)) {
+                InternSceneNames(pimpl->mScene);
+            }
+            BuildMaterialPropertyIndices(pimpl->mScene);
+        }
+
+        LogPhases(pimpl->mPhases);
+
         if (profiler) {
             profiler->EndRegion("total");
         }
@@ -803,13 +945,18 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags) {
     // In debug builds: run basic flag validation
     ai_assert(_ValidateFlags(pFlags));
     ASSIMP_LOG_INFO("Entering post processing pipeline");
+    pimpl->mPhases.reserve(pimpl->mPhases.size() + pimpl->mPostProcessingSteps.size() + 2);
+    AllocationScope allocationScope(&pimpl->mAllocations);
 
 #ifndef ASSIMP_BUILD_NO_VALIDATEDS_PROCESS
     // The ValidateDS process plays an exceptional role. It isn't contained in the global
     // list of post-processing steps, so we need to call it manually.
     if (pFlags & aiProcess_ValidateDataStructure) {
-        ValidateDSProcess ds;
-        ds.ExecuteOnScene (this);
+        {
+            PhaseTimer phase(pimpl, "validate");
+            ValidateDSProcess ds;
+            ds.ExecuteOnScene (this);
+        }
         if (!pimpl->mScene) {
             return nullptr;
         }
@@ -838,7 +985,10 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags) {
                 profiler->BeginRegion("postprocess");
             }
 
-            process->ExecuteOnScene ( this );
+            {
+                PhaseTimer phase(pimpl, GetStepName(process, pFlags));
+                process->ExecuteOnScene ( this );
+            }
 
             if (profiler) {
                 profiler->EndRegion("postprocess");
@@ -871,7 +1021,17 @@ const aiScene* Importer::ApplyPostProcessing(unsigned int pFlags) {
 
     // update private scene flags
     if( pimpl->mScene ) {
+      PhaseTimer phase(pimpl, "finalize");
       ScenePriv(pimpl->mScene)->mPPStepsApplied |= pFlags;
+
+      // steps which rebuild faces have dropped the index buffers
+      if (GetPropertyBool(AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER, false)) {
+          BaseProcess::CreateIndexBuffers(pimpl->mScene);
+      }
+      if (ScenePriv(pimpl->mScene)->mNames != nullptr) {
+          InternSceneNames(pimpl->mScene);
+      }
+      BuildMaterialPropertyIndices(pimpl->mScene);
     }
 
     // clear any data allocated by post-process steps
@@ -939,6 +1099,16 @@ const aiScene* Importer::ApplyCustomizedPostProcessing( BaseProcess *rootProcess
         profiler->EndRegion( "postprocess" );
     }
 
+    if ( pimpl->mScene && GetPropertyBool( AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER, false ) ) {
+        BaseProcess::CreateIndexBuffers( pimpl->mScene );
+    }
+    if ( pimpl->mScene && ScenePriv( pimpl->mScene )->mNames != nullptr ) {
+        InternSceneNames( pimpl->mScene );
+    }
+    if ( pimpl->mScene ) {
+        BuildMaterialPropertyIndices( pimpl->mScene );
+    }
+
     // If the extra verbose mode is active, execute the ValidateDataStructureStep again - after each step
     if ( pimpl->bExtraVerbose || requestValidation  ) {
         ASSIMP_LOG_DEBUG( "Verbose Import: revalidating data structures" );
@@ -1174,6 +1344,25 @@ void AddNodeWeight(unsigned int& iScene,const aiNode* pcNode) {
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+// Get the number of timed import phases
+size_t Importer::GetPhaseCount() const {
+    ai_assert(nullptr != pimpl);
+
+    return pimpl->mPhases.size();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Get the timing of a single import phase
+const ImporterPhase *Importer::GetPhase(size_t index) const {
+    ai_assert(nullptr != pimpl);
+
+    if (index >= pimpl->mPhases.size()) {
+        return nullptr;
+    }
+    return &pimpl->mPhases[index];
+}
+
 // ------------------------------------------------------------------------------------------------
 // Get the memory requirements of the scene
 void Importer::GetMemoryRequirements(aiMemoryInfo& in) const {
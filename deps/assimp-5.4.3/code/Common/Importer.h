@@ -49,6 +49,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include <string>
 #include <assimp/matrix4x4.h>
+#include <assimp/Importer.hpp>
+#include "Common/AllocationContext.h"
 
 struct aiScene;
 
@@ -126,6 +128,12 @@ public:
     /** Used by post-process steps to share data */
     SharedPostProcessInfo* mPPShared;
 
+    /** Timings of the phases of the last import, in execution order */
+    std::vector<ImporterPhase> mPhases;
+
+    /** Custom allocator and allocation statistics of the imports */
+    AllocationContext mAllocations;
+
     /// The default class constructor.
     ImporterPimpl() AI_NO_EXCEPT;
 
@@ -149,7 +157,9 @@ inline ImporterPimpl::ImporterPimpl() AI_NO_EXCEPT :
         mMatrixProperties(),
         mPointerProperties(),
         bExtraVerbose( false ),
-        mPPShared( nullptr ) {
+        mPPShared( nullptr ),
+        mPhases(),
+        mAllocations() {
     // empty
 }
 //! @endcond
@@ -0,0 +1,210 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  MemoryAllocator.cpp
+ *  @brief Implementation of the default MemoryAllocator and the
+ *      allocation statistics of imports
+ */
+
+#include "AllocationContext.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/ai_assert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+struct AllocationContext::Counters {
+    std::atomic<uint64_t> mAllocations{ 0 };
+    std::atomic<uint64_t> mBytes{ 0 };
+    std::atomic<int64_t> mLive{ 0 };
+    std::atomic<int64_t> mPeak{ 0 };
+    std::atomic<uint32_t> mReferences{ 1 };
+
+    void Release() {
+        if (mReferences.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+};
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Forwards to the global heap
+class DefaultMemoryAllocator : public MemoryAllocator {
+public:
+    void *Allocate(size_t size, size_t /*alignment*/) override {
+        return ::operator new(size);
+    }
+
+    void Free(void *data, size_t /*size*/, size_t /*alignment*/) override {
+        ::operator delete(data);
+    }
+};
+
+DefaultMemoryAllocator defaultAllocator;
+
+thread_local AllocationContext *currentContext = nullptr;
+
+// Tracked blocks start with a header holding the counters they were charged to,
+// so a block released on another thread, during another import or after its
+// importer is gone is still credited to the import which allocated it
+constexpr size_t TrackedHeaderSize = alignof(std::max_align_t);
+static_assert(sizeof(AllocationContext::Counters *) <= TrackedHeaderSize, "header too small");
+
+size_t GetTrackedAlignment(size_t alignment) {
+    return std::max(alignment, alignof(AllocationContext::Counters *));
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+MemoryAllocator *MemoryAllocator::GetCurrent() {
+    MemoryAllocator *allocator = currentContext ? currentContext->GetAllocator() : nullptr;
+    return allocator ? allocator : &defaultAllocator;
+}
+
+// ------------------------------------------------------------------------------------------------
+void *MemoryAllocator::AllocateTracked(MemoryAllocator *allocator, size_t size, size_t alignment) {
+    ai_assert(alignment <= TrackedHeaderSize);
+    MemoryAllocator *source = allocator ? allocator : &defaultAllocator;
+    uint8_t *block = static_cast<uint8_t *>(source->Allocate(size + TrackedHeaderSize, GetTrackedAlignment(alignment)));
+    AllocationContext::Counters *counters = currentContext ? currentContext->OnAllocate(size) : nullptr;
+    ::memcpy(block, &counters, sizeof(counters));
+    return block + TrackedHeaderSize;
+}
+
+// ------------------------------------------------------------------------------------------------
+void MemoryAllocator::FreeTracked(MemoryAllocator *allocator, void *data, size_t size, size_t alignment) {
+    if (data == nullptr) {
+        return;
+    }
+    uint8_t *block = static_cast<uint8_t *>(data) - TrackedHeaderSize;
+    AllocationContext::Counters *counters;
+    ::memcpy(&counters, block, sizeof(counters));
+    if (counters) {
+        AllocationContext::OnFree(counters, size);
+    }
+    (allocator ? allocator : &defaultAllocator)->Free(block, size + TrackedHeaderSize, GetTrackedAlignment(alignment));
+}
+
+// ------------------------------------------------------------------------------------------------
+AllocationContext::AllocationContext() :
+        mCounters(new Counters) {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+AllocationContext::~AllocationContext() {
+    mCounters->Release();
+}
+
+// ------------------------------------------------------------------------------------------------
+void AllocationContext::SetAllocator(MemoryAllocator *allocator) {
+    mAllocator = allocator;
+}
+
+// ------------------------------------------------------------------------------------------------
+MemoryAllocator *AllocationContext::GetAllocator() const {
+    return mAllocator;
+}
+
+// ------------------------------------------------------------------------------------------------
+AllocationContext::Counters *AllocationContext::OnAllocate(size_t size) {
+    Counters &c = *mCounters;
+    c.mReferences.fetch_add(1, std::memory_order_relaxed);
+    c.mAllocations.fetch_add(1, std::memory_order_relaxed);
+    c.mBytes.fetch_add(size, std::memory_order_relaxed);
+    const int64_t live = c.mLive.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+    int64_t peak = c.mPeak.load(std::memory_order_relaxed);
+    while (live > peak && !c.mPeak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        // peak was reloaded, try again
+    }
+    return mCounters;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AllocationContext::OnFree(Counters *counters, size_t size) {
+    counters->mLive.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+    counters->Release();
+}
+
+// ------------------------------------------------------------------------------------------------
+AllocationContext::Mark AllocationContext::BeginPhase() {
+    Mark mark;
+    mark.mAllocations = mCounters->mAllocations.load(std::memory_order_relaxed);
+    mark.mBytes = mCounters->mBytes.load(std::memory_order_relaxed);
+    mark.mLive = mCounters->mLive.load(std::memory_order_relaxed);
+    mCounters->mPeak.store(mark.mLive, std::memory_order_relaxed);
+    return mark;
+}
+
+// ------------------------------------------------------------------------------------------------
+void AllocationContext::EndPhase(const Mark &mark, ImporterPhase &phase) const {
+    phase.mAllocations = static_cast<size_t>(mCounters->mAllocations.load(std::memory_order_relaxed) - mark.mAllocations);
+    phase.mAllocatedBytes = static_cast<size_t>(mCounters->mBytes.load(std::memory_order_relaxed) - mark.mBytes);
+    const int64_t peak = mCounters->mPeak.load(std::memory_order_relaxed) - mark.mLive;
+    phase.mPeakBytes = peak > 0 ? static_cast<size_t>(peak) : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+AllocationContext *AllocationContext::GetCurrent() {
+    return currentContext;
+}
+
+// ------------------------------------------------------------------------------------------------
+AllocationScope::AllocationScope(AllocationContext *context) :
+        mPrevious(currentContext) {
+    currentContext = context;
+}
+
+// ------------------------------------------------------------------------------------------------
+AllocationScope::~AllocationScope() {
+    currentContext = mPrevious;
+}
+
+} // namespace Assimp
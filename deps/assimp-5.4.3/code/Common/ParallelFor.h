@@ -0,0 +1,148 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+----------------------------------------------------------------------
+*/
+
+/** @file  ParallelFor.h
+ *  @brief A minimal helper to spread independent work items over a couple
+ *      of worker threads. Used by importers and exporters whose work is
+ *      trivially divisible (i.e. per chunk, per entity or per mesh).
+ */
+#pragma once
+#ifndef AI_PARALLEL_FOR_H_INC
+#define AI_PARALLEL_FOR_H_INC
+
+#include "Common/AllocationContext.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace Assimp {
+
+/// @brief Returns the number of worker threads to use for a parallel section.
+/// @param requested    The number of threads requested by the user, usually
+///                     taken from AI_CONFIG_GLOB_NUM_THREADS. Values < 1 select
+///                     the number of hardware threads.
+/// @return The number of threads, always >= 1.
+inline unsigned int GetWorkerThreadCount(int requested) {
+    if (requested > 0) {
+        return static_cast<unsigned int>(requested);
+    }
+    const unsigned int hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1u;
+}
+
+/// @brief Invokes func(begin, end) for consecutive ranges covering [0, count).
+///
+/// Ranges are handed out dynamically to up to numThreads threads, the calling
+/// thread being one of them. Each index is visited exactly once. If any
+/// invocation throws, remaining ranges are skipped and the first exception
+/// is rethrown on the calling thread once all workers have finished.
+/// Allocations of the workers count towards the import of the calling thread.
+/// @param count        The number of work items.
+/// @param numThreads   The maximum number of threads, 1 runs everything inline.
+/// @param func         Callable with the signature void(size_t begin, size_t end).
+/// @param grain        The minimum number of items per range.
+template <typename TFunc>
+inline void ParallelFor(size_t count, unsigned int numThreads, TFunc func, size_t grain = 1) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    const size_t maxThreads = (count + grain - 1) / grain;
+    const unsigned int threads = static_cast<unsigned int>(std::min<size_t>(std::max(numThreads, 1u), maxThreads));
+    if (threads == 1) {
+        func(static_cast<size_t>(0), count);
+        return;
+    }
+
+    // a few ranges per thread to even out imbalanced work items
+    const size_t step = std::max(grain, count / (static_cast<size_t>(threads) * 4));
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    AllocationContext *const allocations = AllocationContext::GetCurrent();
+
+    auto worker = [&]() {
+        AllocationScope allocationScope(allocations);
+        for (;;) {
+            const size_t begin = next.fetch_add(step);
+            if (begin >= count || failed.load()) {
+                return;
+            }
+            try {
+                func(begin, std::min(begin + step, count));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned int i = 1; i < threads; ++i) {
+        try {
+            pool.emplace_back(worker);
+        } catch (const std::system_error &) {
+            // out of threads, continue with the ones we already have
+            break;
+        }
+    }
+    worker();
+    for (std::thread &t : pool) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace Assimp
+
+#endif // AI_PARALLEL_FOR_H_INC
@@ -0,0 +1,374 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+----------------------------------------------------------------------
+*/
+
+/** @file  PointCloud.cpp
+ *  @brief Implementation of the point cloud helpers
+ */
+#include "PointCloud.h"
+
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/metadata.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Assimp {
+
+namespace {
+
+// the deepest octree whose cell coordinates still fit into a 63 bit morton code
+static constexpr unsigned int MaxOctreeDepth = 21;
+
+// ------------------------------------------------------------------------------------------------
+// Replaces a vertex channel by the given selection of its elements
+template <typename T>
+void Reorder(T *&channel, const std::vector<unsigned int> &order) {
+    if (nullptr == channel) {
+        return;
+    }
+    T *out = new T[order.size()];
+    for (size_t i = 0; i < order.size(); ++i) {
+        out[i] = channel[order[i]];
+    }
+    delete[] channel;
+    channel = out;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ReorderMesh(aiMesh *mesh, const std::vector<unsigned int> &order) {
+    Reorder(mesh->mVertices, order);
+    Reorder(mesh->mNormals, order);
+    Reorder(mesh->mTangents, order);
+    Reorder(mesh->mBitangents, order);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+        Reorder(mesh->mColors[i], order);
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        Reorder(mesh->mTextureCoords[i], order);
+    }
+    mesh->mNumVertices = static_cast<unsigned int>(order.size());
+}
+
+// ------------------------------------------------------------------------------------------------
+// Drops all points with a NaN or infinite coordinate, which cannot be placed in a grid.
+// Returns false if no finite point is left.
+bool RemoveNonFinitePoints(aiMesh *mesh) {
+    std::vector<unsigned int> finite;
+    finite.reserve(mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        const aiVector3D &v = mesh->mVertices[i];
+        if (std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z)) {
+            finite.push_back(i);
+        }
+    }
+    if (finite.size() == mesh->mNumVertices) {
+        return true;
+    }
+    if (finite.empty()) {
+        ASSIMP_LOG_WARN("PointCloud: all points of mesh ", mesh->mName.C_Str(), " have non-finite coordinates");
+        return false;
+    }
+    ASSIMP_LOG_WARN("PointCloud: dropping ", mesh->mNumVertices - finite.size(), " points with non-finite coordinates");
+    ReorderMesh(mesh, finite);
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Replaces a vertex channel by the averages over the given groups of elements
+template <typename T>
+void Average(T *&channel, const std::vector<unsigned int> &order, const std::vector<unsigned int> &groups) {
+    if (nullptr == channel) {
+        return;
+    }
+    T *out = new T[groups.size() - 1];
+    for (size_t g = 0; g + 1 < groups.size(); ++g) {
+        T sum = channel[order[groups[g]]];
+        for (unsigned int i = groups[g] + 1; i < groups[g + 1]; ++i) {
+            sum = sum + channel[order[i]];
+        }
+        out[g] = sum / static_cast<ai_real>(groups[g + 1] - groups[g]);
+    }
+    delete[] channel;
+    channel = out;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Merges all points within one cell of a voxel grid
+void DownsampleMesh(aiMesh *mesh, ai_real voxelSize) {
+    aiVector3D min = mesh->mVertices[0];
+    for (unsigned int i = 1; i < mesh->mNumVertices; ++i) {
+        min = aiVector3D(std::min(min.x, mesh->mVertices[i].x), std::min(min.y, mesh->mVertices[i].y),
+                std::min(min.z, mesh->mVertices[i].z));
+    }
+
+    struct Cell {
+        int64_t x, y, z;
+        bool operator<(const Cell &o) const {
+            return x != o.x ? x < o.x : (y != o.y ? y < o.y : z < o.z);
+        }
+        bool operator!=(const Cell &o) const {
+            return x != o.x || y != o.y || z != o.z;
+        }
+    };
+    // cell coordinates are computed in double precision and clamped, a tiny voxel
+    // size over a large extent must not overflow the integer conversion
+    const double inv = 1.0 / static_cast<double>(voxelSize);
+    const double maxCell = static_cast<double>(INT64_MAX / 2);
+    auto cellOf = [&](ai_real value, ai_real origin) {
+        const double rel = (static_cast<double>(value) - static_cast<double>(origin)) * inv;
+        return static_cast<int64_t>(std::min(std::floor(rel), maxCell));
+    };
+    std::vector<Cell> cells(mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        const aiVector3D &v = mesh->mVertices[i];
+        cells[i] = { cellOf(v.x, min.x), cellOf(v.y, min.y), cellOf(v.z, min.z) };
+    }
+
+    // group the points by cell, a stable sort keeps the result reproducible
+    std::vector<unsigned int> order(mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&cells](unsigned int a, unsigned int b) {
+        return cells[a] < cells[b];
+    });
+    std::vector<unsigned int> groups;
+    groups.reserve(mesh->mNumVertices / 2 + 2);
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        if (0 == i || cells[order[i]] != cells[order[i - 1]]) {
+            groups.push_back(i);
+        }
+    }
+    groups.push_back(mesh->mNumVertices);
+    if (groups.size() - 1 == mesh->mNumVertices) {
+        return;
+    }
+    cells.clear();
+    cells.shrink_to_fit();
+
+    Average(mesh->mVertices, order, groups);
+    Average(mesh->mNormals, order, groups);
+    Average(mesh->mTangents, order, groups);
+    Average(mesh->mBitangents, order, groups);
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_COLOR_SETS; ++i) {
+        Average(mesh->mColors[i], order, groups);
+    }
+    for (unsigned int i = 0; i < AI_MAX_NUMBER_OF_TEXTURECOORDS; ++i) {
+        Average(mesh->mTextureCoords[i], order, groups);
+    }
+    ASSIMP_LOG_DEBUG("PointCloud: downsampled ", mesh->mNumVertices, " points to ", groups.size() - 1);
+    mesh->mNumVertices = static_cast<unsigned int>(groups.size() - 1);
+
+    // averaged direction vectors are not normalized
+    if (mesh->mNormals) {
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            mesh->mNormals[i].NormalizeSafe();
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Spreads the lower 21 bits of a value to every third bit
+inline uint64_t SpreadBits(uint64_t v) {
+    v &= 0x1fffff;
+    v = (v | (v << 32)) & 0x1f00000000ffffull;
+    v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+    v = (v | (v << 8)) & 0x100f00f00f00f00full;
+    v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+    v = (v | (v << 2)) & 0x1249249249249249ull;
+    return v;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Sorts the points into octree level of detail order, returns the end offset of each level
+std::vector<unsigned int> OrderByOctree(aiMesh *mesh, unsigned int depth) {
+    aiVector3D min = mesh->mVertices[0], max = min;
+    for (unsigned int i = 1; i < mesh->mNumVertices; ++i) {
+        const aiVector3D &v = mesh->mVertices[i];
+        min = aiVector3D(std::min(min.x, v.x), std::min(min.y, v.y), std::min(min.z, v.z));
+        max = aiVector3D(std::max(max.x, v.x), std::max(max.y, v.y), std::max(max.z, v.z));
+    }
+    const double extent = std::max(static_cast<double>(max.x) - min.x,
+            std::max(static_cast<double>(max.y) - min.y, static_cast<double>(max.z) - min.z));
+    const double resolution = static_cast<double>(1ull << depth);
+    const double scale = extent > 0 ? resolution / extent : 0.0;
+
+    struct Point {
+        uint64_t code;
+        unsigned int level;
+        unsigned int index;
+    };
+    std::vector<Point> points(mesh->mNumVertices);
+    const double last = resolution - 1;
+    auto cellOf = [&](ai_real value, ai_real origin) {
+        return static_cast<uint64_t>(std::min((static_cast<double>(value) - origin) * scale, last));
+    };
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        const aiVector3D &v = mesh->mVertices[i];
+        const uint64_t x = cellOf(v.x, min.x);
+        const uint64_t y = cellOf(v.y, min.y);
+        const uint64_t z = cellOf(v.z, min.z);
+        points[i] = { SpreadBits(x) | (SpreadBits(y) << 1) | (SpreadBits(z) << 2), 0, i };
+    }
+    std::stable_sort(points.begin(), points.end(), [](const Point &a, const Point &b) {
+        return a.code < b.code;
+    });
+
+    // A point belongs to the first level at which it is the first point of its
+    // cell. Along the morton order that is the level at which its cell differs
+    // from the cell of the preceding point. Duplicates of a finest cell go to
+    // an extra level past the leaves.
+    std::vector<unsigned int> counts(depth + 2, 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        unsigned int level = 0;
+        if (i > 0) {
+            const uint64_t diff = points[i].code ^ points[i - 1].code;
+            if (0 == diff) {
+                level = depth + 1;
+            } else {
+                unsigned int bit = 63;
+                while (0 == (diff & (1ull << bit))) {
+                    --bit;
+                }
+                level = depth - bit / 3;
+            }
+        }
+        points[i].level = level;
+        ++counts[level];
+    }
+
+    std::vector<unsigned int> offsets(depth + 2);
+    std::vector<unsigned int> order(points.size());
+    unsigned int end = 0;
+    for (unsigned int level = 0; level < counts.size(); ++level) {
+        offsets[level] = end;
+        end += counts[level];
+    }
+    for (const Point &point : points) {
+        order[offsets[point.level]++] = point.index;
+    }
+    ReorderMesh(mesh, order);
+    return offsets;
+}
+
+// ------------------------------------------------------------------------------------------------
+// The offsets are keyed by the mesh index, a node may reference several point clouds
+void AddLevelOffsets(aiNode *node, unsigned int depth, unsigned int meshIndex, const std::vector<unsigned int> &offsets) {
+    if (nullptr == node->mMetaData) {
+        node->mMetaData = new aiMetadata();
+    }
+    aiMetadata levels;
+    for (unsigned int level = 0; level < offsets.size(); ++level) {
+        levels.Add(std::to_string(level), static_cast<uint32_t>(offsets[level]));
+    }
+    if (!node->mMetaData->HasKey("PointCloud.OctreeDepth")) {
+        node->mMetaData->Add("PointCloud.OctreeDepth", static_cast<int32_t>(depth));
+    }
+    node->mMetaData->Add("PointCloud.LevelOffsets." + std::to_string(meshIndex), levels);
+}
+
+// ------------------------------------------------------------------------------------------------
+void ProcessNode(aiScene *scene, aiNode *node, const PointCloudConfig &config, unsigned int depth,
+        std::vector<std::vector<unsigned int>> &offsets, std::vector<bool> &done) {
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+        const unsigned int index = node->mMeshes[i];
+        aiMesh *mesh = scene->mMeshes[index];
+        if (!IsPointCloud(mesh)) {
+            continue;
+        }
+        if (!done[index]) {
+            done[index] = true;
+            if (!RemoveNonFinitePoints(mesh)) {
+                continue;
+            }
+            if (config.mVoxelSize > 0) {
+                DownsampleMesh(mesh, config.mVoxelSize);
+            }
+            if (depth > 0) {
+                offsets[index] = OrderByOctree(mesh, depth);
+            }
+        }
+        if (depth > 0 && !offsets[index].empty()) {
+            AddLevelOffsets(node, depth, index, offsets[index]);
+        }
+    }
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        ProcessNode(scene, node->mChildren[i], config, depth, offsets, done);
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+void PointCloudConfig::Setup(const Importer *pImp) {
+    mEnabled = pImp->GetPropertyBool(AI_CONFIG_IMPORT_POINT_CLOUD, false);
+    mVoxelSize = pImp->GetPropertyFloat(AI_CONFIG_IMPORT_POINT_CLOUD_VOXEL_SIZE, 0.0f);
+    const int depth = pImp->GetPropertyInteger(AI_CONFIG_IMPORT_POINT_CLOUD_OCTREE_DEPTH, 0);
+    mOctreeDepth = depth > 0 ? static_cast<unsigned int>(depth) : 0u;
+    if (mOctreeDepth > MaxOctreeDepth) {
+        ASSIMP_LOG_WARN("PointCloud: octree depth ", mOctreeDepth, " is too large, using ", MaxOctreeDepth);
+        mOctreeDepth = MaxOctreeDepth;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool IsPointCloud(const aiMesh *mesh) {
+    return nullptr != mesh && 0 == mesh->mNumFaces && mesh->mNumVertices > 0 && nullptr != mesh->mVertices &&
+           aiPrimitiveType_POINT == mesh->mPrimitiveTypes;
+}
+
+// ------------------------------------------------------------------------------------------------
+void ProcessPointClouds(aiScene *scene, const PointCloudConfig &config) {
+    if (nullptr == scene || nullptr == scene->mRootNode || !config.NeedsProcessing()) {
+        return;
+    }
+    std::vector<std::vector<unsigned int>> offsets(scene->mNumMeshes);
+    std::vector<bool> done(scene->mNumMeshes, false);
+    ProcessNode(scene, scene->mRootNode, config, config.mOctreeDepth, offsets, done);
+}
+
+} // namespace Assimp
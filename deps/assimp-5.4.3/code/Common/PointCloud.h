@@ -0,0 +1,107 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+----------------------------------------------------------------------
+*/
+
+/** @file  PointCloud.h
+ *  @brief Post-import helpers for point clouds, i.e. meshes which store
+ *      vertices only. Used by the importers of formats that commonly carry
+ *      scanned data (PLY, OBJ).
+ */
+#pragma once
+#ifndef AI_POINT_CLOUD_H_INC
+#define AI_POINT_CLOUD_H_INC
+
+#include <assimp/defs.h>
+
+struct aiMesh;
+struct aiScene;
+
+namespace Assimp {
+
+class Importer;
+
+// ---------------------------------------------------------------------------
+/** @brief Point cloud settings of an import, see AI_CONFIG_IMPORT_POINT_CLOUD
+ *  and the related configuration keys.
+ */
+struct PointCloudConfig {
+    /// Store point primitives without faces
+    bool mEnabled = false;
+
+    /// Edge length of the voxel grid used for downsampling, 0 disables it
+    ai_real mVoxelSize = 0;
+
+    /// Reorder the points along an octree of this depth, 0 disables it
+    unsigned int mOctreeDepth = 0;
+
+    /// Reads the settings from the importer properties
+    void Setup(const Importer *pImp);
+
+    /// Returns true if ProcessPointClouds() has anything to do
+    bool NeedsProcessing() const {
+        return mVoxelSize > 0 || mOctreeDepth > 0;
+    }
+};
+
+// ---------------------------------------------------------------------------
+/** @brief Returns true if the mesh is a point cloud, i.e. it has vertices
+ *  of point primitives but no faces.
+ */
+bool IsPointCloud(const aiMesh *mesh);
+
+// ---------------------------------------------------------------------------
+/** @brief Downsamples and reorders all point clouds of a scene as configured.
+ *
+ *  Downsampling merges all points of a voxel into one point at their centroid,
+ *  all other vertex channels are averaged as well. The octree ordering sorts
+ *  the points so that each prefix of the vertex array is a level of detail:
+ *  the first n(L) points hold exactly one point per occupied octree cell of
+ *  level L. The end offsets n(L) are stored in the metadata of each node that
+ *  references the mesh, as "PointCloud.LevelOffsets.<mesh index>" (one uint32
+ *  per level, keyed by the level) along with "PointCloud.OctreeDepth". Points
+ *  with NaN or infinite coordinates are dropped before either step.
+ *  @param scene    The imported scene, meshes that are no point clouds are
+ *                  left untouched.
+ *  @param config   The point cloud settings.
+ */
+void ProcessPointClouds(aiScene *scene, const PointCloudConfig &config);
+
+} // namespace Assimp
+
+#endif // AI_POINT_CLOUD_H_INC
@@ -52,6 +52,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
   *       OptimizeGraph step.
   */
 // ----------------------------------------------------------------------------
+#include "SceneNames.h"
 #include "ScenePrivate.h"
 #include "time.h"
 #include <assimp/Hash.h>
@@ -895,15 +896,21 @@ void SceneCombiner::MergeMeshes(aiMesh **_out, unsigned int /*flags*/,
             for (unsigned int m = 0; m < (*it)->mNumFaces; ++m, ++pf2) {
                 aiFace &face = (*it)->mFaces[m];
                 pf2->mNumIndices = face.mNumIndices;
-                pf2->mIndices = face.mIndices;
+                if ((*it)->mIndexBuffer) {
+                    // indices in an index buffer can't be taken over
+                    pf2->mIndices = new unsigned int[face.mNumIndices];
+                    ::memcpy(pf2->mIndices, face.mIndices, face.mNumIndices * sizeof(unsigned int));
+                } else {
+                    pf2->mIndices = face.mIndices;
+                    face.mIndices = nullptr;
+                }
 
                 if (ofs) {
                     // add the offset to the vertex
                     for (unsigned int q = 0; q < face.mNumIndices; ++q) {
-                        face.mIndices[q] += ofs;
+                        pf2->mIndices[q] += ofs;
                     }
                 }
-                face.mIndices = nullptr;
             }
             ofs += (*it)->mNumVertices;
         }
@@ -1069,6 +1076,11 @@ void SceneCombiner::CopyScene(aiScene **_dest, const aiScene *src, bool allocate
     // source private data might be nullptr if the scene is user-allocated (i.e. for use with the export API)
     if (src->mPrivate != nullptr) {
         ScenePriv(dest)->mPPStepsApplied = ScenePriv(src) ? ScenePriv(src)->mPPStepsApplied : 0;
+
+        // the table refers to the nodes, the copy gets its own one
+        if (ScenePriv(src)->mNames != nullptr) {
+            InternSceneNames(dest);
+        }
     }
 }
 
@@ -1104,9 +1116,20 @@ void SceneCombiner::Copy(aiMesh **_dest, const aiMesh *src) {
 
     // make a deep copy of all faces
     GetArrayCopy(dest->mFaces, dest->mNumFaces);
-    for (unsigned int i = 0; i < dest->mNumFaces; ++i) {
-        aiFace &f = dest->mFaces[i];
-        GetArrayCopy(f.mIndices, f.mNumIndices);
+    if (src->mIndexBuffer) {
+        // one copy of the index buffer, the faces are rebased onto it
+        GetArrayCopy(dest->mIndexBuffer, dest->mIndexBufferSize);
+        for (unsigned int i = 0; i < dest->mNumFaces; ++i) {
+            aiFace &f = dest->mFaces[i];
+            if (f.mIndices) {
+                f.mIndices = dest->mIndexBuffer + (src->mFaces[i].mIndices - src->mIndexBuffer);
+            }
+        }
+    } else {
+        for (unsigned int i = 0; i < dest->mNumFaces; ++i) {
+            aiFace &f = dest->mFaces[i];
+            GetArrayCopy(f.mIndices, f.mNumIndices);
+        }
     }
 
     // make a deep copy of all blend shapes
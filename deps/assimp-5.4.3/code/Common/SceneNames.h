@@ -0,0 +1,91 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+----------------------------------------------------------------------
+*/
+
+
+/** @file  SceneNames.h
+ *  @brief The name table of a scene, see aiBuildSceneNameTable().
+ */
+#pragma once
+#ifndef AI_SCENE_NAMES_H_INC
+#define AI_SCENE_NAMES_H_INC
+
+#include <assimp/StringTable.h>
+
+#include <vector>
+
+struct aiNode;
+struct aiScene;
+
+namespace Assimp {
+
+// ---------------------------------------------------------------------------
+/** @brief The interned names of a scene, kept in its private data.
+ *
+ *  The handles live here and not in the public structs: aiNode, aiBone and
+ *  aiNodeAnim keep their layout. Data an object owns and maintains itself
+ *  (aiMesh::mIndexBuffer, aiMaterial::mPropertyIndex) may hang off the
+ *  object, data relating the objects of a scene to each other belongs to
+ *  the scene.
+ */
+struct SceneNameTable {
+    /** Node names first, in pre-order, then the names of bones and node
+     *  animation channels that no node has. */
+    StringTable mStrings;
+
+    /** The first node in pre-order with the name of a handle, indexed by
+     *  handle. nullptr for the names of bones or channels without node. */
+    std::vector<const aiNode *> mNodes;
+};
+
+// ---------------------------------------------------------------------------
+/** @brief Builds the name table of a scene from the names of all nodes,
+ *  bones and node animation channels. A previous table of the scene is
+ *  replaced, so this is also how the table is updated after names changed.
+ *  @param scene    The scene, must have private data.
+ */
+void InternSceneNames(const aiScene *scene);
+
+// ---------------------------------------------------------------------------
+/** @brief Returns the name table of a scene or nullptr if it has none. */
+const SceneNameTable *GetSceneNames(const aiScene *scene);
+
+} // namespace Assimp
+
+#endif // AI_SCENE_NAMES_H_INC
@@ -53,6 +53,7 @@ namespace Assimp {
 
 // Forward declarations
 class Importer;
+struct SceneNameTable;
 
 struct ScenePrivateData {
     //  The struct constructor.
@@ -71,13 +72,18 @@ struct ScenePrivateData {
     // and mOrigImporter are no longer safe to rely on and only
     // serve informative purposes.
     bool mIsCopy;
+
+    // Interned names of the scene, built on request, see
+    // InternSceneNames(). Owned by the scene.
+    SceneNameTable* mNames;
 };
 
 inline
 ScenePrivateData::ScenePrivateData() AI_NO_EXCEPT
 : mOrigImporter( nullptr )
 , mPPStepsApplied( 0 )
-, mIsCopy( false ) {
+, mIsCopy( false )
+, mNames( nullptr ) {
     // empty
 }
 
@@ -47,16 +47,20 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef AI_STACK_ALLOCATOR_H_INC
 #define AI_STACK_ALLOCATOR_H_INC
 
+#include <assimp/MemoryAllocator.hpp>
+
 #include <vector>
 #include <stdint.h>
 #include <stddef.h>
+#include <cstddef>
 
 namespace Assimp {
 
 /** @brief A very bare-bone allocator class that is suitable when
  *      allocating many small objects, e.g. during parsing.
  *      Individual objects are not freed, instead only the whole memory
- *      can be deallocated.
+ *      can be deallocated. The blocks come from the MemoryAllocator which
+ *      is current when the StackAllocator is constructed.
 */
 class StackAllocator {
 public:
@@ -72,7 +76,8 @@ public:
 
     /// @brief Returns a pointer to byteSize bytes of heap memory that persists
     ///        for the lifetime of the allocator (or until FreeAll is called).
-    inline void *Allocate(size_t byteSize);
+    //         The memory is aligned to alignment bytes, which must be a power of two.
+    inline void *Allocate(size_t byteSize, size_t alignment = alignof(std::max_align_t));
 
     /// @brief Releases all the memory owned by this allocator.
     //         Memory provided through function Allocate is not valid anymore after this function has been called.
@@ -83,7 +88,12 @@ private:
     constexpr const static size_t g_startBytesPerBlock = 16 * 1024;  // Size of the first block. Next blocks will double in size until maximum size of g_maxBytesPerBlock
     size_t m_blockAllocationSize = g_startBytesPerBlock; // Block size of the current block
     size_t m_subIndex = g_maxBytesPerBlock; // The current byte offset in the current block
-    std::vector<uint8_t *> m_storageBlocks;  // A list of blocks
+    struct Block {
+        uint8_t *data;
+        size_t size;
+    };
+    MemoryAllocator *m_allocator; // The source of the blocks
+    std::vector<Block> m_storageBlocks;  // A list of blocks
 };
 
 } // namespace Assimp
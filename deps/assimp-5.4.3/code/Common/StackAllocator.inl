@@ -45,36 +45,41 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace Assimp;
 
-inline StackAllocator::StackAllocator() : m_storageBlocks() {}
+inline StackAllocator::StackAllocator() : m_allocator(MemoryAllocator::GetCurrent()), m_storageBlocks() {}
 
 inline StackAllocator::~StackAllocator() {
     FreeAll();
 }
 
-inline void *StackAllocator::Allocate(size_t byteSize) {
-    if (m_subIndex + byteSize > m_blockAllocationSize) // start a new block
+inline void *StackAllocator::Allocate(size_t byteSize, size_t alignment) {
+    ai_assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    ai_assert(alignment <= alignof(std::max_align_t));
+
+    // new blocks are aligned for any type, so aligning the offset is enough
+    const size_t offset = (m_subIndex + alignment - 1) & ~(alignment - 1);
+    if (offset + byteSize > m_blockAllocationSize) // start a new block
     {
         // double block size every time, up to maximum of g_maxBytesPerBlock.
         // Block size must be at least as large as byteSize, but we want to use this for small allocations anyway.
         m_blockAllocationSize = std::max<std::size_t>(std::min<std::size_t>(m_blockAllocationSize * 2, g_maxBytesPerBlock), byteSize);
-        uint8_t *data = new uint8_t[m_blockAllocationSize];
-        m_storageBlocks.emplace_back(data);
+        uint8_t *data = static_cast<uint8_t *>(MemoryAllocator::AllocateTracked(m_allocator, m_blockAllocationSize, alignof(std::max_align_t)));
+        m_storageBlocks.push_back({ data, m_blockAllocationSize });
         m_subIndex = byteSize;
         return data;
     }
 
-    uint8_t *data = m_storageBlocks.back();
-    data += m_subIndex;
-    m_subIndex += byteSize;
+    uint8_t *data = m_storageBlocks.back().data;
+    data += offset;
+    m_subIndex = offset + byteSize;
 
     return data;
 }
 
 inline void StackAllocator::FreeAll() {
     for (size_t i = 0; i < m_storageBlocks.size(); i++) {
-        delete [] m_storageBlocks[i];
+        MemoryAllocator::FreeTracked(m_allocator, m_storageBlocks[i].data, m_storageBlocks[i].size, alignof(std::max_align_t));
     }
-    std::vector<uint8_t *> empty;
+    std::vector<Block> empty;
     m_storageBlocks.swap(empty);
     // start over:
     m_blockAllocationSize = g_startBytesPerBlock;
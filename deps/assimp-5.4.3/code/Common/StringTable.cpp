@@ -0,0 +1,194 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  StringTable.cpp
+ *  @brief Implementation of the string table and the name table of scenes
+ */
+
+#include "SceneNames.h"
+#include "ScenePrivate.h"
+
+#include <assimp/StringTable.h>
+#include <assimp/scene.h>
+
+#include <cstring>
+#include <memory>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+StringTable::StringTable() :
+        mChars(),
+        mEntries(),
+        mSlots(16, AI_STRING_HANDLE_INVALID) {
+    // empty
+}
+
+// ------------------------------------------------------------------------------------------------
+uint32_t StringTable::Hash(const char *str, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(str[i])) * 16777619u;
+    }
+    return hash;
+}
+
+// ------------------------------------------------------------------------------------------------
+aiStringHandle StringTable::Find(const char *str, size_t len) const {
+    const uint32_t hash = Hash(str, len);
+    const size_t mask = mSlots.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const aiStringHandle handle = mSlots[slot];
+        if (handle == AI_STRING_HANDLE_INVALID) {
+            return AI_STRING_HANDLE_INVALID;
+        }
+        const Entry &entry = mEntries[handle];
+        if (entry.mHash == hash && entry.mLength == len && ::memcmp(&mChars[entry.mOffset], str, len) == 0) {
+            return handle;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+aiStringHandle StringTable::Intern(const char *str, size_t len) {
+    const uint32_t hash = Hash(str, len);
+    const size_t mask = mSlots.size() - 1;
+    size_t slot = hash & mask;
+    for (;; slot = (slot + 1) & mask) {
+        const aiStringHandle handle = mSlots[slot];
+        if (handle == AI_STRING_HANDLE_INVALID) {
+            break;
+        }
+        const Entry &entry = mEntries[handle];
+        if (entry.mHash == hash && entry.mLength == len && ::memcmp(&mChars[entry.mOffset], str, len) == 0) {
+            return handle;
+        }
+    }
+
+    const aiStringHandle handle = static_cast<aiStringHandle>(mEntries.size());
+    mEntries.push_back({ static_cast<uint32_t>(mChars.size()), static_cast<uint32_t>(len), hash });
+    mChars.insert(mChars.end(), str, str + len);
+    mChars.push_back('\0');
+    mSlots[slot] = handle;
+
+    // keep the load factor below 1/2
+    if (mEntries.size() * 2 > mSlots.size()) {
+        Grow();
+    }
+    return handle;
+}
+
+// ------------------------------------------------------------------------------------------------
+void StringTable::Grow() {
+    std::vector<aiStringHandle> slots(mSlots.size() * 2, AI_STRING_HANDLE_INVALID);
+    const size_t mask = slots.size() - 1;
+    for (aiStringHandle handle = 0; handle < mEntries.size(); ++handle) {
+        size_t slot = mEntries[handle].mHash & mask;
+        while (slots[slot] != AI_STRING_HANDLE_INVALID) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = handle;
+    }
+    mSlots.swap(slots);
+}
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+void InternNodeNames(SceneNameTable &names, const aiNode *node) {
+    const aiStringHandle handle = names.mStrings.Intern(node->mName);
+    if (handle == names.mNodes.size()) {
+        names.mNodes.push_back(node);
+    }
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        InternNodeNames(names, node->mChildren[i]);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void InternName(SceneNameTable &names, const aiString &name) {
+    if (names.mStrings.Intern(name) == names.mNodes.size()) {
+        names.mNodes.push_back(nullptr);
+    }
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+void InternSceneNames(const aiScene *scene) {
+    // the table is bookkeeping of the scene, not part of its data
+    ScenePrivateData *priv = const_cast<ScenePrivateData *>(ScenePriv(scene));
+    if (priv == nullptr) {
+        return;
+    }
+
+    // names may have changed since the last run, start over
+    delete priv->mNames;
+    priv->mNames = nullptr;
+    std::unique_ptr<SceneNameTable> names(new SceneNameTable());
+
+    if (scene->mRootNode) {
+        InternNodeNames(*names, scene->mRootNode);
+    }
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        const aiMesh *mesh = scene->mMeshes[i];
+        for (unsigned int b = 0; b < mesh->mNumBones; ++b) {
+            InternName(*names, mesh->mBones[b]->mName);
+        }
+    }
+    for (unsigned int i = 0; i < scene->mNumAnimations; ++i) {
+        const aiAnimation *anim = scene->mAnimations[i];
+        for (unsigned int c = 0; c < anim->mNumChannels; ++c) {
+            InternName(*names, anim->mChannels[c]->mNodeName);
+        }
+    }
+    priv->mNames = names.release();
+}
+
+// ------------------------------------------------------------------------------------------------
+const SceneNameTable *GetSceneNames(const aiScene *scene) {
+    if (scene == nullptr || scene->mPrivate == nullptr) {
+        return nullptr;
+    }
+    return ScenePriv(scene)->mNames;
+}
+
+} // namespace Assimp
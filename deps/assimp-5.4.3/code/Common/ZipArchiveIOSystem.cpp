@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assimp/ai_assert.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 
@@ -85,6 +86,30 @@ private:
 };
 
 
+// ----------------------------------------------------------------
+// A read-only file inside a ZIP, inflated while it is read
+
+class ZipStreamFile final : public IOStream {
+    friend class ZipFileInfo;
+    explicit ZipStreamFile(unzFile zip_handle, size_t size);
+
+public:
+    ~ZipStreamFile() override;
+
+    // IOStream interface
+    size_t Read(void *pvBuffer, size_t pSize, size_t pCount) override;
+    size_t Write(const void * /*pvBuffer*/, size_t /*pSize*/, size_t /*pCount*/) override { return 0; }
+    size_t FileSize() const override;
+    aiReturn Seek(size_t pOffset, aiOrigin pOrigin) override;
+    size_t Tell() const override;
+    void Flush() override {}
+
+private:
+    unzFile m_ZipFileHandle = nullptr;
+    size_t m_Size = 0;
+    size_t m_ReadPtr = 0;
+};
+
 // ----------------------------------------------------------------
 // Wraps an existing Assimp::IOSystem for unzip
 class IOSystem2Unzip {
@@ -232,6 +257,9 @@ public:
     // Allocate and Extract data from the ZIP
     ZipFile *Extract(std::string &filename, unzFile zip_handle) const;
 
+    // Open the file for inflating it while it is read
+    ZipStreamFile *OpenStream(unzFile zip_handle) const;
+
 private:
     size_t m_Size = 0;
     unz_file_pos_s m_ZipFilePos;
@@ -287,6 +315,18 @@ ZipFile *ZipFileInfo::Extract(std::string &filename, unzFile zip_handle) const {
     return zip_file;
 }
 
+// ----------------------------------------------------------------
+ZipStreamFile *ZipFileInfo::OpenStream(unzFile zip_handle) const {
+    unz_file_pos_s *filepos = const_cast<unz_file_pos_s *>(&(m_ZipFilePos));
+    if (unzGoToFilePos(zip_handle, filepos) != UNZ_OK)
+        return nullptr;
+
+    if (unzOpenCurrentFile(zip_handle) != UNZ_OK)
+        return nullptr;
+
+    return new ZipStreamFile(zip_handle, m_Size);
+}
+
 // ----------------------------------------------------------------
 ZipFile::ZipFile(std::string &filename, size_t size) :
         m_Filename(filename), m_Size(size) {
@@ -355,6 +395,83 @@ size_t ZipFile::Tell() const {
     return m_SeekPtr;
 }
 
+// ----------------------------------------------------------------
+ZipStreamFile::ZipStreamFile(unzFile zip_handle, size_t size) :
+        m_ZipFileHandle(zip_handle), m_Size(size) {
+    ai_assert(m_ZipFileHandle != nullptr);
+}
+
+// ----------------------------------------------------------------
+ZipStreamFile::~ZipStreamFile() {
+    unzCloseCurrentFile(m_ZipFileHandle);
+}
+
+// ----------------------------------------------------------------
+size_t ZipStreamFile::Read(void *pvBuffer, size_t pSize, size_t pCount) {
+    ai_assert(nullptr != pvBuffer);
+    ai_assert(0 != pSize);
+
+    // Clip down to file size
+    if (pCount > (m_Size - m_ReadPtr) / pSize) {
+        pCount = (m_Size - m_ReadPtr) / pSize;
+    }
+
+    // Unzip has a limit of UINT16_MAX bytes buffer
+    uint8_t *dest = static_cast<uint8_t *>(pvBuffer);
+    const size_t byteSize = pSize * pCount;
+    size_t readCount = 0;
+    while (readCount < byteSize) {
+        size_t bufferSize = byteSize - readCount;
+        if (bufferSize > UINT16_MAX) {
+            bufferSize = UINT16_MAX;
+        }
+
+        const int ret = unzReadCurrentFile(m_ZipFileHandle, dest + readCount, static_cast<unsigned int>(bufferSize));
+        if (ret <= 0) {
+            break;
+        }
+        readCount += ret;
+    }
+
+    m_ReadPtr += readCount;
+    return readCount / pSize;
+}
+
+// ----------------------------------------------------------------
+size_t ZipStreamFile::FileSize() const {
+    return m_Size;
+}
+
+// ----------------------------------------------------------------
+// Only forward seeking is possible, the skipped data is inflated and dropped
+aiReturn ZipStreamFile::Seek(size_t pOffset, aiOrigin pOrigin) {
+    size_t target = 0;
+    switch (pOrigin) {
+        case aiOrigin_SET: target = pOffset; break;
+        case aiOrigin_CUR: target = m_ReadPtr + pOffset; break;
+        case aiOrigin_END: target = pOffset <= m_Size ? m_Size - pOffset : 0; break;
+        default: return aiReturn_FAILURE;
+    }
+    if (target < m_ReadPtr || target > m_Size) {
+        return aiReturn_FAILURE;
+    }
+
+    uint8_t skipBuffer[4096];
+    while (m_ReadPtr < target) {
+        const size_t count = std::min(target - m_ReadPtr, sizeof(skipBuffer));
+        if (Read(skipBuffer, 1, count) != count) {
+            return aiReturn_FAILURE;
+        }
+    }
+
+    return aiReturn_SUCCESS;
+}
+
+// ----------------------------------------------------------------
+size_t ZipStreamFile::Tell() const {
+    return m_ReadPtr;
+}
+
 // ----------------------------------------------------------------
 // pImpl of the Zip Archive IO
 class ZipArchiveIOSystem::Implement {
@@ -369,6 +486,7 @@ public:
     void getFileListExtension(std::vector<std::string> &rFileList, const std::string &extension);
     bool Exists(std::string &filename);
     IOStream *OpenFile(std::string &filename);
+    IOStream *OpenFileStreamed(std::string &filename);
 
     static void SimplifyFilename(std::string &filename);
 
@@ -477,6 +595,19 @@ IOStream *ZipArchiveIOSystem::Implement::OpenFile(std::string &filename) {
     return zip_file.Extract(filename, m_ZipFileHandle);
 }
 
+// ----------------------------------------------------------------
+IOStream *ZipArchiveIOSystem::Implement::OpenFileStreamed(std::string &filename) {
+    MapArchive();
+
+    SimplifyFilename(filename);
+
+    ZipFileInfoMap::const_iterator zip_it = m_ArchiveMap.find(filename);
+    if (zip_it == m_ArchiveMap.cend())
+        return nullptr;
+
+    return (*zip_it).second.OpenStream(m_ZipFileHandle);
+}
+
 // ----------------------------------------------------------------
 inline void ReplaceAll(std::string &data, const std::string &before, const std::string &after) {
     size_t pos = data.find(before);
@@ -574,6 +705,14 @@ void ZipArchiveIOSystem::Close(IOStream *pFile) {
     delete pFile;
 }
 
+// ----------------------------------------------------------------
+IOStream *ZipArchiveIOSystem::OpenStreamed(const char *pFilename) {
+    ai_assert(pFilename != nullptr);
+
+    std::string filename(pFilename);
+    return pImpl->OpenFileStreamed(filename);
+}
+
 // ----------------------------------------------------------------
 bool ZipArchiveIOSystem::isOpen() const {
     return (pImpl->isOpen());
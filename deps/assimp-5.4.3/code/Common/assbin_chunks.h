@@ -2,7 +2,7 @@
 #define INCLUDED_ASSBIN_CHUNKS_H
 
 #define ASSBIN_VERSION_MAJOR 1
-#define ASSBIN_VERSION_MINOR 0
+#define ASSBIN_VERSION_MINOR 1
 
 /**
 @page assfile .ASS File formats
@@ -73,6 +73,8 @@ byte[44]    Magic identification string for ASSBIN files.
 integer     Major version of the Assimp library which wrote the file
 integer     Minor version of the Assimp library which wrote the file
                 match these against ASSBIN_VERSION_MAJOR and ASSBIN_VERSION_MINOR
+                (revision 1.1 stores arrays as streams, see 4., loaders also
+                accept 1.0 files, which store arrays element by element)
 
 integer     SVN revision of the Assimp library (intended for our internal
             debugging - if you write Ass files from your own APPs, set this value to 0.
@@ -164,12 +166,45 @@ The general 'rule' to get from Assimp headers to the serialized layout is:
 
    - mNumAllocated is omitted, for obvious reasons :-)
 
+-------------------------------------------------------------------------------
+4. Streams (revision 1.1):
+-------------------------------------------------------------------------------
+
+Starting with revision 1.1 the big arrays are not written element by element
+but as one stream block each, so they can be written and read in one go:
+
+integer     Encoding, ASSBIN_STREAM_RAW or ASSBIN_STREAM_DEFLATE
+integer     Decoded size of the stream, in bytes
+integer     Stored size of the stream, in bytes
+byte[]      Zero padding up to the next multiple of ASSBIN_STREAM_ALIGNMENT,
+                counted from the start of the file (or, for files compressed
+                as a whole, from the start of the uncompressed data)
+byte[n]     Stored data, raw or a zlib stream
+
+The decoded data is the packed little-endian array, floats are always single
+precision. The following members are stored as streams:
+
+   - aiMesh vertex components: one stream per array, vectors as float[3],
+     colors as float[4].
+   - aiMesh::mFaces: one stream with the short mNumIndices of every face,
+     followed by one stream with all indices of all faces, as short if
+     aiMesh::mNumVertices<65536, as integer otherwise.
+   - aiBone::mWeights: one stream of (integer mVertexId, float mWeight).
+   - aiNodeAnim keys: per key array one stream with the double mTime values,
+     followed by one stream with the values, vectors as float[3] and
+     quaternions as float[4] (w,x,y,z).
+
 
  @endverbatim*/
 
 
 #define ASSBIN_HEADER_LENGTH 512
 
+// stream encodings and layout, revision 1.1 and later
+#define ASSBIN_STREAM_RAW                       0
+#define ASSBIN_STREAM_DEFLATE                   1
+#define ASSBIN_STREAM_ALIGNMENT                 16
+
 // these are the magic chunk identifiers for the binary ASS file format
 #define ASSBIN_CHUNK_AICAMERA                   0x1234
 #define ASSBIN_CHUNK_AILIGHT                    0x1235
@@ -40,6 +40,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include <assimp/scene.h>
 
+#include "SceneNames.h"
 #include "ScenePrivate.h"
 
 aiScene::aiScene() :
@@ -118,7 +119,11 @@ aiScene::~aiScene() {
 
     delete[] mSkeletons;
 
-    delete static_cast<Assimp::ScenePrivateData *>(mPrivate);
+    Assimp::ScenePrivateData *priv = static_cast<Assimp::ScenePrivateData *>(mPrivate);
+    if (priv != nullptr) {
+        delete priv->mNames;
+    }
+    delete priv;
 }
 
 aiNode::aiNode() :
@@ -52,9 +52,188 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/types.h>
 #include <assimp/DefaultLogger.hpp>
 #include <memory>
+#include <vector>
 
 using namespace Assimp;
 
+// ------------------------------------------------------------------------------------------------
+/*  Hashed lookup table over the property list of a material. Every bucket chains the
+ *  properties whose key hash maps to it in ascending order, so the first match in a
+ *  chain is the property a linear scan would find first - this keeps the UINT_MAX
+ *  wild-cards for the semantic and the index working. The mutators of aiMaterial keep
+ *  the table up to date, lookups never build it. The table remembers the array, the
+ *  size and a checksum of the property pointers it was built for. Lookups fall back to
+ *  a scan if any of them changed behind its back, e.g. because a property was replaced
+ *  or the list was reordered in place. */
+struct aiMaterialPropertyIndex {
+    const aiMaterialProperty *const *mProperties = nullptr;
+    unsigned int mNumProperties = 0;
+    uint64_t mChecksum = 0;
+    unsigned int mMask = 0;
+    std::vector<unsigned int> mHeads;
+    std::vector<unsigned int> mTails;
+    std::vector<unsigned int> mNext;
+    std::vector<uint32_t> mHashes;
+};
+
+// Materials with less properties are scanned, this is cheaper than hashing the key
+static const unsigned int MinIndexedProperties = 8;
+
+// ------------------------------------------------------------------------------------------------
+static uint32_t HashPropertyKey(const char *key, size_t length) {
+    return SuperFastHash(key, static_cast<unsigned int>(length));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Order dependent FNV-1a style mix of the property pointers. Reading the pointer array is
+// much cheaper than the key compares of a scan, it does not touch the properties.
+static const uint64_t PropertyChecksumSeed = 14695981039346656037ull;
+
+static uint64_t MixPropertyChecksum(uint64_t checksum, const aiMaterialProperty *prop) {
+    return (checksum ^ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(prop))) * 1099511628211ull;
+}
+
+static uint64_t ComputePropertyChecksum(const aiMaterial *mat) {
+    uint64_t checksum = PropertyChecksumSeed;
+    for (unsigned int i = 0; i < mat->mNumProperties; ++i) {
+        checksum = MixPropertyChecksum(checksum, mat->mProperties[i]);
+    }
+    return checksum;
+}
+
+// ------------------------------------------------------------------------------------------------
+static bool IsIndexCurrent(const aiMaterial *mat) {
+    const aiMaterialPropertyIndex *idx = mat->mPropertyIndex;
+    return idx != nullptr && idx->mProperties == mat->mProperties && idx->mNumProperties == mat->mNumProperties
+            && idx->mChecksum == ComputePropertyChecksum(mat);
+}
+
+// ------------------------------------------------------------------------------------------------
+static void LinkIndexEntry(aiMaterialPropertyIndex *idx, unsigned int i, uint32_t hash) {
+    idx->mHashes[i] = hash;
+    idx->mNext[i] = UINT_MAX;
+
+    const unsigned int bucket = hash & idx->mMask;
+    if (idx->mHeads[bucket] == UINT_MAX) {
+        idx->mHeads[bucket] = i;
+    } else {
+        idx->mNext[idx->mTails[bucket]] = i;
+    }
+    idx->mTails[bucket] = i;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Lookups only use an index that is up to date, they never build one
+static const aiMaterialPropertyIndex *GetPropertyIndex(const aiMaterial *mat) {
+    return IsIndexCurrent(mat) ? mat->mPropertyIndex : nullptr;
+}
+
+// ------------------------------------------------------------------------------------------------
+// (Re)builds the index after the property list changed, or drops it for small materials
+static void UpdatePropertyIndex(aiMaterial *mat) {
+    if (mat->mNumProperties < MinIndexedProperties) {
+        Assimp::ReleaseMaterialPropertyIndex(mat);
+        return;
+    }
+
+    aiMaterialPropertyIndex *idx = mat->mPropertyIndex;
+    if (idx == nullptr) {
+        idx = mat->mPropertyIndex = new aiMaterialPropertyIndex();
+    }
+
+    // leave room for the properties which fit into the allocated array
+    unsigned int numBuckets = 16;
+    while (numBuckets < std::max(mat->mNumProperties, mat->mNumAllocated) * 2) {
+        numBuckets <<= 1;
+    }
+    idx->mMask = numBuckets - 1;
+    idx->mHeads.assign(numBuckets, UINT_MAX);
+    idx->mTails.assign(numBuckets, UINT_MAX);
+    idx->mNext.assign(mat->mNumProperties, UINT_MAX);
+    idx->mHashes.assign(mat->mNumProperties, 0);
+
+    for (unsigned int i = 0; i < mat->mNumProperties; ++i) {
+        const aiMaterialProperty *prop = mat->mProperties[i];
+        if (prop != nullptr) {
+            LinkIndexEntry(idx, i, HashPropertyKey(prop->mKey.data, prop->mKey.length));
+        }
+    }
+    idx->mProperties = mat->mProperties;
+    idx->mNumProperties = mat->mNumProperties;
+    idx->mChecksum = ComputePropertyChecksum(mat);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Returns the position of the first property matching key, semantic and index, or UINT_MAX.
+// With wildcards set, UINT_MAX as type or index matches any semantic or index.
+static unsigned int FindPropertyPosition(const aiMaterial *mat,
+        const char *pKey,
+        unsigned int type,
+        unsigned int index,
+        bool wildcards) {
+    auto matches = [=](const aiMaterialProperty *prop) {
+        return prop != nullptr
+                && ((wildcards && UINT_MAX == type) || prop->mSemantic == type)
+                && ((wildcards && UINT_MAX == index) || prop->mIndex == index)
+                && 0 == strcmp(prop->mKey.data, pKey);
+    };
+
+    const aiMaterialPropertyIndex *idx = GetPropertyIndex(mat);
+    if (idx == nullptr) {
+        for (unsigned int i = 0; i < mat->mNumProperties; ++i) {
+            if (matches(mat->mProperties[i])) {
+                return i;
+            }
+        }
+        return UINT_MAX;
+    }
+
+    const uint32_t hash = HashPropertyKey(pKey, strlen(pKey));
+    for (unsigned int i = idx->mHeads[hash & idx->mMask]; i != UINT_MAX; i = idx->mNext[i]) {
+        if (idx->mHashes[i] == hash && matches(mat->mProperties[i])) {
+            return i;
+        }
+    }
+    return UINT_MAX;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Calls func for each texture path property, using the index to skip all other properties.
+template <class Func>
+static void ForEachTexturePath(const aiMaterial *mat, Func func) {
+    const aiMaterialPropertyIndex *idx = GetPropertyIndex(mat);
+    if (idx == nullptr) {
+        for (unsigned int i = 0; i < mat->mNumProperties; ++i) {
+            const aiMaterialProperty *prop = mat->mProperties[i];
+            if (prop /* just a sanity check ... */ && 0 == strcmp(prop->mKey.data, _AI_MATKEY_TEXTURE_BASE)) {
+                func(prop);
+            }
+        }
+        return;
+    }
+
+    static const uint32_t hash = HashPropertyKey(_AI_MATKEY_TEXTURE_BASE, strlen(_AI_MATKEY_TEXTURE_BASE));
+    for (unsigned int i = idx->mHeads[hash & idx->mMask]; i != UINT_MAX; i = idx->mNext[i]) {
+        const aiMaterialProperty *prop = mat->mProperties[i];
+        if (idx->mHashes[i] == hash && prop && 0 == strcmp(prop->mKey.data, _AI_MATKEY_TEXTURE_BASE)) {
+            func(prop);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::BuildMaterialPropertyIndex(aiMaterial *mat) {
+    ai_assert(nullptr != mat);
+    UpdatePropertyIndex(mat);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Assimp::ReleaseMaterialPropertyIndex(aiMaterial *mat) {
+    ai_assert(nullptr != mat);
+    delete mat->mPropertyIndex;
+    mat->mPropertyIndex = nullptr;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Get a specific property from a material
 aiReturn aiGetMaterialProperty(const aiMaterial *pMat,
@@ -66,19 +245,11 @@ aiReturn aiGetMaterialProperty(const aiMaterial *pMat,
     ai_assert(pKey != nullptr);
     ai_assert(pPropOut != nullptr);
 
-    /*  Just search for a property with exactly this name ..
-     *  could be improved by hashing, but it's possibly
-     *  no worth the effort (we're bound to C structures,
-     *  thus std::map or derivates are not applicable. */
-    for (unsigned int i = 0; i < pMat->mNumProperties; ++i) {
-        aiMaterialProperty *prop = pMat->mProperties[i];
-
-        if (prop /* just for safety ... */
-                && 0 == strcmp(prop->mKey.data, pKey) && (UINT_MAX == type || prop->mSemantic == type) /* UINT_MAX is a wild-card, but this is undocumented :-) */
-                && (UINT_MAX == index || prop->mIndex == index)) {
-            *pPropOut = pMat->mProperties[i];
-            return AI_SUCCESS;
-        }
+    // UINT_MAX is a wild-card for type and index, but this is undocumented :-)
+    const unsigned int i = FindPropertyPosition(pMat, pKey, type, index, true);
+    if (UINT_MAX != i) {
+        *pPropOut = pMat->mProperties[i];
+        return AI_SUCCESS;
     }
     *pPropOut = nullptr;
     return AI_FAILURE;
@@ -409,15 +580,11 @@ unsigned int aiGetMaterialTextureCount(const C_STRUCT aiMaterial *pMat, C_ENUM a
 
     // Textures are always stored with ascending indices (ValidateDS provides a check, so we don't need to do it again)
     unsigned int max = 0;
-    for (unsigned int i = 0; i < pMat->mNumProperties; ++i) {
-        aiMaterialProperty *prop = pMat->mProperties[i];
-
-        if (prop /* just a sanity check ... */
-                && 0 == strcmp(prop->mKey.data, _AI_MATKEY_TEXTURE_BASE) && static_cast<aiTextureType>(prop->mSemantic) == type) {
-
+    ForEachTexturePath(pMat, [type, &max](const aiMaterialProperty *prop) {
+        if (static_cast<aiTextureType>(prop->mSemantic) == type) {
             max = std::max(max, prop->mIndex + 1);
         }
-    }
+    });
     return max;
 }
 
@@ -473,12 +640,76 @@ aiReturn aiGetMaterialTexture(const C_STRUCT aiMaterial *mat,
     return AI_SUCCESS;
 }
 
+// ------------------------------------------------------------------------------------------------
+aiReturn aiGetMaterialPbrParameters(const C_STRUCT aiMaterial *pMat, C_STRUCT aiPbrParameters *pOut) {
+    ai_assert(nullptr != pMat);
+    ai_assert(nullptr != pOut);
+    if (nullptr == pMat || nullptr == pOut) {
+        return AI_FAILURE;
+    }
+
+    // glTF 2.0 defaults
+    pOut->mBaseColor = aiColor4D(1.0f, 1.0f, 1.0f, 1.0f);
+    pOut->mEmissiveColor = aiColor3D(0.0f, 0.0f, 0.0f);
+    pOut->mSheenColor = aiColor3D(0.0f, 0.0f, 0.0f);
+    pOut->mMetallicFactor = 1.0f;
+    pOut->mRoughnessFactor = 1.0f;
+    pOut->mSpecularFactor = 1.0f;
+    pOut->mGlossinessFactor = 1.0f;
+    pOut->mSheenRoughnessFactor = 0.0f;
+    pOut->mClearcoatFactor = 0.0f;
+    pOut->mClearcoatRoughnessFactor = 0.0f;
+    pOut->mTransmissionFactor = 0.0f;
+    pOut->mVolumeThicknessFactor = 0.0f;
+    pOut->mEmissiveIntensity = 1.0f;
+    pOut->mOpacity = 1.0f;
+    pOut->mIor = 1.5f;
+    pOut->mTwoSided = 0;
+    pOut->mShadingModel = aiShadingMode_PBR_BRDF;
+    pOut->mTextureMask = 0;
+
+    if (AI_SUCCESS != aiGetMaterialColor(pMat, AI_MATKEY_BASE_COLOR, &pOut->mBaseColor)) {
+        aiGetMaterialColor(pMat, AI_MATKEY_COLOR_DIFFUSE, &pOut->mBaseColor);
+    }
+
+    // the three component colors are read through a temporary as the alpha would overrun them
+    aiColor4D color;
+    if (AI_SUCCESS == aiGetMaterialColor(pMat, AI_MATKEY_COLOR_EMISSIVE, &color)) {
+        pOut->mEmissiveColor = aiColor3D(color.r, color.g, color.b);
+    }
+    if (AI_SUCCESS == aiGetMaterialColor(pMat, AI_MATKEY_SHEEN_COLOR_FACTOR, &color)) {
+        pOut->mSheenColor = aiColor3D(color.r, color.g, color.b);
+    }
+
+    aiGetMaterialFloat(pMat, AI_MATKEY_METALLIC_FACTOR, &pOut->mMetallicFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_ROUGHNESS_FACTOR, &pOut->mRoughnessFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_SPECULAR_FACTOR, &pOut->mSpecularFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_GLOSSINESS_FACTOR, &pOut->mGlossinessFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_SHEEN_ROUGHNESS_FACTOR, &pOut->mSheenRoughnessFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_CLEARCOAT_FACTOR, &pOut->mClearcoatFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_CLEARCOAT_ROUGHNESS_FACTOR, &pOut->mClearcoatRoughnessFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_TRANSMISSION_FACTOR, &pOut->mTransmissionFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_VOLUME_THICKNESS_FACTOR, &pOut->mVolumeThicknessFactor);
+    aiGetMaterialFloat(pMat, AI_MATKEY_EMISSIVE_INTENSITY, &pOut->mEmissiveIntensity);
+    aiGetMaterialFloat(pMat, AI_MATKEY_OPACITY, &pOut->mOpacity);
+    aiGetMaterialFloat(pMat, AI_MATKEY_REFRACTI, &pOut->mIor);
+    aiGetMaterialInteger(pMat, AI_MATKEY_TWOSIDED, &pOut->mTwoSided);
+    aiGetMaterialInteger(pMat, AI_MATKEY_SHADING_MODEL, &pOut->mShadingModel);
+
+    ForEachTexturePath(pMat, [pOut](const aiMaterialProperty *prop) {
+        if (prop->mSemantic < 32) {
+            pOut->mTextureMask |= 1u << prop->mSemantic;
+        }
+    });
+    return AI_SUCCESS;
+}
+
 static const unsigned int DefaultNumAllocated = 5;
 
 // ------------------------------------------------------------------------------------------------
 // Construction. Actually the one and only way to get an aiMaterial instance
 aiMaterial::aiMaterial() :
-        mProperties(nullptr), mNumProperties(0), mNumAllocated(DefaultNumAllocated) {
+        mProperties(nullptr), mNumProperties(0), mNumAllocated(DefaultNumAllocated), mPropertyIndex(nullptr) {
     // Allocate 5 entries by default
     mProperties = new aiMaterialProperty *[DefaultNumAllocated];
 }
@@ -506,6 +737,7 @@ void aiMaterial::Clear() {
         AI_DEBUG_INVALIDATE_PTR(mProperties[i]);
     }
     mNumProperties = 0;
+    ReleaseMaterialPropertyIndex(this);
 
     // The array remains allocated, we just invalidated its contents
 }
@@ -514,24 +746,23 @@ void aiMaterial::Clear() {
 aiReturn aiMaterial::RemoveProperty(const char *pKey, unsigned int type, unsigned int index) {
     ai_assert(nullptr != pKey);
 
-    for (unsigned int i = 0; i < mNumProperties; ++i) {
-        aiMaterialProperty *prop = mProperties[i];
+    const unsigned int i = FindPropertyPosition(this, pKey, type, index, false);
+    if (UINT_MAX == i) {
+        return AI_FAILURE;
+    }
 
-        if (prop && !strcmp(prop->mKey.data, pKey) &&
-                prop->mSemantic == type && prop->mIndex == index) {
-            // Delete this entry
-            delete mProperties[i];
+    // Delete this entry
+    delete mProperties[i];
 
-            // collapse the array behind --.
-            --mNumProperties;
-            for (unsigned int a = i; a < mNumProperties; ++a) {
-                mProperties[a] = mProperties[a + 1];
-            }
-            return AI_SUCCESS;
-        }
+    // collapse the array behind --.
+    --mNumProperties;
+    for (unsigned int a = i; a < mNumProperties; ++a) {
+        mProperties[a] = mProperties[a + 1];
     }
 
-    return AI_FAILURE;
+    // the positions behind have moved
+    UpdatePropertyIndex(this);
+    return AI_SUCCESS;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -550,17 +781,11 @@ aiReturn aiMaterial::AddBinaryProperty(const void *pInput,
     }
 
     // first search the list whether there is already an entry with this key
-    unsigned int iOutIndex(UINT_MAX);
-    for (unsigned int i = 0; i < mNumProperties; ++i) {
-        aiMaterialProperty *prop(mProperties[i]);
-
-        if (prop /* just for safety */ && !strcmp(prop->mKey.data, pKey) &&
-                prop->mSemantic == type && prop->mIndex == index) {
-
-            delete mProperties[i];
-            iOutIndex = i;
-        }
+    const unsigned int iOutIndex = FindPropertyPosition(this, pKey, type, index, false);
+    if (UINT_MAX != iOutIndex) {
+        delete mProperties[iOutIndex];
     }
+    const bool indexed = IsIndexCurrent(this);
 
     // Allocate a new material property
     std::unique_ptr<aiMaterialProperty> pcNew(new aiMaterialProperty());
@@ -580,6 +805,9 @@ aiReturn aiMaterial::AddBinaryProperty(const void *pInput,
 
     if (UINT_MAX != iOutIndex) {
         mProperties[iOutIndex] = pcNew.release();
+        if (indexed) {
+            mPropertyIndex->mChecksum = ComputePropertyChecksum(this);
+        }
         return AI_SUCCESS;
     }
 
@@ -602,8 +830,22 @@ aiReturn aiMaterial::AddBinaryProperty(const void *pInput,
         mProperties = ppTemp;
     }
     // push back ...
+    const uint32_t hash = HashPropertyKey(pcNew->mKey.data, pcNew->mKey.length);
     mProperties[mNumProperties++] = pcNew.release();
 
+    // ... and append the property to the index while it stays sparse enough
+    aiMaterialPropertyIndex *idx = mPropertyIndex;
+    if (indexed && mNumProperties * 2 <= idx->mMask + 1) {
+        idx->mNext.push_back(UINT_MAX);
+        idx->mHashes.push_back(0);
+        LinkIndexEntry(idx, mNumProperties - 1, hash);
+        idx->mProperties = mProperties;
+        idx->mNumProperties = mNumProperties;
+        idx->mChecksum = MixPropertyChecksum(idx->mChecksum, mProperties[mNumProperties - 1]);
+    } else {
+        UpdatePropertyIndex(this);
+    }
+
     return AI_SUCCESS;
 }
 
@@ -700,4 +942,5 @@ void aiMaterial::CopyPropertyList(aiMaterial *const pcDest,
         prop->mData = new char[propSrc->mDataLength];
         memcpy(prop->mData, propSrc->mData, prop->mDataLength);
     }
+    UpdatePropertyIndex(pcDest);
 }
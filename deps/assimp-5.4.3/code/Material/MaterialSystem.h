@@ -66,6 +66,21 @@ namespace Assimp    {
  */
 uint32_t ComputeMaterialHash(const aiMaterial* mat, bool includeMatName = false);
 
+// ------------------------------------------------------------------------------
+/** (Re)builds the hashed property lookup table of a material. The mutators
+ *  of aiMaterial keep the table current, this is needed only for materials
+ *  whose property list was assembled or edited directly.
+ *  @param  mat The material, materials with few properties are skipped
+ */
+void BuildMaterialPropertyIndex(aiMaterial* mat);
+
+// ------------------------------------------------------------------------------
+/** Frees the hashed property lookup table of a material. Needed for
+ *  code which edits #aiMaterial::mProperties in place.
+ *  @param  mat The material
+ */
+void ReleaseMaterialPropertyIndex(aiMaterial* mat);
+
 
 } // ! namespace Assimp
 
@@ -41,19 +41,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assimp/BaseImporter.h>
 #include <assimp/DefaultLogger.hpp>
+#include <assimp/StringTable.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
 namespace Assimp {
 
-static bool IsBoneNode(const aiString &bone_name, std::vector<aiBone *> &bones) {
-    for (aiBone *bone : bones) {
-        if (bone->mName == bone_name) {
-            return true;
-        }
-    }
-
-    return false;
+// The table holds the bone names only, so any name found in it is a bone name
+static bool IsBoneNode(const aiString &node_name, const StringTable &bone_names) {
+    return bone_names.Find(node_name) != AI_STRING_HANDLE_INVALID;
 }
 
 bool ArmaturePopulate::IsActive(unsigned int pFlags) const {
@@ -73,7 +69,13 @@ void ArmaturePopulate::Execute(aiScene *out) {
     BuildBoneList(out->mRootNode, out->mRootNode, out, bones);
     BuildNodeList(out->mRootNode, nodes);
 
-    BuildBoneStack(out->mRootNode, out, bones, bone_stack, nodes);
+    // match names by handle instead of comparing strings for every pair of bone and node
+    StringTable bone_names;
+    for (const aiBone *bone : bones) {
+        bone_names.Intern(bone->mName);
+    }
+
+    BuildBoneStack(out->mRootNode, out, bones, bone_names, bone_stack, nodes);
 
     ASSIMP_LOG_DEBUG("Bone stack size: ", bone_stack.size());
 
@@ -83,7 +85,7 @@ void ArmaturePopulate::Execute(aiScene *out) {
         ASSIMP_LOG_VERBOSE_DEBUG("active node lookup: ", bone->mName.C_Str());
         
         // lcl transform grab - done in generate_nodes :)
-        aiNode *armature = GetArmatureRoot(bone_node, bones);
+        aiNode *armature = GetArmatureRoot(bone_node, bone_names);
 
         ai_assert(armature);
 
@@ -164,6 +166,7 @@ void ArmaturePopulate::BuildNodeList(const aiNode *current_node,
 void ArmaturePopulate::BuildBoneStack(const aiNode *root_node,
                                       const aiScene*,
                                       const std::vector<aiBone *> &bones,
+                                      const StringTable &bone_names,
                                       std::map<aiBone *, aiNode *> &bone_stack,
                                   std::vector<aiNode *> &node_stack) {
     if (node_stack.empty()) {
@@ -171,15 +174,27 @@ void ArmaturePopulate::BuildBoneStack(const aiNode *root_node,
     }
     ai_assert(nullptr != root_node);
 
+    // the bone name handle of each node in the stack, kept in step with it
+    std::vector<aiStringHandle> node_handles;
+    auto get_handles = [&bone_names, &node_handles](const std::vector<aiNode *> &nodes) {
+        node_handles.clear();
+        for (const aiNode *node : nodes) {
+            node_handles.push_back(bone_names.Find(node->mName));
+        }
+    };
+    get_handles(node_stack);
+
     for (aiBone *bone : bones) {
         ai_assert(bone);
-        aiNode *node = GetNodeFromStack(bone->mName, node_stack);
+        const aiStringHandle bone_handle = bone_names.Find(bone->mName);
+        aiNode *node = GetNodeFromStack(bone_handle, node_stack, node_handles);
         if (node == nullptr) {
             node_stack.clear();
             BuildNodeList(root_node, node_stack);
+            get_handles(node_stack);
             ASSIMP_LOG_VERBOSE_DEBUG("Resetting bone stack: nullptr element ", bone->mName.C_Str());
 
-            node = GetNodeFromStack(bone->mName, node_stack);
+            node = GetNodeFromStack(bone_handle, node_stack, node_handles);
 
             if (nullptr == node) {
                 ASSIMP_LOG_ERROR("serious import issue node for bone was not detected");
@@ -197,9 +212,9 @@ void ArmaturePopulate::BuildBoneStack(const aiNode *root_node,
 // This is required to be detected for a bone initially, it will recurse up
 // until it cannot find another bone and return the node No known failure
 // points. (yet)
-aiNode *ArmaturePopulate::GetArmatureRoot(aiNode *bone_node, std::vector<aiBone *> &bone_list) {
+aiNode *ArmaturePopulate::GetArmatureRoot(aiNode *bone_node, const StringTable &bone_names) {
     while (nullptr != bone_node) {
-        if (!IsBoneNode(bone_node->mName, bone_list)) {
+        if (!IsBoneNode(bone_node->mName, bone_names)) {
             ASSIMP_LOG_VERBOSE_DEBUG("GetArmatureRoot() Found valid armature: ", bone_node->mName.C_Str());
             return bone_node;
         }
@@ -217,24 +232,27 @@ aiNode *ArmaturePopulate::GetArmatureRoot(aiNode *bone_node, std::vector<aiBone
 // Known flaw: cannot have nodes with bone names, will be fixed in later release
 // (serious to be fixed) Known flaw: nodes which have more than one bone could
 // be prematurely dropped from stack
-aiNode *ArmaturePopulate::GetNodeFromStack(const aiString &node_name,
-                                           std::vector<aiNode *> &nodes) {
-    std::vector<aiNode *>::iterator iter;
+aiNode *ArmaturePopulate::GetNodeFromStack(aiStringHandle node_name,
+                                           std::vector<aiNode *> &nodes,
+                                           std::vector<aiStringHandle> &node_handles) {
+    ai_assert(nodes.size() == node_handles.size());
     aiNode *found = nullptr;
-    for (iter = nodes.begin(); iter < nodes.end(); ++iter) {
-        aiNode *element = *iter;
-        ai_assert(nullptr != element);
-        // node valid and node name matches
-        if (element->mName == node_name) {
-            found = element;
-            break;
+    size_t index = 0;
+    if (node_name != AI_STRING_HANDLE_INVALID) {
+        for (; index < node_handles.size(); ++index) {
+            // node name matches
+            if (node_handles[index] == node_name) {
+                found = nodes[index];
+                break;
+            }
         }
     }
 
     if (found != nullptr) {
         ASSIMP_LOG_INFO("Removed node from stack: ", found->mName.C_Str());
         // now pop the element from the node list
-        nodes.erase(iter);
+        nodes.erase(nodes.begin() + index);
+        node_handles.erase(node_handles.begin() + index);
 
         return found;
     }
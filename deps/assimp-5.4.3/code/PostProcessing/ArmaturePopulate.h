@@ -53,6 +53,8 @@ struct aiBone;
 
 namespace Assimp {
 
+class StringTable;
+
 // ---------------------------------------------------------------------------
 /** Armature Populate: This is a post process designed
  * To save you time when importing models into your game engines
@@ -77,6 +79,11 @@ public:
     /// Overwritten, @see BaseProcess
     virtual bool IsActive( unsigned int pFlags ) const;
 
+    /// Overwritten, @see BaseProcess
+    virtual bool SupportsIndexBuffer() const {
+        return true;
+    }
+
     /// Overwritten, @see BaseProcess
     virtual void SetupProperties( const Importer* pImp );
 
@@ -84,10 +91,11 @@ public:
     virtual void Execute( aiScene* pScene );
 
     static aiNode *GetArmatureRoot(aiNode *bone_node,
-                                      std::vector<aiBone *> &bone_list);
+                                      const StringTable &bone_names);
 
-    static aiNode *GetNodeFromStack(const aiString &node_name,
-                                       std::vector<aiNode *> &nodes);
+    static aiNode *GetNodeFromStack(aiStringHandle node_name,
+                                       std::vector<aiNode *> &nodes,
+                                       std::vector<aiStringHandle> &node_handles);
 
     static void BuildNodeList(const aiNode *current_node,
                                  std::vector<aiNode *> &nodes);
@@ -99,6 +107,7 @@ public:
     static void BuildBoneStack(const aiNode *root_node,
                                   const aiScene *scene,
                                   const std::vector<aiBone *> &bones,
+                                  const StringTable &bone_names,
                                   std::map<aiBone *, aiNode *> &bone_stack,
                                   std::vector<aiNode *> &node_stack);
 };
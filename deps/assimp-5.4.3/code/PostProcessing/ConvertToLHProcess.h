@@ -80,6 +80,11 @@ public:
     // -------------------------------------------------------------------
     bool IsActive( unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     // -------------------------------------------------------------------
     void Execute( aiScene* pScene) override;
 
@@ -137,6 +142,11 @@ public:
     // -------------------------------------------------------------------
     bool IsActive( unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     // -------------------------------------------------------------------
     void Execute( aiScene* pScene) override;
 
@@ -161,6 +171,11 @@ public:
     // -------------------------------------------------------------------
     bool IsActive( unsigned int pFlags) const;
 
+    // -------------------------------------------------------------------
+    bool SupportsIndexBuffer() const {
+        return true;
+    }
+
     // -------------------------------------------------------------------
     void Execute( aiScene* pScene);
 
@@ -70,6 +70,11 @@ public:
     /// Overwritten, @see BaseProcess
     bool IsActive(unsigned int pFlags) const override;
 
+    /// Overwritten, @see BaseProcess
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     /// Overwritten, @see BaseProcess
     void SetupProperties(const Importer* pImp) override;
 
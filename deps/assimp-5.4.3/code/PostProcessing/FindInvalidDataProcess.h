@@ -73,6 +73,11 @@ public:
     /// Returns active state.
     bool IsActive(unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     // -------------------------------------------------------------------
     /// Setup import settings
     void SetupProperties(const Importer *pImp) override;
@@ -71,6 +71,11 @@ public:
     // Check whether the pp step is active
     bool IsActive( unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     // -------------------------------------------------------------------
     // Executes the pp step on a given scene
     void Execute( aiScene* pScene) override;
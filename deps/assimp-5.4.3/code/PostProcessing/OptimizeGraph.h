@@ -79,6 +79,11 @@ public:
     // -------------------------------------------------------------------
     bool IsActive( unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     // -------------------------------------------------------------------
     void Execute( aiScene* pScene) override;
 
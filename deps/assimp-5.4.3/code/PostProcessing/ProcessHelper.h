@@ -340,6 +340,10 @@ class ComputeSpatialSortProcess : public BaseProcess {
                                                            aiProcess_GenNormals | aiProcess_JoinIdenticalVertices));
     }
 
+    bool SupportsIndexBuffer() const {
+        return true;
+    }
+
     void Execute(aiScene *pScene) {
         typedef std::pair<SpatialSort, ai_real> _Type;
         ASSIMP_LOG_DEBUG("Generate spatially-sorted vertex cache");
@@ -366,6 +370,10 @@ class DestroySpatialSortProcess : public BaseProcess {
                                                         aiProcess_GenNormals | aiProcess_JoinIdenticalVertices));
     }
 
+    bool SupportsIndexBuffer() const {
+        return true;
+    }
+
     void Execute(aiScene * /*pScene*/) {
         shared->RemoveProperty(AI_SPP_SPATIAL_SORT);
     }
@@ -68,6 +68,11 @@ public:
     // Check whether step is active
     bool IsActive( unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     // -------------------------------------------------------------------
     // Execute step on a given scene
     void Execute( aiScene* pScene) override;
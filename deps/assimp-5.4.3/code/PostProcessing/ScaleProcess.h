@@ -76,6 +76,11 @@ public:
     /// Overwritten, @see BaseProcess
     virtual bool IsActive( unsigned int pFlags ) const override;
 
+    /// Overwritten, @see BaseProcess
+    virtual bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     /// Overwritten, @see BaseProcess
     virtual void SetupProperties( const Importer* pImp ) override;
 
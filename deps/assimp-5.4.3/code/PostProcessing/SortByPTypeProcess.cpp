@@ -163,6 +163,9 @@ void SortByPTypeProcess::Execute(aiScene *pScene) {
         }
         bAnyChanges = true;
 
+        // the submeshes take over the index arrays of the faces
+        mesh->ReleaseIndexBuffer();
+
         // reuse our current mesh arrays for the submesh
         // with the largest number of primitives
         unsigned int aiNumPerPType[4] = { 0, 0, 0, 0 };
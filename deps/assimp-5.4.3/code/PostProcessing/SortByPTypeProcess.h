@@ -68,6 +68,12 @@ public:
     // -------------------------------------------------------------------
     bool IsActive( unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    // Meshes which need to be split drop their index buffer
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
     // -------------------------------------------------------------------
     void Execute( aiScene* pScene) override;
 
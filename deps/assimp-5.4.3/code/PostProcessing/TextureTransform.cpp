@@ -47,6 +47,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/scene.h>
 
 #include "TextureTransform.h"
+#include "Material/MaterialSystem.h"
 #include <assimp/StringUtils.h>
 
 using namespace Assimp;
@@ -333,6 +334,9 @@ void TextureTransformStep::Execute( aiScene* pScene) {
                 }
             }
         }
+
+        // $tex.uvtrafo properties have been removed from the list directly
+        BuildMaterialPropertyIndex(mat);
     }
 
     char buffer[1024]; // should be sufficiently large
@@ -225,6 +225,9 @@ bool TriangulateProcess::TriangulateMesh( aiMesh* pMesh) {
         ASSIMP_LOG_ERROR( "Invalidation detected in the number of indices: does not fit to the primitive type." );
         return false;
     }
+
+    // the faces are rebuilt one by one
+    pMesh->ReleaseIndexBuffer();
     
     aiVector3D *nor_out = nullptr;
 
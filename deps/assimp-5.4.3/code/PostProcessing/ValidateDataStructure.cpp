@@ -58,13 +58,18 @@ using namespace Assimp;
 
 // ------------------------------------------------------------------------------------------------
 // Constructor to be privately used by Importer
-ValidateDSProcess::ValidateDSProcess() : mScene(nullptr) {}
+ValidateDSProcess::ValidateDSProcess() : mScene(nullptr), mAllowPointClouds(false) {}
 
 // ------------------------------------------------------------------------------------------------
 // Returns whether the processing step is present in the given flag field.
 bool ValidateDSProcess::IsActive(unsigned int pFlags) const {
     return (pFlags & aiProcess_ValidateDataStructure) != 0;
 }
+
+// ------------------------------------------------------------------------------------------------
+void ValidateDSProcess::SetupProperties(const Importer *pImp) {
+    mAllowPointClouds = pImp->GetPropertyBool(AI_CONFIG_IMPORT_POINT_CLOUD, false);
+}
 // ------------------------------------------------------------------------------------------------
 AI_WONT_RETURN void ValidateDSProcess::ReportError(const char *msg, ...) {
     ai_assert(nullptr != msg);
@@ -338,8 +343,9 @@ void ValidateDSProcess::Validate(const aiMesh *pMesh) {
         ReportError("If there are tangents, bitangent vectors must be present as well");
     }
 
-    // faces, too
-    if (!pMesh->mNumFaces || (!pMesh->mFaces && !mScene->mFlags)) {
+    // faces, too - except for point clouds, which consist of vertices only
+    const bool pointCloud = mAllowPointClouds && pMesh->mPrimitiveTypes == aiPrimitiveType_POINT && !pMesh->mNumFaces && !pMesh->mFaces;
+    if (!pointCloud && (!pMesh->mNumFaces || (!pMesh->mFaces && !mScene->mFlags))) {
         ReportError("Mesh %s contains no faces", pMesh->mName.C_Str());
     }
 
@@ -367,7 +373,7 @@ void ValidateDSProcess::Validate(const aiMesh *pMesh) {
         if (!abRefList[i]) b = true;
     }
     abRefList.clear();
-    if (b) {
+    if (b && !pointCloud) {
         ReportWarning("There are unreferenced vertices");
     }
 
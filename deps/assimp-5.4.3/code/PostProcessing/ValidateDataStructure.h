@@ -79,6 +79,14 @@ public:
     // -------------------------------------------------------------------
     bool IsActive( unsigned int pFlags) const override;
 
+    // -------------------------------------------------------------------
+    bool SupportsIndexBuffer() const override {
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    void SetupProperties(const Importer* pImp) override;
+
     // -------------------------------------------------------------------
     void Execute( aiScene* pScene) override;
 
@@ -185,6 +193,9 @@ private:
         const char* firstName, const char* secondName);
 
     aiScene* mScene;
+
+    // point clouds may consist of vertices only, see AI_CONFIG_IMPORT_POINT_CLOUD
+    bool mAllowPointClouds;
 };
 
 
@@ -50,6 +50,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/ParsingUtils.h>
 #include <assimp/types.h>
 #include <assimp/IOStream.hpp>
+#include <assimp/MemoryAllocator.hpp>
 
 #include <vector>
 
@@ -122,7 +123,7 @@ private:
     size_t m_cacheSize;
     size_t m_numBlocks;
     size_t m_blockIdx;
-    std::vector<T> m_cache;
+    std::vector<T, TrackedAllocator<T>> m_cache;
     size_t m_cachePos;
     size_t m_filePos;
 };
@@ -65,6 +65,7 @@ namespace Assimp {
 class Importer;
 class IOStream;
 class IOSystem;
+class MemoryAllocator;
 class ProgressHandler;
 
 // =======================================================================
@@ -93,6 +94,33 @@ struct aiImporterDesc;
 /** @namespace Assimp Assimp's CPP-API and all internal APIs */
 namespace Assimp {
 
+// ----------------------------------------------------------------------------------
+/** Wall-clock time and memory spent in one phase of the last import.
+ *  @see Importer::GetPhaseCount() */
+struct ImporterPhase {
+    /** Name of the phase: "import", "validate", "preprocess", "finalize",
+     *  the post-processing flag of a step (e.g. "aiProcess_Triangulate") or
+     *  a helper shared by several steps (e.g. "ComputeSpatialSort").
+     *  Points to static storage. */
+    const char *mName;
+
+    /** Elapsed time, in seconds. */
+    double mSeconds;
+
+    /** Number of allocations made through the #MemoryAllocator. These are
+     *  the buffers of the loaders listed there. The output scene (meshes,
+     *  vertex and index arrays, faces, nodes, materials) is allocated with
+     *  plain new and is not counted in any of the memory fields. */
+    size_t mAllocations;
+
+    /** Sum of the sizes of these allocations, in bytes. */
+    size_t mAllocatedBytes;
+
+    /** Highest amount of memory held from the #MemoryAllocator during the
+     *  phase, on top of the amount held when the phase began, in bytes. */
+    size_t mPeakBytes;
+};
+
 // ----------------------------------------------------------------------------------
 /** CPP-API: The Importer class forms an C++ interface to the functionality of the
 *   Open Asset Import Library.
@@ -376,6 +404,22 @@ public:
      */
     bool IsDefaultProgressHandler() const;
 
+    // -------------------------------------------------------------------
+    /** Supplies a custom memory allocator for the data of imports.
+     *
+     *  The allocator is used by subsequent calls to #ReadFile() on this
+     *  importer, see #MemoryAllocator for what it receives. The importer
+     *  does not take ownership; the allocator must stay alive as long as
+     *  any scene imported with it.
+     *  @param allocator The allocator, nullptr restores the default
+     *    allocator which uses the global heap. */
+    void SetMemoryAllocator(MemoryAllocator *allocator);
+
+    // -------------------------------------------------------------------
+    /** Retrieves the memory allocator that is currently set.
+     *  @return The custom allocator, nullptr if the default one is used. */
+    MemoryAllocator *GetMemoryAllocator() const;
+
     // -------------------------------------------------------------------
     /** @brief Check whether a given set of post-processing flags
      *  is supported.
@@ -638,6 +682,26 @@ public:
      *   is (naturally) not included.*/
     void GetMemoryRequirements(aiMemoryInfo &in) const;
 
+    // -------------------------------------------------------------------
+    /** Returns the number of phases timed during the last import.
+     *
+     * The list is reset by #ReadFile() and extended by every later call
+     * to #ApplyPostProcessing(). Post-processing steps which are not
+     * active are not listed.
+     * @return Number of entries available through #GetPhase(). */
+    size_t GetPhaseCount() const;
+
+    // -------------------------------------------------------------------
+    /** Returns the timing of one phase of the last import.
+     *
+     * The memory figures only cover allocations made through the
+     * #MemoryAllocator, not the data of the output scene. Use
+     * #GetMemoryRequirements() for the size of the scene.
+     * @param index Index to query, must be within [0,GetPhaseCount())
+     * @return Phase in execution order. nullptr if the index does
+     *     not exist. */
+    const ImporterPhase *GetPhase(size_t index) const;
+
     // -------------------------------------------------------------------
     /** Enables "extra verbose" mode.
      *
@@ -0,0 +1,169 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file MemoryAllocator.hpp
+ *  @brief Abstract base class 'MemoryAllocator' for the memory of imports.
+ */
+#pragma once
+#ifndef AI_MEMORYALLOCATOR_H_INC
+#define AI_MEMORYALLOCATOR_H_INC
+
+#ifdef __GNUC__
+#   pragma GCC system_header
+#endif
+
+#include <assimp/types.h>
+
+#include <cstddef>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------
+/** @brief CPP-API: Abstract interface for custom allocators of import data.
+ *
+ *  An allocator is assigned to an #Importer with Importer::SetMemoryAllocator().
+ *  It receives the large blocks allocated while that importer reads a file:
+ *  the parse buffers of the FBX loader, the binary buffers of the glTF2
+ *  loader and the line caches of the text loaders using IOStreamBuffer.
+ *  The output scene itself is not allocated from it.
+ *
+ *  Memory is always returned to the allocator that provided it, even if it
+ *  is released after the import has finished. The allocator must therefore
+ *  outlive all memory allocated from it.
+ *  Both functions may be called from several threads at the same time. */
+class ASSIMP_API MemoryAllocator
+#ifndef SWIG
+    : public Intern::AllocateFromAssimpHeap
+#endif
+{
+protected:
+    /// @brief  Default constructor
+    MemoryAllocator() AI_NO_EXCEPT = default;
+
+public:
+    /// @brief  Virtual destructor.
+    virtual ~MemoryAllocator() = default;
+
+    // -------------------------------------------------------------------
+    /** @brief Allocates a block of memory.
+     *  @param size      Number of bytes, may be 0.
+     *  @param alignment Required alignment, a power of two which is not
+     *    larger than alignof(std::max_align_t).
+     *  @return The block. Failures are reported with std::bad_alloc. */
+    virtual void *Allocate(size_t size, size_t alignment) = 0;
+
+    // -------------------------------------------------------------------
+    /** @brief Releases a block returned by Allocate().
+     *  @param data      The block.
+     *  @param size      Size passed to Allocate().
+     *  @param alignment Alignment passed to Allocate(). */
+    virtual void Free(void *data, size_t size, size_t alignment) = 0;
+
+    // -------------------------------------------------------------------
+    /** @brief Returns the allocator of the import running on the calling
+     *  thread, or the default allocator using the global heap. */
+    static MemoryAllocator *GetCurrent();
+
+    // -------------------------------------------------------------------
+    /** @brief Allocates from an allocator and records the allocation for
+     *  the import running on the calling thread, see Importer::GetPhase().
+     *  The allocator receives a few more bytes, which remember the import.
+     *  @param allocator Allocator, usually obtained from GetCurrent().
+     *  @param alignment At most alignof(std::max_align_t). */
+    static void *AllocateTracked(MemoryAllocator *allocator, size_t size, size_t alignment);
+
+    // -------------------------------------------------------------------
+    /** @brief Counterpart of AllocateTracked(). The release is credited to
+     *  the import which made the allocation, whichever import is running
+     *  on the calling thread and even if its importer no longer exists. */
+    static void FreeTracked(MemoryAllocator *allocator, void *data, size_t size, size_t alignment);
+};
+
+// ------------------------------------------------------------------------------------
+/** @brief Standard library allocator forwarding to the MemoryAllocator which
+ *  was current when it was constructed, e.g. for buffers of loaders. */
+template <typename T>
+class TrackedAllocator {
+public:
+    using value_type = T;
+
+    TrackedAllocator() :
+            mAllocator(MemoryAllocator::GetCurrent()) {
+        // empty
+    }
+
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U> &other) AI_NO_EXCEPT :
+            mAllocator(other.GetAllocator()) {
+        // empty
+    }
+
+    T *allocate(size_t count) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+        return static_cast<T *>(MemoryAllocator::AllocateTracked(mAllocator, count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *data, size_t count) AI_NO_EXCEPT {
+        MemoryAllocator::FreeTracked(mAllocator, data, count * sizeof(T), alignof(T));
+    }
+
+    MemoryAllocator *GetAllocator() const {
+        return mAllocator;
+    }
+
+    template <typename U>
+    bool operator==(const TrackedAllocator<U> &other) const {
+        return mAllocator == other.GetAllocator();
+    }
+
+    template <typename U>
+    bool operator!=(const TrackedAllocator<U> &other) const {
+        return mAllocator != other.GetAllocator();
+    }
+
+private:
+    MemoryAllocator *mAllocator;
+};
+
+} // Namespace Assimp
+
+#endif // AI_MEMORYALLOCATOR_H_INC
@@ -0,0 +1,133 @@
+/*
+Open Asset Import Library (assimp)
+----------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the
+following conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------
+*/
+
+/** @file StringTable.h
+ *  @brief A table of unique strings with 32 bit handles
+ */
+#pragma once
+#ifndef AI_STRINGTABLE_H_INC
+#define AI_STRINGTABLE_H_INC
+
+#ifdef __GNUC__
+#pragma GCC system_header
+#endif
+
+#include <assimp/types.h>
+#include <vector>
+
+namespace Assimp {
+
+// ------------------------------------------------------------------------------------------------
+/** A table of unique strings, each one identified by a 32 bit handle (see #aiStringHandle).
+ *
+ *  The strings are stored back to back with a terminating zero, so an interned name costs its
+ *  length plus a few bytes of bookkeeping instead of a full aiString. The hash of every string is
+ *  computed once on insertion. Two names are equal if and only if their handles are equal, which
+ *  turns name matching (e.g. bones or animation channels to nodes) into an integer compare.
+ *
+ *  Handles are dense: the n-th distinct string gets the handle n, so they run from 0 to
+ *  Size() - 1 in insertion order and can index arrays kept next to the table. */
+// ------------------------------------------------------------------------------------------------
+class ASSIMP_API StringTable {
+public:
+    StringTable();
+
+    // ------------------------------------------------------------------------------------
+    /** Returns the handle of a string, adding it to the table if it isn't known yet.
+     *  @param str  The string, doesn't need to be zero-terminated.
+     *  @param len  Length of the string in bytes. */
+    aiStringHandle Intern(const char *str, size_t len);
+
+    aiStringHandle Intern(const aiString &str) {
+        return Intern(str.data, str.length);
+    }
+
+    // ------------------------------------------------------------------------------------
+    /** Returns the handle of a string or #AI_STRING_HANDLE_INVALID if it isn't in the table. */
+    aiStringHandle Find(const char *str, size_t len) const;
+
+    aiStringHandle Find(const aiString &str) const {
+        return Find(str.data, str.length);
+    }
+
+    // ------------------------------------------------------------------------------------
+    /** Returns the zero-terminated string for a valid handle. */
+    const char *GetString(aiStringHandle handle) const {
+        return &mChars[mEntries[handle].mOffset];
+    }
+
+    /** Returns the length in bytes of the string for a valid handle. */
+    unsigned int GetLength(aiStringHandle handle) const {
+        return mEntries[handle].mLength;
+    }
+
+    /** Returns the precomputed hash of the string for a valid handle. */
+    uint32_t GetHash(aiStringHandle handle) const {
+        return mEntries[handle].mHash;
+    }
+
+    /** Returns the number of strings in the table. */
+    unsigned int Size() const {
+        return static_cast<unsigned int>(mEntries.size());
+    }
+
+    // ------------------------------------------------------------------------------------
+    /** Computes the hash used by the table (32 bit FNV-1a). */
+    static uint32_t Hash(const char *str, size_t len);
+
+private:
+    void Grow();
+
+    struct Entry {
+        uint32_t mOffset;
+        uint32_t mLength;
+        uint32_t mHash;
+    };
+
+    std::vector<char> mChars;
+    std::vector<Entry> mEntries;
+    std::vector<aiStringHandle> mSlots; // open addressing, the size is a power of two
+};
+
+} // namespace Assimp
+
+#endif // AI_STRINGTABLE_H_INC
@@ -71,6 +71,11 @@ public:
     // Specific to ZIP
     //! The file was opened and is a ZIP
     bool isOpen() const;
+    //! Open a file which is inflated while it is read instead of being
+    //! extracted into memory at once. The returned stream only supports
+    //! sequential reading. No other file of the archive may be opened
+    //! before it is closed again.
+    IOStream* OpenStreamed(const char* pFilename);
 
     //! Get the list of all files with their simplified paths
     //! Intended for use within Assimp library boundaries
@@ -59,6 +59,7 @@ extern "C" {
 
 struct aiScene;
 struct aiTexture;
+struct aiNode;
 struct aiFileIO;
 
 typedef void (*aiLogStreamCallback)(const char * /* message */, char * /* user */);
@@ -374,6 +375,50 @@ ASSIMP_API void aiGetMemoryRequirements(
         const C_STRUCT aiScene *pIn,
         C_STRUCT aiMemoryInfo *in);
 
+// --------------------------------------------------------------------------------
+/** Builds the name table of a scene, see #AI_CONFIG_IMPORT_INTERN_NAMES.
+ *
+ * The names of all nodes, bones and node animation channels are interned,
+ * each distinct name gets a handle. The table is kept with the scene, the
+ * scene's structures are not modified. Call this again after changing names.
+ * It must not run while other threads use the table of the same scene.
+ * @param pScene The scene, must have been created by assimp or with the
+ *   aiScene constructor.
+ * @return AI_SUCCESS, or AI_FAILURE if the scene has no private data.
+ */
+ASSIMP_API aiReturn aiBuildSceneNameTable(
+        const C_STRUCT aiScene *pScene);
+
+// --------------------------------------------------------------------------------
+/** Returns the handle of a name in the name table of a scene.
+ * @param pScene The scene.
+ * @param pName The name, e.g. aiBone::mName or aiNodeAnim::mNodeName.
+ * @return The handle, AI_STRING_HANDLE_INVALID if the name is not in the
+ *   table or the scene has no table (see aiBuildSceneNameTable()).
+ */
+ASSIMP_API aiStringHandle aiGetNameHandle(
+        const C_STRUCT aiScene *pScene,
+        const C_STRUCT aiString *pName);
+
+// --------------------------------------------------------------------------------
+/** Returns the handle of the name of a node, see aiGetNameHandle(). */
+ASSIMP_API aiStringHandle aiGetNodeNameHandle(
+        const C_STRUCT aiScene *pScene,
+        const C_STRUCT aiNode *pNode);
+
+// --------------------------------------------------------------------------------
+/** Returns the node for a name handle.
+ * This is what aiNode::FindNode() returns for the name on the root node, but
+ * without any string compare.
+ * @param pScene The scene.
+ * @param handle A handle of the scene's name table.
+ * @return The first node with that name in pre-order, NULL if no node has
+ *   the name, the handle is invalid or the scene has no name table.
+ */
+ASSIMP_API const C_STRUCT aiNode *aiFindNodeByHandle(
+        const C_STRUCT aiScene *pScene,
+        aiStringHandle handle);
+
 // --------------------------------------------------------------------------------
 /** Returns an embedded texture, or nullptr.
  * @param pIn Input asset.
@@ -691,6 +691,78 @@ struct aiMaterialProperty {
 };
 //! @endcond
 
+// ---------------------------------------------------------------------------
+/** @brief The physically based shading parameters of a material, decoded
+ *  in one go by #aiGetMaterialPbrParameters().
+ *
+ *  Members which are not stored in the material keep their default, the
+ *  defaults are the ones of the glTF 2.0 metallic-roughness model.
+ */
+struct aiPbrParameters {
+    /** #AI_MATKEY_BASE_COLOR, or #AI_MATKEY_COLOR_DIFFUSE if the material
+     *  has no base color. Default: (1,1,1,1) */
+    C_STRUCT aiColor4D mBaseColor;
+
+    /** #AI_MATKEY_COLOR_EMISSIVE. Default: (0,0,0) */
+    C_STRUCT aiColor3D mEmissiveColor;
+
+    /** #AI_MATKEY_SHEEN_COLOR_FACTOR. Default: (0,0,0) */
+    C_STRUCT aiColor3D mSheenColor;
+
+    /** #AI_MATKEY_METALLIC_FACTOR. Default: 1 */
+    ai_real mMetallicFactor;
+
+    /** #AI_MATKEY_ROUGHNESS_FACTOR. Default: 1 */
+    ai_real mRoughnessFactor;
+
+    /** #AI_MATKEY_SPECULAR_FACTOR. Default: 1 */
+    ai_real mSpecularFactor;
+
+    /** #AI_MATKEY_GLOSSINESS_FACTOR. Default: 1 */
+    ai_real mGlossinessFactor;
+
+    /** #AI_MATKEY_SHEEN_ROUGHNESS_FACTOR. Default: 0 */
+    ai_real mSheenRoughnessFactor;
+
+    /** #AI_MATKEY_CLEARCOAT_FACTOR. Default: 0 */
+    ai_real mClearcoatFactor;
+
+    /** #AI_MATKEY_CLEARCOAT_ROUGHNESS_FACTOR. Default: 0 */
+    ai_real mClearcoatRoughnessFactor;
+
+    /** #AI_MATKEY_TRANSMISSION_FACTOR. Default: 0 */
+    ai_real mTransmissionFactor;
+
+    /** #AI_MATKEY_VOLUME_THICKNESS_FACTOR. Default: 0 */
+    ai_real mVolumeThicknessFactor;
+
+    /** #AI_MATKEY_EMISSIVE_INTENSITY. Default: 1 */
+    ai_real mEmissiveIntensity;
+
+    /** #AI_MATKEY_OPACITY. Default: 1 */
+    ai_real mOpacity;
+
+    /** #AI_MATKEY_REFRACTI. Default: 1.5 */
+    ai_real mIor;
+
+    /** #AI_MATKEY_TWOSIDED. Default: 0 */
+    int mTwoSided;
+
+    /** #AI_MATKEY_SHADING_MODEL, one of the #aiShadingMode values.
+     *  Default: #aiShadingMode_PBR_BRDF */
+    int mShadingModel;
+
+    /** Bit (1 << type) is set for each #aiTextureType the material has
+     *  at least one texture for. */
+    unsigned int mTextureMask;
+};
+
+//! @cond AI_DOX_INCLUDE_INTERNAL
+/** Lookup table over the properties of a material, owned by the
+ *  material system. */
+struct aiMaterialPropertyIndex;
+//! @endcond
+
 #ifdef __cplusplus
 } // We need to leave the "C" block here to allow template member functions
 #endif
@@ -946,6 +1018,13 @@ public:
     static void CopyPropertyList(aiMaterial *pcDest,
             const aiMaterial *pcSrc);
 
+    // ------------------------------------------------------------------------------
+    /** @brief Decode all physically based shading parameters at once.
+     *
+     *  See #aiGetMaterialPbrParameters() for the details.
+     *  @param pOut Receives the parameters */
+    aiReturn GetPbrParameters(aiPbrParameters &pOut) const;
+
 #endif
 
     /** List of all material properties loaded. */
@@ -956,6 +1035,20 @@ public:
 
     /** Storage allocated */
     unsigned int mNumAllocated;
+
+    /** Hashed lookup table over #mProperties of materials with many
+     *  properties. AddProperty(), RemoveProperty() and Clear() keep it up
+     *  to date, lookups never modify it, so a material can be read from
+     *  several threads. Lookups ignore the table once #mProperties,
+     *  #mNumProperties or the property pointers no longer match it, so
+     *  properties replaced, added or reordered directly in #mProperties
+     *  are still found, by a linear scan. Changing the key, semantic or
+     *  index of a property object in place is not detected; the library
+     *  rebuilds the table with Assimp::BuildMaterialPropertyIndex() where
+     *  it does that, other code should use RemoveProperty() and
+     *  AddProperty() instead. Like aiMesh::mIndexBuffer, this is data owned
+     *  by the object and maintained by its own functions. */
+    C_STRUCT aiMaterialPropertyIndex *mPropertyIndex;
 };
 
 // Go back to extern "C" again
@@ -1623,6 +1716,21 @@ ASSIMP_API C_ENUM aiReturn aiGetMaterialString(const C_STRUCT aiMaterial *pMat,
         unsigned int index,
         C_STRUCT aiString *pOut);
 
+// ---------------------------------------------------------------------------
+/** @brief Decode all physically based shading parameters of a material
+ *  into a single structure.
+ *
+ *  This is a shortcut for the dozen of aiGetMaterialFloat() and
+ *  aiGetMaterialColor() calls a PBR renderer does for each material,
+ *  members the material doesn't store keep the defaults documented
+ *  in #aiPbrParameters.
+ *  @param[in] pMat Pointer to the input material. May not be NULL
+ *  @param[out] pOut Receives the parameters. May not be NULL
+ *  @return AI_SUCCESS, or AI_FAILURE if one of the pointers is NULL */
+// ---------------------------------------------------------------------------
+ASSIMP_API C_ENUM aiReturn aiGetMaterialPbrParameters(const C_STRUCT aiMaterial *pMat,
+        C_STRUCT aiPbrParameters *pOut);
+
 // ---------------------------------------------------------------------------
 /** Get the number of textures for a particular texture type.
  *  @param[in] pMat Pointer to the input material. May not be NULL
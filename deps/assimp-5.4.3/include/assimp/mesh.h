@@ -132,6 +132,10 @@ extern "C" {
  * @endcode
  * Together with the #aiProcess_Triangulate flag you can then be sure that
  * #aiFace::mNumIndices is always 3.
+ * <br>
+ * If the owning mesh has an index buffer (see aiMesh::mIndexBuffer), mIndices
+ * points into that buffer and is not owned by the face. Such faces must not
+ * be assigned to; call aiMesh::ReleaseIndexBuffer() first to edit them.
  * @note Take a look at the @link data Data Structures page @endlink for
  * more information on the layout and winding order of a face.
  */
@@ -826,6 +830,19 @@ struct aiMesh {
      */
     C_STRUCT aiString **mTextureCoordsNames;
 
+    /**
+     * The number of indices in #mIndexBuffer.
+     */
+    unsigned int mIndexBufferSize;
+
+    /**
+     * Optional contiguous storage for the indices of all faces, in face order.
+     * If not nullptr, aiFace::mIndices of every face points into this buffer
+     * and the mesh owns the indices, not the faces. This saves one allocation
+     * per face. Enable it with #AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER.
+     */
+    unsigned int *mIndexBuffer;
+
 #ifdef __cplusplus
 
     //! The default class constructor.
@@ -848,7 +865,9 @@ struct aiMesh {
               mAnimMeshes(nullptr),
               mMethod(aiMorphingMethod_UNKNOWN),
               mAABB(),
-              mTextureCoordsNames(nullptr) {
+              mTextureCoordsNames(nullptr),
+              mIndexBufferSize(0),
+              mIndexBuffer(nullptr) {
         // empty
     }
 
@@ -894,6 +913,13 @@ struct aiMesh {
             delete[] mAnimMeshes;
         }
 
+        if (mIndexBuffer) {
+            // the faces don't own their indices
+            for (unsigned int a = 0; a < mNumFaces; a++) {
+                mFaces[a].mIndices = nullptr;
+            }
+            delete[] mIndexBuffer;
+        }
         delete[] mFaces;
     }
 
@@ -1027,6 +1053,63 @@ struct aiMesh {
         return mTextureCoordsNames[index];
     }
 
+    //! @brief  Check whether the indices of all faces are stored in one buffer
+    //! @return true, if #mIndexBuffer is set.
+    bool HasIndexBuffer() const {
+        return mIndexBuffer != nullptr;
+    }
+
+    //! @brief  Moves the indices of all faces into #mIndexBuffer.
+    //! The faces stay valid, their indices point into the buffer afterwards.
+    void CreateIndexBuffer() {
+        if (mIndexBuffer != nullptr || mFaces == nullptr) {
+            return;
+        }
+
+        unsigned int size = 0;
+        for (unsigned int a = 0; a < mNumFaces; a++) {
+            size += mFaces[a].mNumIndices;
+        }
+        if (size == 0) {
+            return;
+        }
+
+        mIndexBufferSize = size;
+        mIndexBuffer = new unsigned int[size];
+        unsigned int *p = mIndexBuffer;
+        for (unsigned int a = 0; a < mNumFaces; a++) {
+            aiFace &face = mFaces[a];
+            if (face.mNumIndices) {
+                ::memcpy(p, face.mIndices, face.mNumIndices * sizeof(unsigned int));
+            }
+            delete[] face.mIndices;
+            face.mIndices = face.mNumIndices ? p : nullptr;
+            p += face.mNumIndices;
+        }
+    }
+
+    //! @brief  Gives each face its own index array again and frees #mIndexBuffer.
+    //! Needed before faces are reallocated or handed over one by one.
+    void ReleaseIndexBuffer() {
+        if (mIndexBuffer == nullptr) {
+            return;
+        }
+
+        for (unsigned int a = 0; a < mNumFaces; a++) {
+            aiFace &face = mFaces[a];
+            if (face.mNumIndices) {
+                unsigned int *indices = new unsigned int[face.mNumIndices];
+                ::memcpy(indices, face.mIndices, face.mNumIndices * sizeof(unsigned int));
+                face.mIndices = indices;
+            } else {
+                face.mIndices = nullptr;
+            }
+        }
+        delete[] mIndexBuffer;
+        mIndexBuffer = nullptr;
+        mIndexBufferSize = 0;
+    }
+
 #endif // __cplusplus
 };
 
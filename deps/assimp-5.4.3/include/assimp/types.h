@@ -395,6 +395,16 @@ struct aiString {
     char data[AI_MAXLEN];
 }; // !struct aiString
 
+// ----------------------------------------------------------------------------------
+/** Handle of a string in a string table, e.g. the name table of a scene (see
+ *  aiBuildSceneNameTable()). Handles of the same table are equal if and only if
+ *  the strings are equal.
+ */
+typedef uint32_t aiStringHandle;
+
+/** The handle returned for strings that are not in the table. */
+#define AI_STRING_HANDLE_INVALID 0xffffffffu
+
 // ----------------------------------------------------------------------------------
 /** Standard return type for some library functions.
  * Rarely used, and if, mostly in the C API.
@@ -0,0 +1,636 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  Benchmark.cpp
+ *  @brief Importer throughput benchmark over the test models
+ *
+ *  Imports a curated set of models per format, plus synthetic grid meshes
+ *  of increasing size written by the exporters, and reports MB/s,
+ *  triangles/s, peak RSS and the time spent in every import phase.
+ *  The results can be written as JSON for regression tracking.
+ */
+
+#include <assimp/Exporter.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <assimp/version.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#   include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#   include <sys/resource.h>
+#endif
+#if defined(__GLIBC__)
+#   include <malloc.h>
+#endif
+
+namespace fs = std::filesystem;
+
+using namespace Assimp;
+
+namespace {
+
+// ------------------------------------------------------------------------------------------------
+// Curated models, relative to the test model directory. Small files are
+// dominated by per-file overhead, so prefer the largest sample per format.
+struct CuratedModel {
+    const char *format;
+    const char *path;
+};
+
+const CuratedModel CuratedModels[] = {
+    { "3ds", "3DS/fels.3ds" },
+    { "ac", "AC/Wuson.ac" },
+    { "b3d", "B3D/WusonBlitz.b3d" },
+    { "blend", "BLEND/box.blend" },
+    { "dae", "Collada/duck.dae" },
+    { "dxf", "DXF/wuson.dxf" },
+    { "fbx", "FBX/spider.fbx" },
+    { "glb", "glTF2/BoxTextured-glTF-Binary/BoxTextured.glb" },
+    { "gltf", "glTF2/BoxTextured-glTF/BoxTextured.gltf" },
+    { "irrmesh", "IRRMesh/spider.irrmesh" },
+    { "lwo", "LWO/LWO2/hierarchy.lwo" },
+    { "md2", "MD2/faerie.md2" },
+    { "ms3d", "MS3D/twospheres.ms3d" },
+    { "obj", "OBJ/spider.obj" },
+    { "off", "OFF/Wuson.off" },
+    { "ogex", "OpenGEX/Example.ogex" },
+    { "ply", "PLY/Wuson.ply" },
+    { "q3o", "Q3D/earth.q3o" },
+    { "stl", "STL/Wuson.stl" },
+    { "stl", "STL/Spider_binary.stl" },
+    { "x", "X/Testwuson.X" },
+};
+
+// ------------------------------------------------------------------------------------------------
+// Exporters used to write the synthetic models, by export format id
+const char *const SyntheticFormats[] = {
+    "obj", "stlb", "plyb", "glb2", "collada", "fbx", "x", "assbin"
+};
+
+// ------------------------------------------------------------------------------------------------
+struct Options {
+    std::string modelsDir = ASSIMP_TEST_MODELS_DIR;
+    std::string jsonFile;
+    std::string filter;
+    std::string ppName = "fast";
+    unsigned int ppFlags = aiProcessPreset_TargetRealtime_Fast;
+    unsigned int repeat = 3;
+    int threads = -1;
+    std::vector<unsigned int> syntheticTriangles = { 16384, 262144 };
+    std::vector<std::string> extraFiles;
+};
+
+// ------------------------------------------------------------------------------------------------
+struct Phase {
+    std::string name;
+    double seconds;
+    size_t allocations;
+    size_t allocatedBytes;
+    size_t peakBytes;
+};
+
+// ------------------------------------------------------------------------------------------------
+struct Result {
+    std::string format;
+    std::string model;
+    bool synthetic = false;
+    std::string error;
+    uintmax_t bytes = 0;
+    uint64_t triangles = 0;
+    uint64_t vertices = 0;
+    double minSeconds = 0.0;
+    double medianSeconds = 0.0;
+    uint64_t baseRss = 0;
+    uint64_t peakRss = 0;
+    std::vector<Phase> phases;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Models to benchmark
+struct Input {
+    std::string format;
+    std::string path;
+    std::string label;
+    bool synthetic;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Reads a size in kB from /proc/self/status, e.g. "VmHWM:"
+uint64_t ReadProcStatus(const char *key) {
+    uint64_t kb = 0;
+#if defined(__linux__)
+    FILE *file = fopen("/proc/self/status", "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    char line[256];
+    const size_t length = strlen(key);
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        if (strncmp(line, key, length) == 0) {
+            kb = strtoull(line + length, nullptr, 10);
+            break;
+        }
+    }
+    fclose(file);
+#else
+    (void)key;
+#endif
+    return kb * 1024;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Peak resident set size. On Linux the high-water mark can be reset, so the
+// value refers to a single model. Elsewhere it is the peak of the process.
+bool ResetPeakRss() {
+#if defined(__GLIBC__)
+    // hand memory freed by earlier models back, so it doesn't count as resident
+    malloc_trim(0);
+#endif
+#if defined(__linux__)
+    FILE *file = fopen("/proc/self/clear_refs", "w");
+    if (file == nullptr) {
+        return false;
+    }
+    const bool ok = fputs("5", file) >= 0;
+    return (fclose(file) == 0) && ok;
+#else
+    return false;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+uint64_t GetPeakRss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#elif defined(__linux__)
+    return ReadProcStatus("VmHWM:");
+#elif defined(__APPLE__)
+    rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<uint64_t>(usage.ru_maxrss) : 0;
+#elif defined(__unix__)
+    rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<uint64_t>(usage.ru_maxrss) * 1024 : 0;
+#else
+    return 0;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+// A grid of quads in the xy plane with normals and UVs, split into triangles
+aiScene *CreateGridScene(unsigned int triangles) {
+    const unsigned int cells = std::max(1u, static_cast<unsigned int>(std::sqrt(triangles / 2.0)));
+    const unsigned int side = cells + 1;
+
+    aiMesh *mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mNumVertices = side * side;
+    mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+    mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+    mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+    mesh->mNumUVComponents[0] = 2;
+    for (unsigned int y = 0; y < side; ++y) {
+        for (unsigned int x = 0; x < side; ++x) {
+            const unsigned int i = y * side + x;
+            const ai_real u = static_cast<ai_real>(x) / cells, v = static_cast<ai_real>(y) / cells;
+
+            // a gentle wave keeps the vertices distinct from each other
+            mesh->mVertices[i] = aiVector3D(u, v, static_cast<ai_real>(0.05 * std::sin(u * 20.0) * std::cos(v * 20.0)));
+            mesh->mNormals[i] = aiVector3D(0, 0, 1);
+            mesh->mTextureCoords[0][i] = aiVector3D(u, v, 0);
+        }
+    }
+
+    mesh->mNumFaces = cells * cells * 2;
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    aiFace *face = mesh->mFaces;
+    for (unsigned int y = 0; y < cells; ++y) {
+        for (unsigned int x = 0; x < cells; ++x) {
+            const unsigned int i = y * side + x;
+            const unsigned int corners[2][3] = { { i, i + 1, i + side + 1 }, { i, i + side + 1, i + side } };
+            for (const auto &corner : corners) {
+                face->mNumIndices = 3;
+                face->mIndices = new unsigned int[3];
+                std::copy(corner, corner + 3, face->mIndices);
+                ++face;
+            }
+        }
+    }
+
+    aiScene *scene = new aiScene();
+    scene->mNumMeshes = 1;
+    scene->mMeshes = new aiMesh *[1];
+    scene->mMeshes[0] = mesh;
+
+    aiMaterial *material = new aiMaterial();
+    const aiString name("grid");
+    material->AddProperty(&name, AI_MATKEY_NAME);
+    scene->mNumMaterials = 1;
+    scene->mMaterials = new aiMaterial *[1];
+    scene->mMaterials[0] = material;
+
+    scene->mRootNode = new aiNode("root");
+    scene->mRootNode->mNumMeshes = 1;
+    scene->mRootNode->mMeshes = new unsigned int[1];
+    scene->mRootNode->mMeshes[0] = 0;
+    return scene;
+}
+
+// ------------------------------------------------------------------------------------------------
+std::string FormatCount(unsigned int count) {
+    if (count % (1024 * 1024) == 0) {
+        return std::to_string(count / (1024 * 1024)) + "m";
+    }
+    if (count % 1024 == 0) {
+        return std::to_string(count / 1024) + "k";
+    }
+    return std::to_string(count);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Writes the synthetic models for every exporter that is available
+void WriteSyntheticModels(const Options &options, const fs::path &dir, std::vector<Input> &inputs) {
+#ifndef ASSIMP_BUILD_NO_EXPORT
+    Exporter exporter;
+    for (unsigned int triangles : options.syntheticTriangles) {
+        aiScene *scene = CreateGridScene(triangles);
+        for (const char *id : SyntheticFormats) {
+            const aiExportFormatDesc *desc = nullptr;
+            for (size_t i = 0; i < exporter.GetExportFormatCount(); ++i) {
+                if (strcmp(exporter.GetExportFormatDescription(i)->id, id) == 0) {
+                    desc = exporter.GetExportFormatDescription(i);
+                    break;
+                }
+            }
+            if (desc == nullptr) {
+                continue;
+            }
+            const std::string label = std::string("synthetic-") + id + "-" + FormatCount(triangles);
+            if (!options.filter.empty() && label.find(options.filter) == std::string::npos &&
+                    options.filter != desc->fileExtension) {
+                continue;
+            }
+
+            const fs::path path = dir / (label + "." + desc->fileExtension);
+            if (exporter.Export(scene, id, path.string()) != AI_SUCCESS) {
+                printf("Skipping %s: %s\n", label.c_str(), exporter.GetErrorString());
+                continue;
+            }
+            inputs.push_back({ desc->fileExtension, path.string(), label, true });
+        }
+        delete scene;
+    }
+#else
+    (void)options;
+    (void)dir;
+    (void)inputs;
+#endif
+}
+
+// ------------------------------------------------------------------------------------------------
+void CountGeometry(const aiScene *scene, Result &result) {
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        const aiMesh *mesh = scene->mMeshes[i];
+        result.vertices += mesh->mNumVertices;
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            if (mesh->mFaces[f].mNumIndices >= 3) {
+                result.triangles += mesh->mFaces[f].mNumIndices - 2;
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Phases of the last import; repeated phases (e.g. "finalize") are merged
+std::vector<Phase> GetPhases(const Importer &importer) {
+    std::vector<Phase> phases;
+    for (size_t i = 0; i < importer.GetPhaseCount(); ++i) {
+        const ImporterPhase *phase = importer.GetPhase(i);
+        auto it = std::find_if(phases.begin(), phases.end(), [phase](const Phase &p) { return p.name == phase->mName; });
+        if (it != phases.end()) {
+            it->seconds += phase->mSeconds;
+            it->allocations += phase->mAllocations;
+            it->allocatedBytes += phase->mAllocatedBytes;
+            it->peakBytes = std::max(it->peakBytes, phase->mPeakBytes);
+        } else {
+            phases.push_back({ phase->mName, phase->mSeconds, phase->mAllocations, phase->mAllocatedBytes, phase->mPeakBytes });
+        }
+    }
+    return phases;
+}
+
+// ------------------------------------------------------------------------------------------------
+Result RunBenchmark(const Options &options, const Input &input) {
+    Result result;
+    result.format = input.format;
+    result.model = input.label;
+    result.synthetic = input.synthetic;
+
+    std::error_code ec;
+    result.bytes = fs::file_size(input.path, ec);
+
+    ResetPeakRss();
+    result.baseRss = ReadProcStatus("VmRSS:");
+    std::vector<double> times;
+    for (unsigned int run = 0; run < options.repeat; ++run) {
+        // a fresh importer per run, so no loader state carries over between runs
+        Importer importer;
+        if (options.threads >= 0) {
+            importer.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, options.threads);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const aiScene *scene = importer.ReadFile(input.path, options.ppFlags);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (scene == nullptr) {
+            result.error = importer.GetErrorString();
+            return result;
+        }
+
+        times.push_back(elapsed.count());
+        if (times.back() <= *std::min_element(times.begin(), times.end())) {
+            result.phases = GetPhases(importer);
+        }
+        if (run == 0) {
+            CountGeometry(scene, result);
+        }
+    }
+    result.peakRss = GetPeakRss();
+
+    std::sort(times.begin(), times.end());
+    result.minSeconds = times.front();
+    result.medianSeconds = times[times.size() / 2];
+    return result;
+}
+
+// ------------------------------------------------------------------------------------------------
+std::string EscapeJson(const std::string &in) {
+    std::string out;
+    for (char c : in) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8];
+                snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+                out += buffer;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out;
+}
+
+// ------------------------------------------------------------------------------------------------
+double PerSecond(double value, double seconds) {
+    return seconds > 0.0 ? value / seconds : 0.0;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool WriteJson(const Options &options, bool perModelRss, const std::vector<Result> &results) {
+    std::ofstream out(options.jsonFile);
+    if (!out) {
+        return false;
+    }
+    char number[64];
+    auto num = [&number](double value) {
+        snprintf(number, sizeof(number), "%.9g", value);
+        return number;
+    };
+
+    out << "{\n";
+    out << "  \"assimp_version\": \"" << aiGetVersionMajor() << "." << aiGetVersionMinor() << "." << aiGetVersionPatch()
+        << "\",\n";
+    out << "  \"revision\": \"" << std::hex << aiGetVersionRevision() << std::dec << "\",\n";
+    out << "  \"postprocess\": \"" << EscapeJson(options.ppName) << "\",\n";
+    out << "  \"postprocess_flags\": " << options.ppFlags << ",\n";
+    out << "  \"repeat\": " << options.repeat << ",\n";
+    out << "  \"rss_scope\": \"" << (perModelRss ? "model" : "process") << "\",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"format\": \"" << EscapeJson(r.format) << "\",\n";
+        out << "      \"model\": \"" << EscapeJson(r.model) << "\",\n";
+        out << "      \"synthetic\": " << (r.synthetic ? "true" : "false") << ",\n";
+        out << "      \"bytes\": " << r.bytes << ",\n";
+        if (!r.error.empty()) {
+            out << "      \"error\": \"" << EscapeJson(r.error) << "\"\n    }";
+            continue;
+        }
+        out << "      \"triangles\": " << r.triangles << ",\n";
+        out << "      \"vertices\": " << r.vertices << ",\n";
+        out << "      \"seconds_min\": " << num(r.minSeconds) << ",\n";
+        out << "      \"seconds_median\": " << num(r.medianSeconds) << ",\n";
+        out << "      \"mb_per_s\": " << num(PerSecond(r.bytes / 1e6, r.minSeconds)) << ",\n";
+        out << "      \"triangles_per_s\": " << num(PerSecond(static_cast<double>(r.triangles), r.minSeconds)) << ",\n";
+        out << "      \"base_rss_bytes\": " << r.baseRss << ",\n";
+        out << "      \"peak_rss_bytes\": " << r.peakRss << ",\n";
+        out << "      \"phases\": [";
+        for (size_t p = 0; p < r.phases.size(); ++p) {
+            const Phase &phase = r.phases[p];
+            out << (p ? ",\n" : "\n") << "        { \"name\": \"" << EscapeJson(phase.name) << "\", \"seconds\": "
+                << num(phase.seconds) << ", \"allocations\": " << phase.allocations << ", \"allocated_bytes\": "
+                << phase.allocatedBytes << ", \"peak_bytes\": " << phase.peakBytes << " }";
+        }
+        out << (r.phases.empty() ? "]\n    }" : "\n      ]\n    }");
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+// ------------------------------------------------------------------------------------------------
+void PrintUsage() {
+    printf("assimp_benchmark [options] [<file> ...]\n"
+           "  Imports the curated test models, synthetic models and the given files\n"
+           "  and reports the import throughput.\n\n"
+           "  --repeat=<n>          Imports per model, the fastest one is reported (default 3)\n"
+           "  --pp=<preset>         Post-processing: none, fast, quality or max (default fast)\n"
+           "  --filter=<text>       Only run models whose format or path contains <text>\n"
+           "  --synthetic=<n,...>   Triangle counts of the synthetic models (default 16384,262144),\n"
+           "                        'none' disables them\n"
+           "  --threads=<n>         Value of AI_CONFIG_GLOB_NUM_THREADS\n"
+           "  --models=<dir>        Directory of the curated models (default test/models)\n"
+           "  --json=<file>         Write the results as JSON\n");
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ParseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string key = arg.substr(0, eq);
+        const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+        if (key == "--help" || key == "-h") {
+            return false;
+        } else if (key == "--repeat") {
+            options.repeat = std::max(1, atoi(value.c_str()));
+        } else if (key == "--pp") {
+            options.ppName = value;
+            if (value == "none") {
+                options.ppFlags = 0;
+            } else if (value == "fast") {
+                options.ppFlags = aiProcessPreset_TargetRealtime_Fast;
+            } else if (value == "quality") {
+                options.ppFlags = aiProcessPreset_TargetRealtime_Quality;
+            } else if (value == "max") {
+                options.ppFlags = aiProcessPreset_TargetRealtime_MaxQuality;
+            } else {
+                printf("Unknown post-processing preset: %s\n", value.c_str());
+                return false;
+            }
+        } else if (key == "--filter") {
+            options.filter = value;
+        } else if (key == "--synthetic") {
+            options.syntheticTriangles.clear();
+            for (size_t begin = 0; value != "none" && begin < value.size();) {
+                size_t end = value.find(',', begin);
+                if (end == std::string::npos) {
+                    end = value.size();
+                }
+                const unsigned long count = strtoul(value.substr(begin, end - begin).c_str(), nullptr, 10);
+                if (count > 0) {
+                    options.syntheticTriangles.push_back(static_cast<unsigned int>(count));
+                }
+                begin = end + 1;
+            }
+        } else if (key == "--threads") {
+            options.threads = atoi(value.c_str());
+        } else if (key == "--models") {
+            options.modelsDir = value;
+        } else if (key == "--json") {
+            options.jsonFile = value;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            printf("Unknown option: %s\n", arg.c_str());
+            return false;
+        } else {
+            options.extraFiles.push_back(arg);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<Input> inputs;
+    for (const CuratedModel &model : CuratedModels) {
+        const std::string path = (fs::path(options.modelsDir) / model.path).string();
+        if (options.filter.empty() || options.filter == model.format || path.find(options.filter) != std::string::npos) {
+            inputs.push_back({ model.format, path, model.path, false });
+        }
+    }
+    for (const std::string &file : options.extraFiles) {
+        std::string ext = fs::path(file).extension().string();
+        ext = ext.empty() ? std::string("unknown") : ext.substr(1);
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+        inputs.push_back({ ext, file, file, false });
+    }
+
+    std::error_code ec;
+    const fs::path tempDir = fs::temp_directory_path(ec) / "assimp_benchmark";
+    fs::create_directories(tempDir, ec);
+    WriteSyntheticModels(options, tempDir, inputs);
+
+    // the peak RSS can only be attributed to a model if it can be reset
+    const bool perModelRss = ResetPeakRss();
+
+    printf("%-8s %-48s %10s %10s %10s %10s %10s %10s\n", "format", "model", "MB", "triangles", "ms", "MB/s", "Mtri/s",
+            perModelRss ? "RSS MB" : "peak MB");
+    std::vector<Result> results;
+    unsigned int failed = 0;
+    for (const Input &input : inputs) {
+        results.push_back(RunBenchmark(options, input));
+        const Result &r = results.back();
+        std::string model = r.model.size() > 48 ? "..." + r.model.substr(r.model.size() - 45) : r.model;
+        if (!r.error.empty()) {
+            printf("%-8s %-48s failed: %s\n", r.format.c_str(), model.c_str(), r.error.c_str());
+            ++failed;
+            continue;
+        }
+        printf("%-8s %-48s %10.3f %10llu %10.2f %10.2f %10.2f %10.1f\n", r.format.c_str(), model.c_str(), r.bytes / 1e6,
+                static_cast<unsigned long long>(r.triangles), r.minSeconds * 1e3, PerSecond(r.bytes / 1e6, r.minSeconds),
+                PerSecond(r.triangles / 1e6, r.minSeconds), r.peakRss / 1e6);
+    }
+
+    fs::remove_all(tempDir, ec);
+
+    if (!options.jsonFile.empty()) {
+        if (!WriteJson(options, perModelRss, results)) {
+            printf("Failed to write %s\n", options.jsonFile.c_str());
+            return 1;
+        }
+        printf("Results written to %s\n", options.jsonFile.c_str());
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+copyright notice, this list of conditions and the
+following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+copyright notice, this list of conditions and the
+following disclaimer in the documentation and/or other
+materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+contributors may be used to endorse or promote products
+derived from this software without specific prior
+written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+#include "UnitTestPCH.h"
+
+#include <assimp/StringTable.h>
+#include <assimp/cimport.h>
+#include <assimp/scene.h>
+
+#include <string>
+#include <vector>
+
+using namespace Assimp;
+
+class utStringTable : public ::testing::Test {
+    // empty
+};
+
+TEST_F(utStringTable, internAndFind) {
+    StringTable table;
+    std::vector<aiStringHandle> handles;
+    for (unsigned int i = 0; i < 1000; ++i) {
+        const std::string name = "bone_" + std::to_string(i);
+        handles.push_back(table.Intern(name.c_str(), name.length()));
+    }
+    EXPECT_EQ(1000u, table.Size());
+
+    for (unsigned int i = 0; i < 1000; ++i) {
+        const std::string name = "bone_" + std::to_string(i);
+        // handles are handed out in insertion order
+        EXPECT_EQ(i, handles[i]);
+        EXPECT_EQ(handles[i], table.Intern(aiString(name)));
+        EXPECT_EQ(handles[i], table.Find(name.c_str(), name.length()));
+        EXPECT_STREQ(name.c_str(), table.GetString(handles[i]));
+        EXPECT_EQ(name.length(), table.GetLength(handles[i]));
+        EXPECT_EQ(StringTable::Hash(name.c_str(), name.length()), table.GetHash(handles[i]));
+    }
+    EXPECT_EQ(1000u, table.Size());
+    EXPECT_EQ(AI_STRING_HANDLE_INVALID, table.Find("bone_1000", 9));
+
+    // the empty string is a valid name
+    const aiStringHandle empty = table.Intern("", 0);
+    EXPECT_NE(AI_STRING_HANDLE_INVALID, empty);
+    EXPECT_STREQ("", table.GetString(empty));
+}
+
+TEST_F(utStringTable, sceneNameTable) {
+    // root -> arm -> hand, root -> hand (a second node with the same name)
+    aiScene scene;
+    scene.mRootNode = new aiNode("root");
+    aiNode *arm = new aiNode("arm");
+    aiNode *hand = new aiNode("hand");
+    aiNode *otherHand = new aiNode("hand");
+    arm->addChildren(1, &hand);
+    aiNode *children[] = { arm, otherHand };
+    scene.mRootNode->addChildren(2, children);
+
+    scene.mNumMeshes = 1;
+    scene.mMeshes = new aiMesh *[1];
+    scene.mMeshes[0] = new aiMesh();
+    scene.mMeshes[0]->mNumBones = 2;
+    scene.mMeshes[0]->mBones = new aiBone *[2];
+    scene.mMeshes[0]->mBones[0] = new aiBone();
+    scene.mMeshes[0]->mBones[0]->mName.Set("hand");
+    scene.mMeshes[0]->mBones[1] = new aiBone();
+    scene.mMeshes[0]->mBones[1]->mName.Set("finger");
+
+    // no table yet
+    EXPECT_EQ(AI_STRING_HANDLE_INVALID, aiGetNodeNameHandle(&scene, arm));
+    EXPECT_EQ(nullptr, aiFindNodeByHandle(&scene, 0));
+
+    ASSERT_EQ(AI_SUCCESS, aiBuildSceneNameTable(&scene));
+    const aiStringHandle armHandle = aiGetNodeNameHandle(&scene, arm);
+    const aiStringHandle handHandle = aiGetNameHandle(&scene, &scene.mMeshes[0]->mBones[0]->mName);
+    ASSERT_NE(AI_STRING_HANDLE_INVALID, armHandle);
+    ASSERT_NE(AI_STRING_HANDLE_INVALID, handHandle);
+    EXPECT_NE(armHandle, handHandle);
+    EXPECT_EQ(handHandle, aiGetNodeNameHandle(&scene, otherHand));
+
+    // the same node aiNode::FindNode() returns
+    EXPECT_EQ(arm, aiFindNodeByHandle(&scene, armHandle));
+    EXPECT_EQ(scene.mRootNode->FindNode("hand"), aiFindNodeByHandle(&scene, handHandle));
+
+    // names of bones without node have a handle, but no node
+    const aiStringHandle fingerHandle = aiGetNameHandle(&scene, &scene.mMeshes[0]->mBones[1]->mName);
+    EXPECT_NE(AI_STRING_HANDLE_INVALID, fingerHandle);
+    EXPECT_EQ(nullptr, aiFindNodeByHandle(&scene, fingerHandle));
+    const aiString unknown("thumb");
+    EXPECT_EQ(AI_STRING_HANDLE_INVALID, aiGetNameHandle(&scene, &unknown));
+    EXPECT_EQ(nullptr, aiFindNodeByHandle(&scene, AI_STRING_HANDLE_INVALID));
+
+    // a rebuild picks up renamed nodes
+    arm->mName.Set("finger");
+    ASSERT_EQ(AI_SUCCESS, aiBuildSceneNameTable(&scene));
+    EXPECT_EQ(AI_STRING_HANDLE_INVALID, aiGetNameHandle(&scene, &unknown));
+    EXPECT_EQ(arm, aiFindNodeByHandle(&scene, aiGetNameHandle(&scene, &scene.mMeshes[0]->mBones[1]->mName)));
+}
@@ -46,6 +46,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/Exporter.hpp>
 #include <assimp/Importer.hpp>
 
+#include <rapidjson/document.h>
+
+#include <vector>
+
 using namespace Assimp;
 
 #ifndef ASSIMP_BUILD_NO_EXPORT
@@ -77,4 +81,110 @@ TEST_F(utAssjsonImportExport, exportTest) {
     EXPECT_TRUE(exporterTest());
 }
 
+TEST_F(utAssjsonImportExport, floatsRoundTrip) {
+    Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+
+    Exporter exporter;
+    const aiExportDataBlob *blob = exporter.ExportToBlob(scene, "assjson");
+    ASSERT_NE(nullptr, blob);
+
+    rapidjson::Document doc;
+    doc.Parse(static_cast<const char *>(blob->data), blob->size);
+    ASSERT_FALSE(doc.HasParseError());
+    const rapidjson::Value &meshes = doc["meshes"];
+    ASSERT_EQ(scene->mNumMeshes, meshes.Size());
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+        const aiMesh *mesh = scene->mMeshes[m];
+        const rapidjson::Value &vertices = meshes[m]["vertices"];
+        ASSERT_EQ(mesh->mNumVertices * 3, vertices.Size());
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            EXPECT_EQ(mesh->mVertices[i].x, vertices[i * 3].GetFloat());
+            EXPECT_EQ(mesh->mVertices[i].y, vertices[i * 3 + 1].GetFloat());
+            EXPECT_EQ(mesh->mVertices[i].z, vertices[i * 3 + 2].GetFloat());
+        }
+    }
+}
+
+TEST_F(utAssjsonImportExport, base64Streams) {
+    Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+
+    Exporter plainExporter;
+    const aiExportDataBlob *plain = plainExporter.ExportToBlob(scene, "assjson");
+    ASSERT_NE(nullptr, plain);
+
+    ExportProperties properties;
+    properties.SetPropertyBool("JSON_BASE64_STREAMS", true);
+    Exporter exporter;
+    const aiExportDataBlob *blob = exporter.ExportToBlob(scene, "assjson", 0u, &properties);
+    ASSERT_NE(nullptr, blob);
+    EXPECT_LT(blob->size, plain->size);
+
+    rapidjson::Document doc;
+    doc.Parse(static_cast<const char *>(blob->data), blob->size);
+    ASSERT_FALSE(doc.HasParseError());
+    EXPECT_STREQ("base64", doc["__metadata__"]["streams"].GetString());
+    const rapidjson::Value &vertices = doc["meshes"][0]["vertices"];
+    ASSERT_TRUE(vertices.IsString());
+    EXPECT_EQ((scene->mMeshes[0]->mNumVertices * 12 + 2) / 3 * 4, vertices.GetStringLength());
+}
+
+TEST_F(utAssjsonImportExport, splitLargeMesh) {
+    // 25000 triangles with unshared vertices, the 75000 vertices need two meshes with 16 bit indices
+    const unsigned int numFaces = 25000;
+    aiMesh *mesh = new aiMesh();
+    mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+    mesh->mNumVertices = numFaces * 3;
+    mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        mesh->mVertices[i] = aiVector3D(static_cast<ai_real>(i), 0, 0);
+    }
+    mesh->mNumFaces = numFaces;
+    mesh->mFaces = new aiFace[numFaces];
+    for (unsigned int i = 0; i < numFaces; ++i) {
+        aiFace &face = mesh->mFaces[i];
+        face.mNumIndices = 3;
+        face.mIndices = new unsigned int[3]{ i * 3, i * 3 + 1, i * 3 + 2 };
+    }
+
+    aiScene scene;
+    scene.mNumMeshes = 1;
+    scene.mMeshes = new aiMesh *[1]{ mesh };
+    scene.mNumMaterials = 1;
+    scene.mMaterials = new aiMaterial *[1]{ new aiMaterial() };
+    scene.mRootNode = new aiNode();
+    scene.mRootNode->mNumMeshes = 1;
+    scene.mRootNode->mMeshes = new unsigned int[1]{ 0 };
+
+    Exporter exporter;
+    const aiExportDataBlob *blob = exporter.ExportToBlob(&scene, "assjson");
+    ASSERT_NE(nullptr, blob);
+
+    rapidjson::Document doc;
+    doc.Parse(static_cast<const char *>(blob->data), blob->size);
+    ASSERT_FALSE(doc.HasParseError());
+    const rapidjson::Value &meshes = doc["meshes"];
+    ASSERT_EQ(2u, meshes.Size());
+    const rapidjson::Value &nodeMeshes = doc["rootnode"]["meshes"];
+    ASSERT_EQ(2u, nodeMeshes.Size());
+    EXPECT_EQ(0u, nodeMeshes[0].GetUint());
+    EXPECT_EQ(1u, nodeMeshes[1].GetUint());
+
+    unsigned int faces = 0;
+    for (rapidjson::SizeType m = 0; m < meshes.Size(); ++m) {
+        EXPECT_LE(meshes[m]["vertices"].Size(), 3u * (1u << 16));
+        faces += meshes[m]["faces"].Size();
+    }
+    EXPECT_EQ(numFaces, faces);
+
+    // the first face of the second mesh continues where the first mesh ended
+    const unsigned int firstFaces = meshes[0]["faces"].Size();
+    const rapidjson::Value &second = meshes[1];
+    const unsigned int index = second["faces"][0][0].GetUint();
+    EXPECT_EQ(static_cast<float>(firstFaces * 3), second["vertices"][index * 3].GetFloat());
+}
+
 #endif // ASSIMP_BUILD_NO_EXPORT
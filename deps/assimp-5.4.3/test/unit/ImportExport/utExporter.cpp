@@ -41,7 +41,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UnitTestPCH.h"
 
 #include <assimp/Exporter.hpp>
+#include <assimp/Importer.hpp>
 #include <assimp/ProgressHandler.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <vector>
 
 using namespace Assimp;
 
@@ -102,4 +108,117 @@ TEST_F(ExporterTest, ExporterIdTest) {
     EXPECT_EQ(nullptr, desc) << "More exporters than claimed";
 }
 
+TEST_F(ExporterTest, testExportLeavesSourceSceneUntouched) {
+    Importer importer;
+    const aiScene *pTest = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/X/test.x", aiProcess_ValidateDataStructure);
+    ASSERT_TRUE(pTest);
+    Exporter exporter;
+    std::vector<aiVector3D> vertices, normals, uvs;
+    for (unsigned int m = 0; m < pTest->mNumMeshes; ++m) {
+        const aiMesh *mesh = pTest->mMeshes[m];
+        vertices.insert(vertices.end(), mesh->mVertices, mesh->mVertices + mesh->mNumVertices);
+        if (mesh->HasNormals()) {
+            normals.insert(normals.end(), mesh->mNormals, mesh->mNormals + mesh->mNumVertices);
+        }
+        if (mesh->HasTextureCoords(0)) {
+            uvs.insert(uvs.end(), mesh->mTextureCoords[0], mesh->mTextureCoords[0] + mesh->mNumVertices);
+        }
+    }
+    const unsigned int numMeshes = pTest->mNumMeshes;
+    const unsigned int numMaterials = pTest->mNumMaterials;
+
+    // The unmodified parts of the scene are shared with the export, the others copied
+    EXPECT_TRUE(exporter.ExportToBlob(pTest, "collada", aiProcess_FlipUVs | aiProcess_MakeLeftHanded));
+    EXPECT_TRUE(exporter.ExportToBlob(pTest, "collada", aiProcess_ValidateDataStructure));
+#ifndef ASSIMP_BUILD_NO_GLTF_EXPORTER
+    EXPECT_TRUE(exporter.ExportToBlob(pTest, "glb2", aiProcess_RemoveRedundantMaterials));
+#endif
+
+    ASSERT_EQ(numMeshes, pTest->mNumMeshes);
+    EXPECT_EQ(numMaterials, pTest->mNumMaterials);
+    size_t v = 0, n = 0, t = 0;
+    for (unsigned int m = 0; m < pTest->mNumMeshes; ++m) {
+        const aiMesh *mesh = pTest->mMeshes[m];
+        for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+            EXPECT_EQ(vertices[v++], mesh->mVertices[i]);
+            if (mesh->HasNormals()) {
+                EXPECT_EQ(normals[n++], mesh->mNormals[i]);
+            }
+            if (mesh->HasTextureCoords(0)) {
+                EXPECT_EQ(uvs[t++], mesh->mTextureCoords[0][i]);
+            }
+        }
+    }
+}
+
+// Records the meshes the exporter is handed
+static std::vector<const aiMesh *> exportedMeshes;
+
+static void ExportMeshPointers(const char *, IOSystem *, const aiScene *pScene, const ExportProperties *) {
+    exportedMeshes.assign(pScene->mMeshes, pScene->mMeshes + pScene->mNumMeshes);
+}
+
+static aiMesh *CreateMesh(unsigned int numFaces, unsigned int faceSize, bool withNormals) {
+    aiMesh *mesh = new aiMesh();
+    mesh->mPrimitiveTypes = faceSize == 3 ? aiPrimitiveType_TRIANGLE : aiPrimitiveType_POLYGON;
+    mesh->mNumVertices = numFaces * faceSize;
+    mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        mesh->mVertices[i] = aiVector3D(static_cast<ai_real>(i % faceSize), static_cast<ai_real>(i / faceSize),
+                static_cast<ai_real>(i % 2));
+    }
+    if (withNormals) {
+        mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+        std::fill(mesh->mNormals, mesh->mNormals + mesh->mNumVertices, aiVector3D(0, 0, 1));
+    }
+    mesh->mNumFaces = numFaces;
+    mesh->mFaces = new aiFace[numFaces];
+    for (unsigned int f = 0; f < numFaces; ++f) {
+        mesh->mFaces[f].mNumIndices = faceSize;
+        mesh->mFaces[f].mIndices = new unsigned int[faceSize];
+        for (unsigned int i = 0; i < faceSize; ++i) {
+            mesh->mFaces[f].mIndices[i] = f * faceSize + i;
+        }
+    }
+    return mesh;
+}
+
+TEST_F(ExporterTest, testPerMeshStepsCopyOnlyChangedMeshes) {
+    aiScene scene;
+    scene.mNumMeshes = 3;
+    scene.mMeshes = new aiMesh *[3];
+    scene.mMeshes[0] = CreateMesh(4, 3, true); // nothing to do
+    scene.mMeshes[1] = CreateMesh(2, 4, true); // quads, triangulated
+    scene.mMeshes[2] = CreateMesh(4, 3, false); // no normals, they are generated
+    scene.mNumMaterials = 1;
+    scene.mMaterials = new aiMaterial *[1];
+    scene.mMaterials[0] = new aiMaterial();
+    scene.mRootNode = new aiNode();
+    scene.mRootNode->mNumMeshes = 3;
+    scene.mRootNode->mMeshes = new unsigned int[3]{ 0, 1, 2 };
+    aiNode *const root = scene.mRootNode;
+
+    Exporter exporter;
+    EXPECT_EQ(AI_SUCCESS, exporter.RegisterExporter(Exporter::ExportFormatEntry("meshptrs", "Mesh pointers", "ptrs",
+            &ExportMeshPointers)));
+    EXPECT_EQ(AI_SUCCESS, exporter.Export(&scene, "meshptrs", "unused.ptrs",
+            aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_GenSmoothNormals));
+
+    ASSERT_EQ(3u, exportedMeshes.size());
+    EXPECT_EQ(scene.mMeshes[0], exportedMeshes[0]);
+    EXPECT_NE(scene.mMeshes[1], exportedMeshes[1]);
+    EXPECT_NE(scene.mMeshes[2], exportedMeshes[2]);
+
+    // the source is untouched
+    EXPECT_EQ(root, scene.mRootNode);
+    EXPECT_EQ(4u, scene.mMeshes[1]->mFaces[0].mNumIndices);
+    EXPECT_EQ(nullptr, scene.mMeshes[2]->mNormals);
+
+    // forcing the normals changes every mesh
+    EXPECT_EQ(AI_SUCCESS, exporter.Export(&scene, "meshptrs", "unused.ptrs", aiProcess_GenNormals | aiProcess_ForceGenNormals));
+    ASSERT_EQ(3u, exportedMeshes.size());
+    EXPECT_NE(scene.mMeshes[0], exportedMeshes[0]);
+    exportedMeshes.clear();
+}
+
 #endif
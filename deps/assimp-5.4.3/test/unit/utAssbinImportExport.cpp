@@ -40,10 +40,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "AbstractImportExportBase.h"
 #include "UnitTestPCH.h"
+#include <assimp/config.h>
 #include <assimp/postprocess.h>
+#include <assimp/scene.h>
 #include <assimp/Exporter.hpp>
 #include <assimp/Importer.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using namespace Assimp;
 
 #ifndef ASSIMP_BUILD_NO_EXPORT
@@ -66,4 +71,164 @@ TEST_F(utAssbinImportExport, import3ExportAssbinDFromFileTest) {
     EXPECT_TRUE(importerTest());
 }
 
+namespace {
+
+// Finds the raw bytes of an array in an exported file and checks that they start at
+// a stream aligned offset
+template <typename T>
+void ExpectAlignedStream(const aiExportDataBlob *blob, const T *data, size_t count) {
+    const uint8_t *begin = static_cast<const uint8_t *>(blob->data);
+    const uint8_t *end = begin + blob->size;
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    const uint8_t *found = std::search(begin, end, bytes, bytes + count * sizeof(T));
+    ASSERT_NE(end, found);
+    EXPECT_EQ(0u, static_cast<size_t>(found - begin) % 16);
+}
+
+template <typename T>
+void ExpectEqualKeys(const T *expected, const T *actual, unsigned int count) {
+    for (unsigned int i = 0; i < count; ++i) {
+        EXPECT_EQ(expected[i].mTime, actual[i].mTime);
+        EXPECT_EQ(expected[i].mValue, actual[i].mValue);
+    }
+}
+
+void ExpectEqualSkinsAndAnimations(const aiScene *expected, const aiScene *actual) {
+    ASSERT_EQ(expected->mNumMeshes, actual->mNumMeshes);
+    for (unsigned int m = 0; m < expected->mNumMeshes; ++m) {
+        const aiMesh *mesh = expected->mMeshes[m];
+        const aiMesh *newMesh = actual->mMeshes[m];
+        ASSERT_EQ(mesh->mNumVertices, newMesh->mNumVertices);
+        EXPECT_TRUE(std::equal(mesh->mVertices, mesh->mVertices + mesh->mNumVertices, newMesh->mVertices));
+        ASSERT_EQ(mesh->mNumBones, newMesh->mNumBones);
+        for (unsigned int b = 0; b < mesh->mNumBones; ++b) {
+            const aiBone *bone = mesh->mBones[b];
+            const aiBone *newBone = newMesh->mBones[b];
+            EXPECT_EQ(bone->mName, newBone->mName);
+            EXPECT_EQ(bone->mOffsetMatrix, newBone->mOffsetMatrix);
+            ASSERT_EQ(bone->mNumWeights, newBone->mNumWeights);
+            for (unsigned int w = 0; w < bone->mNumWeights; ++w) {
+                EXPECT_EQ(bone->mWeights[w].mVertexId, newBone->mWeights[w].mVertexId);
+                EXPECT_EQ(bone->mWeights[w].mWeight, newBone->mWeights[w].mWeight);
+            }
+        }
+    }
+
+    ASSERT_EQ(expected->mNumAnimations, actual->mNumAnimations);
+    for (unsigned int a = 0; a < expected->mNumAnimations; ++a) {
+        const aiAnimation *anim = expected->mAnimations[a];
+        const aiAnimation *newAnim = actual->mAnimations[a];
+        EXPECT_EQ(anim->mDuration, newAnim->mDuration);
+        EXPECT_EQ(anim->mTicksPerSecond, newAnim->mTicksPerSecond);
+        ASSERT_EQ(anim->mNumChannels, newAnim->mNumChannels);
+        for (unsigned int c = 0; c < anim->mNumChannels; ++c) {
+            const aiNodeAnim *channel = anim->mChannels[c];
+            const aiNodeAnim *newChannel = newAnim->mChannels[c];
+            EXPECT_EQ(channel->mNodeName, newChannel->mNodeName);
+            ASSERT_EQ(channel->mNumPositionKeys, newChannel->mNumPositionKeys);
+            ASSERT_EQ(channel->mNumRotationKeys, newChannel->mNumRotationKeys);
+            ASSERT_EQ(channel->mNumScalingKeys, newChannel->mNumScalingKeys);
+            ExpectEqualKeys(channel->mPositionKeys, newChannel->mPositionKeys, channel->mNumPositionKeys);
+            ExpectEqualKeys(channel->mRotationKeys, newChannel->mRotationKeys, channel->mNumRotationKeys);
+            ExpectEqualKeys(channel->mScalingKeys, newChannel->mScalingKeys, channel->mNumScalingKeys);
+        }
+    }
+}
+
+} // namespace
+
+TEST_F(utAssbinImportExport, skinnedAnimationRoundTripTest) {
+    Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/FBX/animation_with_skeleton.fbx", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+    ASSERT_GT(scene->mNumAnimations, 0u);
+    const aiMesh *skinned = nullptr;
+    for (unsigned int m = 0; m < scene->mNumMeshes && skinned == nullptr; ++m) {
+        skinned = scene->mMeshes[m]->HasBones() ? scene->mMeshes[m] : nullptr;
+    }
+    ASSERT_NE(nullptr, skinned);
+
+    // plain streams land on aligned file offsets
+    Exporter exporter;
+    const aiExportDataBlob *blob = exporter.ExportToBlob(scene, "assbin", 0);
+    ASSERT_NE(nullptr, blob);
+#ifndef ASSIMP_DOUBLE_PRECISION
+    ExpectAlignedStream(blob, skinned->mVertices, skinned->mNumVertices);
+    // the longest arrays, short ones could also match padding or other data
+    const aiBone *bone = *std::max_element(skinned->mBones, skinned->mBones + skinned->mNumBones, [](const aiBone *a, const aiBone *b) {
+        return a->mNumWeights < b->mNumWeights;
+    });
+    ExpectAlignedStream(blob, bone->mWeights, bone->mNumWeights);
+    const aiAnimation *anim = scene->mAnimations[0];
+    const aiNodeAnim *channel = *std::max_element(anim->mChannels, anim->mChannels + anim->mNumChannels, [](const aiNodeAnim *a, const aiNodeAnim *b) {
+        return a->mNumRotationKeys < b->mNumRotationKeys;
+    });
+    ASSERT_GT(channel->mNumRotationKeys, 2u);
+    std::vector<double> times(channel->mNumRotationKeys);
+    std::vector<aiQuaternion> rotations(channel->mNumRotationKeys);
+    for (unsigned int k = 0; k < channel->mNumRotationKeys; ++k) {
+        times[k] = channel->mRotationKeys[k].mTime;
+        rotations[k] = channel->mRotationKeys[k].mValue;
+    }
+    ExpectAlignedStream(blob, times.data(), times.size());
+    ExpectAlignedStream(blob, rotations.data(), rotations.size());
+#endif
+
+    Importer reimporter;
+    const aiScene *newScene = reimporter.ReadFileFromMemory(blob->data, blob->size, aiProcess_ValidateDataStructure, "assbin");
+    ASSERT_NE(nullptr, newScene);
+    ExpectEqualSkinsAndAnimations(scene, newScene);
+
+    // deflated streams decode to the same scene
+    ExportProperties properties;
+    properties.SetPropertyBool(AI_CONFIG_EXPORT_ASSBIN_COMPRESS_STREAMS, true);
+    Exporter compressedExporter;
+    const aiExportDataBlob *compressedBlob = compressedExporter.ExportToBlob(scene, "assbin", 0, &properties);
+    ASSERT_NE(nullptr, compressedBlob);
+    EXPECT_LT(compressedBlob->size, blob->size);
+
+    Importer compressedImporter;
+    const aiScene *compressedScene = compressedImporter.ReadFileFromMemory(compressedBlob->data, compressedBlob->size,
+            aiProcess_ValidateDataStructure, "assbin");
+    ASSERT_NE(nullptr, compressedScene);
+    ExpectEqualSkinsAndAnimations(scene, compressedScene);
+}
+
+TEST_F(utAssbinImportExport, exportCompressedStreamsRoundTripTest) {
+    Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+
+    ExportProperties properties;
+    properties.SetPropertyBool(AI_CONFIG_EXPORT_ASSBIN_COMPRESS_STREAMS, true);
+    Exporter exporter;
+    const aiExportDataBlob *blob = exporter.ExportToBlob(scene, "assbin", 0, &properties);
+    ASSERT_NE(nullptr, blob);
+
+    Importer reimporter;
+    reimporter.SetPropertyBool(AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER, true);
+    const aiScene *newScene = reimporter.ReadFileFromMemory(blob->data, blob->size, aiProcess_ValidateDataStructure, "assbin");
+    ASSERT_NE(nullptr, newScene);
+    ASSERT_EQ(scene->mNumMeshes, newScene->mNumMeshes);
+
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        const aiMesh *mesh = scene->mMeshes[i];
+        const aiMesh *newMesh = newScene->mMeshes[i];
+        ASSERT_EQ(mesh->mNumVertices, newMesh->mNumVertices);
+        ASSERT_EQ(mesh->mNumFaces, newMesh->mNumFaces);
+        EXPECT_TRUE(newMesh->HasIndexBuffer());
+        for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+            EXPECT_EQ(mesh->mVertices[v], newMesh->mVertices[v]);
+            EXPECT_EQ(mesh->mNormals[v], newMesh->mNormals[v]);
+            EXPECT_EQ(mesh->mTextureCoords[0][v], newMesh->mTextureCoords[0][v]);
+        }
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            ASSERT_EQ(mesh->mFaces[f].mNumIndices, newMesh->mFaces[f].mNumIndices);
+            for (unsigned int a = 0; a < mesh->mFaces[f].mNumIndices; ++a) {
+                EXPECT_EQ(mesh->mFaces[f].mIndices[a], newMesh->mFaces[f].mIndices[a]);
+            }
+        }
+    }
+}
+
 #endif // #ifndef ASSIMP_BUILD_NO_EXPORT
@@ -41,12 +41,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractImportExportBase.h"
 #include "UnitTestPCH.h"
 
+#include <assimp/config.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <assimp/Exporter.hpp>
 #include <assimp/Importer.hpp>
 
 #include "AssetLib/3MF/D3MFExporter.h"
+#include "AssetLib/3MF/D3MFOpcPackage.h"
+#include "AssetLib/3MF/XmlSerializer.h"
+
+#include <assimp/DefaultIOSystem.h>
+#include <assimp/XmlParser.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
 
 class utD3MFImporterExporter : public AbstractImportExportBase {
 public:
@@ -82,8 +92,112 @@ TEST_F(utD3MFImporterExporter, import3MFFromFileTest) {
     EXPECT_TRUE(importerTest());
 }
 
+TEST_F(utD3MFImporterExporter, importWithReadAheadMatchesSerialImport) {
+    Assimp::Importer serialImporter;
+    serialImporter.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 1);
+    const aiScene *serial = serialImporter.ReadFile(ASSIMP_TEST_MODELS_DIR "/3MF/box.3mf", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, serial);
+
+    Assimp::Importer parallelImporter;
+    parallelImporter.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 4);
+    const aiScene *parallel = parallelImporter.ReadFile(ASSIMP_TEST_MODELS_DIR "/3MF/box.3mf", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, parallel);
+
+    ASSERT_EQ(serial->mNumMeshes, parallel->mNumMeshes);
+    for (unsigned int i = 0; i < serial->mNumMeshes; ++i) {
+        const aiMesh *a = serial->mMeshes[i];
+        const aiMesh *b = parallel->mMeshes[i];
+        ASSERT_EQ(a->mNumVertices, b->mNumVertices);
+        ASSERT_EQ(a->mNumFaces, b->mNumFaces);
+        for (unsigned int v = 0; v < a->mNumVertices; ++v) {
+            EXPECT_EQ(a->mVertices[v], b->mVertices[v]);
+        }
+        for (unsigned int f = 0; f < a->mNumFaces; ++f) {
+            ASSERT_EQ(3u, b->mFaces[f].mNumIndices);
+            EXPECT_EQ(a->mFaces[f].mIndices[0], b->mFaces[f].mIndices[0]);
+            EXPECT_EQ(a->mFaces[f].mIndices[1], b->mFaces[f].mIndices[1]);
+            EXPECT_EQ(a->mFaces[f].mIndices[2], b->mFaces[f].mIndices[2]);
+        }
+    }
+}
+
+// Decodes the model part the way the importer did before it was streamed: the whole
+// part is parsed into a DOM and vertices and triangles are read from the DOM nodes.
+static std::unique_ptr<aiScene> ImportWithDom(const char *file) {
+    Assimp::DefaultIOSystem ioSystem;
+    Assimp::D3MF::D3MFOpcPackage package(&ioSystem, file);
+    Assimp::IOStream *stream = package.OpenRootStreamed();
+    if (nullptr == stream) {
+        return nullptr;
+    }
+
+    Assimp::XmlParser xmlParser;
+    const bool parsed = xmlParser.parse(stream);
+    package.CloseStream(stream);
+    if (!parsed) {
+        return nullptr;
+    }
+
+    std::unique_ptr<aiScene> scene(new aiScene);
+    Assimp::D3MF::XmlSerializer xmlSerializer(&xmlParser);
+    xmlSerializer.ImportXml(scene.get());
+    return scene;
+}
+
+static void ExpectStreamedImportMatchesDom(const char *file) {
+    std::unique_ptr<aiScene> dom = ImportWithDom(file);
+    ASSERT_NE(nullptr, dom);
+
+    Assimp::Importer importer;
+    const aiScene *streamed = importer.ReadFile(file, 0);
+    ASSERT_NE(nullptr, streamed);
+
+    // the importer adds a default material to scenes without any
+    ASSERT_EQ(dom->mNumMeshes, streamed->mNumMeshes);
+    ASSERT_EQ(std::max(dom->mNumMaterials, 1u), streamed->mNumMaterials);
+    for (unsigned int i = 0; i < dom->mNumMeshes; ++i) {
+        const aiMesh *a = dom->mMeshes[i];
+        const aiMesh *b = streamed->mMeshes[i];
+        EXPECT_STREQ(a->mName.C_Str(), b->mName.C_Str());
+        EXPECT_EQ(a->mMaterialIndex, b->mMaterialIndex);
+        ASSERT_EQ(a->mNumVertices, b->mNumVertices);
+        ASSERT_EQ(a->mNumFaces, b->mNumFaces);
+        for (unsigned int v = 0; v < a->mNumVertices; ++v) {
+            EXPECT_EQ(a->mVertices[v], b->mVertices[v]);
+        }
+        ASSERT_EQ(a->HasVertexColors(0), b->HasVertexColors(0));
+        if (a->HasVertexColors(0)) {
+            for (unsigned int v = 0; v < a->mNumVertices; ++v) {
+                EXPECT_EQ(a->mColors[0][v], b->mColors[0][v]);
+            }
+        }
+        for (unsigned int f = 0; f < a->mNumFaces; ++f) {
+            ASSERT_EQ(a->mFaces[f].mNumIndices, b->mFaces[f].mNumIndices);
+            for (unsigned int j = 0; j < a->mFaces[f].mNumIndices; ++j) {
+                EXPECT_EQ(a->mFaces[f].mIndices[j], b->mFaces[f].mIndices[j]);
+            }
+        }
+    }
+}
+
+TEST_F(utD3MFImporterExporter, streamedImportMatchesDomImport) {
+    ExpectStreamedImportMatchesDom(ASSIMP_TEST_MODELS_DIR "/3MF/box.3mf");
+}
+
 #ifndef ASSIMP_BUILD_NO_EXPORT
 
+TEST_F(utD3MFImporterExporter, streamedImportMatchesDomImportOfExportedModel) {
+    // a larger model with several meshes and materials
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj", aiProcess_Triangulate);
+    ASSERT_NE(nullptr, scene);
+
+    Assimp::Exporter exporter;
+    ASSERT_EQ(AI_SUCCESS, exporter.Export(scene, "3mf", "spider_streamed.3mf")) << exporter.GetErrorString();
+    ExpectStreamedImportMatchesDom("spider_streamed.3mf");
+    std::remove("spider_streamed.3mf");
+}
+
 TEST_F(utD3MFImporterExporter, export3MFtoMemTest) {
     //EXPECT_TRUE(exporterTest());
 }
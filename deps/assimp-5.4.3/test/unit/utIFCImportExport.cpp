@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UnitTestPCH.h"
 
 #include <assimp/postprocess.h>
+#include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 
 using namespace Assimp;
@@ -78,3 +79,48 @@ TEST_F(utIFCImportExport, importComplextypeAsColor) {
     const aiScene *scene = importer.ReadFileFromMemory(asset.c_str(), asset.size(), 0);
     EXPECT_EQ(nullptr, scene);
 }
+
+static void expectSameNodes(const aiNode *expected, const aiNode *node) {
+    EXPECT_STREQ(expected->mName.C_Str(), node->mName.C_Str());
+    EXPECT_TRUE(expected->mTransformation.Equal(node->mTransformation));
+    ASSERT_EQ(expected->mNumMeshes, node->mNumMeshes);
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+        EXPECT_EQ(expected->mMeshes[i], node->mMeshes[i]);
+    }
+    ASSERT_EQ(expected->mNumChildren, node->mNumChildren);
+    for (unsigned int i = 0; i < node->mNumChildren; ++i) {
+        expectSameNodes(expected->mChildren[i], node->mChildren[i]);
+    }
+}
+
+TEST_F(utIFCImportExport, importWithWorkerThreadsMatchesSerialImport) {
+    Assimp::Importer serial;
+    serial.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 1);
+    const aiScene *expected = serial.ReadFile(ASSIMP_TEST_MODELS_DIR "/IFC/AC14-FZK-Haus.ifc", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, expected);
+
+    Assimp::Importer parallel;
+    parallel.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 4);
+    const aiScene *scene = parallel.ReadFile(ASSIMP_TEST_MODELS_DIR "/IFC/AC14-FZK-Haus.ifc", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+
+    ASSERT_EQ(expected->mNumMeshes, scene->mNumMeshes);
+    EXPECT_EQ(expected->mNumMaterials, scene->mNumMaterials);
+    for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+        const aiMesh *want = expected->mMeshes[i];
+        const aiMesh *mesh = scene->mMeshes[i];
+        EXPECT_EQ(want->mMaterialIndex, mesh->mMaterialIndex);
+        ASSERT_EQ(want->mNumVertices, mesh->mNumVertices);
+        for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+            EXPECT_EQ(want->mVertices[v], mesh->mVertices[v]);
+        }
+        ASSERT_EQ(want->mNumFaces, mesh->mNumFaces);
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            ASSERT_EQ(want->mFaces[f].mNumIndices, mesh->mFaces[f].mNumIndices);
+            for (unsigned int j = 0; j < mesh->mFaces[f].mNumIndices; ++j) {
+                EXPECT_EQ(want->mFaces[f].mIndices[j], mesh->mFaces[f].mIndices[j]);
+            }
+        }
+    }
+    expectSameNodes(expected->mRootNode, scene->mRootNode);
+}
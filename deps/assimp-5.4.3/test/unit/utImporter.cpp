@@ -46,6 +46,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/BaseImporter.h>
 #include <assimp/DefaultIOSystem.h>
 #include <assimp/Importer.hpp>
+#include <assimp/MemoryAllocator.hpp>
+#include <assimp/ProgressHandler.hpp>
+#include <assimp/material.h>
+
+#include <algorithm>
 
 using namespace ::std;
 using namespace ::Assimp;
@@ -275,6 +280,164 @@ TEST_F(ImporterTest, testMultipleReads) {
     //EXPECT_TRUE(pImp->ReadFile(ASSIMP_TEST_MODELS_DIR "/X/dwarf.x",flags)); # is in nonbsd
 }
 
+TEST_F(ImporterTest, testPhaseTimings) {
+    const unsigned int flags = aiProcess_ValidateDataStructure | aiProcess_Triangulate | aiProcess_GenSmoothNormals;
+    ASSERT_NE(nullptr, pImp->ReadFile(ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj", flags));
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < pImp->GetPhaseCount(); ++i) {
+        const ImporterPhase *phase = pImp->GetPhase(i);
+        ASSERT_NE(nullptr, phase);
+        EXPECT_GE(phase->mSeconds, 0.0);
+        names.emplace_back(phase->mName);
+    }
+    EXPECT_EQ(nullptr, pImp->GetPhase(pImp->GetPhaseCount()));
+    ASSERT_GE(names.size(), 5u);
+    EXPECT_EQ("import", names[0]);
+    EXPECT_EQ("validate", names[1]);
+    EXPECT_EQ("preprocess", names[2]);
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "aiProcess_Triangulate"));
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "aiProcess_GenSmoothNormals"));
+    EXPECT_EQ("finalize", names.back());
+
+    // a later post-processing pass extends the list, a new read resets it
+    const size_t count = pImp->GetPhaseCount();
+    ASSERT_NE(nullptr, pImp->ApplyPostProcessing(aiProcess_FlipUVs));
+    ASSERT_GT(pImp->GetPhaseCount(), count);
+    EXPECT_STREQ("aiProcess_FlipUVs", pImp->GetPhase(count)->mName);
+
+    ASSERT_NE(nullptr, pImp->ReadFile(ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj", 0));
+    EXPECT_STREQ("import", pImp->GetPhase(0)->mName);
+    for (size_t i = 0; i < pImp->GetPhaseCount(); ++i) {
+        EXPECT_NE(0, strncmp("aiProcess_", pImp->GetPhase(i)->mName, 10));
+    }
+}
+
+namespace {
+
+class CountingAllocator : public MemoryAllocator {
+public:
+    void *Allocate(size_t size, size_t alignment) override {
+        EXPECT_LE(alignment, alignof(std::max_align_t));
+        ++mAllocations;
+        mLive += size;
+        return ::operator new(size);
+    }
+
+    void Free(void *data, size_t size, size_t) override {
+        ++mFrees;
+        mLive -= size;
+        ::operator delete(data);
+    }
+
+    size_t mAllocations = 0;
+    size_t mFrees = 0;
+    size_t mLive = 0;
+};
+
+// Allocates a tracked block from a progress callback, i.e. during the import phase,
+// or releases the block it is given
+class TrackingProgressHandler : public ProgressHandler {
+public:
+    static constexpr size_t BlockSize = 1 << 20;
+
+    explicit TrackingProgressHandler(void *block) :
+            mBlock(block), mRelease(block != nullptr) {}
+
+    bool Update(float) override {
+        return true;
+    }
+
+    void UpdateFileRead(int currentStep, int) override {
+        if (currentStep == 0 || mRelease == (mBlock == nullptr)) {
+            return;
+        }
+        if (mRelease) {
+            MemoryAllocator::FreeTracked(MemoryAllocator::GetCurrent(), mBlock, BlockSize, 16);
+            mBlock = nullptr;
+        } else {
+            mBlock = MemoryAllocator::AllocateTracked(MemoryAllocator::GetCurrent(), BlockSize, 16);
+        }
+    }
+
+    void *mBlock;
+    const bool mRelease;
+};
+
+} // namespace
+
+TEST_F(ImporterTest, testMemoryAllocator) {
+    const char *files[] = {
+        ASSIMP_TEST_MODELS_DIR "/FBX/spider.fbx",
+        ASSIMP_TEST_MODELS_DIR "/glTF2/BoxTextured-glTF-Binary/BoxTextured.glb",
+        ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj"
+    };
+    for (const char *file : files) {
+        CountingAllocator allocator;
+        {
+            Importer importer;
+            importer.SetMemoryAllocator(&allocator);
+            EXPECT_EQ(&allocator, importer.GetMemoryAllocator());
+            ASSERT_NE(nullptr, importer.ReadFile(file, aiProcess_Triangulate));
+            EXPECT_GT(allocator.mAllocations, 0u);
+
+            // the loader's buffers are attributed to the import phase
+            const ImporterPhase *phase = importer.GetPhase(0);
+            ASSERT_NE(nullptr, phase);
+            EXPECT_STREQ("import", phase->mName);
+            EXPECT_GT(phase->mAllocations, 0u);
+            EXPECT_GT(phase->mAllocatedBytes, 0u);
+            EXPECT_GT(phase->mPeakBytes, 0u);
+            EXPECT_LE(phase->mPeakBytes, phase->mAllocatedBytes);
+        }
+        EXPECT_EQ(allocator.mAllocations, allocator.mFrees);
+        EXPECT_EQ(0u, allocator.mLive);
+    }
+
+    CountingAllocator allocator;
+    pImp->SetMemoryAllocator(&allocator);
+    pImp->SetMemoryAllocator(nullptr);
+    EXPECT_EQ(nullptr, pImp->GetMemoryAllocator());
+}
+
+TEST_F(ImporterTest, testFreesAreChargedToTheirImport) {
+    const char *file = ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj";
+    CountingAllocator allocator;
+    size_t referencePeak = 0;
+    {
+        Importer reference;
+        reference.SetMemoryAllocator(&allocator);
+        ASSERT_NE(nullptr, reference.ReadFile(file, 0));
+        referencePeak = reference.GetPhase(0)->mPeakBytes;
+    }
+    EXPECT_GT(referencePeak, 0u);
+
+    // a block which outlives the importer it was allocated for
+    void *block = nullptr;
+    {
+        Importer importer;
+        importer.SetMemoryAllocator(&allocator);
+        TrackingProgressHandler *handler = new TrackingProgressHandler(nullptr);
+        importer.SetProgressHandler(handler);
+        ASSERT_NE(nullptr, importer.ReadFile(file, 0));
+        ASSERT_NE(nullptr, handler->mBlock);
+        EXPECT_GE(importer.GetPhase(0)->mPeakBytes, TrackingProgressHandler::BlockSize);
+        block = handler->mBlock;
+    }
+    EXPECT_GE(allocator.mLive, TrackingProgressHandler::BlockSize);
+
+    // releasing it while another import runs doesn't change that import's statistics
+    Importer importer;
+    importer.SetMemoryAllocator(&allocator);
+    TrackingProgressHandler *handler = new TrackingProgressHandler(block);
+    importer.SetProgressHandler(handler);
+    ASSERT_NE(nullptr, importer.ReadFile(file, 0));
+    EXPECT_EQ(nullptr, handler->mBlock);
+    EXPECT_EQ(referencePeak, importer.GetPhase(0)->mPeakBytes);
+    importer.FreeScene();
+    EXPECT_EQ(0u, allocator.mLive);
+}
+
 TEST_F(ImporterTest, SearchFileHeaderForTokenTest) {
     //DefaultIOSystem ioSystem;
     //    BaseImporter::SearchFileHeaderForToken( &ioSystem, assetPath, Token, 2 )
@@ -41,6 +41,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "UnitTestPCH.h"
 
 #include "Material/MaterialSystem.h"
+#include <assimp/Importer.hpp>
+#include <assimp/SceneCombiner.h>
 #include <assimp/scene.h>
 
 using namespace ::std;
@@ -217,6 +219,156 @@ TEST_F(MaterialSystemTest, testCastSmallFloatProperty) {
     EXPECT_EQ(false, valBool);
 }
 
+// ------------------------------------------------------------------------------------------------
+TEST_F(MaterialSystemTest, testIndexedLookup) {
+    // enough properties to have them hashed
+    for (int i = 0; i < 40; ++i) {
+        const std::string key = "key" + std::to_string(i);
+        EXPECT_EQ(AI_SUCCESS, pcMat->AddProperty(&i, 1, key.c_str(), i % 3, i % 2));
+    }
+    for (unsigned int i = 0; i < 3; ++i) {
+        aiString path("tex" + std::to_string(i));
+        EXPECT_EQ(AI_SUCCESS, pcMat->AddProperty(&path, AI_MATKEY_TEXTURE_DIFFUSE(i)));
+    }
+
+    int value = -1;
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("key17", 2, 1, value));
+    EXPECT_EQ(17, value);
+    EXPECT_EQ(AI_FAILURE, pcMat->Get("key17", 0, 0, value));
+    EXPECT_EQ(AI_FAILURE, pcMat->Get("key40", 1, 0, value));
+    EXPECT_NE(nullptr, pcMat->mPropertyIndex);
+
+    // UINT_MAX matches any semantic and index
+    const aiMaterialProperty *prop = nullptr;
+    EXPECT_EQ(AI_SUCCESS, aiGetMaterialProperty(pcMat, "key22", UINT_MAX, UINT_MAX, &prop));
+    ASSERT_NE(nullptr, prop);
+    EXPECT_EQ(1u, prop->mSemantic);
+    EXPECT_EQ(0u, prop->mIndex);
+    EXPECT_EQ(3u, pcMat->GetTextureCount(aiTextureType_DIFFUSE));
+    EXPECT_EQ(0u, pcMat->GetTextureCount(aiTextureType_SPECULAR));
+
+    // properties added and removed after the first lookup are seen
+    int added = 99;
+    EXPECT_EQ(AI_SUCCESS, pcMat->AddProperty(&added, 1, "added", 5, 5));
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("added", 5, 5, value));
+    EXPECT_EQ(99, value);
+    added = 100;
+    EXPECT_EQ(AI_SUCCESS, pcMat->AddProperty(&added, 1, "key17", 2, 1));
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("key17", 2, 1, value));
+    EXPECT_EQ(100, value);
+
+    EXPECT_EQ(AI_SUCCESS, pcMat->RemoveProperty("key5", 2, 1));
+    EXPECT_EQ(AI_FAILURE, pcMat->RemoveProperty("key5", 2, 1));
+    EXPECT_EQ(AI_FAILURE, pcMat->Get("key5", 2, 1, value));
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("key39", 0, 1, value));
+    EXPECT_EQ(39, value);
+    EXPECT_EQ(43u, pcMat->mNumProperties);
+
+    pcMat->Clear();
+    EXPECT_EQ(nullptr, pcMat->mPropertyIndex);
+    EXPECT_EQ(AI_FAILURE, pcMat->Get("key39", 0, 1, value));
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(MaterialSystemTest, testIndexNotBuiltByLookups) {
+    for (int i = 0; i < 20; ++i) {
+        const std::string key = "key" + std::to_string(i);
+        EXPECT_EQ(AI_SUCCESS, pcMat->AddProperty(&i, 1, key.c_str(), 0, 0));
+    }
+    EXPECT_NE(nullptr, pcMat->mPropertyIndex);
+
+    // a copy assembled by the scene combiner has no index, lookups must not create one
+    aiMaterial *copy = nullptr;
+    Assimp::SceneCombiner::Copy(&copy, pcMat);
+    ASSERT_NE(nullptr, copy);
+    ASSERT_EQ(nullptr, copy->mPropertyIndex);
+    int value = -1;
+    EXPECT_EQ(AI_SUCCESS, static_cast<const aiMaterial *>(copy)->Get("key13", 0, 0, value));
+    EXPECT_EQ(13, value);
+    EXPECT_EQ(nullptr, copy->mPropertyIndex);
+    delete copy;
+
+    // rewriting the list in place keeps array and size, the editor rebuilds the index
+    aiMaterialProperty *first = pcMat->mProperties[0];
+    for (unsigned int i = 0; i + 1 < pcMat->mNumProperties; ++i) {
+        pcMat->mProperties[i] = pcMat->mProperties[i + 1];
+    }
+    pcMat->mProperties[pcMat->mNumProperties - 1] = first;
+    first->mKey.Set("renamed");
+    Assimp::BuildMaterialPropertyIndex(pcMat);
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("renamed", 0, 0, value));
+    EXPECT_EQ(0, value);
+    EXPECT_EQ(AI_FAILURE, pcMat->Get("key0", 0, 0, value));
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("key1", 0, 0, value));
+    EXPECT_EQ(1, value);
+
+    // replacing or reordering properties without a rebuild falls back to the scan
+    aiMaterialProperty *replacement = new aiMaterialProperty();
+    replacement->mKey.Set("replacement");
+    replacement->mType = aiPTI_Integer;
+    replacement->mDataLength = sizeof(int);
+    replacement->mData = new char[sizeof(int)];
+    const int replaced = 42;
+    memcpy(replacement->mData, &replaced, sizeof(int));
+    delete pcMat->mProperties[3];
+    pcMat->mProperties[3] = replacement;
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("replacement", 0, 0, value));
+    EXPECT_EQ(42, value);
+    EXPECT_EQ(AI_FAILURE, pcMat->Get("key4", 0, 0, value));
+    std::swap(pcMat->mProperties[5], pcMat->mProperties[pcMat->mNumProperties - 2]);
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("key6", 0, 0, value));
+    EXPECT_EQ(6, value);
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("key19", 0, 0, value));
+    EXPECT_EQ(19, value);
+
+    // the next mutation rebuilds the index, properties keep being found through it
+    EXPECT_EQ(AI_SUCCESS, pcMat->AddProperty(&replaced, 1, "key4", 0, 0));
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("replacement", 0, 0, value));
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("key4", 0, 0, value));
+    EXPECT_EQ(42, value);
+    EXPECT_EQ(AI_SUCCESS, pcMat->RemoveProperty("key4", 0, 0));
+    EXPECT_EQ(AI_SUCCESS, pcMat->RemoveProperty("replacement", 0, 0));
+    EXPECT_EQ(AI_SUCCESS, pcMat->AddProperty(&replaced, 1, "key4", 0, 0));
+
+    // removing properties down to a small material drops the index
+    for (int i = 1; i < 20; ++i) {
+        const std::string key = "key" + std::to_string(i);
+        EXPECT_EQ(AI_SUCCESS, pcMat->RemoveProperty(key.c_str(), 0, 0));
+    }
+    EXPECT_EQ(nullptr, pcMat->mPropertyIndex);
+    EXPECT_EQ(AI_SUCCESS, pcMat->Get("renamed", 0, 0, value));
+}
+
+// ------------------------------------------------------------------------------------------------
+TEST_F(MaterialSystemTest, testPbrParameters) {
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/glTF2/BoxTextured-glTF/BoxTextured.gltf", 0);
+    ASSERT_NE(nullptr, scene);
+    ASSERT_LT(0u, scene->mNumMaterials);
+
+    const aiMaterial *mat = scene->mMaterials[0];
+    aiPbrParameters pbr;
+    EXPECT_EQ(AI_SUCCESS, mat->GetPbrParameters(pbr));
+
+    aiColor4D baseColor;
+    EXPECT_EQ(AI_SUCCESS, mat->Get(AI_MATKEY_BASE_COLOR, baseColor));
+    EXPECT_EQ(baseColor, pbr.mBaseColor);
+    ai_real metallic = 0, roughness = 0;
+    EXPECT_EQ(AI_SUCCESS, mat->Get(AI_MATKEY_METALLIC_FACTOR, metallic));
+    EXPECT_EQ(AI_SUCCESS, mat->Get(AI_MATKEY_ROUGHNESS_FACTOR, roughness));
+    EXPECT_EQ(metallic, pbr.mMetallicFactor);
+    EXPECT_EQ(roughness, pbr.mRoughnessFactor);
+    EXPECT_NE(0u, pbr.mTextureMask & (1u << aiTextureType_BASE_COLOR));
+    EXPECT_EQ(0u, pbr.mTextureMask & (1u << aiTextureType_CLEARCOAT));
+
+    // without any property all members keep their defaults
+    EXPECT_EQ(AI_SUCCESS, aiGetMaterialPbrParameters(pcMat, &pbr));
+    EXPECT_EQ(aiColor4D(1.0f, 1.0f, 1.0f, 1.0f), pbr.mBaseColor);
+    EXPECT_EQ(ai_real(1.5), pbr.mIor);
+    EXPECT_EQ(aiShadingMode_PBR_BRDF, pbr.mShadingModel);
+    EXPECT_EQ(0u, pbr.mTextureMask);
+}
+
 // ------------------------------------------------------------------------------------------------
 #if defined(_MSC_VER)
 // Refuse to compile on Windows if any enum values are not explicitly handled in the switch
@@ -525,3 +525,63 @@ TEST_F(utObjImportExport, import_with_line_continuations) {
     EXPECT_NEAR(vertices[2].y, 0.5f, threshold);
     EXPECT_NEAR(vertices[2].z, -0.5f, threshold);
 }
+
+TEST_F(utObjImportExport, import_points_as_point_cloud) {
+    static const char *curObjModel =
+            "v 0 0 0\n"
+            "v 1 0 0\n"
+            "v 0 1 0\n"
+            "v 0 0 1\n"
+            "p 1 2\n"
+            "p 3 4\n";
+
+    Assimp::Importer myImporter;
+    myImporter.SetPropertyBool(AI_CONFIG_IMPORT_POINT_CLOUD, true);
+    const aiScene *scene = myImporter.ReadFileFromMemory(curObjModel, strlen(curObjModel), aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+
+    ASSERT_EQ(scene->mNumMeshes, 1U);
+    const aiMesh *mesh = scene->mMeshes[0];
+    EXPECT_EQ(mesh->mNumVertices, 4U);
+    EXPECT_EQ(mesh->mNumFaces, 0U);
+    EXPECT_EQ(mesh->mFaces, nullptr);
+    EXPECT_EQ(mesh->mPrimitiveTypes, static_cast<unsigned int>(aiPrimitiveType_POINT));
+    EXPECT_EQ(mesh->mVertices[3], aiVector3D(0, 0, 1));
+}
+
+TEST_F(utObjImportExport, import_point_cloud_level_offsets_per_mesh) {
+    // two material groups of one object end up as two meshes of the same node
+    static const char *curObjModel =
+            "o cloud\n"
+            "v 0 0 0\n"
+            "v 1 0 0\n"
+            "v 0 1 0\n"
+            "v 0 0 1\n"
+            "v 4 4 4\n"
+            "v 5 4 4\n"
+            "usemtl first\n"
+            "p 1 2 3 4\n"
+            "usemtl second\n"
+            "p 5 6\n";
+
+    Assimp::Importer myImporter;
+    myImporter.SetPropertyBool(AI_CONFIG_IMPORT_POINT_CLOUD, true);
+    myImporter.SetPropertyInteger(AI_CONFIG_IMPORT_POINT_CLOUD_OCTREE_DEPTH, 1);
+    const aiScene *scene = myImporter.ReadFileFromMemory(curObjModel, strlen(curObjModel), aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+    ASSERT_EQ(2u, scene->mNumMeshes);
+
+    const aiNode *node = scene->mRootNode->FindNode("cloud");
+    ASSERT_NE(nullptr, node);
+    ASSERT_EQ(2u, node->mNumMeshes);
+    ASSERT_NE(nullptr, node->mMetaData);
+    EXPECT_EQ(3u, node->mMetaData->mNumProperties);
+    for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+        const unsigned int index = node->mMeshes[i];
+        aiMetadata levels;
+        ASSERT_TRUE(node->mMetaData->Get("PointCloud.LevelOffsets." + std::to_string(index), levels));
+        uint32_t offset = 0;
+        ASSERT_TRUE(levels.Get("2", offset));
+        EXPECT_EQ(scene->mMeshes[index]->mNumVertices, offset);
+    }
+}
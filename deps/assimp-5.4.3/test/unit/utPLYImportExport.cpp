@@ -40,6 +40,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "UnitTestPCH.h"
 
+#include <cmath>
+
 #include "AbstractImportExportBase.h"
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
@@ -171,6 +173,187 @@ TEST_F(utPLYImportExport, pointcloudTest) {
     EXPECT_EQ(0u, scene->mMeshes[0]->mNumFaces);
 }
 
+// Binary vertices and faces are decoded in blocks, the result must match the ascii version
+TEST_F(utPLYImportExport, importBinaryBlocksMatchesAscii) {
+    static const char *header =
+            "element vertex 4\n"
+            "property float x\n"
+            "property float y\n"
+            "property float z\n"
+            "property uchar red\n"
+            "property uchar green\n"
+            "property uchar blue\n"
+            "property short nx\n"
+            "property short ny\n"
+            "property short nz\n"
+            "element face 2\n"
+            "property uchar flags\n"
+            "property list uchar int vertex_indices\n"
+            "property float quality\n"
+            "end_header\n";
+    const float positions[4][3] = { { 0.f, 0.f, 0.f }, { 1.5f, 0.f, -2.f }, { 0.f, 1.f, 0.25f }, { -3.f, 1.f, 1.f } };
+    const uint8_t colors[4][3] = { { 255, 255, 255 }, { 255, 0, 255 }, { 255, 255, 0 }, { 0, 128, 255 } };
+    const int16_t normals[4][3] = { { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 0 }, { -1, 1, 0 } };
+    const std::vector<std::vector<int32_t>> faces = { { 0, 1, 2 }, { 0, 2, 3, 1 } };
+
+    std::string ascii = std::string("ply\nformat ascii 1.0\n") + header;
+    std::string binary = std::string("ply\nformat binary_big_endian 1.0\n") + header;
+    auto appendBE = [&binary](const void *value, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            binary.push_back(static_cast<const char *>(value)[size - 1 - i]);
+        }
+    };
+    for (int v = 0; v < 4; ++v) {
+        for (int i = 0; i < 3; ++i) {
+            ascii += std::to_string(positions[v][i]) + " ";
+            appendBE(&positions[v][i], sizeof(float));
+        }
+        for (int i = 0; i < 3; ++i) {
+            ascii += std::to_string(colors[v][i]) + " ";
+            appendBE(&colors[v][i], sizeof(uint8_t));
+        }
+        for (int i = 0; i < 3; ++i) {
+            ascii += std::to_string(normals[v][i]) + " ";
+            appendBE(&normals[v][i], sizeof(int16_t));
+        }
+        ascii += "\n";
+    }
+    for (const std::vector<int32_t> &face : faces) {
+        const uint8_t flags = 7, count = static_cast<uint8_t>(face.size());
+        const float quality = 0.5f;
+        ascii += "7 " + std::to_string(face.size());
+        appendBE(&flags, sizeof(uint8_t));
+        appendBE(&count, sizeof(uint8_t));
+        for (int32_t index : face) {
+            ascii += " " + std::to_string(index);
+            appendBE(&index, sizeof(int32_t));
+        }
+        ascii += " 0.5\n";
+        appendBE(&quality, sizeof(float));
+    }
+
+    Assimp::Importer asciiImporter, binaryImporter;
+    const aiScene *expected = asciiImporter.ReadFileFromMemory(ascii.data(), ascii.size(), aiProcess_ValidateDataStructure);
+    const aiScene *scene = binaryImporter.ReadFileFromMemory(binary.data(), binary.size(), aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, expected);
+    ASSERT_NE(nullptr, scene);
+
+    const aiMesh *a = expected->mMeshes[0];
+    const aiMesh *b = scene->mMeshes[0];
+    ASSERT_EQ(4u, b->mNumVertices);
+    ASSERT_EQ(2u, b->mNumFaces);
+    ASSERT_TRUE(b->HasNormals());
+    ASSERT_TRUE(b->HasVertexColors(0));
+    for (unsigned int v = 0; v < 4; ++v) {
+        EXPECT_EQ(a->mVertices[v], b->mVertices[v]);
+        EXPECT_EQ(a->mNormals[v], b->mNormals[v]);
+        EXPECT_EQ(a->mColors[0][v], b->mColors[0][v]);
+    }
+    for (unsigned int f = 0; f < 2; ++f) {
+        ASSERT_EQ(faces[f].size(), b->mFaces[f].mNumIndices);
+        for (unsigned int i = 0; i < b->mFaces[f].mNumIndices; ++i) {
+            EXPECT_EQ(a->mFaces[f].mIndices[i], b->mFaces[f].mIndices[i]);
+        }
+    }
+}
+
+// Point clouds are downsampled on a voxel grid and sorted into octree levels
+TEST_F(utPLYImportExport, importPointCloudVoxelOctree) {
+    static const char *cloud =
+            "ply\n"
+            "format ascii 1.0\n"
+            "element vertex 7\n"
+            "property float x\n"
+            "property float y\n"
+            "property float z\n"
+            "end_header\n"
+            "0.1 0.1 0.1\n"
+            "0.3 0.3 0.3\n"
+            "3.5 0.5 0.5\n"
+            "0.5 3.5 0.5\n"
+            "3.2 3.2 3.2\n"
+            "3.4 3.4 3.4\n"
+            "0.5 0.5 3.5\n";
+
+    Assimp::Importer importer;
+    importer.SetPropertyBool(AI_CONFIG_IMPORT_POINT_CLOUD, true);
+    importer.SetPropertyFloat(AI_CONFIG_IMPORT_POINT_CLOUD_VOXEL_SIZE, 1.0f);
+    importer.SetPropertyInteger(AI_CONFIG_IMPORT_POINT_CLOUD_OCTREE_DEPTH, 2);
+    const aiScene *scene = importer.ReadFileFromMemory(cloud, strlen(cloud), aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+    ASSERT_EQ(1u, scene->mNumMeshes);
+    const aiMesh *mesh = scene->mMeshes[0];
+    EXPECT_EQ(0u, mesh->mNumFaces);
+    EXPECT_EQ(aiPrimitiveType_POINT, mesh->mPrimitiveTypes);
+
+    // the two pairs of points share a voxel
+    ASSERT_EQ(5u, mesh->mNumVertices);
+    unsigned int merged = 0;
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        const aiVector3D &v = mesh->mVertices[i];
+        if (v.Equal(aiVector3D(0.2f, 0.2f, 0.2f)) || v.Equal(aiVector3D(3.3f, 3.3f, 3.3f))) {
+            ++merged;
+        }
+    }
+    EXPECT_EQ(2u, merged);
+
+    // level 0 has one point, level 1 one point per occupied octant
+    const aiMetadata *meta = scene->mRootNode->mMetaData;
+    ASSERT_NE(nullptr, meta);
+    int32_t depth = 0;
+    ASSERT_TRUE(meta->Get("PointCloud.OctreeDepth", depth));
+    EXPECT_EQ(2, depth);
+    aiMetadata levels;
+    ASSERT_TRUE(meta->Get("PointCloud.LevelOffsets.0", levels));
+    ASSERT_EQ(4u, levels.mNumProperties);
+    uint32_t offset = 0;
+    ASSERT_TRUE(levels.Get("0", offset));
+    EXPECT_EQ(1u, offset);
+    ASSERT_TRUE(levels.Get("1", offset));
+    EXPECT_EQ(5u, offset);
+    ASSERT_TRUE(levels.Get("3", offset));
+    EXPECT_EQ(5u, offset);
+}
+
+// Points with NaN or infinite coordinates cannot be placed in the grid and are dropped
+TEST_F(utPLYImportExport, importPointCloudNonFinite) {
+    static const char *cloud =
+            "ply\n"
+            "format ascii 1.0\n"
+            "element vertex 6\n"
+            "property float x\n"
+            "property float y\n"
+            "property float z\n"
+            "end_header\n"
+            "0.1 0.1 0.1\n"
+            "nan 0.5 0.5\n"
+            "3.5 0.5 0.5\n"
+            "0.5 inf 0.5\n"
+            "0.5 0.5 -inf\n"
+            "0.5 3.5 0.5\n";
+
+    Assimp::Importer importer;
+    importer.SetPropertyBool(AI_CONFIG_IMPORT_POINT_CLOUD, true);
+    importer.SetPropertyFloat(AI_CONFIG_IMPORT_POINT_CLOUD_VOXEL_SIZE, 1.0f);
+    importer.SetPropertyInteger(AI_CONFIG_IMPORT_POINT_CLOUD_OCTREE_DEPTH, 3);
+    const aiScene *scene = importer.ReadFileFromMemory(cloud, strlen(cloud), aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+    ASSERT_EQ(1u, scene->mNumMeshes);
+    const aiMesh *mesh = scene->mMeshes[0];
+    ASSERT_EQ(3u, mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
+        EXPECT_TRUE(std::isfinite(mesh->mVertices[i].x));
+        EXPECT_TRUE(std::isfinite(mesh->mVertices[i].y));
+        EXPECT_TRUE(std::isfinite(mesh->mVertices[i].z));
+    }
+
+    aiMetadata levels;
+    ASSERT_TRUE(scene->mRootNode->mMetaData->Get("PointCloud.LevelOffsets.0", levels));
+    uint32_t offset = 0;
+    ASSERT_TRUE(levels.Get("4", offset));
+    EXPECT_EQ(3u, offset);
+}
+
 static const char *test_file =
         "ply\n"
         "format ascii 1.0\n"
@@ -44,6 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <assimp/SceneCombiner.h>
 #include <assimp/Exporter.hpp>
 #include <assimp/Importer.hpp>
 
@@ -99,6 +100,77 @@ TEST_F(utSTLImporterExporter, test_with_empty_solid) {
     EXPECT_EQ(nullptr, scene2);
 }
 
+TEST_F(utSTLImporterExporter, importBinaryWithWeldedVertices) {
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/STL/Spider_binary.stl", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, scene);
+    ASSERT_EQ(1u, scene->mNumMeshes);
+    const aiMesh *mesh = scene->mMeshes[0];
+    const unsigned int numFaces = mesh->mNumFaces;
+    std::vector<aiVector3D> positions;
+    for (unsigned int i = 0; i < numFaces; ++i) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            positions.push_back(mesh->mVertices[mesh->mFaces[i].mIndices[j]]);
+        }
+    }
+
+    Assimp::Importer weldImporter;
+    weldImporter.SetPropertyBool(AI_CONFIG_IMPORT_STL_WELD_VERTICES, true);
+    const aiScene *welded = weldImporter.ReadFile(ASSIMP_TEST_MODELS_DIR "/STL/Spider_binary.stl", aiProcess_ValidateDataStructure);
+    ASSERT_NE(nullptr, welded);
+    ASSERT_EQ(1u, welded->mNumMeshes);
+    const aiMesh *weldedMesh = welded->mMeshes[0];
+    ASSERT_EQ(numFaces, weldedMesh->mNumFaces);
+    EXPECT_LT(weldedMesh->mNumVertices, numFaces * 3);
+    EXPECT_FALSE(weldedMesh->HasNormals());
+    for (unsigned int i = 0; i < numFaces; ++i) {
+        for (unsigned int j = 0; j < 3; ++j) {
+            EXPECT_EQ(positions[i * 3 + j], weldedMesh->mVertices[weldedMesh->mFaces[i].mIndices[j]]);
+        }
+    }
+}
+
+TEST_F(utSTLImporterExporter, importWithFlatIndexBuffer) {
+    const unsigned int flags = aiProcess_ValidateDataStructure | aiProcess_JoinIdenticalVertices |
+                               aiProcess_SplitLargeMeshes | aiProcess_ImproveCacheLocality;
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/STL/Spider_binary.stl", flags);
+    ASSERT_NE(nullptr, scene);
+    ASSERT_EQ(1u, scene->mNumMeshes);
+    EXPECT_FALSE(scene->mMeshes[0]->HasIndexBuffer());
+
+    Assimp::Importer flatImporter;
+    flatImporter.SetPropertyBool(AI_CONFIG_IMPORT_FLAT_INDEX_BUFFER, true);
+    const aiScene *flat = flatImporter.ReadFile(ASSIMP_TEST_MODELS_DIR "/STL/Spider_binary.stl", flags);
+    ASSERT_NE(nullptr, flat);
+    ASSERT_EQ(1u, flat->mNumMeshes);
+
+    // the split step drops the buffer, it is rebuilt once post-processing is done
+    const aiMesh *mesh = scene->mMeshes[0];
+    const aiMesh *flatMesh = flat->mMeshes[0];
+    ASSERT_TRUE(flatMesh->HasIndexBuffer());
+    ASSERT_EQ(mesh->mNumFaces, flatMesh->mNumFaces);
+    ASSERT_EQ(mesh->mNumFaces * 3, flatMesh->mIndexBufferSize);
+    for (unsigned int i = 0; i < flatMesh->mNumFaces; ++i) {
+        const aiFace &face = flatMesh->mFaces[i];
+        ASSERT_EQ(flatMesh->mIndexBuffer + i * 3, face.mIndices);
+        for (unsigned int j = 0; j < 3; ++j) {
+            EXPECT_EQ(mesh->mFaces[i].mIndices[j], face.mIndices[j]);
+        }
+    }
+
+    // copies keep the faces inside their own buffer
+    aiScene *copy = nullptr;
+    Assimp::SceneCombiner::CopyScene(&copy, flat);
+    ASSERT_NE(nullptr, copy);
+    const aiMesh *copyMesh = copy->mMeshes[0];
+    ASSERT_TRUE(copyMesh->HasIndexBuffer());
+    EXPECT_NE(flatMesh->mIndexBuffer, copyMesh->mIndexBuffer);
+    EXPECT_EQ(copyMesh->mIndexBuffer + 3, copyMesh->mFaces[1].mIndices);
+    EXPECT_EQ(flatMesh->mFaces[1].mIndices[2], copyMesh->mFaces[1].mIndices[2]);
+    delete copy;
+}
+
 #ifndef ASSIMP_BUILD_NO_EXPORT
 
 TEST_F(utSTLImporterExporter, exporterTest) {
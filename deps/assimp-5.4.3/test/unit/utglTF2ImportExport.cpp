@@ -57,6 +57,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <assimp/material.h>
 #include <assimp/GltfMaterial.h>
 
+#include "AssetLib/glTF2/glTF2Meshopt.h"
+
 using namespace Assimp;
 
 class utglTF2ImportExport : public AbstractImportExportBase {
@@ -727,8 +729,180 @@ TEST_F(utglTF2ImportExport, export_normalized_normals) {
     }
 }
 
+TEST_F(utglTF2ImportExport, export_threaded_matches_serial) {
+    const char *files[] = {
+        ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj",
+        ASSIMP_TEST_MODELS_DIR "/glTF2/glTF-Sample-Models/AnimatedMorphCube-glTF/AnimatedMorphCube.gltf"
+    };
+    for (const char *file : files) {
+        Assimp::Importer importer;
+        const aiScene *scene = importer.ReadFile(file, aiProcess_ValidateDataStructure);
+        ASSERT_NE(scene, nullptr);
+
+        Assimp::ExportProperties serial;
+        serial.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 1);
+        Assimp::ExportProperties threaded;
+        threaded.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 4);
+
+        for (const char *format : { "glb2", "gltf2" }) {
+            Assimp::Exporter serialExporter, threadedExporter;
+            const aiExportDataBlob *serialBlob = serialExporter.ExportToBlob(scene, format, 0, &serial);
+            const aiExportDataBlob *threadedBlob = threadedExporter.ExportToBlob(scene, format, 0, &threaded);
+            ASSERT_NE(serialBlob, nullptr);
+            ASSERT_NE(threadedBlob, nullptr);
+            for (; serialBlob && threadedBlob; serialBlob = serialBlob->next, threadedBlob = threadedBlob->next) {
+                ASSERT_EQ(serialBlob->size, threadedBlob->size);
+                EXPECT_EQ(0, memcmp(serialBlob->data, threadedBlob->data, serialBlob->size));
+            }
+            EXPECT_EQ(serialBlob, threadedBlob);
+        }
+    }
+}
+
+TEST_F(utglTF2ImportExport, export_compact_json) {
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/glTF2/BoxTextured-glTF/BoxTextured.gltf", aiProcess_ValidateDataStructure);
+    ASSERT_NE(scene, nullptr);
+
+    Assimp::ExportProperties properties;
+    properties.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_COMPACT_JSON, true);
+    Assimp::Exporter exporter;
+    const aiExportDataBlob *blob = exporter.ExportToBlob(scene, "gltf2", 0, &properties);
+    ASSERT_NE(blob, nullptr);
+    const std::string json(static_cast<const char *>(blob->data), blob->size);
+    EXPECT_EQ(json.find('\n'), std::string::npos);
+
+    Assimp::Exporter prettyExporter;
+    const aiExportDataBlob *prettyBlob = prettyExporter.ExportToBlob(scene, "gltf2", 0);
+    ASSERT_NE(prettyBlob, nullptr);
+    EXPECT_LT(blob->size, prettyBlob->size);
+}
+
+TEST_F(utglTF2ImportExport, export_quantized_meshopt_round_trip) {
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/OBJ/spider.obj", aiProcess_ValidateDataStructure);
+    ASSERT_NE(scene, nullptr);
+
+    Assimp::Exporter plainExporter;
+    const aiExportDataBlob *plainBlob = plainExporter.ExportToBlob(scene, "glb2", 0);
+    ASSERT_NE(plainBlob, nullptr);
+
+    Assimp::ExportProperties properties;
+    properties.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_QUANTIZE, true);
+    properties.SetPropertyBool(AI_CONFIG_EXPORT_GLTF_MESHOPT_COMPRESSION, true);
+    properties.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 1);
+    Assimp::Exporter compressedExporter;
+    const aiExportDataBlob *compressedBlob = compressedExporter.ExportToBlob(scene, "glb2", 0, &properties);
+    ASSERT_NE(compressedBlob, nullptr);
+    EXPECT_LT(compressedBlob->size, plainBlob->size);
+
+    // The encoding doesn't depend on the number of threads
+    properties.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 4);
+    Assimp::Exporter threadedExporter;
+    const aiExportDataBlob *threadedBlob = threadedExporter.ExportToBlob(scene, "glb2", 0, &properties);
+    ASSERT_NE(threadedBlob, nullptr);
+    ASSERT_EQ(compressedBlob->size, threadedBlob->size);
+    EXPECT_EQ(0, memcmp(compressedBlob->data, threadedBlob->data, compressedBlob->size));
+
+    const std::string json(static_cast<const char *>(compressedBlob->data), compressedBlob->size);
+    EXPECT_NE(json.find("\"extensionsRequired\":[\"KHR_mesh_quantization\",\"EXT_meshopt_compression\"]"), std::string::npos);
+
+    Assimp::Importer plainImporter, compressedImporter;
+    const aiScene *plain = plainImporter.ReadFileFromMemory(plainBlob->data, plainBlob->size, aiProcess_ValidateDataStructure, "glb");
+    const aiScene *compressed = compressedImporter.ReadFileFromMemory(compressedBlob->data, compressedBlob->size, aiProcess_ValidateDataStructure, "glb");
+    ASSERT_NE(plain, nullptr);
+    ASSERT_NE(compressed, nullptr);
+    ASSERT_EQ(plain->mNumMeshes, compressed->mNumMeshes);
+    for (unsigned int m = 0; m < plain->mNumMeshes; ++m) {
+        const aiMesh *expected = plain->mMeshes[m];
+        const aiMesh *actual = compressed->mMeshes[m];
+        ASSERT_EQ(expected->mNumVertices, actual->mNumVertices);
+        ASSERT_EQ(expected->mNumFaces, actual->mNumFaces);
+        ASSERT_TRUE(actual->HasNormals());
+        ASSERT_EQ(expected->HasTextureCoords(0), actual->HasTextureCoords(0));
+        for (unsigned int i = 0; i < expected->mNumVertices; ++i) {
+            EXPECT_EQ(expected->mVertices[i], actual->mVertices[i]);
+            EXPECT_NEAR(expected->mNormals[i].x, actual->mNormals[i].x, 0.01f);
+            EXPECT_NEAR(expected->mNormals[i].y, actual->mNormals[i].y, 0.01f);
+            EXPECT_NEAR(expected->mNormals[i].z, actual->mNormals[i].z, 0.01f);
+            if (expected->HasTextureCoords(0)) {
+                EXPECT_NEAR(expected->mTextureCoords[0][i].x, actual->mTextureCoords[0][i].x, 1e-4f);
+                EXPECT_NEAR(expected->mTextureCoords[0][i].y, actual->mTextureCoords[0][i].y, 1e-4f);
+            }
+        }
+        for (unsigned int i = 0; i < expected->mNumFaces; ++i) {
+            ASSERT_EQ(expected->mFaces[i].mNumIndices, actual->mFaces[i].mNumIndices);
+            for (unsigned int j = 0; j < expected->mFaces[i].mNumIndices; ++j) {
+                EXPECT_EQ(expected->mFaces[i].mIndices[j], actual->mFaces[i].mIndices[j]);
+            }
+        }
+    }
+}
+
 #endif // ASSIMP_BUILD_NO_EXPORT
 
+#ifndef ASSIMP_BUILD_NO_GLTF_IMPORTER
+
+// Known answers from the decoder tests of meshoptimizer, i.e. the output of its encoder
+namespace {
+
+struct MeshoptVertex {
+    uint16_t px, py, pz;
+    uint8_t nu, nv;
+    uint16_t tx, ty;
+};
+
+const MeshoptVertex kMeshoptVertices[] = {
+    { 0, 0, 0, 0, 0, 0, 0 },
+    { 300, 0, 0, 0, 0, 500, 0 },
+    { 0, 300, 0, 0, 0, 0, 500 },
+    { 300, 300, 0, 0, 0, 500, 500 },
+};
+
+const uint8_t kMeshoptVertexData[] = {
+    0xa0, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x58, 0x57, 0x58, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01,
+    0x0c, 0x00, 0x00, 0x00, 0x58, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x3f, 0x00, 0x00, 0x00, 0x17, 0x18, 0x17, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00,
+    0x00, 0x00, 0x17, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+const uint32_t kMeshoptIndices[] = { 0, 1, 51, 2, 49, 1000 };
+
+const uint8_t kMeshoptIndexData[] = {
+    0xd1, 0x00, 0x04, 0xcd, 0x01, 0x04, 0x07, 0x98, 0x1f, 0x00, 0x00, 0x00, 0x00,
+};
+
+} // namespace
+
+TEST_F(utglTF2ImportExport, meshopt_known_answers) {
+    static_assert(sizeof(MeshoptVertex) == 12, "unexpected padding");
+    using namespace glTF2::Meshopt;
+
+    MeshoptVertex vertices[4];
+    ASSERT_TRUE(DecodeVertexBuffer(reinterpret_cast<uint8_t *>(vertices), 4, sizeof(MeshoptVertex), kMeshoptVertexData, sizeof(kMeshoptVertexData)));
+    EXPECT_EQ(0, memcmp(kMeshoptVertices, vertices, sizeof(vertices)));
+
+    uint32_t indices[6];
+    ASSERT_TRUE(DecodeIndexSequence(reinterpret_cast<uint8_t *>(indices), 6, sizeof(uint32_t), kMeshoptIndexData, sizeof(kMeshoptIndexData)));
+    EXPECT_EQ(0, memcmp(kMeshoptIndices, indices, sizeof(indices)));
+
+    // the encoder makes the same choices
+    std::vector<uint8_t> encoded;
+    EncodeVertexBuffer(reinterpret_cast<const uint8_t *>(kMeshoptVertices), 4, sizeof(MeshoptVertex), encoded);
+    EXPECT_EQ(std::vector<uint8_t>(kMeshoptVertexData, kMeshoptVertexData + sizeof(kMeshoptVertexData)), encoded);
+    encoded.clear();
+    EncodeIndexSequence(reinterpret_cast<const uint8_t *>(kMeshoptIndices), 6, sizeof(uint32_t), encoded);
+    EXPECT_EQ(std::vector<uint8_t>(kMeshoptIndexData, kMeshoptIndexData + sizeof(kMeshoptIndexData)), encoded);
+
+    // truncated streams are rejected
+    EXPECT_FALSE(DecodeVertexBuffer(reinterpret_cast<uint8_t *>(vertices), 4, sizeof(MeshoptVertex), kMeshoptVertexData, sizeof(kMeshoptVertexData) - 1));
+    EXPECT_FALSE(DecodeIndexSequence(reinterpret_cast<uint8_t *>(indices), 6, sizeof(uint32_t), kMeshoptIndexData, 6));
+}
+
+#endif // ASSIMP_BUILD_NO_GLTF_IMPORTER
+
 TEST_F(utglTF2ImportExport, sceneMetadata) {
     Assimp::Importer importer;
     const aiScene *scene = importer.ReadFile(ASSIMP_TEST_MODELS_DIR "/glTF2/BoxTextured-glTF/BoxTextured.gltf",
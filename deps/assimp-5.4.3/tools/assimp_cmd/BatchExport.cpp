@@ -0,0 +1,408 @@
+/*
+---------------------------------------------------------------------------
+Open Asset Import Library (assimp)
+---------------------------------------------------------------------------
+
+Copyright (c) 2006-2024, assimp team
+
+All rights reserved.
+
+Redistribution and use of this software in source and binary forms,
+with or without modification, are permitted provided that the following
+conditions are met:
+
+* Redistributions of source code must retain the above
+  copyright notice, this list of conditions and the
+  following disclaimer.
+
+* Redistributions in binary form must reproduce the above
+  copyright notice, this list of conditions and the
+  following disclaimer in the documentation and/or other
+  materials provided with the distribution.
+
+* Neither the name of the assimp team, nor the names of its
+  contributors may be used to endorse or promote products
+  derived from this software without specific prior
+  written permission of the assimp team.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+---------------------------------------------------------------------------
+*/
+
+/** @file  BatchExport.cpp
+ *  @brief Implementation of the 'assimp batch-export' utility
+ */
+
+#include "Main.h"
+#include <assimp/ParsingUtils.h>
+#include <assimp/StringUtils.h>
+#include <assimp/config.h>
+#include <assimp/fast_atof.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef ASSIMP_BUILD_NO_EXPORT
+
+namespace fs = std::filesystem;
+
+const char *AICMD_MSG_BATCH_EXPORT_HELP_E =
+        "assimp batch-export <input> [<input> ...] -f<h> [-o<dir>] [-j<n>] [--force] [common parameters]\n"
+        "\t <input> A model file, a directory that is searched recursively for files\n"
+        "\t\twith a known extension, or @<list>, a text file with one path per line\n"
+        "\t -f<h> Specify the file format by id or file extension\n"
+        "\t -o<dir> --output-dir=<dir> Write all outputs below this directory. Files\n"
+        "\t\tfound in a directory keep their relative path. If omitted, each\n"
+        "\t\toutput is written next to its input. Nothing is converted if two\n"
+        "\t\tinputs map to the same output or an output would replace an input\n"
+        "\t -j<n> --jobs=<n> Number of files converted in parallel, defaults to the\n"
+        "\t\tnumber of hardware threads\n"
+        "\t --force Convert all files, even if the output is newer than the input\n"
+        "\t[See the assimp_cmd docs for a full list of all common parameters]  \n";
+
+namespace {
+
+// -----------------------------------------------------------------------------------
+struct BatchJob {
+    fs::path in;
+    fs::path out;
+    uintmax_t size = 0;
+};
+
+// -----------------------------------------------------------------------------------
+// Counters shared by all workers
+struct BatchTotals {
+    std::atomic<unsigned int> converted{ 0 };
+    std::atomic<unsigned int> skipped{ 0 };
+    std::atomic<unsigned int> failed{ 0 };
+    std::atomic<uintmax_t> bytes{ 0 };
+};
+
+// -----------------------------------------------------------------------------------
+// Common parameters that share a prefix with the ones of this command
+bool IsStandardArgument(const char *param) {
+    static const char *const prefixed[] = { "-fi", "-fid", "-fixn", "-fuv", "-fwo", "-fd", "-og", "-om", "-jiv" };
+    for (const char *arg : prefixed) {
+        if (!strcmp(param, arg)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------------
+bool IsUpToDate(const BatchJob &job) {
+    std::error_code ec;
+    const fs::file_time_type outTime = fs::last_write_time(job.out, ec);
+    if (ec) {
+        return false;
+    }
+    const fs::file_time_type inTime = fs::last_write_time(job.in, ec);
+    return !ec && outTime >= inTime;
+}
+
+// -----------------------------------------------------------------------------------
+fs::path GetOutputPath(const fs::path &relative, const fs::path &outDir, const std::string &ext) {
+    fs::path out = outDir.empty() ? relative : outDir / relative;
+    out.replace_extension(ext);
+    return out;
+}
+
+// -----------------------------------------------------------------------------------
+// Absolute, normalized form of a path so differently spelled paths compare equal
+fs::path GetComparablePath(const fs::path &path) {
+    std::error_code ec;
+    const fs::path absolute = fs::absolute(path, ec);
+    return (ec ? path : absolute).lexically_normal();
+}
+
+// -----------------------------------------------------------------------------------
+// True if path is dir or lies below it, compared component by component so that
+// 'out' doesn't contain 'output/a.obj'
+bool IsInside(const fs::path &path, const fs::path &dir) {
+    const fs::path p = GetComparablePath(path), d = GetComparablePath(dir);
+    auto dirEnd = d.end();
+    if (dirEnd != d.begin() && std::prev(dirEnd)->empty()) {
+        --dirEnd; // trailing separator
+    }
+    return std::mismatch(d.begin(), dirEnd, p.begin(), p.end()).first == dirEnd;
+}
+
+// -----------------------------------------------------------------------------------
+// Adds a job for every model found below an input, returns false if the input doesn't exist
+bool CollectJobs(const fs::path &input, const fs::path &outDir, const std::string &ext, std::vector<BatchJob> &jobs) {
+    std::error_code ec;
+    if (fs::is_directory(input, ec)) {
+        for (fs::recursive_directory_iterator it(input, ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file(ec)) {
+                continue;
+            }
+            const fs::path &path = it->path();
+
+            // don't pick up our own outputs when they are written into the input tree
+            if (!outDir.empty() && IsInside(path, outDir)) {
+                continue;
+            }
+            std::string fileExt = path.extension().string();
+            if (fileExt.size() < 2 || !globalImporter->IsExtensionSupported(fileExt)) {
+                continue;
+            }
+            const fs::path relative = outDir.empty() ? path : fs::relative(path, input, ec);
+            jobs.push_back({ path, GetOutputPath(relative, outDir, ext), it->file_size(ec) });
+        }
+        return true;
+    }
+
+    if (!fs::is_regular_file(input, ec)) {
+        return false;
+    }
+    jobs.push_back({ input, GetOutputPath(outDir.empty() ? input : input.filename(), outDir, ext), fs::file_size(input, ec) });
+    return true;
+}
+
+// -----------------------------------------------------------------------------------
+// Converts jobs until none are left, with an importer and exporter of its own
+void RunWorker(const std::vector<BatchJob> &jobs, std::atomic<size_t> &next, BatchTotals &totals,
+        const ImportData &import, const char *formatId, bool force, std::mutex &printLock) {
+    Importer importer;
+    Exporter exporter;
+
+    // the files are processed in parallel already
+    importer.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 1);
+    ExportProperties properties;
+    properties.SetPropertyInteger(AI_CONFIG_GLOB_NUM_THREADS, 1);
+
+    aiMatrix4x4 rx, ry, rz;
+    aiMatrix4x4::RotationX(import.rot.x, rx);
+    aiMatrix4x4::RotationY(import.rot.y, ry);
+    aiMatrix4x4::RotationZ(import.rot.z, rz);
+
+    for (size_t index = next++; index < jobs.size(); index = next++) {
+        const BatchJob &job = jobs[index];
+        if (!force && IsUpToDate(job)) {
+            ++totals.skipped;
+            std::lock_guard<std::mutex> lock(printLock);
+            printf("[skip] %s (up to date)\n", job.out.string().c_str());
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const aiScene *scene = importer.ReadFile(job.in.string(), import.ppFlags);
+        const auto imported = std::chrono::steady_clock::now();
+
+        std::string error;
+        if (!scene) {
+            error = std::string("failed to import: ") + importer.GetErrorString();
+        } else {
+            scene->mRootNode->mTransformation *= rx;
+            scene->mRootNode->mTransformation *= ry;
+            scene->mRootNode->mTransformation *= rz;
+
+            std::error_code ec;
+            if (job.out.has_parent_path()) {
+                fs::create_directories(job.out.parent_path(), ec);
+            }
+            if (exporter.Export(scene, formatId, job.out.string(), 0u, &properties) != AI_SUCCESS) {
+                error = std::string("failed to export: ") + exporter.GetErrorString();
+            }
+        }
+        importer.FreeScene();
+        const auto exported = std::chrono::steady_clock::now();
+
+        const double importSeconds = std::chrono::duration<double>(imported - start).count();
+        const double exportSeconds = std::chrono::duration<double>(exported - imported).count();
+        const double megabytes = job.size / (1024.0 * 1024.0);
+
+        std::lock_guard<std::mutex> lock(printLock);
+        if (!error.empty()) {
+            ++totals.failed;
+            printf("[fail] %s: %s\n", job.in.string().c_str(), error.c_str());
+            continue;
+        }
+        ++totals.converted;
+        totals.bytes += job.size;
+        printf("[ ok ] %s -> %s  %.2f MB, import %.3f s, export %.3f s, %.2f MB/s\n", job.in.string().c_str(),
+                job.out.string().c_str(), megabytes, importSeconds, exportSeconds,
+                megabytes / std::max(importSeconds + exportSeconds, 1e-6));
+    }
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------------
+int Assimp_BatchExport(const char *const *params, unsigned int num) {
+    const char *const invalid = "assimp batch-export: Invalid number of arguments. See \'assimp batch-export --help\'\n";
+    if (num < 1) {
+        printf(invalid);
+        return AssimpCmdError::InvalidNumberOfArguments;
+    }
+
+    // --help
+    if (!strcmp(params[0], "-h") || !strcmp(params[0], "--help") || !strcmp(params[0], "-?")) {
+        printf("%s", AICMD_MSG_BATCH_EXPORT_HELP_E);
+        return AssimpCmdError::Success;
+    }
+
+    // get import flags
+    ImportData import;
+    ProcessStandardArguments(import, params, num);
+
+    // process other flags, everything that isn't a flag is an input
+    std::string outf, outDir;
+    unsigned int numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    bool force = false;
+    std::vector<std::string> inputs;
+    for (unsigned int i = 0; i < num; ++i) {
+        const char *param = params[i];
+        if (!param || IsStandardArgument(param)) {
+            continue;
+        }
+        if (!strncmp(param, "-f", 2)) {
+            outf = std::string(param + 2);
+        } else if (!strncmp(param, "--format=", 9)) {
+            outf = std::string(param + 9);
+        } else if (!strncmp(param, "-o", 2)) {
+            outDir = std::string(param + 2);
+        } else if (!strncmp(param, "--output-dir=", 13)) {
+            outDir = std::string(param + 13);
+        } else if (!strncmp(param, "-j", 2)) {
+            numThreads = std::max(strtoul10(param + 2), 1u);
+        } else if (!strncmp(param, "--jobs=", 7)) {
+            numThreads = std::max(strtoul10(param + 7), 1u);
+        } else if (!strcmp(param, "--force")) {
+            force = true;
+        } else if (param[0] != '-') {
+            inputs.emplace_back(param);
+        }
+    }
+    if (inputs.empty()) {
+        printf(invalid);
+        return AssimpCmdError::InvalidNumberOfArguments;
+    }
+
+    std::transform(outf.begin(), outf.end(), outf.begin(), ai_tolower<char>);
+
+    // convert the output format to a format id, either given by id or by file extension
+    size_t outfi = GetMatchingFormat(outf);
+    if (outfi == SIZE_MAX) {
+        outfi = GetMatchingFormat(outf, true);
+        if (outfi == SIZE_MAX) {
+            printf("assimp batch-export: no or unknown output format \'%s\' specified\n", outf.c_str());
+            return AssimpCmdError::UnknownFileFormat;
+        }
+    }
+    const aiExportFormatDesc *const e = globalExporter->GetExportFormatDescription(outfi);
+    printf("assimp batch-export: select file format: \'%s\' (%s)\n", e->id, e->description);
+
+    // gather the files, @<list> names a file with one input per line
+    std::vector<BatchJob> jobs;
+    const fs::path outPath = fs::path(outDir).lexically_normal();
+    for (const std::string &input : inputs) {
+        std::vector<std::string> paths;
+        if (input[0] == '@') {
+            std::ifstream list(input.substr(1));
+            if (!list) {
+                printf("assimp batch-export: failed to open file list \'%s\'\n", input.c_str() + 1);
+                return AssimpCmdError::FailedToLoadInputFile;
+            }
+            for (std::string line; std::getline(list, line);) {
+                line = ai_trim(line);
+                if (!line.empty()) {
+                    paths.push_back(line);
+                }
+            }
+        } else {
+            paths.push_back(input);
+        }
+
+        for (const std::string &path : paths) {
+            if (!CollectJobs(fs::path(path).lexically_normal(), outPath, e->fileExtension, jobs)) {
+                printf("assimp batch-export: input \'%s\' does not exist\n", path.c_str());
+                return AssimpCmdError::FailedToLoadInputFile;
+            }
+        }
+    }
+
+    // refuse to start if two inputs would be written to the same file, e.g. equally
+    // named models from different directories, or if an output would replace an input
+    std::map<fs::path, const BatchJob *> inputsByPath, outputsByPath;
+    for (const BatchJob &job : jobs) {
+        inputsByPath.emplace(GetComparablePath(job.in), &job);
+    }
+    for (const BatchJob &job : jobs) {
+        const fs::path out = GetComparablePath(job.out);
+        const auto written = outputsByPath.emplace(out, &job);
+        if (!written.second) {
+            printf("assimp batch-export: \'%s\' and \'%s\' would both be written to \'%s\'\n",
+                    written.first->second->in.string().c_str(), job.in.string().c_str(), job.out.string().c_str());
+            return AssimpCmdError::InvalidNumberOfArguments;
+        }
+        const auto input = inputsByPath.find(out);
+        if (input != inputsByPath.end()) {
+            printf("assimp batch-export: \'%s\' would overwrite the input \'%s\'\n",
+                    job.in.string().c_str(), input->second->in.string().c_str());
+            return AssimpCmdError::InvalidNumberOfArguments;
+        }
+    }
+
+    // start with the largest files so no worker is left with a big one at the end
+    std::stable_sort(jobs.begin(), jobs.end(), [](const BatchJob &a, const BatchJob &b) {
+        return a.size > b.size;
+    });
+    numThreads = std::min(numThreads, static_cast<unsigned int>(std::max(jobs.size(), size_t(1))));
+    printf("assimp batch-export: %u files, %u workers\n", static_cast<unsigned int>(jobs.size()), numThreads);
+
+    if (import.log) {
+        SetLogStreams(import);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    BatchTotals totals;
+    std::atomic<size_t> next{ 0 };
+    std::mutex printLock;
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        workers.emplace_back(RunWorker, std::cref(jobs), std::ref(next), std::ref(totals), std::cref(import), e->id,
+                force, std::ref(printLock));
+    }
+    RunWorker(jobs, next, totals, import, e->id, force, printLock);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (import.log) {
+        FreeLogStreams();
+    }
+
+    const double megabytes = totals.bytes / (1024.0 * 1024.0);
+    printf("assimp batch-export: %u converted, %u skipped, %u failed in %.3f s\n"
+           "   %.2f MB read, %.2f MB/s, %.2f files/s\n",
+            totals.converted.load(), totals.skipped.load(), totals.failed.load(), seconds,
+            megabytes, megabytes / std::max(seconds, 1e-6), totals.converted / std::max(seconds, 1e-6));
+
+    if (totals.failed) {
+        return AssimpCmdExportError::FailedToExportModel;
+    }
+    return AssimpCmdError::Success;
+}
+
+#endif // no export
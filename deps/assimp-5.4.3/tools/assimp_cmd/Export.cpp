@@ -56,7 +56,7 @@ const char *AICMD_MSG_EXPORT_HELP_E =
         "\t[See the assimp_cmd docs for a full list of all common parameters]  \n";
 
 // -----------------------------------------------------------------------------------
-size_t GetMatchingFormat(const std::string &outf, bool byext = false) {
+size_t GetMatchingFormat(const std::string &outf, bool byext) {
     for (size_t i = 0, end = globalExporter->GetExportFormatCount(); i < end; ++i) {
         const aiExportFormatDesc *const e = globalExporter->GetExportFormatDescription(i);
         if (outf == (byext ? e->fileExtension : e->id)) {
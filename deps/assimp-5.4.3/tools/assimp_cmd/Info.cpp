@@ -402,6 +402,21 @@ int Assimp_Info(const char *const *params, unsigned int num) {
         return AssimpCmdError::Success;
     }
 
+    // import phases, the memory columns count the allocations made through the importer's MemoryAllocator
+    if (globalImporter->GetPhaseCount()) {
+        printf("\nImport phases:  (name) [milliseconds / allocations / bytes / peak bytes]\n");
+        printf("    (memory of loader buffers only, the scene's meshes, faces and nodes are not counted)\n");
+    }
+    for (size_t i = 0; i < globalImporter->GetPhaseCount(); ++i) {
+        const ImporterPhase *phase = globalImporter->GetPhase(i);
+        printf("    %s: [%.3f / %zu / %zu / %zu]\n",
+                phase->mName,
+                phase->mSeconds * 1000.0,
+                phase->mAllocations,
+                phase->mAllocatedBytes,
+                phase->mPeakBytes);
+    }
+
     // meshes
     if (scene->mNumMeshes) {
         printf("\nMeshes:  (name) [vertices / bones / faces | primitive_types]\n");
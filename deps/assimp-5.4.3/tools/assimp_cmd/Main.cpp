@@ -81,6 +81,7 @@ constexpr char AICMD_MSG_HELP[] =
 " \texport     - Export a file to one of the supported output formats\n"
 " \tlistexport - List all supported export formats\n"
 " \texportinfo - Show basic information on a specific export format\n"
+" \tbatch-export - Convert many files in parallel to one output format\n"
 #endif
 " \textract    - Extract embedded texture images\n"
 " \tdump       - Convert models to a binary or textual dump (ASSBIN/ASSXML)\n"
@@ -202,6 +203,12 @@ int main (int argc, char* argv[]) {
 		return Assimp_Export (&argv[2],argc-2);
 	}
 
+	// assimp batch-export
+	// Convert a list or directory of models in parallel
+	if (! strcmp(argv[1], "batch-export")) {
+		return Assimp_BatchExport (&argv[2],argc-2);
+	}
+
 #endif
 
 	// assimp knowext
@@ -148,6 +148,15 @@ const aiScene* ImportModel(
 	const ImportData& imp,
 	const std::string& path);
 
+// ------------------------------------------------------------------------------
+/** Attach the log streams requested by an import configuration
+ *  @param imp Import configuration to be used */
+void SetLogStreams(const ImportData& imp);
+
+// ------------------------------------------------------------------------------
+/** Detach the log streams again */
+void FreeLogStreams();
+
 #ifndef ASSIMP_BUILD_NO_EXPORT
 
 // ------------------------------------------------------------------------------
@@ -160,6 +169,13 @@ bool ExportModel(const aiScene* pOut,
 	const std::string& path,
 	const char* pID);
 
+// ------------------------------------------------------------------------------
+/** Find an export format
+ *  @param outf Format id or file extension
+ *  @param byext Match outf against the file extensions instead of the ids
+ *  @return Index of the format or SIZE_MAX if unknown */
+size_t GetMatchingFormat(const std::string& outf, bool byext = false);
+
 #endif
 
 // ------------------------------------------------------------------------------
@@ -191,6 +207,15 @@ int Assimp_Export (
 	const char* const* params,
 	unsigned int num);
 
+// ------------------------------------------------------------------------------
+/** assimp batch-export utility
+ *  @param params Command line parameters to 'assimp batch-export'
+ *  @param Number of params
+ *  @return Either an #AssimpCmdError or #AssimpCmdExportError value. */
+int Assimp_BatchExport (
+	const char* const* params,
+	unsigned int num);
+
 // ------------------------------------------------------------------------------
 /// @brief Error codes used by the 'Image Extractor' utility.
 enum AssimpCmdExtractError {
@@ -0,0 +1,389 @@
+#include "AnimationClip.h"
+
+#include "assimp/anim.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine
+{
+
+namespace
+{
+	// Longest run of keys one interpolated segment may replace, bounds the build time
+	// of long densely baked tracks
+	constexpr uint32_t kMaxReducedSpan = 256;
+
+	// Greedy key reduction: grows a segment from the last kept key for as long as
+	// withinTolerance(first, last, i) holds for every key i inside it.
+	template <class WithinTolerance>
+	std::vector<uint32_t> selectKeys(uint32_t count, WithinTolerance withinTolerance)
+	{
+		std::vector<uint32_t> kept;
+		if (count == 0)
+		{
+			return kept;
+		}
+
+		kept.push_back(0);
+		uint32_t anchor = 0;
+		for (uint32_t end = 2; end < count; ++end)
+		{
+			bool reducible = end - anchor <= kMaxReducedSpan;
+			for (uint32_t i = anchor + 1; reducible && i < end; ++i)
+			{
+				reducible = withinTolerance(anchor, end, i);
+			}
+			if (!reducible)
+			{
+				anchor = end - 1;
+				kept.push_back(anchor);
+			}
+		}
+		if (count > 1)
+		{
+			kept.push_back(count - 1);
+		}
+		return kept;
+	}
+
+	float segmentAlpha(const std::vector<float>& times, uint32_t first, uint32_t last, uint32_t i)
+	{
+		const float span = times[last] - times[first];
+		return span > 0.0f ? (times[i] - times[first]) / span : 0.0f;
+	}
+
+	struct Vec3Track
+	{
+		std::vector<float> times;
+		std::vector<float> x, y, z;
+	};
+
+	struct QuatTrack
+	{
+		std::vector<float> times;
+		std::vector<float> q;  // x, y, z, w per key
+	};
+
+	std::vector<uint32_t> reduceVec3Track(const Vec3Track& track, float tolerance)
+	{
+		const uint32_t count = static_cast<uint32_t>(track.times.size());
+		if (tolerance <= 0.0f)
+		{
+			std::vector<uint32_t> all(count);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				all[i] = i;
+			}
+			return all;
+		}
+
+		auto error = [&](uint32_t first, uint32_t last, uint32_t i, float alpha)
+		{
+			const float ex = track.x[first] + (track.x[last] - track.x[first]) * alpha - track.x[i];
+			const float ey = track.y[first] + (track.y[last] - track.y[first]) * alpha - track.y[i];
+			const float ez = track.z[first] + (track.z[last] - track.z[first]) * alpha - track.z[i];
+			return std::max(std::fabs(ex), std::max(std::fabs(ey), std::fabs(ez)));
+		};
+
+		std::vector<uint32_t> kept = selectKeys(count, [&](uint32_t first, uint32_t last, uint32_t i)
+		{
+			return error(first, last, i, segmentAlpha(track.times, first, last, i)) <= tolerance;
+		});
+
+		// a constant track needs a single key
+		if (kept.size() == 2 && error(kept[0], kept[0], kept[1], 0.0f) <= tolerance)
+		{
+			kept.pop_back();
+		}
+		return kept;
+	}
+
+	// Same blend as the sampler: shortest-arc normalized lerp
+	void nlerp(const float* a, const float* b, float alpha, float* out)
+	{
+		const float dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+		const float sign = dot < 0.0f ? -1.0f : 1.0f;
+		float lengthSquared = 0.0f;
+		for (int c = 0; c < 4; ++c)
+		{
+			out[c] = a[c] + (b[c] * sign - a[c]) * alpha;
+			lengthSquared += out[c] * out[c];
+		}
+		const float invLength = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+		for (int c = 0; c < 4; ++c)
+		{
+			out[c] *= invLength;
+		}
+	}
+
+	float angleBetween(const float* a, const float* b)
+	{
+		const float dot = std::fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+		return 2.0f * std::acos(std::min(dot, 1.0f));
+	}
+
+	std::vector<uint32_t> reduceQuatTrack(const QuatTrack& track, float tolerance)
+	{
+		const uint32_t count = static_cast<uint32_t>(track.times.size());
+		if (tolerance <= 0.0f)
+		{
+			std::vector<uint32_t> all(count);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				all[i] = i;
+			}
+			return all;
+		}
+
+		std::vector<uint32_t> kept = selectKeys(count, [&](uint32_t first, uint32_t last, uint32_t i)
+		{
+			float blended[4];
+			nlerp(&track.q[first * 4], &track.q[last * 4], segmentAlpha(track.times, first, last, i), blended);
+			return angleBetween(blended, &track.q[i * 4]) <= tolerance;
+		});
+
+		if (kept.size() == 2 && angleBetween(&track.q[kept[0] * 4], &track.q[kept[1] * 4]) <= tolerance)
+		{
+			kept.pop_back();
+		}
+		return kept;
+	}
+
+	void appendSeekTable(AnimationTrackSet& set, uint32_t begin, uint32_t count, float duration)
+	{
+		const float bucketsPerSecond = duration > 0.0f ? static_cast<float>(count) / duration : 0.0f;
+		set.seekBucketsPerSecond.push_back(bucketsPerSecond);
+
+		uint32_t key = 0;
+		for (uint32_t bucket = 0; bucket < count; ++bucket)
+		{
+			const float start = bucketsPerSecond > 0.0f ? static_cast<float>(bucket) / bucketsPerSecond : 0.0f;
+			while (key + 1 < count && set.times[begin + key + 1] <= start)
+			{
+				++key;
+			}
+			set.seekTable.push_back(key);
+		}
+		set.seekBegin.push_back(static_cast<uint32_t>(set.seekTable.size()));
+	}
+
+	void beginTrackSet(AnimationTrackSet& set)
+	{
+		set.keyBegin.assign(1, 0);
+		set.seekBegin.assign(1, 0);
+	}
+
+	void appendVec3Track(AnimationTrackSet& set, std::vector<float>& x, std::vector<float>& y, std::vector<float>& z,
+		const Vec3Track& track, float tolerance, float duration)
+	{
+		const uint32_t begin = static_cast<uint32_t>(set.times.size());
+		for (uint32_t key : reduceVec3Track(track, tolerance))
+		{
+			set.times.push_back(track.times[key]);
+			x.push_back(track.x[key]);
+			y.push_back(track.y[key]);
+			z.push_back(track.z[key]);
+		}
+		const uint32_t count = static_cast<uint32_t>(set.times.size()) - begin;
+		set.keyBegin.push_back(begin + count);
+		appendSeekTable(set, begin, count, duration);
+	}
+
+	void appendQuatTrack(AnimationTrackSet& set, std::vector<QuantizedQuaternion>& rotations,
+		const QuatTrack& track, float tolerance, float duration)
+	{
+		const uint32_t begin = static_cast<uint32_t>(set.times.size());
+		for (uint32_t key : reduceQuatTrack(track, tolerance))
+		{
+			set.times.push_back(track.times[key]);
+			rotations.push_back(quantizeQuaternion(&track.q[key * 4]));
+		}
+		const uint32_t count = static_cast<uint32_t>(set.times.size()) - begin;
+		set.keyBegin.push_back(begin + count);
+		appendSeekTable(set, begin, count, duration);
+	}
+
+	Vec3Track convertVectorKeys(const aiVectorKey* keys, unsigned int count, double secondsPerTick, float fallback)
+	{
+		Vec3Track track;
+		if (count == 0)
+		{
+			track.times.push_back(0.0f);
+			track.x.push_back(fallback);
+			track.y.push_back(fallback);
+			track.z.push_back(fallback);
+			return track;
+		}
+
+		track.times.resize(count);
+		track.x.resize(count);
+		track.y.resize(count);
+		track.z.resize(count);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			track.times[i] = static_cast<float>(keys[i].mTime * secondsPerTick);
+			track.x[i] = static_cast<float>(keys[i].mValue.x);
+			track.y[i] = static_cast<float>(keys[i].mValue.y);
+			track.z[i] = static_cast<float>(keys[i].mValue.z);
+		}
+		return track;
+	}
+
+	QuatTrack convertQuatKeys(const aiQuatKey* keys, unsigned int count, double secondsPerTick)
+	{
+		QuatTrack track;
+		if (count == 0)
+		{
+			track.times.push_back(0.0f);
+			track.q = { 0.0f, 0.0f, 0.0f, 1.0f };
+			return track;
+		}
+
+		track.times.resize(count);
+		track.q.resize(count * 4);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			track.times[i] = static_cast<float>(keys[i].mTime * secondsPerTick);
+
+			float* q = &track.q[i * 4];
+			q[0] = static_cast<float>(keys[i].mValue.x);
+			q[1] = static_cast<float>(keys[i].mValue.y);
+			q[2] = static_cast<float>(keys[i].mValue.z);
+			q[3] = static_cast<float>(keys[i].mValue.w);
+			const float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+			if (length > 0.0f)
+			{
+				for (int c = 0; c < 4; ++c)
+				{
+					q[c] /= length;
+				}
+			}
+			else
+			{
+				q[0] = q[1] = q[2] = 0.0f;
+				q[3] = 1.0f;
+			}
+
+			// keep neighbouring keys on the same hemisphere so the reduction compares like with like
+			if (i > 0)
+			{
+				const float* previous = q - 4;
+				if (previous[0] * q[0] + previous[1] * q[1] + previous[2] * q[2] + previous[3] * q[3] < 0.0f)
+				{
+					for (int c = 0; c < 4; ++c)
+					{
+						q[c] = -q[c];
+					}
+				}
+			}
+		}
+		return track;
+	}
+
+	size_t trackSetMemory(const AnimationTrackSet& set)
+	{
+		return set.keyBegin.size() * sizeof(uint32_t) + set.times.size() * sizeof(float)
+			+ set.seekBegin.size() * sizeof(uint32_t) + set.seekTable.size() * sizeof(uint32_t)
+			+ set.seekBucketsPerSecond.size() * sizeof(float);
+	}
+}
+
+uint32_t AnimationTrackSet::findKey(uint32_t track, float time) const
+{
+	const uint32_t begin = keyBegin[track];
+	const uint32_t count = keyBegin[track + 1] - begin;
+	const uint32_t seek = seekBegin[track];
+	const uint32_t buckets = seekBegin[track + 1] - seek;
+
+	const float bucket = time * seekBucketsPerSecond[track];
+	uint32_t key = seekTable[seek + (bucket > 0.0f ? std::min(static_cast<uint32_t>(bucket), buckets - 1) : 0)];
+
+	// the bucket start is only exact up to rounding, correct in both directions
+	while (key > 0 && times[begin + key] > time)
+	{
+		--key;
+	}
+	while (key + 1 < count && times[begin + key + 1] <= time)
+	{
+		++key;
+	}
+	return begin + key;
+}
+
+size_t AnimationTrackSet::getMemoryUsage() const
+{
+	return trackSetMemory(*this);
+}
+
+int AnimationClip::findChannel(const std::string& nodeName) const
+{
+	for (size_t i = 0; i < channelNodes.size(); ++i)
+	{
+		if (channelNodes[i] == nodeName)
+		{
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+size_t AnimationClip::getMemoryUsage() const
+{
+	return translationTracks.getMemoryUsage() + rotationTracks.getMemoryUsage() + scaleTracks.getMemoryUsage()
+		+ (translationX.size() + translationY.size() + translationZ.size()) * sizeof(float)
+		+ rotations.size() * sizeof(QuantizedQuaternion)
+		+ (scaleX.size() + scaleY.size() + scaleZ.size()) * sizeof(float);
+}
+
+AnimationClip buildAnimationClip(const aiAnimation& animation, const ClipBuildSettings& settings)
+{
+	AnimationClip clip;
+	clip.name = animation.mName.C_Str();
+
+	const double ticksPerSecond = animation.mTicksPerSecond > 0.0 ? animation.mTicksPerSecond : settings.defaultTicksPerSecond;
+	const double secondsPerTick = 1.0 / ticksPerSecond;
+	// keys past the announced duration still have to be reachable
+	double durationTicks = animation.mDuration;
+	for (unsigned int c = 0; c < animation.mNumChannels; ++c)
+	{
+		const aiNodeAnim* channel = animation.mChannels[c];
+		if (channel->mNumPositionKeys)
+		{
+			durationTicks = std::max(durationTicks, channel->mPositionKeys[channel->mNumPositionKeys - 1].mTime);
+		}
+		if (channel->mNumRotationKeys)
+		{
+			durationTicks = std::max(durationTicks, channel->mRotationKeys[channel->mNumRotationKeys - 1].mTime);
+		}
+		if (channel->mNumScalingKeys)
+		{
+			durationTicks = std::max(durationTicks, channel->mScalingKeys[channel->mNumScalingKeys - 1].mTime);
+		}
+	}
+	clip.duration = static_cast<float>(durationTicks * secondsPerTick);
+
+	beginTrackSet(clip.translationTracks);
+	beginTrackSet(clip.rotationTracks);
+	beginTrackSet(clip.scaleTracks);
+
+	clip.channelNodes.reserve(animation.mNumChannels);
+	for (unsigned int c = 0; c < animation.mNumChannels; ++c)
+	{
+		const aiNodeAnim* channel = animation.mChannels[c];
+		clip.channelNodes.emplace_back(channel->mNodeName.C_Str());
+
+		const Vec3Track translation = convertVectorKeys(channel->mPositionKeys, channel->mNumPositionKeys, secondsPerTick, 0.0f);
+		const QuatTrack rotation = convertQuatKeys(channel->mRotationKeys, channel->mNumRotationKeys, secondsPerTick);
+		const Vec3Track scale = convertVectorKeys(channel->mScalingKeys, channel->mNumScalingKeys, secondsPerTick, 1.0f);
+
+		appendVec3Track(clip.translationTracks, clip.translationX, clip.translationY, clip.translationZ,
+			translation, settings.translationTolerance, clip.duration);
+		appendQuatTrack(clip.rotationTracks, clip.rotations, rotation, settings.rotationTolerance, clip.duration);
+		appendVec3Track(clip.scaleTracks, clip.scaleX, clip.scaleY, clip.scaleZ,
+			scale, settings.scaleTolerance, clip.duration);
+	}
+	return clip;
+}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "QuantizedQuaternion.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct aiAnimation;
+
+namespace engine
+{
+
+// Keys of one kind (translation, rotation or scale) for all channels of a clip.
+// Track c owns the keys [keyBegin[c], keyBegin[c + 1]), every track has at least
+// one key. Next to the key times each track keeps a seek table: the clip is cut
+// into as many equal buckets as the track has keys and each bucket stores the key
+// that is active at its start, so finding the key for any time is a table lookup
+// plus, on average, less than one step forward.
+struct AnimationTrackSet
+{
+	std::vector<uint32_t> keyBegin;
+	std::vector<float> times;  // seconds
+
+	std::vector<uint32_t> seekBegin;
+	std::vector<uint32_t> seekTable;  // key index relative to the track
+	std::vector<float> seekBucketsPerSecond;
+
+	// Absolute index of the last key at or before time, or the first key of the track
+	uint32_t findKey(uint32_t track, float time) const;
+
+	size_t getMemoryUsage() const;
+};
+
+// Sampling-friendly copy of an aiAnimation. Values are stored per component
+// (structure of arrays) so a sampler walks each stream linearly, rotations are
+// quantized to 48 bits and keys that linear interpolation reproduces within the
+// build tolerances are dropped.
+struct AnimationClip
+{
+	std::string name;
+	float duration = 0.0f;  // seconds
+
+	std::vector<std::string> channelNodes;  // animated node per channel
+
+	AnimationTrackSet translationTracks;
+	std::vector<float> translationX;
+	std::vector<float> translationY;
+	std::vector<float> translationZ;
+
+	AnimationTrackSet rotationTracks;
+	std::vector<QuantizedQuaternion> rotations;
+
+	AnimationTrackSet scaleTracks;
+	std::vector<float> scaleX;
+	std::vector<float> scaleY;
+	std::vector<float> scaleZ;
+
+	uint32_t getChannelCount() const { return static_cast<uint32_t>(channelNodes.size()); }
+
+	// Channel animating the named node, or -1
+	int findChannel(const std::string& nodeName) const;
+
+	size_t getMemoryUsage() const;
+};
+
+struct ClipBuildSettings
+{
+	// Largest error a dropped key may introduce, zero keeps every key
+	float translationTolerance = 1e-4f;  // scene units
+	float rotationTolerance = 1e-3f;     // radians
+	float scaleTolerance = 1e-4f;
+
+	// Used when the animation doesn't specify its tick rate
+	double defaultTicksPerSecond = 25.0;
+};
+
+AnimationClip buildAnimationClip(const aiAnimation& animation, const ClipBuildSettings& settings = ClipBuildSettings());
+
+}
@@ -0,0 +1,191 @@
+#include "AnimationSampler.h"
+
+#include "../core/JobSystem.h"
+
+#include <cmath>
+
+namespace engine
+{
+
+namespace
+{
+	// Clips sampled per job system chunk
+	constexpr size_t kClipsPerChunk = 8;
+
+	// Per-thread staging buffers: the key search and the dequantization are scalar,
+	// they fill these arrays and the interpolation then runs as plain loops over them
+	struct SampleScratch
+	{
+		std::vector<uint32_t> first, second;
+		std::vector<float> alpha;
+		std::vector<float> ax, ay, az, aw;
+		std::vector<float> bx, by, bz, bw;
+
+		void resize(size_t count)
+		{
+			if (first.size() >= count)
+			{
+				return;
+			}
+			for (std::vector<uint32_t>* keys : { &first, &second })
+			{
+				keys->resize(count);
+			}
+			for (std::vector<float>* stream : { &alpha, &ax, &ay, &az, &aw, &bx, &by, &bz, &bw })
+			{
+				stream->resize(count);
+			}
+		}
+	};
+
+	thread_local SampleScratch t_scratch;
+
+	void locateKeys(const AnimationTrackSet& tracks, uint32_t trackCount, float time, SampleScratch& scratch)
+	{
+		for (uint32_t track = 0; track < trackCount; ++track)
+		{
+			const uint32_t last = tracks.keyBegin[track + 1] - 1;
+			const uint32_t first = tracks.findKey(track, time);
+			const uint32_t second = first < last ? first + 1 : first;
+
+			float alpha = 0.0f;
+			if (second != first)
+			{
+				const float span = tracks.times[second] - tracks.times[first];
+				alpha = span > 0.0f ? (time - tracks.times[first]) / span : 0.0f;
+				alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+			}
+			scratch.first[track] = first;
+			scratch.second[track] = second;
+			scratch.alpha[track] = alpha;
+		}
+	}
+
+	void blendStream(const float* keys, const SampleScratch& scratch, uint32_t count, float* out)
+	{
+		const uint32_t* first = scratch.first.data();
+		const uint32_t* second = scratch.second.data();
+		const float* alpha = scratch.alpha.data();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const float a = keys[first[i]];
+			out[i] = a + (keys[second[i]] - a) * alpha[i];
+		}
+	}
+
+	void sampleVec3(const AnimationTrackSet& tracks, const std::vector<float>& x, const std::vector<float>& y,
+		const std::vector<float>& z, uint32_t count, float time, SampleScratch& scratch,
+		float* outX, float* outY, float* outZ)
+	{
+		locateKeys(tracks, count, time, scratch);
+		blendStream(x.data(), scratch, count, outX);
+		blendStream(y.data(), scratch, count, outY);
+		blendStream(z.data(), scratch, count, outZ);
+	}
+
+	void sampleRotations(const AnimationClip& clip, uint32_t count, float time, SampleScratch& scratch, Pose& pose)
+	{
+		locateKeys(clip.rotationTracks, count, time, scratch);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			float q[4];
+			dequantizeQuaternion(clip.rotations[scratch.first[i]], q);
+			scratch.ax[i] = q[0];
+			scratch.ay[i] = q[1];
+			scratch.az[i] = q[2];
+			scratch.aw[i] = q[3];
+			dequantizeQuaternion(clip.rotations[scratch.second[i]], q);
+			scratch.bx[i] = q[0];
+			scratch.by[i] = q[1];
+			scratch.bz[i] = q[2];
+			scratch.bw[i] = q[3];
+		}
+
+		// shortest-arc normalized lerp, branch free so it vectorizes
+		const float* alpha = scratch.alpha.data();
+		float* rx = pose.rotationX.data();
+		float* ry = pose.rotationY.data();
+		float* rz = pose.rotationZ.data();
+		float* rw = pose.rotationW.data();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const float ax = scratch.ax[i], ay = scratch.ay[i], az = scratch.az[i], aw = scratch.aw[i];
+			const float dot = ax * scratch.bx[i] + ay * scratch.by[i] + az * scratch.bz[i] + aw * scratch.bw[i];
+			const float t = dot < 0.0f ? -alpha[i] : alpha[i];
+			const float s = 1.0f - alpha[i];
+
+			const float x = ax * s + scratch.bx[i] * t;
+			const float y = ay * s + scratch.by[i] * t;
+			const float z = az * s + scratch.bz[i] * t;
+			const float w = aw * s + scratch.bw[i] * t;
+			const float invLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+			rx[i] = x * invLength;
+			ry[i] = y * invLength;
+			rz[i] = z * invLength;
+			rw[i] = w * invLength;
+		}
+	}
+}
+
+void Pose::resize(size_t channelCount)
+{
+	for (std::vector<float>* stream : { &translationX, &translationY, &translationZ,
+		&rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ })
+	{
+		stream->resize(channelCount);
+	}
+}
+
+void sampleClip(const AnimationClip& clip, float time, bool loop, Pose& pose)
+{
+	const uint32_t count = clip.getChannelCount();
+	pose.resize(count);
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (clip.duration > 0.0f)
+	{
+		if (loop)
+		{
+			time = std::fmod(time, clip.duration);
+			time = time < 0.0f ? time + clip.duration : time;
+		}
+		else
+		{
+			time = time < 0.0f ? 0.0f : (time > clip.duration ? clip.duration : time);
+		}
+	}
+	else
+	{
+		time = 0.0f;
+	}
+
+	SampleScratch& scratch = t_scratch;
+	scratch.resize(count);
+
+	sampleVec3(clip.translationTracks, clip.translationX, clip.translationY, clip.translationZ, count, time, scratch,
+		pose.translationX.data(), pose.translationY.data(), pose.translationZ.data());
+	sampleRotations(clip, count, time, scratch, pose);
+	sampleVec3(clip.scaleTracks, clip.scaleX, clip.scaleY, clip.scaleZ, count, time, scratch,
+		pose.scaleX.data(), pose.scaleY.data(), pose.scaleZ.data());
+}
+
+void sampleClips(const AnimationSampleJob* jobs, size_t count, JobSystem& jobSystem)
+{
+	jobSystem.parallelFor(count, kClipsPerChunk, [jobs](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			const AnimationSampleJob& job = jobs[i];
+			if (job.clip != nullptr && job.pose != nullptr)
+			{
+				sampleClip(*job.clip, job.time, job.loop, *job.pose);
+			}
+		}
+	});
+}
+
+}
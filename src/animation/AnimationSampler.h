@@ -0,0 +1,41 @@
+#pragma once
+
+#include "AnimationClip.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+class JobSystem;
+
+// Local transforms of all channels of a clip, one array per component so the
+// blend loops run over contiguous memory.
+struct Pose
+{
+	std::vector<float> translationX, translationY, translationZ;
+	std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+	std::vector<float> scaleX, scaleY, scaleZ;
+
+	void resize(size_t channelCount);
+	size_t size() const { return translationX.size(); }
+};
+
+// Samples every channel of the clip at time (seconds). With loop set the time
+// wraps around the clip duration, otherwise it is clamped to it.
+void sampleClip(const AnimationClip& clip, float time, bool loop, Pose& pose);
+
+struct AnimationSampleJob
+{
+	const AnimationClip* clip = nullptr;
+	float time = 0.0f;
+	bool loop = true;
+	Pose* pose = nullptr;
+};
+
+// Samples many clips, typically one per character, spread over the job system
+void sampleClips(const AnimationSampleJob* jobs, size_t count, JobSystem& jobSystem);
+
+}
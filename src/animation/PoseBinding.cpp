@@ -0,0 +1,36 @@
+#include "PoseBinding.h"
+
+#include "../scene/NodeHierarchy.h"
+
+#include <algorithm>
+
+namespace engine
+{
+
+std::vector<int32_t> bindClipToHierarchy(const AnimationClip& clip, const NodeHierarchy& hierarchy)
+{
+	std::vector<int32_t> channelNodes(clip.getChannelCount());
+	for (uint32_t c = 0; c < clip.getChannelCount(); ++c)
+	{
+		channelNodes[c] = hierarchy.findNode(clip.channelNodes[c]);
+	}
+	return channelNodes;
+}
+
+void applyPose(const Pose& pose, const std::vector<int32_t>& channelNodes, Affine* locals)
+{
+	const size_t count = std::min(pose.size(), channelNodes.size());
+	for (size_t c = 0; c < count; ++c)
+	{
+		if (channelNodes[c] < 0)
+		{
+			continue;
+		}
+		locals[channelNodes[c]] = affineFromTranslationRotationScale(
+			pose.translationX[c], pose.translationY[c], pose.translationZ[c],
+			pose.rotationX[c], pose.rotationY[c], pose.rotationZ[c], pose.rotationW[c],
+			pose.scaleX[c], pose.scaleY[c], pose.scaleZ[c]);
+	}
+}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "AnimationSampler.h"
+
+#include "../core/Affine.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+struct NodeHierarchy;
+
+// Node index for every channel of the clip, -1 for channels animating a node
+// the hierarchy doesn't have
+std::vector<int32_t> bindClipToHierarchy(const AnimationClip& clip, const NodeHierarchy& hierarchy);
+
+// Overwrites the local transforms of the animated nodes with the sampled pose
+void applyPose(const Pose& pose, const std::vector<int32_t>& channelNodes, Affine* locals);
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace engine
+{
+
+// Unit quaternion packed into 48 bits with the "smallest three" scheme: the
+// component with the largest magnitude is dropped (and made positive by
+// flipping the sign of the whole quaternion), the other three lie within
+// +-1/sqrt(2) and are stored with 15 bits each. The two bits naming the
+// dropped component sit in the top bits of the first two words.
+struct QuantizedQuaternion
+{
+	uint16_t packed[3];
+};
+
+namespace quat_quantization
+{
+	constexpr float kRange = 0.70710678118f;  // 1 / sqrt(2)
+	constexpr float kScale = 32767.0f;
+	constexpr uint16_t kMask = 0x7fff;
+}
+
+// q is (x, y, z, w) and expected to be normalized
+inline QuantizedQuaternion quantizeQuaternion(const float q[4])
+{
+	using namespace quat_quantization;
+
+	unsigned int largest = 0;
+	for (unsigned int i = 1; i < 4; ++i)
+	{
+		if (std::fabs(q[i]) > std::fabs(q[largest]))
+		{
+			largest = i;
+		}
+	}
+	const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+	QuantizedQuaternion result;
+	unsigned int out = 0;
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+		float unit = (q[i] * sign / kRange) * 0.5f + 0.5f;
+		unit = unit < 0.0f ? 0.0f : (unit > 1.0f ? 1.0f : unit);
+		result.packed[out++] = static_cast<uint16_t>(unit * kScale + 0.5f);
+	}
+	result.packed[0] |= static_cast<uint16_t>((largest & 1u) << 15);
+	result.packed[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+	return result;
+}
+
+// Writes (x, y, z, w)
+inline void dequantizeQuaternion(const QuantizedQuaternion& packed, float q[4])
+{
+	using namespace quat_quantization;
+
+	const unsigned int largest = (packed.packed[0] >> 15) | ((packed.packed[1] >> 15) << 1);
+	float sumSquares = 0.0f;
+	unsigned int in = 0;
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		if (i == largest)
+		{
+			continue;
+		}
+		const float unit = static_cast<float>(packed.packed[in++] & kMask) / kScale;
+		q[i] = (unit * 2.0f - 1.0f) * kRange;
+		sumSquares += q[i] * q[i];
+	}
+	q[largest] = std::sqrt(sumSquares < 1.0f ? 1.0f - sumSquares : 0.0f);
+}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "assimp/matrix4x4.h"
+
+#include <cmath>
+
+namespace engine
+{
+
+// Row-major 3x4 affine transform, the implicit fourth row is (0, 0, 0, 1).
+// The layout matches the first three rows of aiMatrix4x4, so points are
+// transformed as column vectors: p' = m * p.
+struct Affine
+{
+	float m[3][4];
+};
+
+inline Affine affineIdentity()
+{
+	return Affine{ { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f } } };
+}
+
+inline Affine affineFromMatrix(const aiMatrix4x4& matrix)
+{
+	Affine result;
+	for (int row = 0; row < 3; ++row)
+	{
+		for (int column = 0; column < 4; ++column)
+		{
+			result.m[row][column] = static_cast<float>(matrix[row][column]);
+		}
+	}
+	return result;
+}
+
+// T * R * S with the rotation given as a unit quaternion (x, y, z, w)
+inline Affine affineFromTranslationRotationScale(float tx, float ty, float tz,
+	float qx, float qy, float qz, float qw, float sx, float sy, float sz)
+{
+	const float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+	const float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+	const float wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+	Affine result;
+	result.m[0][0] = (1.0f - 2.0f * (yy + zz)) * sx;
+	result.m[0][1] = 2.0f * (xy - wz) * sy;
+	result.m[0][2] = 2.0f * (xz + wy) * sz;
+	result.m[0][3] = tx;
+	result.m[1][0] = 2.0f * (xy + wz) * sx;
+	result.m[1][1] = (1.0f - 2.0f * (xx + zz)) * sy;
+	result.m[1][2] = 2.0f * (yz - wx) * sz;
+	result.m[1][3] = ty;
+	result.m[2][0] = 2.0f * (xz - wy) * sx;
+	result.m[2][1] = 2.0f * (yz + wx) * sy;
+	result.m[2][2] = (1.0f - 2.0f * (xx + yy)) * sz;
+	result.m[2][3] = tz;
+	return result;
+}
+
+inline Affine operator*(const Affine& a, const Affine& b)
+{
+	Affine result;
+	for (int row = 0; row < 3; ++row)
+	{
+		for (int column = 0; column < 4; ++column)
+		{
+			result.m[row][column] = a.m[row][0] * b.m[0][column] + a.m[row][1] * b.m[1][column] + a.m[row][2] * b.m[2][column];
+		}
+		result.m[row][3] += a.m[row][3];
+	}
+	return result;
+}
+
+inline Affine affineInverse(const Affine& a)
+{
+	const float (*m)[4] = a.m;
+	const float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	const float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	const float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+	const float determinant = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+	if (determinant == 0.0f)
+	{
+		return affineIdentity();
+	}
+	const float inv = 1.0f / determinant;
+
+	Affine result;
+	result.m[0][0] = c00 * inv;
+	result.m[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * inv;
+	result.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inv;
+	result.m[1][0] = c01 * inv;
+	result.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * inv;
+	result.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inv;
+	result.m[2][0] = c02 * inv;
+	result.m[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * inv;
+	result.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inv;
+	for (int row = 0; row < 3; ++row)
+	{
+		result.m[row][3] = -(result.m[row][0] * m[0][3] + result.m[row][1] * m[1][3] + result.m[row][2] * m[2][3]);
+	}
+	return result;
+}
+
+}
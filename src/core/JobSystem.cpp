@@ -0,0 +1,150 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace engine
+{
+
+namespace
+{
+	thread_local bool t_insideLoop = false;
+
+	// Marks the current thread as running loop bodies, also while unwinding
+	struct InsideLoopScope
+	{
+		InsideLoopScope() { t_insideLoop = true; }
+		~InsideLoopScope() { t_insideLoop = false; }
+	};
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+{
+	if (workerCount == 0)
+	{
+		const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	m_workers.reserve(workerCount);
+	for (unsigned int i = 0; i < workerCount; ++i)
+	{
+		m_workers.emplace_back(&JobSystem::workerMain, this);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const RangeFunction& body)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	grain = std::max<size_t>(grain, 1);
+
+	// not worth waking anybody, or we are already inside a loop body
+	if (m_workers.empty() || count <= grain || t_insideLoop)
+	{
+		for (size_t begin = 0; begin < count; begin += grain)
+		{
+			body(begin, std::min(begin + grain, count));
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> loopLock(m_loopMutex);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_body = &body;
+		m_count = count;
+		m_grain = grain;
+		m_next.store(0, std::memory_order_relaxed);
+		m_busy = static_cast<unsigned int>(m_workers.size());
+		m_error = nullptr;
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	runChunks();
+
+	// the body lives on our stack, wait until every worker has let go of it
+	std::exception_ptr error;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this] { return m_busy == 0; });
+		m_body = nullptr;
+		error = m_error;
+		m_error = nullptr;
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+void JobSystem::workerMain()
+{
+	unsigned long long seenGeneration = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [&] { return m_quit || m_generation != seenGeneration; });
+			if (m_quit)
+			{
+				return;
+			}
+			seenGeneration = m_generation;
+		}
+
+		runChunks();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (--m_busy == 0)
+		{
+			m_done.notify_one();
+		}
+	}
+}
+
+void JobSystem::runChunks()
+{
+	InsideLoopScope insideLoop;
+	for (;;)
+	{
+		const size_t begin = m_next.fetch_add(m_grain, std::memory_order_relaxed);
+		if (begin >= m_count)
+		{
+			break;
+		}
+		try
+		{
+			(*m_body)(begin, std::min(begin + m_grain, m_count));
+		}
+		catch (...)
+		{
+			// keep the first exception for the caller and hand out no further chunks
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_error)
+			{
+				m_error = std::current_exception();
+			}
+			m_next.store(m_count, std::memory_order_relaxed);
+			break;
+		}
+	}
+}
+
+}
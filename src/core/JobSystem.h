@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine
+{
+
+// Fixed pool of worker threads running data-parallel loops.
+// The calling thread takes part in every loop, so a pool without workers
+// simply runs everything inline. Loops started from inside a loop body run
+// inline on the thread that started them.
+class JobSystem
+{
+public:
+	using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+	// workerCount == 0 picks one worker less than the number of hardware threads
+	explicit JobSystem(unsigned int workerCount = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Number of threads a loop is spread over, the caller included
+	unsigned int getThreadCount() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+	// Calls body for consecutive ranges of at most grain items covering [0, count)
+	// and returns once all of them are done. Every range starts at a multiple of
+	// grain, so begin / grain identifies the chunk. If a range throws, the ranges
+	// not yet started are skipped and the first exception is rethrown here once
+	// every thread has left the body.
+	void parallelFor(size_t count, size_t grain, const RangeFunction& body);
+
+private:
+	void workerMain();
+	void runChunks();
+
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_loopMutex;  // one loop at a time
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+
+	const RangeFunction* m_body = nullptr;
+	size_t m_count = 0;
+	size_t m_grain = 1;
+	std::atomic<size_t> m_next{ 0 };
+	unsigned int m_busy = 0;
+	std::exception_ptr m_error;  // first exception thrown by the body
+	unsigned long long m_generation = 0;
+	bool m_quit = false;
+};
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Affine.h"
+
+#include <cmath>
+
+namespace engine
+{
+
+// Row-major 4x4 matrix for projections, same conventions as Affine:
+// column vectors, p' = m * p. Clip space follows OpenGL, -w <= z <= w.
+struct Matrix4
+{
+	float m[4][4];
+};
+
+inline Matrix4 matrixFromAffine(const Affine& a)
+{
+	Matrix4 result;
+	for (int row = 0; row < 3; ++row)
+	{
+		for (int column = 0; column < 4; ++column)
+		{
+			result.m[row][column] = a.m[row][column];
+		}
+	}
+	result.m[3][0] = result.m[3][1] = result.m[3][2] = 0.0f;
+	result.m[3][3] = 1.0f;
+	return result;
+}
+
+inline Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+{
+	Matrix4 result;
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int column = 0; column < 4; ++column)
+		{
+			result.m[row][column] = a.m[row][0] * b.m[0][column] + a.m[row][1] * b.m[1][column]
+				+ a.m[row][2] * b.m[2][column] + a.m[row][3] * b.m[3][column];
+		}
+	}
+	return result;
+}
+
+// Right-handed perspective projection looking down -z
+inline Matrix4 perspectiveMatrix(float verticalFov, float aspect, float nearPlane, float farPlane)
+{
+	const float f = 1.0f / std::tan(verticalFov * 0.5f);
+	Matrix4 result = {};
+	result.m[0][0] = f / aspect;
+	result.m[1][1] = f;
+	result.m[2][2] = (farPlane + nearPlane) / (nearPlane - farPlane);
+	result.m[2][3] = 2.0f * farPlane * nearPlane / (nearPlane - farPlane);
+	result.m[3][2] = -1.0f;
+	return result;
+}
+
+// View matrix of a camera at eye looking at target
+inline Matrix4 lookAtMatrix(const float eye[3], const float target[3], const float up[3])
+{
+	float forward[3] = { target[0] - eye[0], target[1] - eye[1], target[2] - eye[2] };
+	const float forwardLength = std::sqrt(forward[0] * forward[0] + forward[1] * forward[1] + forward[2] * forward[2]);
+	for (float& c : forward)
+	{
+		c /= forwardLength;
+	}
+	float side[3] = {
+		forward[1] * up[2] - forward[2] * up[1],
+		forward[2] * up[0] - forward[0] * up[2],
+		forward[0] * up[1] - forward[1] * up[0]
+	};
+	const float sideLength = std::sqrt(side[0] * side[0] + side[1] * side[1] + side[2] * side[2]);
+	for (float& c : side)
+	{
+		c /= sideLength;
+	}
+	const float realUp[3] = {
+		side[1] * forward[2] - side[2] * forward[1],
+		side[2] * forward[0] - side[0] * forward[2],
+		side[0] * forward[1] - side[1] * forward[0]
+	};
+
+	Matrix4 result = {};
+	for (int c = 0; c < 3; ++c)
+	{
+		result.m[0][c] = side[c];
+		result.m[1][c] = realUp[c];
+		result.m[2][c] = -forward[c];
+	}
+	result.m[0][3] = -(side[0] * eye[0] + side[1] * eye[1] + side[2] * eye[2]);
+	result.m[1][3] = -(realUp[0] * eye[0] + realUp[1] * eye[1] + realUp[2] * eye[2]);
+	result.m[2][3] = forward[0] * eye[0] + forward[1] * eye[1] + forward[2] * eye[2];
+	result.m[3][3] = 1.0f;
+	return result;
+}
+
+}
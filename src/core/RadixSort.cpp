@@ -0,0 +1,58 @@
+#include "RadixSort.h"
+
+#include <cassert>
+
+namespace engine
+{
+
+void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values,
+	std::vector<uint64_t>& scratchKeys, std::vector<uint32_t>& scratchValues)
+{
+	assert(keys.size() == values.size());
+	const size_t count = keys.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	// all eight histograms in one read of the keys
+	std::vector<size_t> histograms(8 * 256, 0);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const uint64_t key = keys[i];
+		for (unsigned int pass = 0; pass < 8; ++pass)
+		{
+			++histograms[pass * 256 + ((key >> (pass * 8)) & 0xff)];
+		}
+	}
+
+	scratchKeys.resize(count);
+	scratchValues.resize(count);
+	for (unsigned int pass = 0; pass < 8; ++pass)
+	{
+		size_t* histogram = &histograms[pass * 256];
+		const unsigned int shift = pass * 8;
+		if (histogram[(keys[0] >> shift) & 0xff] == count)
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (unsigned int bucket = 0; bucket < 256; ++bucket)
+		{
+			const size_t bucketSize = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketSize;
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			const size_t target = histogram[(keys[i] >> shift) & 0xff]++;
+			scratchKeys[target] = keys[i];
+			scratchValues[target] = values[i];
+		}
+		keys.swap(scratchKeys);
+		values.swap(scratchValues);
+	}
+}
+
+}
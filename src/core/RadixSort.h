@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+// Stable LSD radix sort of 64 bit keys carrying a 32 bit value, one byte per
+// pass. Bytes that are the same in every key are skipped, so keys using only
+// a few distinct high bits cost fewer than eight passes. The scratch vectors
+// are resized as needed and can be kept between calls.
+void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values,
+	std::vector<uint64_t>& scratchKeys, std::vector<uint32_t>& scratchValues);
+
+}
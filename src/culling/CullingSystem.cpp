@@ -0,0 +1,161 @@
+#include "CullingSystem.h"
+
+#include "Frustum.h"
+#include "InstanceBounds.h"
+#include "../core/JobSystem.h"
+#include "../scene/SceneGraph.h"
+
+#include "assimp/scene.h"
+
+#include <algorithm>
+
+namespace engine
+{
+
+namespace
+{
+	// Boxes per job system chunk
+	constexpr size_t kBoxesPerChunk = 16384;
+
+	void forRange(JobSystem* jobSystem, size_t count, size_t grain, const JobSystem::RangeFunction& body)
+	{
+		if (jobSystem != nullptr)
+		{
+			jobSystem->parallelFor(count, grain, body);
+		}
+		else if (count != 0)
+		{
+			body(0, count);
+		}
+	}
+}
+
+CullingSystem::CullingSystem(const CullingSettings& settings)
+	: m_settings(settings)
+	, m_rasterizer(settings.depthWidth, settings.depthHeight)
+{
+}
+
+void CullingSystem::cull(const InstanceBounds& bounds, const SceneGraph& graph, const aiScene& scene,
+	const Matrix4& viewProjection, DrawList& drawList, JobSystem* jobSystem)
+{
+	drawList.clear();
+	const size_t count = bounds.size();
+	drawList.stats.instances = count;
+
+	const Frustum frustum = frustumFromMatrix(viewProjection);
+	m_visible.resize(count);
+	forRange(jobSystem, count, kBoxesPerChunk, [&](size_t begin, size_t end)
+	{
+		testFrustum(frustum, bounds, begin, end, m_visible.data() + begin);
+	});
+
+	m_candidates.clear();
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (m_visible[i] != 0)
+		{
+			m_candidates.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	drawList.stats.frustumVisible = m_candidates.size();
+
+	m_rasterizer.begin(viewProjection);
+	if (m_settings.occlusionCulling && !m_candidates.empty())
+	{
+		renderOccluders(bounds, graph, scene, drawList, jobSystem);
+
+		// nothing drawn, nothing hidden
+		if (drawList.stats.occluders != 0)
+		{
+			forRange(jobSystem, m_candidates.size(), kBoxesPerChunk / 4, [&](size_t begin, size_t end)
+			{
+				for (size_t c = begin; c < end; ++c)
+				{
+					const ScreenRect& rect = m_rects[c];
+					const bool projected = rect.minX <= rect.maxX;
+					m_visible[m_candidates[c]] = !projected || m_rasterizer.isRectVisible(rect) ? 1 : 0;
+				}
+			});
+		}
+	}
+
+	const float (*m)[4] = viewProjection.m;
+	for (uint32_t i : m_candidates)
+	{
+		if (m_visible[i] == 0)
+		{
+			continue;
+		}
+		const float x = (bounds.minX[i] + bounds.maxX[i]) * 0.5f;
+		const float y = (bounds.minY[i] + bounds.maxY[i]) * 0.5f;
+		const float z = (bounds.minZ[i] + bounds.maxZ[i]) * 0.5f;
+
+		DrawItem item;
+		item.node = bounds.nodes[i];
+		item.mesh = bounds.meshes[i];
+		item.material = item.mesh < scene.mNumMeshes ? scene.mMeshes[item.mesh]->mMaterialIndex : 0;
+		item.depth = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3];
+		drawList.items.push_back(item);
+	}
+	drawList.stats.visible = drawList.items.size();
+}
+
+void CullingSystem::renderOccluders(const InstanceBounds& bounds, const SceneGraph& graph, const aiScene& scene,
+	DrawList& drawList, JobSystem* jobSystem)
+{
+	const float screenPixels = static_cast<float>(m_rasterizer.getWidth()) * m_rasterizer.getHeight();
+
+	// screen coverage of every candidate's box, zero for boxes crossing the near
+	// plane; the rectangles are kept for the occlusion test
+	m_rects.resize(m_candidates.size());
+	m_screenArea.resize(m_candidates.size());
+	forRange(jobSystem, m_candidates.size(), kBoxesPerChunk / 8, [&](size_t begin, size_t end)
+	{
+		for (size_t c = begin; c < end; ++c)
+		{
+			const uint32_t i = m_candidates[c];
+			const float boxMin[3] = { bounds.minX[i], bounds.minY[i], bounds.minZ[i] };
+			const float boxMax[3] = { bounds.maxX[i], bounds.maxY[i], bounds.maxZ[i] };
+			ScreenRect& rect = m_rects[c];
+			if (m_rasterizer.projectBox(boxMin, boxMax, rect))
+			{
+				m_screenArea[c] = float(rect.maxX - rect.minX + 1) * float(rect.maxY - rect.minY + 1) / screenPixels;
+			}
+			else
+			{
+				rect.minX = 1;
+				rect.maxX = 0;
+				m_screenArea[c] = 0.0f;
+			}
+		}
+	});
+
+	std::vector<uint32_t> occluders;
+	for (uint32_t c = 0; c < m_candidates.size(); ++c)
+	{
+		if (m_screenArea[c] >= m_settings.minOccluderScreenArea && m_screenArea[c] > 0.0f)
+		{
+			occluders.push_back(c);
+		}
+	}
+	auto larger = [this](uint32_t a, uint32_t b) { return m_screenArea[a] > m_screenArea[b]; };
+	if (occluders.size() > m_settings.maxOccluders)
+	{
+		std::nth_element(occluders.begin(), occluders.begin() + m_settings.maxOccluders, occluders.end(), larger);
+		occluders.resize(m_settings.maxOccluders);
+	}
+
+	for (uint32_t c : occluders)
+	{
+		const uint32_t i = m_candidates[c];
+		if (bounds.meshes[i] < scene.mNumMeshes)
+		{
+			m_rasterizer.addOccluder(*scene.mMeshes[bounds.meshes[i]], graph.getWorldTransform(bounds.nodes[i]));
+		}
+	}
+	drawList.stats.occluders = occluders.size();
+	m_rasterizer.rasterize(jobSystem);
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "DepthRasterizer.h"
+#include "DrawList.h"
+
+#include <cstdint>
+#include <vector>
+
+struct aiScene;
+
+namespace engine
+{
+
+class JobSystem;
+class SceneGraph;
+struct InstanceBounds;
+
+struct CullingSettings
+{
+	bool occlusionCulling = true;
+
+	// Resolution of the software depth buffer
+	uint32_t depthWidth = 256;
+	uint32_t depthHeight = 128;
+
+	// Occluders are the largest frustum-visible instances on screen, at most
+	// maxOccluders of them covering at least this fraction of the screen each
+	uint32_t maxOccluders = 32;
+	float minOccluderScreenArea = 0.01f;
+};
+
+// Turns instance bounds into a draw list: a frustum test over all boxes,
+// then, optionally, an occlusion test of the survivors against a depth buffer
+// rasterized from the biggest of them. Both tests are conservative, an
+// instance is only dropped if it can't contribute a pixel.
+class CullingSystem
+{
+public:
+	explicit CullingSystem(const CullingSettings& settings = CullingSettings());
+
+	// bounds come from gatherInstanceBounds() for the same graph and scene
+	void cull(const InstanceBounds& bounds, const SceneGraph& graph, const aiScene& scene,
+		const Matrix4& viewProjection, DrawList& drawList, JobSystem* jobSystem = nullptr);
+
+	const DepthRasterizer& getDepthRasterizer() const { return m_rasterizer; }
+
+private:
+	void renderOccluders(const InstanceBounds& bounds, const SceneGraph& graph, const aiScene& scene,
+		DrawList& drawList, JobSystem* jobSystem);
+
+	CullingSettings m_settings;
+	DepthRasterizer m_rasterizer;
+	std::vector<uint8_t> m_visible;
+	std::vector<uint32_t> m_candidates;
+	std::vector<ScreenRect> m_rects;  // per candidate, empty if not projectable
+	std::vector<float> m_screenArea;
+};
+
+}
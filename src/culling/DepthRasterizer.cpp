@@ -0,0 +1,299 @@
+#include "DepthRasterizer.h"
+
+#include "../core/JobSystem.h"
+
+#include "assimp/mesh.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace engine
+{
+
+namespace
+{
+	constexpr uint32_t kTileSize = 32;
+
+	// Closer than this (in clip w) counts as crossing the near plane
+	constexpr float kMinClipW = 1e-5f;
+
+	// Slack for the depth comparison, keeps occluders from hiding their own box
+	constexpr float kDepthBias = 1e-5f;
+
+	struct ClipPoint
+	{
+		float x, y, z, w;
+	};
+
+	ClipPoint toClip(const Matrix4& m, float x, float y, float z)
+	{
+		return {
+			m.m[0][0] * x + m.m[0][1] * y + m.m[0][2] * z + m.m[0][3],
+			m.m[1][0] * x + m.m[1][1] * y + m.m[1][2] * z + m.m[1][3],
+			m.m[2][0] * x + m.m[2][1] * y + m.m[2][2] * z + m.m[2][3],
+			m.m[3][0] * x + m.m[3][1] * y + m.m[3][2] * z + m.m[3][3]
+		};
+	}
+}
+
+DepthRasterizer::DepthRasterizer(uint32_t width, uint32_t height)
+	: m_width(std::max(width, 1u))
+	, m_height(std::max(height, 1u))
+	, m_tilesX((m_width + kTileSize - 1) / kTileSize)
+	, m_tilesY((m_height + kTileSize - 1) / kTileSize)
+{
+	m_depth.assign(size_t(m_width) * m_height, 1.0f);
+	m_tileFarthest.assign(size_t(m_tilesX) * m_tilesY, 1.0f);
+	m_tileTriangles.resize(size_t(m_tilesX) * m_tilesY);
+}
+
+void DepthRasterizer::begin(const Matrix4& viewProjection)
+{
+	m_viewProjection = viewProjection;
+	std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+	std::fill(m_tileFarthest.begin(), m_tileFarthest.end(), 1.0f);
+	m_triangles.clear();
+	for (std::vector<uint32_t>& bin : m_tileTriangles)
+	{
+		bin.clear();
+	}
+}
+
+void DepthRasterizer::addOccluder(const aiMesh& mesh, const Affine& world)
+{
+	const Matrix4 transform = m_viewProjection * matrixFromAffine(world);
+
+	std::vector<ClipPoint> clip(mesh.mNumVertices);
+	for (unsigned int v = 0; v < mesh.mNumVertices; ++v)
+	{
+		clip[v] = toClip(transform, mesh.mVertices[v].x, mesh.mVertices[v].y, mesh.mVertices[v].z);
+	}
+
+	for (unsigned int f = 0; f < mesh.mNumFaces; ++f)
+	{
+		const aiFace& face = mesh.mFaces[f];
+		if (face.mNumIndices != 3)
+		{
+			continue;
+		}
+
+		ScreenTriangle triangle;
+		bool inFront = true;
+		for (int corner = 0; corner < 3 && inFront; ++corner)
+		{
+			const ClipPoint& p = clip[face.mIndices[corner]];
+			inFront = p.w > kMinClipW;
+			triangle.x[corner] = (p.x / p.w * 0.5f + 0.5f) * m_width;
+			triangle.y[corner] = (p.y / p.w * 0.5f + 0.5f) * m_height;
+			triangle.z[corner] = p.z / p.w * 0.5f + 0.5f;
+		}
+		if (!inFront)
+		{
+			continue;
+		}
+
+		const float minX = std::min({ triangle.x[0], triangle.x[1], triangle.x[2] });
+		const float maxX = std::max({ triangle.x[0], triangle.x[1], triangle.x[2] });
+		const float minY = std::min({ triangle.y[0], triangle.y[1], triangle.y[2] });
+		const float maxY = std::max({ triangle.y[0], triangle.y[1], triangle.y[2] });
+		if (maxX < 0.0f || maxY < 0.0f || minX >= m_width || minY >= m_height)
+		{
+			continue;
+		}
+
+		const uint32_t index = static_cast<uint32_t>(m_triangles.size());
+		m_triangles.push_back(triangle);
+
+		const uint32_t tileX0 = static_cast<uint32_t>(std::max(minX, 0.0f)) / kTileSize;
+		const uint32_t tileY0 = static_cast<uint32_t>(std::max(minY, 0.0f)) / kTileSize;
+		const uint32_t tileX1 = std::min(static_cast<uint32_t>(maxX) / kTileSize, m_tilesX - 1);
+		const uint32_t tileY1 = std::min(static_cast<uint32_t>(maxY) / kTileSize, m_tilesY - 1);
+		for (uint32_t ty = tileY0; ty <= tileY1; ++ty)
+		{
+			for (uint32_t tx = tileX0; tx <= tileX1; ++tx)
+			{
+				m_tileTriangles[ty * m_tilesX + tx].push_back(index);
+			}
+		}
+	}
+}
+
+void DepthRasterizer::rasterize(JobSystem* jobSystem)
+{
+	const size_t tileCount = m_tileTriangles.size();
+	if (jobSystem != nullptr)
+	{
+		jobSystem->parallelFor(tileCount, 1, [this](size_t begin, size_t end)
+		{
+			for (size_t tile = begin; tile < end; ++tile)
+			{
+				rasterizeTile(static_cast<uint32_t>(tile));
+			}
+		});
+	}
+	else
+	{
+		for (size_t tile = 0; tile < tileCount; ++tile)
+		{
+			rasterizeTile(static_cast<uint32_t>(tile));
+		}
+	}
+}
+
+void DepthRasterizer::rasterizeTile(uint32_t tile)
+{
+	const int32_t tileMinX = static_cast<int32_t>((tile % m_tilesX) * kTileSize);
+	const int32_t tileMinY = static_cast<int32_t>((tile / m_tilesX) * kTileSize);
+	const int32_t tileMaxX = std::min(tileMinX + static_cast<int32_t>(kTileSize), static_cast<int32_t>(m_width)) - 1;
+	const int32_t tileMaxY = std::min(tileMinY + static_cast<int32_t>(kTileSize), static_cast<int32_t>(m_height)) - 1;
+
+	for (uint32_t index : m_tileTriangles[tile])
+	{
+		const ScreenTriangle& t = m_triangles[index];
+		const float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+		if (area == 0.0f)
+		{
+			continue;
+		}
+		// both windings are accepted, occluders aren't backface culled
+		const float sign = area > 0.0f ? 1.0f : -1.0f;
+		const float invArea = 1.0f / std::fabs(area);
+
+		const int32_t minX = std::max(tileMinX, static_cast<int32_t>(std::floor(std::min({ t.x[0], t.x[1], t.x[2] }))));
+		const int32_t maxX = std::min(tileMaxX, static_cast<int32_t>(std::ceil(std::max({ t.x[0], t.x[1], t.x[2] }))));
+		const int32_t minY = std::max(tileMinY, static_cast<int32_t>(std::floor(std::min({ t.y[0], t.y[1], t.y[2] }))));
+		const int32_t maxY = std::min(tileMaxY, static_cast<int32_t>(std::ceil(std::max({ t.y[0], t.y[1], t.y[2] }))));
+
+		for (int32_t y = minY; y <= maxY; ++y)
+		{
+			const float py = y + 0.5f;
+			float* row = m_depth.data() + size_t(y) * m_width;
+			for (int32_t x = minX; x <= maxX; ++x)
+			{
+				const float px = x + 0.5f;
+				const float w0 = sign * ((t.x[2] - t.x[1]) * (py - t.y[1]) - (t.y[2] - t.y[1]) * (px - t.x[1]));
+				const float w1 = sign * ((t.x[0] - t.x[2]) * (py - t.y[2]) - (t.y[0] - t.y[2]) * (px - t.x[2]));
+				const float w2 = sign * ((t.x[1] - t.x[0]) * (py - t.y[0]) - (t.y[1] - t.y[0]) * (px - t.x[0]));
+				if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+				{
+					continue;
+				}
+				const float z = (w0 * t.z[0] + w1 * t.z[1] + w2 * t.z[2]) * invArea;
+				row[x] = std::min(row[x], z);
+			}
+		}
+	}
+
+	float farthest = 0.0f;
+	for (int32_t y = tileMinY; y <= tileMaxY; ++y)
+	{
+		const float* row = m_depth.data() + size_t(y) * m_width;
+		for (int32_t x = tileMinX; x <= tileMaxX; ++x)
+		{
+			farthest = std::max(farthest, row[x]);
+		}
+	}
+	m_tileFarthest[tile] = farthest;
+}
+
+bool DepthRasterizer::projectBox(const float boxMin[3], const float boxMax[3], ScreenRect& rect) const
+{
+	// the corners are the min corner plus any sum of the three edge vectors,
+	// which the projection maps linearly
+	const float (*m)[4] = m_viewProjection.m;
+	const ClipPoint base = toClip(m_viewProjection, boxMin[0], boxMin[1], boxMin[2]);
+	const float size[3] = { boxMax[0] - boxMin[0], boxMax[1] - boxMin[1], boxMax[2] - boxMin[2] };
+	ClipPoint edges[3];
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		edges[axis] = { m[0][axis] * size[axis], m[1][axis] * size[axis], m[2][axis] * size[axis], m[3][axis] * size[axis] };
+	}
+
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	float nearest = 1.0f;
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		ClipPoint p = base;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			if (corner & (1 << axis))
+			{
+				p.x += edges[axis].x;
+				p.y += edges[axis].y;
+				p.z += edges[axis].z;
+				p.w += edges[axis].w;
+			}
+		}
+		if (p.w <= kMinClipW)
+		{
+			return false;
+		}
+		const float invW = 1.0f / p.w;
+		const float x = (p.x * invW * 0.5f + 0.5f) * m_width;
+		const float y = (p.y * invW * 0.5f + 0.5f) * m_height;
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		nearest = std::min(nearest, p.z * invW * 0.5f + 0.5f);
+	}
+
+	// every pixel the box touches, not only those whose center it covers
+	rect.minX = std::max(static_cast<int32_t>(std::floor(minX)), 0);
+	rect.minY = std::max(static_cast<int32_t>(std::floor(minY)), 0);
+	rect.maxX = std::min(static_cast<int32_t>(std::floor(maxX)), static_cast<int32_t>(m_width) - 1);
+	rect.maxY = std::min(static_cast<int32_t>(std::floor(maxY)), static_cast<int32_t>(m_height) - 1);
+	rect.nearestDepth = std::max(nearest, 0.0f);
+	return rect.minX <= rect.maxX && rect.minY <= rect.maxY;
+}
+
+bool DepthRasterizer::isBoxVisible(const float boxMin[3], const float boxMax[3]) const
+{
+	ScreenRect rect;
+	if (!projectBox(boxMin, boxMax, rect))
+	{
+		// crossing the near plane can't be decided here, off screen is the frustum test's job
+		return true;
+	}
+	return isRectVisible(rect);
+}
+
+bool DepthRasterizer::isRectVisible(const ScreenRect& rect) const
+{
+	const float depth = rect.nearestDepth - kDepthBias;
+
+	const uint32_t tileX0 = static_cast<uint32_t>(rect.minX) / kTileSize;
+	const uint32_t tileX1 = static_cast<uint32_t>(rect.maxX) / kTileSize;
+	const uint32_t tileY0 = static_cast<uint32_t>(rect.minY) / kTileSize;
+	const uint32_t tileY1 = static_cast<uint32_t>(rect.maxY) / kTileSize;
+	for (uint32_t ty = tileY0; ty <= tileY1; ++ty)
+	{
+		for (uint32_t tx = tileX0; tx <= tileX1; ++tx)
+		{
+			if (m_tileFarthest[ty * m_tilesX + tx] < depth)
+			{
+				continue;
+			}
+
+			const int32_t x0 = std::max(rect.minX, static_cast<int32_t>(tx * kTileSize));
+			const int32_t x1 = std::min(rect.maxX, static_cast<int32_t>((tx + 1) * kTileSize) - 1);
+			const int32_t y0 = std::max(rect.minY, static_cast<int32_t>(ty * kTileSize));
+			const int32_t y1 = std::min(rect.maxY, static_cast<int32_t>((ty + 1) * kTileSize) - 1);
+			for (int32_t y = y0; y <= y1; ++y)
+			{
+				const float* row = m_depth.data() + size_t(y) * m_width;
+				for (int32_t x = x0; x <= x1; ++x)
+				{
+					if (row[x] >= depth)
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+	return false;
+}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../core/Matrix4.h"
+
+#include <cstdint>
+#include <vector>
+
+struct aiMesh;
+
+namespace engine
+{
+
+class JobSystem;
+
+// Screen rectangle in pixels, inclusive, plus the nearest depth of what was projected
+struct ScreenRect
+{
+	int32_t minX, minY, maxX, maxY;
+	float nearestDepth;
+};
+
+// Low resolution software depth buffer for occlusion culling. Occluder triangles
+// are transformed and binned into 32x32 pixel tiles, the tiles are then
+// rasterized independently (in parallel with a job system). Queries test the
+// screen rectangle of a box against the rasterized depth, skipping tiles whose
+// farthest depth is already in front of the box.
+// Depth is clip z / w mapped to [0, 1], smaller is nearer.
+class DepthRasterizer
+{
+public:
+	explicit DepthRasterizer(uint32_t width = 256, uint32_t height = 128);
+
+	uint32_t getWidth() const { return m_width; }
+	uint32_t getHeight() const { return m_height; }
+	const float* getDepth() const { return m_depth.data(); }
+	size_t getTriangleCount() const { return m_triangles.size(); }
+
+	// Clears the buffer and the occluders, all following calls use this camera
+	void begin(const Matrix4& viewProjection);
+
+	// Triangles crossing the near plane are dropped, which only makes the
+	// buffer less occluding
+	void addOccluder(const aiMesh& mesh, const Affine& world);
+
+	void rasterize(JobSystem* jobSystem = nullptr);
+
+	// Projects a world box, false if it crosses the near plane or is off screen
+	bool projectBox(const float boxMin[3], const float boxMax[3], ScreenRect& rect) const;
+
+	// False only if every pixel the box may cover is hidden behind occluders
+	bool isBoxVisible(const float boxMin[3], const float boxMax[3]) const;
+
+	// Same test for a rectangle projectBox() already returned
+	bool isRectVisible(const ScreenRect& rect) const;
+
+private:
+	struct ScreenTriangle
+	{
+		float x[3], y[3], z[3];
+	};
+
+	void rasterizeTile(uint32_t tile);
+
+	uint32_t m_width;
+	uint32_t m_height;
+	uint32_t m_tilesX;
+	uint32_t m_tilesY;
+	Matrix4 m_viewProjection = {};
+
+	std::vector<float> m_depth;
+	std::vector<float> m_tileFarthest;
+	std::vector<ScreenTriangle> m_triangles;
+	std::vector<std::vector<uint32_t>> m_tileTriangles;
+};
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+// One mesh instance to draw
+struct DrawItem
+{
+	uint32_t node;
+	uint32_t mesh;      // aiScene::mMeshes index
+	uint32_t material;  // aiScene::mMaterials index
+	float depth;        // view depth of the bounds center, for sorting
+};
+
+struct CullingStats
+{
+	size_t instances = 0;
+	size_t frustumVisible = 0;
+	size_t occluders = 0;
+	size_t visible = 0;
+};
+
+// Output of the culling stage, in instance order
+struct DrawList
+{
+	std::vector<DrawItem> items;
+	CullingStats stats;
+
+	void clear()
+	{
+		items.clear();
+		stats = CullingStats();
+	}
+};
+
+}
@@ -0,0 +1,57 @@
+#include "Frustum.h"
+
+#include "InstanceBounds.h"
+
+#include <cmath>
+
+namespace engine
+{
+
+Frustum frustumFromMatrix(const Matrix4& viewProjection)
+{
+	const float (*m)[4] = viewProjection.m;
+	Frustum frustum;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			frustum.planes[axis * 2][c] = m[3][c] + m[axis][c];
+			frustum.planes[axis * 2 + 1][c] = m[3][c] - m[axis][c];
+		}
+	}
+	for (float (&plane)[4] : frustum.planes)
+	{
+		const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+		if (length > 0.0f)
+		{
+			for (float& c : plane)
+			{
+				c /= length;
+			}
+		}
+	}
+	return frustum;
+}
+
+void testFrustum(const Frustum& frustum, const InstanceBounds& bounds, size_t begin, size_t end, uint8_t* visible)
+{
+	const size_t count = end - begin;
+	for (size_t i = 0; i < count; ++i)
+	{
+		visible[i] = 1;
+	}
+
+	for (const float (&plane)[4] : frustum.planes)
+	{
+		const float* x = (plane[0] >= 0.0f ? bounds.maxX.data() : bounds.minX.data()) + begin;
+		const float* y = (plane[1] >= 0.0f ? bounds.maxY.data() : bounds.minY.data()) + begin;
+		const float* z = (plane[2] >= 0.0f ? bounds.maxZ.data() : bounds.minZ.data()) + begin;
+		const float a = plane[0], b = plane[1], c = plane[2], d = plane[3];
+		for (size_t i = 0; i < count; ++i)
+		{
+			visible[i] &= static_cast<uint8_t>(a * x[i] + b * y[i] + c * z[i] + d >= 0.0f);
+		}
+	}
+}
+
+}
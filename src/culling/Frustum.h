@@ -0,0 +1,28 @@
+#pragma once
+
+#include "../core/Matrix4.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace engine
+{
+
+struct InstanceBounds;
+
+// Six normalized planes (a, b, c, d), a point is inside when a*x + b*y + c*z + d >= 0
+struct Frustum
+{
+	float planes[6][4];
+};
+
+// Planes of the clip volume of a view-projection matrix (Gribb/Hartmann)
+Frustum frustumFromMatrix(const Matrix4& viewProjection);
+
+// visible[i - begin] = 1 for the boxes in [begin, end) intersecting the frustum, 0 otherwise.
+// Per plane only the box corner furthest along the plane normal is tested, and
+// as the normal is the same for every box the corner selection is hoisted out of
+// the loop, leaving branch-free arithmetic over the bound streams.
+void testFrustum(const Frustum& frustum, const InstanceBounds& bounds, size_t begin, size_t end, uint8_t* visible);
+
+}
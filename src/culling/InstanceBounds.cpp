@@ -0,0 +1,115 @@
+#include "InstanceBounds.h"
+
+#include "../scene/SceneGraph.h"
+
+#include "assimp/scene.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine
+{
+
+void InstanceBounds::clear()
+{
+	for (std::vector<float>* stream : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+	{
+		stream->clear();
+	}
+	nodes.clear();
+	meshes.clear();
+}
+
+void InstanceBounds::reserve(size_t count)
+{
+	for (std::vector<float>* stream : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+	{
+		stream->reserve(count);
+	}
+	nodes.reserve(count);
+	meshes.reserve(count);
+}
+
+void InstanceBounds::add(uint32_t node, uint32_t mesh, const float boxMin[3], const float boxMax[3])
+{
+	minX.push_back(boxMin[0]);
+	minY.push_back(boxMin[1]);
+	minZ.push_back(boxMin[2]);
+	maxX.push_back(boxMax[0]);
+	maxY.push_back(boxMax[1]);
+	maxZ.push_back(boxMax[2]);
+	nodes.push_back(node);
+	meshes.push_back(mesh);
+}
+
+void computeMeshBounds(const aiMesh& mesh, float boxMin[3], float boxMax[3])
+{
+	const aiAABB& box = mesh.mAABB;
+	const bool empty = box.mMin == box.mMax && box.mMin == aiVector3D();
+	if (!empty || mesh.mNumVertices == 0)
+	{
+		boxMin[0] = box.mMin.x;
+		boxMin[1] = box.mMin.y;
+		boxMin[2] = box.mMin.z;
+		boxMax[0] = box.mMax.x;
+		boxMax[1] = box.mMax.y;
+		boxMax[2] = box.mMax.z;
+		return;
+	}
+
+	for (int c = 0; c < 3; ++c)
+	{
+		boxMin[c] = mesh.mVertices[0][c];
+		boxMax[c] = mesh.mVertices[0][c];
+	}
+	for (unsigned int v = 1; v < mesh.mNumVertices; ++v)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			boxMin[c] = std::min(boxMin[c], static_cast<float>(mesh.mVertices[v][c]));
+			boxMax[c] = std::max(boxMax[c], static_cast<float>(mesh.mVertices[v][c]));
+		}
+	}
+}
+
+void gatherInstanceBounds(const SceneGraph& graph, const aiScene& scene, InstanceBounds& bounds)
+{
+	bounds.clear();
+
+	// local boxes once per mesh, instanced meshes are referenced many times
+	std::vector<float> local(size_t(scene.mNumMeshes) * 6);
+	for (unsigned int m = 0; m < scene.mNumMeshes; ++m)
+	{
+		computeMeshBounds(*scene.mMeshes[m], &local[m * 6], &local[m * 6 + 3]);
+	}
+
+	for (uint32_t node = 0; node < graph.getNodeCount(); ++node)
+	{
+		const Affine& world = graph.getWorldTransform(node);
+		const uint32_t* meshes = graph.getMeshes(node);
+		for (uint32_t i = 0; i < graph.getMeshCount(node); ++i)
+		{
+			if (meshes[i] >= scene.mNumMeshes)
+			{
+				continue;
+			}
+
+			// transform center and half extent, the extent by the absolute matrix
+			const float* box = &local[meshes[i] * 6];
+			const float center[3] = { (box[0] + box[3]) * 0.5f, (box[1] + box[4]) * 0.5f, (box[2] + box[5]) * 0.5f };
+			const float extent[3] = { (box[3] - box[0]) * 0.5f, (box[4] - box[1]) * 0.5f, (box[5] - box[2]) * 0.5f };
+			float boxMin[3], boxMax[3];
+			for (int row = 0; row < 3; ++row)
+			{
+				const float* m = world.m[row];
+				const float c = m[0] * center[0] + m[1] * center[1] + m[2] * center[2] + m[3];
+				const float e = std::fabs(m[0]) * extent[0] + std::fabs(m[1]) * extent[1] + std::fabs(m[2]) * extent[2];
+				boxMin[row] = c - e;
+				boxMax[row] = c + e;
+			}
+			bounds.add(node, meshes[i], boxMin, boxMax);
+		}
+	}
+}
+
+}
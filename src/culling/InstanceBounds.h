@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct aiMesh;
+struct aiScene;
+
+namespace engine
+{
+
+class SceneGraph;
+
+// World space bounding boxes of all mesh instances (one per mesh reference of a
+// node), one array per box component so the culling loops stream through them.
+struct InstanceBounds
+{
+	std::vector<float> minX, minY, minZ;
+	std::vector<float> maxX, maxY, maxZ;
+	std::vector<uint32_t> nodes;
+	std::vector<uint32_t> meshes;
+
+	size_t size() const { return nodes.size(); }
+	void clear();
+	void reserve(size_t count);
+	void add(uint32_t node, uint32_t mesh, const float boxMin[3], const float boxMax[3]);
+};
+
+// Local bounds of a mesh: aiMesh::mAABB as filled by aiProcess_GenBoundingBoxes,
+// or computed from the vertices if the importer left it empty
+void computeMeshBounds(const aiMesh& mesh, float boxMin[3], float boxMax[3]);
+
+// Replaces bounds by the world boxes of all instances in the graph, whose world
+// transforms have to be up to date
+void gatherInstanceBounds(const SceneGraph& graph, const aiScene& scene, InstanceBounds& bounds);
+
+}
@@ -1,9 +1,47 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <string>
 
 #include "GLFW/glfw3.h"
+#include "assimp/Importer.hpp"
+#include "assimp/postprocess.h"
 #include "assimp/scene.h"
 
-int main()
+#include "core/JobSystem.h"
+#include "culling/CullingSystem.h"
+#include "culling/InstanceBounds.h"
+#include "render/Batching.h"
+#include "render/Renderer.h"
+#include "scene/SceneGraph.h"
+
+namespace
+{
+	// Camera looking down -z at the whole scene
+	engine::Matrix4 fitCamera(const engine::InstanceBounds& bounds, float aspect)
+	{
+		float boxMin[3] = { -1.0f, -1.0f, -1.0f };
+		float boxMax[3] = { 1.0f, 1.0f, 1.0f };
+		if (bounds.size() != 0)
+		{
+			boxMin[0] = *std::min_element(bounds.minX.begin(), bounds.minX.end());
+			boxMin[1] = *std::min_element(bounds.minY.begin(), bounds.minY.end());
+			boxMin[2] = *std::min_element(bounds.minZ.begin(), bounds.minZ.end());
+			boxMax[0] = *std::max_element(bounds.maxX.begin(), bounds.maxX.end());
+			boxMax[1] = *std::max_element(bounds.maxY.begin(), bounds.maxY.end());
+			boxMax[2] = *std::max_element(bounds.maxZ.begin(), bounds.maxZ.end());
+		}
+		const float center[3] = { (boxMin[0] + boxMax[0]) * 0.5f, (boxMin[1] + boxMax[1]) * 0.5f, (boxMin[2] + boxMax[2]) * 0.5f };
+		const float radius = std::max(0.5f * std::sqrt((boxMax[0] - boxMin[0]) * (boxMax[0] - boxMin[0])
+			+ (boxMax[1] - boxMin[1]) * (boxMax[1] - boxMin[1]) + (boxMax[2] - boxMin[2]) * (boxMax[2] - boxMin[2])), 1e-3f);
+
+		const float eye[3] = { center[0], center[1], center[2] + radius * 2.5f };
+		const float up[3] = { 0.0f, 1.0f, 0.0f };
+		return engine::perspectiveMatrix(1.0f, aspect, radius * 0.01f, radius * 10.0f) * engine::lookAtMatrix(eye, center, up);
+	}
+}
+
+int main(int argc, char** argv)
 {
     // glfw window
 	glfwInit();
@@ -21,8 +59,73 @@ int main()
 	}
 	glfwMakeContextCurrent(window);
 
+	// optional model given on the command line
+	Assimp::Importer importer;
+	const aiScene* scene = nullptr;
+	if (argc > 1)
+	{
+		scene = importer.ReadFile(argv[1], aiProcess_Triangulate | aiProcess_GenBoundingBoxes
+			| aiProcess_FindInstances | aiProcess_OptimizeMeshes);
+		if (scene == nullptr)
+		{
+			std::cout << "Failed to load " << argv[1] << ": " << importer.GetErrorString() << std::endl;
+		}
+	}
+
+	engine::JobSystem jobSystem;
+	engine::RecordingBackend backend;
+	engine::Renderer renderer(backend);
+	engine::SceneGraph graph;
+	engine::InstanceBounds bounds;
+	engine::CullingSystem culling;
+	engine::DrawList drawList;
+	engine::Matrix4 viewProjection = engine::perspectiveMatrix(1.0f, 800.0f / 600.0f, 0.1f, 100.0f);
+	if (scene != nullptr)
+	{
+		graph = engine::SceneGraph(*scene);
+		graph.updateWorldTransforms(&jobSystem);
+		engine::gatherInstanceBounds(graph, *scene, bounds);
+		viewProjection = fitCamera(bounds, 800.0f / 600.0f);
+
+		engine::BatchList batches;
+		engine::buildBatches(*scene, graph, engine::BatchSettings(), batches);
+		const engine::BatchReport& report = batches.report;
+		std::cout << "Batching: " << report.sourceDrawCalls << " draws -> " << report.batchedDrawCalls
+			<< " (" << report.instancedMeshes << " instanced meshes over " << report.instancedNodes << " nodes, "
+			<< report.mergedMeshes << " meshes merged)" << std::endl;
+
+		std::vector<engine::RenderLayer> layers(scene->mNumMaterials, engine::RenderLayer::Opaque);
+		for (unsigned int i = 0; i < scene->mNumMaterials; ++i)
+		{
+			aiPbrParameters parameters;
+			if (scene->mMaterials[i]->GetPbrParameters(parameters) == aiReturn_SUCCESS && parameters.mOpacity < 1.0f)
+			{
+				layers[i] = engine::RenderLayer::Translucent;
+			}
+		}
+		renderer.setMaterialLayers(std::move(layers));
+	}
+
 	while(!glfwWindowShouldClose(window))
 	{
+		engine::FrameInfo frame;
+		frame.viewProjection = viewProjection;
+		frame.transforms = graph.getWorldTransforms();
+		frame.transformCount = graph.getNodeCount();
+		renderer.beginFrame(frame);
+
+		if (scene != nullptr)
+		{
+			culling.cull(bounds, graph, *scene, viewProjection, drawList, &jobSystem);
+			renderer.recordDrawList(drawList, &jobSystem);
+		}
+		renderer.submit(&jobSystem);
+
+		const engine::FrameStats& stats = backend.getFrameStats();
+		const std::string title = "LearnOpenGL - " + std::to_string(stats.drawCalls) + " draws, "
+			+ std::to_string(stats.materialChanges) + " material / " + std::to_string(stats.meshChanges) + " mesh changes";
+		glfwSetWindowTitle(window, title.c_str());
+
 		glfwSwapBuffers(window);
 		glfwPollEvents();
 	}
@@ -30,4 +133,4 @@ int main()
 	glfwTerminate();
 
     return 0;
-}
\ No newline at end of file
+}
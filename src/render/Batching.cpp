@@ -0,0 +1,225 @@
+#include "Batching.h"
+
+#include "../core/Affine.h"
+#include "../scene/SceneGraph.h"
+
+#include "assimp/scene.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine
+{
+
+namespace
+{
+	bool hasTriangles(const aiMesh& mesh)
+	{
+		return (mesh.mPrimitiveTypes & aiPrimitiveType_TRIANGLE) != 0 && mesh.mNumFaces != 0;
+	}
+
+	bool isMergeable(const aiMesh& mesh, const BatchSettings& settings)
+	{
+		return settings.mergeStatic
+			&& mesh.mNumBones == 0
+			&& mesh.mNumAnimMeshes == 0
+			&& mesh.mNumVertices <= settings.maxMergeVertices;
+	}
+
+	// Appends the mesh's vertices, transformed when world is given, and its
+	// triangles offset by baseVertex. Returns the number of indices written.
+	uint32_t appendGeometry(GeometryPool& pool, const aiMesh& mesh, const Affine* world, uint32_t baseVertex)
+	{
+		Affine normalMatrix = affineIdentity();
+		if (world != nullptr)
+		{
+			// inverse transpose, read transposed below
+			normalMatrix = affineInverse(*world);
+		}
+
+		for (unsigned int v = 0; v < mesh.mNumVertices; ++v)
+		{
+			const aiVector3D& p = mesh.mVertices[v];
+			if (world != nullptr)
+			{
+				const float (*m)[4] = world->m;
+				pool.positions.push_back(m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3]);
+				pool.positions.push_back(m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3]);
+				pool.positions.push_back(m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3]);
+			}
+			else
+			{
+				pool.positions.insert(pool.positions.end(), { p.x, p.y, p.z });
+			}
+
+			float normal[3] = { 0.0f, 0.0f, 0.0f };
+			if (mesh.HasNormals())
+			{
+				const aiVector3D& n = mesh.mNormals[v];
+				if (world != nullptr)
+				{
+					const float (*m)[4] = normalMatrix.m;
+					normal[0] = m[0][0] * n.x + m[1][0] * n.y + m[2][0] * n.z;
+					normal[1] = m[0][1] * n.x + m[1][1] * n.y + m[2][1] * n.z;
+					normal[2] = m[0][2] * n.x + m[1][2] * n.y + m[2][2] * n.z;
+					const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+					if (length > 0.0f)
+					{
+						normal[0] /= length;
+						normal[1] /= length;
+						normal[2] /= length;
+					}
+				}
+				else
+				{
+					normal[0] = n.x;
+					normal[1] = n.y;
+					normal[2] = n.z;
+				}
+			}
+			pool.normals.insert(pool.normals.end(), { normal[0], normal[1], normal[2] });
+
+			if (mesh.HasTextureCoords(0))
+			{
+				pool.texCoords.insert(pool.texCoords.end(), { mesh.mTextureCoords[0][v].x, mesh.mTextureCoords[0][v].y });
+			}
+			else
+			{
+				pool.texCoords.insert(pool.texCoords.end(), { 0.0f, 0.0f });
+			}
+		}
+
+		uint32_t indexCount = 0;
+		for (unsigned int f = 0; f < mesh.mNumFaces; ++f)
+		{
+			const aiFace& face = mesh.mFaces[f];
+			if (face.mNumIndices != 3)
+			{
+				continue;
+			}
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				pool.indices.push_back(baseVertex + face.mIndices[i]);
+			}
+			indexCount += 3;
+		}
+		return indexCount;
+	}
+
+	struct MeshReference
+	{
+		uint32_t material;
+		uint32_t mesh;
+		uint32_t node;
+	};
+}
+
+void buildBatches(const aiScene& scene, const SceneGraph& graph, const BatchSettings& settings, BatchList& batches)
+{
+	batches = BatchList();
+	BatchReport& report = batches.report;
+	GeometryPool& pool = batches.pool;
+
+	std::vector<MeshReference> references;
+	for (uint32_t node = 0; node < graph.getNodeCount(); ++node)
+	{
+		const uint32_t* meshes = graph.getMeshes(node);
+		for (uint32_t i = 0; i < graph.getMeshCount(node); ++i)
+		{
+			if (meshes[i] >= scene.mNumMeshes)
+			{
+				continue;
+			}
+			++report.sourceDrawCalls;
+			const aiMesh& mesh = *scene.mMeshes[meshes[i]];
+			if (!hasTriangles(mesh))
+			{
+				++report.skippedMeshes;
+				continue;
+			}
+			references.push_back({ mesh.mMaterialIndex, meshes[i], node });
+		}
+	}
+
+	// (material, mesh) runs, node order kept within a run
+	std::stable_sort(references.begin(), references.end(), [](const MeshReference& a, const MeshReference& b)
+	{
+		return a.material != b.material ? a.material < b.material : a.mesh < b.mesh;
+	});
+
+	// instanced and single draws first, mergeable references are set aside so
+	// every merged batch gets a contiguous vertex range
+	std::vector<MeshReference> mergeable;
+	for (size_t begin = 0; begin < references.size();)
+	{
+		size_t end = begin + 1;
+		while (end < references.size() && references[end].material == references[begin].material
+			&& references[end].mesh == references[begin].mesh)
+		{
+			++end;
+		}
+
+		const MeshReference& reference = references[begin];
+		const aiMesh& mesh = *scene.mMeshes[reference.mesh];
+		const uint32_t count = static_cast<uint32_t>(end - begin);
+		if (count < settings.minInstanceCount && isMergeable(mesh, settings))
+		{
+			mergeable.insert(mergeable.end(), references.begin() + begin, references.begin() + end);
+			begin = end;
+			continue;
+		}
+
+		Batch batch = {};
+		batch.kind = count > 1 ? BatchKind::Instanced : BatchKind::Single;
+		batch.material = reference.material;
+		batch.mesh = reference.mesh;
+		batch.vertexOffset = pool.getVertexCount();
+		batch.indexOffset = static_cast<uint32_t>(pool.indices.size());
+		batch.indexCount = appendGeometry(pool, mesh, nullptr, 0);
+		batch.firstInstance = static_cast<uint32_t>(batches.instanceNodes.size());
+		batch.instanceCount = count;
+		for (size_t r = begin; r < end; ++r)
+		{
+			batches.instanceNodes.push_back(references[r].node);
+		}
+		batches.batches.push_back(batch);
+
+		if (count > 1)
+		{
+			++report.instancedMeshes;
+			report.instancedNodes += count;
+		}
+		begin = end;
+	}
+
+	// mergeable references are still sorted by material
+	Batch* merged = nullptr;
+	for (const MeshReference& reference : mergeable)
+	{
+		const aiMesh& mesh = *scene.mMeshes[reference.mesh];
+		if (merged != nullptr && (merged->material != reference.material
+			|| pool.getVertexCount() - merged->vertexOffset + mesh.mNumVertices > settings.maxBatchVertices))
+		{
+			merged = nullptr;
+		}
+		if (merged == nullptr)
+		{
+			Batch batch = {};
+			batch.kind = BatchKind::Merged;
+			batch.material = reference.material;
+			batch.mesh = kMergedMesh;
+			batch.vertexOffset = pool.getVertexCount();
+			batch.indexOffset = static_cast<uint32_t>(pool.indices.size());
+			batches.batches.push_back(batch);
+			merged = &batches.batches.back();
+		}
+
+		const uint32_t baseVertex = pool.getVertexCount() - merged->vertexOffset;
+		merged->indexCount += appendGeometry(pool, mesh, &graph.getWorldTransform(reference.node), baseVertex);
+		++report.mergedMeshes;
+	}
+
+	report.batchedDrawCalls = batches.batches.size();
+}
+
+}
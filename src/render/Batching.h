@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct aiScene;
+
+namespace engine
+{
+
+class SceneGraph;
+
+struct BatchSettings
+{
+	// Meshes drawn by at least this many nodes become one instanced draw
+	uint32_t minInstanceCount = 2;
+
+	// Static meshes drawn once with at most this many vertices are baked into
+	// world space and merged per material
+	bool mergeStatic = true;
+	uint32_t maxMergeVertices = 1024;
+
+	// A merged batch is split once it would exceed this many vertices
+	uint32_t maxBatchVertices = 65536;
+};
+
+// Shared vertex and index storage every batch draws from. Vertices are
+// position, normal and first texture coordinate set, missing channels are zero.
+struct GeometryPool
+{
+	std::vector<float> positions;  // xyz
+	std::vector<float> normals;    // xyz
+	std::vector<float> texCoords;  // uv
+	std::vector<uint32_t> indices; // relative to the batch's vertexOffset
+
+	uint32_t getVertexCount() const { return static_cast<uint32_t>(positions.size() / 3); }
+};
+
+enum class BatchKind : uint8_t
+{
+	Single,     // one node drawing a mesh in its own space
+	Instanced,  // several nodes drawing the same mesh
+	Merged,     // several meshes baked into world space, no transform
+};
+
+// One draw call
+struct Batch
+{
+	BatchKind kind;
+	uint32_t material;
+	uint32_t mesh;  // source aiScene mesh, kMergedMesh for Merged batches
+	uint32_t vertexOffset;
+	uint32_t indexOffset;
+	uint32_t indexCount;
+	uint32_t firstInstance;  // into BatchList::instanceNodes
+	uint32_t instanceCount;  // 0 for Merged, drawn once without a transform
+};
+
+constexpr uint32_t kMergedMesh = ~0u;
+
+struct BatchReport
+{
+	size_t sourceDrawCalls = 0;  // one per mesh reference of a node
+	size_t batchedDrawCalls = 0;
+	size_t instancedMeshes = 0;
+	size_t instancedNodes = 0;
+	size_t mergedMeshes = 0;
+	size_t skippedMeshes = 0;  // references to meshes without triangles
+};
+
+struct BatchList
+{
+	std::vector<Batch> batches;
+	std::vector<uint32_t> instanceNodes;  // SceneGraph nodes, contiguous per batch
+	GeometryPool pool;
+	BatchReport report;
+};
+
+// Groups the graph's mesh references into draw batches. Meaningful after
+// aiProcess_FindInstances (and aiProcess_OptimizeMeshes), which turn repeated
+// geometry into shared mesh indices. Merged geometry uses the current world
+// transforms, so those nodes must not move afterwards.
+void buildBatches(const aiScene& scene, const SceneGraph& graph, const BatchSettings& settings, BatchList& batches);
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+// What a backend needs for one draw, everything else is bound by the sort order
+struct DrawPacket
+{
+	uint32_t mesh;       // aiScene::mMeshes index
+	uint32_t material;   // aiScene::mMaterials index
+	uint32_t transform;  // index into the frame's world transforms
+	uint32_t instanceCount;
+};
+
+// Unsorted list of keyed draw packets. Each recording task writes its own
+// buffer, so recording needs no synchronization.
+class CommandBuffer
+{
+public:
+	void clear()
+	{
+		m_keys.clear();
+		m_packets.clear();
+	}
+
+	void reserve(size_t count)
+	{
+		m_keys.reserve(count);
+		m_packets.reserve(count);
+	}
+
+	void draw(uint64_t sortKey, const DrawPacket& packet)
+	{
+		m_keys.push_back(sortKey);
+		m_packets.push_back(packet);
+	}
+
+	size_t size() const { return m_keys.size(); }
+	bool empty() const { return m_keys.empty(); }
+	const uint64_t* getKeys() const { return m_keys.data(); }
+	const DrawPacket* getPackets() const { return m_packets.data(); }
+
+private:
+	std::vector<uint64_t> m_keys;
+	std::vector<DrawPacket> m_packets;
+};
+
+}
@@ -0,0 +1,37 @@
+#include "RenderBackend.h"
+
+namespace engine
+{
+
+void RecordingBackend::beginFrame(const FrameInfo&)
+{
+	m_frame = FrameStats();
+	m_packets.clear();
+}
+
+void RecordingBackend::setMaterial(uint32_t)
+{
+	++m_frame.materialChanges;
+}
+
+void RecordingBackend::setMesh(uint32_t)
+{
+	++m_frame.meshChanges;
+}
+
+void RecordingBackend::draw(const DrawPacket& packet)
+{
+	++m_frame.drawCalls;
+	m_frame.instances += packet.instanceCount;
+	if (m_keepPackets)
+	{
+		m_packets.push_back(packet);
+	}
+}
+
+void RecordingBackend::endFrame()
+{
+	m_lastFrame = m_frame;
+}
+
+}
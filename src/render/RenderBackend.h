@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CommandBuffer.h"
+#include "../core/Affine.h"
+#include "../core/Matrix4.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+// Per frame data the backend reads while draws are submitted
+struct FrameInfo
+{
+	Matrix4 viewProjection;
+	const Affine* transforms = nullptr;  // DrawPacket::transform indexes this
+	size_t transformCount = 0;
+};
+
+// Receives the sorted command stream. State is only set when it changes, a
+// backend can rely on setMaterial() / setMesh() preceding the draws using them.
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() = default;
+
+	virtual void beginFrame(const FrameInfo& frame) = 0;
+	virtual void setMaterial(uint32_t material) = 0;
+	virtual void setMesh(uint32_t mesh) = 0;
+	virtual void draw(const DrawPacket& packet) = 0;
+	virtual void endFrame() = 0;
+};
+
+struct FrameStats
+{
+	size_t drawCalls = 0;
+	size_t instances = 0;
+	size_t materialChanges = 0;
+	size_t meshChanges = 0;
+};
+
+// Backend without a GPU, counts what it is asked to do and optionally keeps
+// the submitted packets, for tests and headless runs
+class RecordingBackend : public RenderBackend
+{
+public:
+	explicit RecordingBackend(bool keepPackets = false) : m_keepPackets(keepPackets) {}
+
+	void beginFrame(const FrameInfo& frame) override;
+	void setMaterial(uint32_t material) override;
+	void setMesh(uint32_t mesh) override;
+	void draw(const DrawPacket& packet) override;
+	void endFrame() override;
+
+	// Counters of the last completed frame
+	const FrameStats& getFrameStats() const { return m_lastFrame; }
+	const std::vector<DrawPacket>& getPackets() const { return m_packets; }
+
+private:
+	bool m_keepPackets;
+	FrameStats m_frame;
+	FrameStats m_lastFrame;
+	std::vector<DrawPacket> m_packets;
+};
+
+}
@@ -0,0 +1,150 @@
+#include "Renderer.h"
+
+#include "../core/JobSystem.h"
+#include "../core/RadixSort.h"
+#include "../culling/DrawList.h"
+
+#include <algorithm>
+
+namespace engine
+{
+
+namespace
+{
+	constexpr size_t kDrawItemsPerChunk = 4096;
+	constexpr uint32_t kNoState = ~0u;
+}
+
+Renderer::Renderer(RenderBackend& backend)
+	: m_backend(backend)
+{
+}
+
+void Renderer::beginFrame(const FrameInfo& frame)
+{
+	m_frame = frame;
+	for (size_t i = 0; i < m_usedBuffers; ++i)
+	{
+		m_buffers[i].clear();
+	}
+	m_usedBuffers = 0;
+}
+
+void Renderer::record(size_t count, size_t grain, const RecordFunction& record, JobSystem* jobSystem)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	grain = grain == 0 ? 1 : grain;
+
+	// buffers are handed out by chunk index, the job system starts every chunk at a multiple of grain
+	const size_t base = m_usedBuffers;
+	m_usedBuffers += (count + grain - 1) / grain;
+	if (m_buffers.size() < m_usedBuffers)
+	{
+		m_buffers.resize(m_usedBuffers);
+	}
+
+	const JobSystem::RangeFunction body = [&](size_t begin, size_t end)
+	{
+		record(m_buffers[base + begin / grain], begin, end);
+	};
+	if (jobSystem != nullptr)
+	{
+		jobSystem->parallelFor(count, grain, body);
+	}
+	else
+	{
+		for (size_t begin = 0; begin < count; begin += grain)
+		{
+			body(begin, std::min(begin + grain, count));
+		}
+	}
+}
+
+void Renderer::recordDrawList(const DrawList& drawList, JobSystem* jobSystem)
+{
+	const DrawItem* items = drawList.items.data();
+	record(drawList.items.size(), kDrawItemsPerChunk, [this, items](CommandBuffer& buffer, size_t begin, size_t end)
+	{
+		buffer.reserve(buffer.size() + (end - begin));
+		for (size_t i = begin; i < end; ++i)
+		{
+			const DrawItem& item = items[i];
+			const uint64_t key = makeSortKey(getMaterialLayer(item.material), item.material, item.mesh, item.depth);
+			buffer.draw(key, DrawPacket{ item.mesh, item.material, item.node, 1 });
+		}
+	}, jobSystem);
+}
+
+size_t Renderer::getRecordedCount() const
+{
+	size_t count = 0;
+	for (size_t i = 0; i < m_usedBuffers; ++i)
+	{
+		count += m_buffers[i].size();
+	}
+	return count;
+}
+
+void Renderer::submit(JobSystem* jobSystem)
+{
+	// merge the buffers at their prefix offsets
+	std::vector<size_t> offsets(m_usedBuffers + 1, 0);
+	for (size_t i = 0; i < m_usedBuffers; ++i)
+	{
+		offsets[i + 1] = offsets[i] + m_buffers[i].size();
+	}
+	const size_t count = offsets[m_usedBuffers];
+	m_keys.resize(count);
+	m_order.resize(count);
+	m_packets.resize(count);
+
+	const JobSystem::RangeFunction merge = [&](size_t begin, size_t end)
+	{
+		for (size_t b = begin; b < end; ++b)
+		{
+			const CommandBuffer& buffer = m_buffers[b];
+			const size_t offset = offsets[b];
+			std::copy(buffer.getKeys(), buffer.getKeys() + buffer.size(), m_keys.begin() + offset);
+			std::copy(buffer.getPackets(), buffer.getPackets() + buffer.size(), m_packets.begin() + offset);
+			for (size_t i = 0; i < buffer.size(); ++i)
+			{
+				m_order[offset + i] = static_cast<uint32_t>(offset + i);
+			}
+		}
+	};
+	if (jobSystem != nullptr)
+	{
+		jobSystem->parallelFor(m_usedBuffers, 1, merge);
+	}
+	else
+	{
+		merge(0, m_usedBuffers);
+	}
+
+	radixSort(m_keys, m_order, m_scratchKeys, m_scratchOrder);
+
+	m_backend.beginFrame(m_frame);
+	uint32_t material = kNoState;
+	uint32_t mesh = kNoState;
+	for (uint32_t index : m_order)
+	{
+		const DrawPacket& packet = m_packets[index];
+		if (packet.material != material)
+		{
+			material = packet.material;
+			m_backend.setMaterial(material);
+		}
+		if (packet.mesh != mesh)
+		{
+			mesh = packet.mesh;
+			m_backend.setMesh(mesh);
+		}
+		m_backend.draw(packet);
+	}
+	m_backend.endFrame();
+}
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CommandBuffer.h"
+#include "RenderBackend.h"
+#include "SortKey.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace engine
+{
+
+class JobSystem;
+struct DrawList;
+
+// Renderer front-end. Draws are recorded as sort-keyed packets into separate
+// command buffers, one per recording chunk, which can be filled from any
+// number of threads. submit() merges the buffers, radix sorts the packets by
+// key and hands them to the backend in order, binding state only on change.
+// Merging goes by chunk index, so the submitted order never depends on
+// which thread recorded what.
+class Renderer
+{
+public:
+	using RecordFunction = std::function<void(CommandBuffer& buffer, size_t begin, size_t end)>;
+
+	explicit Renderer(RenderBackend& backend);
+
+	RenderBackend& getBackend() const { return m_backend; }
+
+	// Layer of each material, materials beyond the list are opaque
+	void setMaterialLayers(std::vector<RenderLayer> layers) { m_materialLayers = std::move(layers); }
+	RenderLayer getMaterialLayer(uint32_t material) const
+	{
+		return material < m_materialLayers.size() ? m_materialLayers[material] : RenderLayer::Opaque;
+	}
+
+	// Drops everything recorded so far
+	void beginFrame(const FrameInfo& frame);
+
+	// Calls record for chunks of at most grain items covering [0, count), in
+	// parallel when given a job system. Every chunk gets its own buffer.
+	void record(size_t count, size_t grain, const RecordFunction& record, JobSystem* jobSystem = nullptr);
+
+	// One packet per draw list item, transform is the item's node
+	void recordDrawList(const DrawList& drawList, JobSystem* jobSystem = nullptr);
+
+	size_t getRecordedCount() const;
+
+	// Sorts and submits everything recorded since beginFrame(), then ends the
+	// backend frame
+	void submit(JobSystem* jobSystem = nullptr);
+
+private:
+	RenderBackend& m_backend;
+	FrameInfo m_frame;
+	std::vector<RenderLayer> m_materialLayers;
+
+	std::vector<CommandBuffer> m_buffers;
+	size_t m_usedBuffers = 0;
+
+	// merged stream, sorted through m_order
+	std::vector<uint64_t> m_keys;
+	std::vector<uint32_t> m_order;
+	std::vector<DrawPacket> m_packets;
+	std::vector<uint64_t> m_scratchKeys;
+	std::vector<uint32_t> m_scratchOrder;
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace engine
+{
+
+enum class RenderLayer : uint8_t
+{
+	Opaque = 0,
+	Translucent = 1,
+};
+
+// 64 bit draw order, sorted ascending. The layer is always the top 4 bits.
+// Opaque:      layer | material 20 | mesh 20 | depth 20, front to back within a state
+// Translucent: layer | inverted depth 20 | material 20 | mesh 20, back to front
+namespace sortkey
+{
+	constexpr unsigned int kFieldBits = 20;
+	constexpr uint64_t kFieldMask = (uint64_t(1) << kFieldBits) - 1;
+
+	// Positive floats order like their bit patterns, the top 20 bits of those
+	// (exponent and 12 mantissa bits) keep the order without a depth range
+	inline uint64_t quantizeDepth(float depth)
+	{
+		if (!(depth > 0.0f))
+		{
+			return 0;
+		}
+		uint32_t bits;
+		std::memcpy(&bits, &depth, sizeof(bits));
+		return (bits >> (31 - kFieldBits)) & kFieldMask;
+	}
+}
+
+inline uint64_t makeSortKey(RenderLayer layer, uint32_t material, uint32_t mesh, float depth)
+{
+	using namespace sortkey;
+	const uint64_t top = uint64_t(layer) << 60;
+	const uint64_t materialField = material & kFieldMask;
+	const uint64_t meshField = mesh & kFieldMask;
+	const uint64_t depthField = quantizeDepth(depth);
+	if (layer == RenderLayer::Opaque)
+	{
+		return top | materialField << 40 | meshField << 20 | depthField;
+	}
+	return top | (kFieldMask - depthField) << 40 | materialField << 20 | meshField;
+}
+
+inline RenderLayer sortKeyLayer(uint64_t key)
+{
+	return static_cast<RenderLayer>(key >> 60);
+}
+
+}
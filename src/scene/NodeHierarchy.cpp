@@ -0,0 +1,63 @@
+#include "NodeHierarchy.h"
+
+#include "assimp/scene.h"
+
+namespace engine
+{
+
+int32_t NodeHierarchy::findNode(const std::string& name) const
+{
+	const aiStringHandle handle = nameTable.Find(name.data(), name.size());
+	return handle != AI_STRING_HANDLE_INVALID ? handleToNode[handle] : -1;
+}
+
+NodeHierarchy flattenNodeHierarchy(const aiNode* root)
+{
+	NodeHierarchy hierarchy;
+	if (root == nullptr)
+	{
+		return hierarchy;
+	}
+
+	// the output arrays double as the breadth-first queue
+	hierarchy.sourceNodes.push_back(root);
+	hierarchy.parents.push_back(-1);
+	for (size_t i = 0; i < hierarchy.sourceNodes.size(); ++i)
+	{
+		const aiNode* node = hierarchy.sourceNodes[i];
+		for (unsigned int c = 0; c < node->mNumChildren; ++c)
+		{
+			hierarchy.sourceNodes.push_back(node->mChildren[c]);
+			hierarchy.parents.push_back(static_cast<int32_t>(i));
+		}
+	}
+
+	const size_t count = hierarchy.sourceNodes.size();
+	hierarchy.localTransforms.reserve(count);
+	hierarchy.names.reserve(count);
+	hierarchy.handleToNode.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const aiNode* node = hierarchy.sourceNodes[i];
+		hierarchy.localTransforms.push_back(affineFromMatrix(node->mTransformation));
+		const aiStringHandle handle = hierarchy.nameTable.Intern(node->mName);
+		hierarchy.names.push_back(handle);
+		if (handle == hierarchy.handleToNode.size())
+		{
+			hierarchy.handleToNode.push_back(static_cast<int32_t>(i));
+		}
+	}
+	return hierarchy;
+}
+
+void computeWorldTransforms(const NodeHierarchy& hierarchy, const Affine* locals, Affine* worlds)
+{
+	const uint32_t count = hierarchy.size();
+	const int32_t* parents = hierarchy.parents.data();
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		worlds[i] = parents[i] < 0 ? locals[i] : worlds[parents[i]] * locals[i];
+	}
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../core/Affine.h"
+
+#include "assimp/StringTable.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct aiNode;
+
+namespace engine
+{
+
+// The aiNode tree flattened into arrays in breadth-first order. Every node comes
+// after its parent, so walking the arrays front to back visits parents first and
+// world transforms are a single linear pass instead of a recursive traversal.
+struct NodeHierarchy
+{
+	std::vector<int32_t> parents;  // -1 for the root
+	std::vector<Affine> localTransforms;  // aiNode::mTransformation
+	std::vector<aiStringHandle> names;  // handles into nameTable
+	std::vector<const aiNode*> sourceNodes;
+
+	// Every distinct node name once; handleToNode maps a handle to the first
+	// node with that name
+	Assimp::StringTable nameTable;
+	std::vector<int32_t> handleToNode;
+
+	uint32_t size() const { return static_cast<uint32_t>(parents.size()); }
+
+	const char* getName(uint32_t node) const { return nameTable.GetString(names[node]); }
+
+	// Index of the first node with this name, or -1
+	int32_t findNode(const std::string& name) const;
+};
+
+NodeHierarchy flattenNodeHierarchy(const aiNode* root);
+
+// worlds[i] = worlds[parents[i]] * locals[i], in one pass over the arrays
+void computeWorldTransforms(const NodeHierarchy& hierarchy, const Affine* locals, Affine* worlds);
+
+}
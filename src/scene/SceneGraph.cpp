@@ -0,0 +1,154 @@
+#include "SceneGraph.h"
+
+#include "../core/JobSystem.h"
+
+#include "assimp/scene.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+namespace engine
+{
+
+namespace
+{
+	// Nodes per job system chunk, levels up to this size are updated inline
+	constexpr size_t kNodesPerChunk = 4096;
+}
+
+SceneGraph::SceneGraph(const aiScene& scene)
+	: SceneGraph(flattenNodeHierarchy(scene.mRootNode))
+{
+}
+
+SceneGraph::SceneGraph(NodeHierarchy hierarchy)
+	: m_hierarchy(std::move(hierarchy))
+{
+	const uint32_t count = m_hierarchy.size();
+
+	// breadth-first order: a node's level is one more than its parent's and never decreases
+	m_levelOf.resize(count);
+	m_levelBegin.assign(1, 0);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const int32_t parent = m_hierarchy.parents[i];
+		m_levelOf[i] = parent < 0 ? 0 : m_levelOf[parent] + 1;
+		while (m_levelBegin.size() <= m_levelOf[i])
+		{
+			m_levelBegin.push_back(i);
+		}
+	}
+	m_levelBegin.push_back(count);
+	m_levelDirtyCount.assign(getLevelCount(), 0);
+
+	m_meshBegin.reserve(size_t(count) + 1);
+	m_meshBegin.push_back(0);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const aiNode* node = i < m_hierarchy.sourceNodes.size() ? m_hierarchy.sourceNodes[i] : nullptr;
+		if (node != nullptr)
+		{
+			m_meshIndices.insert(m_meshIndices.end(), node->mMeshes, node->mMeshes + node->mNumMeshes);
+		}
+		m_meshBegin.push_back(static_cast<uint32_t>(m_meshIndices.size()));
+	}
+
+	// everything starts out dirty, the roots pull in the rest
+	m_worldTransforms.resize(count);
+	m_dirty.assign(count, 0);
+	for (uint32_t i = m_levelBegin[0]; i < m_levelBegin[1]; ++i)
+	{
+		markDirty(i);
+	}
+}
+
+void SceneGraph::setLocalTransform(uint32_t node, const Affine& transform)
+{
+	m_hierarchy.localTransforms[node] = transform;
+	markDirty(node);
+}
+
+void SceneGraph::markDirty(uint32_t node)
+{
+	if (m_dirty[node] == 0)
+	{
+		m_dirty[node] = 1;
+		++m_levelDirtyCount[m_levelOf[node]];
+		++m_dirtyNodeCount;
+	}
+}
+
+bool SceneGraph::updateLevel(uint32_t level, JobSystem* jobSystem)
+{
+	const uint32_t begin = m_levelBegin[level];
+	const uint32_t end = m_levelBegin[level + 1];
+	const int32_t* parents = m_hierarchy.parents.data();
+	const Affine* locals = m_hierarchy.localTransforms.data();
+	Affine* worlds = m_worldTransforms.data();
+	uint8_t* dirty = m_dirty.data();
+
+	std::atomic<bool> anyDirty{ false };
+	auto updateRange = [&](size_t first, size_t last)
+	{
+		bool rangeDirty = false;
+		for (size_t i = begin + first; i < begin + last; ++i)
+		{
+			const int32_t parent = parents[i];
+			dirty[i] |= parent >= 0 ? dirty[parent] : 0;
+			if (dirty[i] != 0)
+			{
+				worlds[i] = parent >= 0 ? worlds[parent] * locals[i] : locals[i];
+				rangeDirty = true;
+			}
+		}
+		if (rangeDirty)
+		{
+			anyDirty.store(true, std::memory_order_relaxed);
+		}
+	};
+
+	if (jobSystem != nullptr)
+	{
+		jobSystem->parallelFor(end - begin, kNodesPerChunk, updateRange);
+	}
+	else
+	{
+		updateRange(0, end - begin);
+	}
+	return anyDirty.load(std::memory_order_relaxed);
+}
+
+void SceneGraph::updateWorldTransforms(JobSystem* jobSystem)
+{
+	if (m_dirtyNodeCount == 0)
+	{
+		return;
+	}
+
+	// levels without flagged nodes whose parents are all clean are skipped entirely
+	std::vector<uint32_t> updatedLevels;
+	bool carry = false;
+	uint32_t remaining = m_dirtyNodeCount;
+	for (uint32_t level = 0; level < getLevelCount() && (carry || remaining != 0); ++level)
+	{
+		if (!carry && m_levelDirtyCount[level] == 0)
+		{
+			continue;
+		}
+		remaining -= m_levelDirtyCount[level];
+		carry = updateLevel(level, jobSystem);
+		updatedLevels.push_back(level);
+	}
+
+	// the flags of a level are read by the next one, so they are cleared at the end
+	for (uint32_t level : updatedLevels)
+	{
+		std::memset(m_dirty.data() + m_levelBegin[level], 0, m_levelBegin[level + 1] - m_levelBegin[level]);
+		m_levelDirtyCount[level] = 0;
+	}
+	m_dirtyNodeCount = 0;
+}
+
+}
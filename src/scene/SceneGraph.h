@@ -0,0 +1,74 @@
+#pragma once
+
+#include "NodeHierarchy.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct aiScene;
+
+namespace engine
+{
+
+class JobSystem;
+
+// Transform hierarchy of an imported scene, stored as flat arrays in
+// breadth-first order: the nodes of one depth are contiguous and all their
+// parents live in the level before. Changing a local transform only flags the
+// node; updateWorldTransforms() then walks the levels top-down, recomputing the
+// world transforms of flagged nodes and everything below them, and hands the
+// nodes of each level to the job system in parallel.
+class SceneGraph
+{
+public:
+	SceneGraph() = default;
+	explicit SceneGraph(const aiScene& scene);
+	explicit SceneGraph(NodeHierarchy hierarchy);
+
+	uint32_t getNodeCount() const { return m_hierarchy.size(); }
+	uint32_t getLevelCount() const { return m_levelBegin.empty() ? 0 : static_cast<uint32_t>(m_levelBegin.size()) - 1; }
+
+	// Nodes of one depth are [getLevelBegin(level), getLevelBegin(level + 1))
+	uint32_t getLevelBegin(uint32_t level) const { return m_levelBegin[level]; }
+
+	int32_t getParent(uint32_t node) const { return m_hierarchy.parents[node]; }
+	const char* getName(uint32_t node) const { return m_hierarchy.getName(node); }
+	int32_t findNode(const std::string& name) const { return m_hierarchy.findNode(name); }
+	const NodeHierarchy& getHierarchy() const { return m_hierarchy; }
+
+	// aiScene mesh indices referenced by a node
+	const uint32_t* getMeshes(uint32_t node) const { return m_meshIndices.data() + m_meshBegin[node]; }
+	uint32_t getMeshCount(uint32_t node) const { return m_meshBegin[node + 1] - m_meshBegin[node]; }
+
+	const Affine& getLocalTransform(uint32_t node) const { return m_hierarchy.localTransforms[node]; }
+	void setLocalTransform(uint32_t node, const Affine& transform);
+
+	// Valid for all nodes after updateWorldTransforms()
+	const Affine& getWorldTransform(uint32_t node) const { return m_worldTransforms[node]; }
+	const Affine* getWorldTransforms() const { return m_worldTransforms.data(); }
+
+	bool isDirty() const { return m_dirtyNodeCount != 0; }
+
+	// Brings the world transforms of all flagged subtrees up to date. Without a
+	// job system, or for small levels, everything runs on the calling thread.
+	void updateWorldTransforms(JobSystem* jobSystem = nullptr);
+
+private:
+	void markDirty(uint32_t node);
+	bool updateLevel(uint32_t level, JobSystem* jobSystem);
+
+	NodeHierarchy m_hierarchy;
+	std::vector<Affine> m_worldTransforms;
+	std::vector<uint8_t> m_dirty;
+
+	std::vector<uint32_t> m_levelBegin;
+	std::vector<uint32_t> m_levelOf;
+	std::vector<uint32_t> m_levelDirtyCount;  // nodes flagged directly, per level
+	uint32_t m_dirtyNodeCount = 0;
+
+	std::vector<uint32_t> m_meshBegin;
+	std::vector<uint32_t> m_meshIndices;
+};
+
+}
@@ -0,0 +1,125 @@
+#include "SkinnedMesh.h"
+
+#include "../scene/NodeHierarchy.h"
+
+#include "assimp/mesh.h"
+
+#include <algorithm>
+
+namespace engine
+{
+
+SkinnedMesh buildSkinnedMesh(const aiMesh& mesh, const NodeHierarchy& hierarchy, int32_t meshNode)
+{
+	SkinnedMesh skinned;
+	skinned.vertexCount = mesh.mNumVertices;
+	skinned.meshNode = meshNode;
+
+	const uint32_t vertexCount = mesh.mNumVertices;
+	skinned.positionX.resize(vertexCount);
+	skinned.positionY.resize(vertexCount);
+	skinned.positionZ.resize(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		skinned.positionX[v] = static_cast<float>(mesh.mVertices[v].x);
+		skinned.positionY[v] = static_cast<float>(mesh.mVertices[v].y);
+		skinned.positionZ[v] = static_cast<float>(mesh.mVertices[v].z);
+	}
+	if (mesh.HasNormals())
+	{
+		skinned.normalX.resize(vertexCount);
+		skinned.normalY.resize(vertexCount);
+		skinned.normalZ.resize(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; ++v)
+		{
+			skinned.normalX[v] = static_cast<float>(mesh.mNormals[v].x);
+			skinned.normalY[v] = static_cast<float>(mesh.mNormals[v].y);
+			skinned.normalZ[v] = static_cast<float>(mesh.mNormals[v].z);
+		}
+	}
+
+	skinned.boneNodes.resize(mesh.mNumBones);
+	skinned.inverseBindMatrices.resize(mesh.mNumBones);
+	for (unsigned int b = 0; b < mesh.mNumBones; ++b)
+	{
+		skinned.boneNodes[b] = hierarchy.findNode(mesh.mBones[b]->mName.C_Str());
+		skinned.inverseBindMatrices[b] = affineFromMatrix(mesh.mBones[b]->mOffsetMatrix);
+	}
+
+	// aiBone stores weights per bone, gather the heaviest influences per vertex
+	std::vector<uint16_t> bones(size_t(vertexCount) * kMaxBoneInfluences, 0);
+	std::vector<float> weights(size_t(vertexCount) * kMaxBoneInfluences, 0.0f);
+	for (unsigned int b = 0; b < mesh.mNumBones; ++b)
+	{
+		const aiBone* bone = mesh.mBones[b];
+		for (unsigned int w = 0; w < bone->mNumWeights; ++w)
+		{
+			const aiVertexWeight& weight = bone->mWeights[w];
+			if (weight.mVertexId >= vertexCount || !(weight.mWeight > 0.0f))
+			{
+				continue;
+			}
+
+			uint16_t* vertexBones = &bones[size_t(weight.mVertexId) * kMaxBoneInfluences];
+			float* vertexWeights = &weights[size_t(weight.mVertexId) * kMaxBoneInfluences];
+			unsigned int lightest = 0;
+			for (unsigned int i = 1; i < kMaxBoneInfluences; ++i)
+			{
+				if (vertexWeights[i] < vertexWeights[lightest])
+				{
+					lightest = i;
+				}
+			}
+			if (weight.mWeight > vertexWeights[lightest])
+			{
+				vertexBones[lightest] = static_cast<uint16_t>(b);
+				vertexWeights[lightest] = weight.mWeight;
+			}
+		}
+	}
+
+	const uint16_t identityEntry = static_cast<uint16_t>(mesh.mNumBones);
+	for (unsigned int i = 0; i < kMaxBoneInfluences; ++i)
+	{
+		skinned.influenceBones[i].resize(vertexCount);
+		skinned.influenceWeights[i].resize(vertexCount);
+	}
+	for (uint32_t v = 0; v < vertexCount; ++v)
+	{
+		const uint16_t* vertexBones = &bones[size_t(v) * kMaxBoneInfluences];
+		const float* vertexWeights = &weights[size_t(v) * kMaxBoneInfluences];
+
+		float total = 0.0f;
+		for (unsigned int i = 0; i < kMaxBoneInfluences; ++i)
+		{
+			total += vertexWeights[i];
+		}
+		for (unsigned int i = 0; i < kMaxBoneInfluences; ++i)
+		{
+			if (total > 0.0f)
+			{
+				skinned.influenceBones[i][v] = vertexBones[i];
+				skinned.influenceWeights[i][v] = vertexWeights[i] / total;
+			}
+			else
+			{
+				skinned.influenceBones[i][v] = identityEntry;
+				skinned.influenceWeights[i][v] = i == 0 ? 1.0f : 0.0f;
+			}
+		}
+	}
+	return skinned;
+}
+
+void computeBonePalette(const SkinnedMesh& mesh, const Affine* worlds, Affine* palette)
+{
+	const Affine meshInverse = mesh.meshNode >= 0 ? affineInverse(worlds[mesh.meshNode]) : affineIdentity();
+	for (uint32_t b = 0; b < mesh.getBoneCount(); ++b)
+	{
+		const int32_t node = mesh.boneNodes[b];
+		palette[b] = node >= 0 ? meshInverse * worlds[node] * mesh.inverseBindMatrices[b] : affineIdentity();
+	}
+	palette[mesh.getBoneCount()] = affineIdentity();
+}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../core/Affine.h"
+
+#include <cstdint>
+#include <vector>
+
+struct aiMesh;
+
+namespace engine
+{
+
+struct NodeHierarchy;
+
+// Maximum number of bones influencing one vertex, lighter influences are dropped
+constexpr unsigned int kMaxBoneInfluences = 4;
+
+// Bind-pose vertex streams of an aiMesh plus its skin, prepared for the skinning
+// kernels: every stream is a separate array, and the influences are stored as
+// kMaxBoneInfluences index and weight streams with normalized weights.
+// Vertices without any weight reference the extra identity entry at the end of
+// the palette (index == bone count), so they stay in their bind position.
+struct SkinnedMesh
+{
+	uint32_t vertexCount = 0;
+	std::vector<float> positionX, positionY, positionZ;
+	std::vector<float> normalX, normalY, normalZ;  // empty if the mesh has no normals
+
+	std::vector<uint16_t> influenceBones[kMaxBoneInfluences];
+	std::vector<float> influenceWeights[kMaxBoneInfluences];
+
+	std::vector<int32_t> boneNodes;  // node index per aiBone, -1 if the node is missing
+	std::vector<Affine> inverseBindMatrices;  // aiBone::mOffsetMatrix
+
+	int32_t meshNode = -1;  // node the mesh is attached to, results are relative to it
+
+	uint32_t getBoneCount() const { return static_cast<uint32_t>(boneNodes.size()); }
+	uint32_t getPaletteSize() const { return getBoneCount() + 1; }
+};
+
+SkinnedMesh buildSkinnedMesh(const aiMesh& mesh, const NodeHierarchy& hierarchy, int32_t meshNode);
+
+// palette[b] = inverse(worlds[meshNode]) * worlds[boneNodes[b]] * inverseBindMatrices[b],
+// followed by the identity entry; palette must have getPaletteSize() entries.
+void computeBonePalette(const SkinnedMesh& mesh, const Affine* worlds, Affine* palette);
+
+}
@@ -0,0 +1,439 @@
+#include "Skinning.h"
+
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace engine
+{
+
+namespace
+{
+	// Vertices per job system chunk, and per block the kernels keep on the stack
+	constexpr uint32_t kVerticesPerChunk = 2048;
+	constexpr uint32_t kBlockSize = 64;
+
+	constexpr uint32_t kAffineComponents = 12;
+	constexpr uint32_t kDualQuaternionComponents = 8;
+
+	// The palette transposed into one array per matrix component, so the blend
+	// loops below gather one component for a whole block of vertices at a time
+	std::vector<float> transposeAffinePalette(const Affine* palette, uint32_t size)
+	{
+		std::vector<float> components(size_t(kAffineComponents) * size);
+		for (uint32_t b = 0; b < size; ++b)
+		{
+			for (uint32_t j = 0; j < kAffineComponents; ++j)
+			{
+				components[size_t(j) * size + b] = palette[b].m[j / 4][j % 4];
+			}
+		}
+		return components;
+	}
+
+	// Rotation part of m (scale removed) as quaternion (x, y, z, w)
+	void rotationFromAffine(const Affine& affine, float q[4])
+	{
+		float r[3][3];
+		for (int column = 0; column < 3; ++column)
+		{
+			const float length = std::sqrt(affine.m[0][column] * affine.m[0][column]
+				+ affine.m[1][column] * affine.m[1][column] + affine.m[2][column] * affine.m[2][column]);
+			const float inv = length > 0.0f ? 1.0f / length : 0.0f;
+			for (int row = 0; row < 3; ++row)
+			{
+				r[row][column] = affine.m[row][column] * inv;
+			}
+		}
+
+		const float trace = r[0][0] + r[1][1] + r[2][2];
+		if (trace > 0.0f)
+		{
+			const float s = 0.5f / std::sqrt(trace + 1.0f);
+			q[3] = 0.25f / s;
+			q[0] = (r[2][1] - r[1][2]) * s;
+			q[1] = (r[0][2] - r[2][0]) * s;
+			q[2] = (r[1][0] - r[0][1]) * s;
+		}
+		else if (r[0][0] > r[1][1] && r[0][0] > r[2][2])
+		{
+			const float s = 2.0f * std::sqrt(1.0f + r[0][0] - r[1][1] - r[2][2]);
+			q[3] = (r[2][1] - r[1][2]) / s;
+			q[0] = 0.25f * s;
+			q[1] = (r[0][1] + r[1][0]) / s;
+			q[2] = (r[0][2] + r[2][0]) / s;
+		}
+		else if (r[1][1] > r[2][2])
+		{
+			const float s = 2.0f * std::sqrt(1.0f + r[1][1] - r[0][0] - r[2][2]);
+			q[3] = (r[0][2] - r[2][0]) / s;
+			q[0] = (r[0][1] + r[1][0]) / s;
+			q[1] = 0.25f * s;
+			q[2] = (r[1][2] + r[2][1]) / s;
+		}
+		else
+		{
+			const float s = 2.0f * std::sqrt(1.0f + r[2][2] - r[0][0] - r[1][1]);
+			q[3] = (r[1][0] - r[0][1]) / s;
+			q[0] = (r[0][2] + r[2][0]) / s;
+			q[1] = (r[1][2] + r[2][1]) / s;
+			q[2] = 0.25f * s;
+		}
+	}
+
+	// Dual quaternion skinning only blends rigid transforms. Each palette entry is
+	// split into M = R * S: the rigid part (R plus the translation) becomes a unit
+	// dual quaternion, the remaining scale/shear S is blended linearly and applied
+	// to the vertex first. Components 0-3 hold the real part (x, y, z, w), 4-7 the
+	// dual part and 8-16 the row-major S, transposed like the affine palette.
+	struct DualQuaternionPalette
+	{
+		std::vector<float> components;
+		bool hasScale = false;
+	};
+
+	constexpr uint32_t kScaleComponents = 9;
+	constexpr uint32_t kDualQuaternionPaletteComponents = kDualQuaternionComponents + kScaleComponents;
+
+	DualQuaternionPalette dualQuaternionPalette(const Affine* palette, uint32_t size)
+	{
+		DualQuaternionPalette result;
+		result.components.resize(size_t(kDualQuaternionPaletteComponents) * size);
+		for (uint32_t b = 0; b < size; ++b)
+		{
+			const Affine& m = palette[b];
+			float q[4];
+			rotationFromAffine(m, q);
+			const float tx = m.m[0][3], ty = m.m[1][3], tz = m.m[2][3];
+
+			// dual = 0.5 * (t, 0) * q
+			const float d[4] = {
+				0.5f * (tx * q[3] + ty * q[2] - tz * q[1]),
+				0.5f * (-tx * q[2] + ty * q[3] + tz * q[0]),
+				0.5f * (tx * q[1] - ty * q[0] + tz * q[3]),
+				-0.5f * (tx * q[0] + ty * q[1] + tz * q[2])
+			};
+			for (uint32_t j = 0; j < 4; ++j)
+			{
+				result.components[size_t(j) * size + b] = q[j];
+				result.components[size_t(j + 4) * size + b] = d[j];
+			}
+
+			// S = transpose(R) * M
+			const float r[3][3] = {
+				{ 1.0f - 2.0f * (q[1] * q[1] + q[2] * q[2]), 2.0f * (q[0] * q[1] - q[3] * q[2]), 2.0f * (q[0] * q[2] + q[3] * q[1]) },
+				{ 2.0f * (q[0] * q[1] + q[3] * q[2]), 1.0f - 2.0f * (q[0] * q[0] + q[2] * q[2]), 2.0f * (q[1] * q[2] - q[3] * q[0]) },
+				{ 2.0f * (q[0] * q[2] - q[3] * q[1]), 2.0f * (q[1] * q[2] + q[3] * q[0]), 1.0f - 2.0f * (q[0] * q[0] + q[1] * q[1]) }
+			};
+			for (uint32_t row = 0; row < 3; ++row)
+			{
+				for (uint32_t column = 0; column < 3; ++column)
+				{
+					const float value = r[0][row] * m.m[0][column] + r[1][row] * m.m[1][column] + r[2][row] * m.m[2][column];
+					result.components[size_t(kDualQuaternionComponents + row * 3 + column) * size + b] = value;
+					result.hasScale |= std::fabs(value - (row == column ? 1.0f : 0.0f)) > 1e-5f;
+				}
+			}
+		}
+		return result;
+	}
+
+	void skinLinearBlend(const SkinnedMesh& mesh, const float* palette, uint32_t paletteSize,
+		uint32_t begin, uint32_t end, SkinnedVertices& out)
+	{
+		const bool normals = !mesh.normalX.empty();
+		for (uint32_t block = begin; block < end; block += kBlockSize)
+		{
+			const uint32_t count = std::min(kBlockSize, end - block);
+
+			float m[kAffineComponents][kBlockSize] = {};
+			for (unsigned int k = 0; k < kMaxBoneInfluences; ++k)
+			{
+				const uint16_t* bones = mesh.influenceBones[k].data() + block;
+				const float* weights = mesh.influenceWeights[k].data() + block;
+				for (uint32_t j = 0; j < kAffineComponents; ++j)
+				{
+					const float* component = palette + size_t(j) * paletteSize;
+					for (uint32_t v = 0; v < count; ++v)
+					{
+						m[j][v] += weights[v] * component[bones[v]];
+					}
+				}
+			}
+
+			const float* px = mesh.positionX.data() + block;
+			const float* py = mesh.positionY.data() + block;
+			const float* pz = mesh.positionZ.data() + block;
+			float* ox = out.positionX.data() + block;
+			float* oy = out.positionY.data() + block;
+			float* oz = out.positionZ.data() + block;
+			for (uint32_t v = 0; v < count; ++v)
+			{
+				ox[v] = m[0][v] * px[v] + m[1][v] * py[v] + m[2][v] * pz[v] + m[3][v];
+				oy[v] = m[4][v] * px[v] + m[5][v] * py[v] + m[6][v] * pz[v] + m[7][v];
+				oz[v] = m[8][v] * px[v] + m[9][v] * py[v] + m[10][v] * pz[v] + m[11][v];
+			}
+
+			if (!normals)
+			{
+				continue;
+			}
+			const float* nx = mesh.normalX.data() + block;
+			const float* ny = mesh.normalY.data() + block;
+			const float* nz = mesh.normalZ.data() + block;
+			float* onx = out.normalX.data() + block;
+			float* ony = out.normalY.data() + block;
+			float* onz = out.normalZ.data() + block;
+			for (uint32_t v = 0; v < count; ++v)
+			{
+				const float x = m[0][v] * nx[v] + m[1][v] * ny[v] + m[2][v] * nz[v];
+				const float y = m[4][v] * nx[v] + m[5][v] * ny[v] + m[6][v] * nz[v];
+				const float z = m[8][v] * nx[v] + m[9][v] * ny[v] + m[10][v] * nz[v];
+				const float lengthSquared = x * x + y * y + z * z;
+				const float inv = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+				onx[v] = x * inv;
+				ony[v] = y * inv;
+				onz[v] = z * inv;
+			}
+		}
+	}
+
+	// Blends the S part of the palette and applies it to one stream triple of a block
+	void blendScale(const SkinnedMesh& mesh, const float* palette, uint32_t paletteSize, uint32_t block, uint32_t count,
+		const float* x, const float* y, const float* z, float (*out)[kBlockSize])
+	{
+		float s[kScaleComponents][kBlockSize] = {};
+		for (unsigned int k = 0; k < kMaxBoneInfluences; ++k)
+		{
+			const uint16_t* bones = mesh.influenceBones[k].data() + block;
+			const float* weights = mesh.influenceWeights[k].data() + block;
+			for (uint32_t j = 0; j < kScaleComponents; ++j)
+			{
+				const float* component = palette + size_t(kDualQuaternionComponents + j) * paletteSize;
+				for (uint32_t v = 0; v < count; ++v)
+				{
+					s[j][v] += weights[v] * component[bones[v]];
+				}
+			}
+		}
+		for (uint32_t v = 0; v < count; ++v)
+		{
+			out[0][v] = s[0][v] * x[v] + s[1][v] * y[v] + s[2][v] * z[v];
+			out[1][v] = s[3][v] * x[v] + s[4][v] * y[v] + s[5][v] * z[v];
+			out[2][v] = s[6][v] * x[v] + s[7][v] * y[v] + s[8][v] * z[v];
+		}
+	}
+
+	void skinDualQuaternion(const SkinnedMesh& mesh, const float* palette, uint32_t paletteSize, bool hasScale,
+		uint32_t begin, uint32_t end, SkinnedVertices& out)
+	{
+		const bool normals = !mesh.normalX.empty();
+		const float* realX = palette;
+		const float* realY = palette + paletteSize;
+		const float* realZ = palette + size_t(2) * paletteSize;
+		const float* realW = palette + size_t(3) * paletteSize;
+
+		for (uint32_t block = begin; block < end; block += kBlockSize)
+		{
+			const uint32_t count = std::min(kBlockSize, end - block);
+
+			// antipodal influences have to be flipped onto the hemisphere of the first one
+			float weights[kMaxBoneInfluences][kBlockSize];
+			const uint16_t* firstBones = mesh.influenceBones[0].data() + block;
+			for (unsigned int k = 0; k < kMaxBoneInfluences; ++k)
+			{
+				const uint16_t* bones = mesh.influenceBones[k].data() + block;
+				const float* source = mesh.influenceWeights[k].data() + block;
+				for (uint32_t v = 0; v < count; ++v)
+				{
+					const uint16_t a = firstBones[v], b = bones[v];
+					const float dot = realX[a] * realX[b] + realY[a] * realY[b] + realZ[a] * realZ[b] + realW[a] * realW[b];
+					weights[k][v] = dot < 0.0f ? -source[v] : source[v];
+				}
+			}
+
+			float q[kDualQuaternionComponents][kBlockSize] = {};
+			for (unsigned int k = 0; k < kMaxBoneInfluences; ++k)
+			{
+				const uint16_t* bones = mesh.influenceBones[k].data() + block;
+				for (uint32_t j = 0; j < kDualQuaternionComponents; ++j)
+				{
+					const float* component = palette + size_t(j) * paletteSize;
+					for (uint32_t v = 0; v < count; ++v)
+					{
+						q[j][v] += weights[k][v] * component[bones[v]];
+					}
+				}
+			}
+
+			const float* px = mesh.positionX.data() + block;
+			const float* py = mesh.positionY.data() + block;
+			const float* pz = mesh.positionZ.data() + block;
+			float scaled[3][kBlockSize];
+			if (hasScale)
+			{
+				blendScale(mesh, palette, paletteSize, block, count, px, py, pz, scaled);
+				px = scaled[0];
+				py = scaled[1];
+				pz = scaled[2];
+			}
+			float* ox = out.positionX.data() + block;
+			float* oy = out.positionY.data() + block;
+			float* oz = out.positionZ.data() + block;
+			for (uint32_t v = 0; v < count; ++v)
+			{
+				const float lengthSquared = q[0][v] * q[0][v] + q[1][v] * q[1][v] + q[2][v] * q[2][v] + q[3][v] * q[3][v];
+				const float inv = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+				const float rx = q[0][v] * inv, ry = q[1][v] * inv, rz = q[2][v] * inv, rw = q[3][v] * inv;
+				const float dx = q[4][v] * inv, dy = q[5][v] * inv, dz = q[6][v] * inv, dw = q[7][v] * inv;
+				for (uint32_t j = 0; j < kDualQuaternionComponents; ++j)
+				{
+					q[j][v] *= inv;
+				}
+
+				// rotate: p + 2 r x (r x p + w p)
+				const float cx = ry * pz[v] - rz * py[v] + rw * px[v];
+				const float cy = rz * px[v] - rx * pz[v] + rw * py[v];
+				const float cz = rx * py[v] - ry * px[v] + rw * pz[v];
+				const float rotatedX = px[v] + 2.0f * (ry * cz - rz * cy);
+				const float rotatedY = py[v] + 2.0f * (rz * cx - rx * cz);
+				const float rotatedZ = pz[v] + 2.0f * (rx * cy - ry * cx);
+
+				// translate: 2 (w d - dw r + r x d)
+				ox[v] = rotatedX + 2.0f * (rw * dx - dw * rx + ry * dz - rz * dy);
+				oy[v] = rotatedY + 2.0f * (rw * dy - dw * ry + rz * dx - rx * dz);
+				oz[v] = rotatedZ + 2.0f * (rw * dz - dw * rz + rx * dy - ry * dx);
+			}
+
+			if (!normals)
+			{
+				continue;
+			}
+			// like the linear blend path, normals take the same transform as positions
+			const float* nx = mesh.normalX.data() + block;
+			const float* ny = mesh.normalY.data() + block;
+			const float* nz = mesh.normalZ.data() + block;
+			if (hasScale)
+			{
+				blendScale(mesh, palette, paletteSize, block, count, nx, ny, nz, scaled);
+				nx = scaled[0];
+				ny = scaled[1];
+				nz = scaled[2];
+			}
+			float* onx = out.normalX.data() + block;
+			float* ony = out.normalY.data() + block;
+			float* onz = out.normalZ.data() + block;
+			for (uint32_t v = 0; v < count; ++v)
+			{
+				const float rx = q[0][v], ry = q[1][v], rz = q[2][v], rw = q[3][v];
+				const float cx = ry * nz[v] - rz * ny[v] + rw * nx[v];
+				const float cy = rz * nx[v] - rx * nz[v] + rw * ny[v];
+				const float cz = rx * ny[v] - ry * nx[v] + rw * nz[v];
+				const float x = nx[v] + 2.0f * (ry * cz - rz * cy);
+				const float y = ny[v] + 2.0f * (rz * cx - rx * cz);
+				const float z = nz[v] + 2.0f * (rx * cy - ry * cx);
+				const float lengthSquared = x * x + y * y + z * z;
+				const float inv = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+				onx[v] = x * inv;
+				ony[v] = y * inv;
+				onz[v] = z * inv;
+			}
+		}
+	}
+
+	// A job with its palette prepared for the kernels
+	struct PreparedSkin
+	{
+		const SkinningJob* job;
+		std::vector<float> palette;
+		bool hasScale;
+		uint32_t firstChunk;
+	};
+
+	PreparedSkin prepareSkin(const SkinningJob& job, uint32_t firstChunk)
+	{
+		const uint32_t size = job.mesh->getPaletteSize();
+		PreparedSkin prepared{ &job, {}, false, firstChunk };
+		if (job.method == SkinningMethod::DualQuaternion)
+		{
+			DualQuaternionPalette palette = dualQuaternionPalette(job.palette, size);
+			prepared.palette = std::move(palette.components);
+			prepared.hasScale = palette.hasScale;
+		}
+		else
+		{
+			prepared.palette = transposeAffinePalette(job.palette, size);
+		}
+		job.output->resize(job.mesh->vertexCount, !job.mesh->normalX.empty());
+		return prepared;
+	}
+
+	void skinRange(const PreparedSkin& prepared, uint32_t begin, uint32_t end)
+	{
+		const SkinningJob& job = *prepared.job;
+		const uint32_t paletteSize = job.mesh->getPaletteSize();
+		if (job.method == SkinningMethod::DualQuaternion)
+		{
+			skinDualQuaternion(*job.mesh, prepared.palette.data(), paletteSize, prepared.hasScale, begin, end, *job.output);
+		}
+		else
+		{
+			skinLinearBlend(*job.mesh, prepared.palette.data(), paletteSize, begin, end, *job.output);
+		}
+	}
+}
+
+void SkinnedVertices::resize(size_t vertexCount, bool normals)
+{
+	positionX.resize(vertexCount);
+	positionY.resize(vertexCount);
+	positionZ.resize(vertexCount);
+	const size_t normalCount = normals ? vertexCount : 0;
+	normalX.resize(normalCount);
+	normalY.resize(normalCount);
+	normalZ.resize(normalCount);
+}
+
+void skinMesh(const SkinnedMesh& mesh, const Affine* palette, SkinningMethod method,
+	SkinnedVertices& output, JobSystem& jobSystem)
+{
+	SkinningJob job;
+	job.mesh = &mesh;
+	job.palette = palette;
+	job.method = method;
+	job.output = &output;
+	skinMeshes(&job, 1, jobSystem);
+}
+
+void skinMeshes(const SkinningJob* jobs, size_t count, JobSystem& jobSystem)
+{
+	std::vector<PreparedSkin> prepared;
+	prepared.reserve(count);
+	uint32_t chunkCount = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (jobs[i].mesh == nullptr || jobs[i].palette == nullptr || jobs[i].output == nullptr)
+		{
+			continue;
+		}
+		prepared.push_back(prepareSkin(jobs[i], chunkCount));
+		chunkCount += (jobs[i].mesh->vertexCount + kVerticesPerChunk - 1) / kVerticesPerChunk;
+	}
+
+	jobSystem.parallelFor(chunkCount, 1, [&prepared](size_t begin, size_t end)
+	{
+		for (size_t chunk = begin; chunk < end; ++chunk)
+		{
+			// the job owning this chunk is the last one starting at or before it
+			const auto owner = std::upper_bound(prepared.begin(), prepared.end(), chunk,
+				[](size_t value, const PreparedSkin& skin) { return value < skin.firstChunk; }) - 1;
+			const uint32_t first = static_cast<uint32_t>(chunk - owner->firstChunk) * kVerticesPerChunk;
+			const uint32_t last = std::min(first + kVerticesPerChunk, owner->job->mesh->vertexCount);
+			skinRange(*owner, first, last);
+		}
+	});
+}
+
+}
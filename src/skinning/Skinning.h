@@ -0,0 +1,48 @@
+#pragma once
+
+#include "SkinnedMesh.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace engine
+{
+
+class JobSystem;
+
+enum class SkinningMethod
+{
+	LinearBlend,
+	// Blends the rigid part of the bone transforms as dual quaternions, avoids
+	// the volume loss of linear blending at twisting joints. Scale and shear
+	// are split off and blended linearly.
+	DualQuaternion
+};
+
+// Skinned output streams, in the space of the mesh node
+struct SkinnedVertices
+{
+	std::vector<float> positionX, positionY, positionZ;
+	std::vector<float> normalX, normalY, normalZ;
+
+	void resize(size_t vertexCount, bool normals);
+};
+
+// Skins one mesh, the vertices are split into chunks over the job system.
+// palette holds mesh.getPaletteSize() entries, see computeBonePalette().
+void skinMesh(const SkinnedMesh& mesh, const Affine* palette, SkinningMethod method,
+	SkinnedVertices& output, JobSystem& jobSystem);
+
+struct SkinningJob
+{
+	const SkinnedMesh* mesh = nullptr;
+	const Affine* palette = nullptr;
+	SkinningMethod method = SkinningMethod::LinearBlend;
+	SkinnedVertices* output = nullptr;
+};
+
+// Skins many meshes in one parallel loop over all their vertex chunks, so many
+// small meshes keep every thread busy as well as a few large ones
+void skinMeshes(const SkinningJob* jobs, size_t count, JobSystem& jobSystem);
+
+}
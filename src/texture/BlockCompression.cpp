@@ -0,0 +1,462 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace engine
+{
+
+namespace
+{
+	// ---- BC1 ----
+
+	uint16_t packRgb565(const float color[3])
+	{
+		const int r = std::min(std::max(static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f), 0), 31);
+		const int g = std::min(std::max(static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f), 0), 63);
+		const int b = std::min(std::max(static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f), 0), 31);
+		return static_cast<uint16_t>(r << 11 | g << 5 | b);
+	}
+
+	void unpackRgb565(uint16_t packed, int color[3])
+	{
+		const int r = (packed >> 11) & 31;
+		const int g = (packed >> 5) & 63;
+		const int b = packed & 31;
+		color[0] = r << 3 | r >> 2;
+		color[1] = g << 2 | g >> 4;
+		color[2] = b << 3 | b >> 2;
+	}
+
+	// Principal axis of the texel colors by power iteration, returns false for a single color
+	bool principalAxis(const uint8_t texels[64], int channels, float mean[4], float axis[4])
+	{
+		for (int c = 0; c < channels; ++c)
+		{
+			mean[c] = 0.0f;
+			for (int i = 0; i < 16; ++i)
+			{
+				mean[c] += texels[i * 4 + c];
+			}
+			mean[c] /= 16.0f;
+		}
+
+		float covariance[4][4] = {};
+		for (int i = 0; i < 16; ++i)
+		{
+			float d[4];
+			for (int c = 0; c < channels; ++c)
+			{
+				d[c] = texels[i * 4 + c] - mean[c];
+			}
+			for (int a = 0; a < channels; ++a)
+			{
+				for (int b = a; b < channels; ++b)
+				{
+					covariance[a][b] += d[a] * d[b];
+				}
+			}
+		}
+		for (int a = 0; a < channels; ++a)
+		{
+			for (int b = 0; b < a; ++b)
+			{
+				covariance[a][b] = covariance[b][a];
+			}
+		}
+
+		for (int c = 0; c < channels; ++c)
+		{
+			axis[c] = 1.0f;
+		}
+		float length = 0.0f;
+		for (int iteration = 0; iteration < 8; ++iteration)
+		{
+			float next[4] = {};
+			for (int a = 0; a < channels; ++a)
+			{
+				for (int b = 0; b < channels; ++b)
+				{
+					next[a] += covariance[a][b] * axis[b];
+				}
+			}
+			length = 0.0f;
+			for (int c = 0; c < channels; ++c)
+			{
+				length = std::max(length, std::fabs(next[c]));
+			}
+			if (length < 1e-6f)
+			{
+				return false;
+			}
+			for (int c = 0; c < channels; ++c)
+			{
+				axis[c] = next[c] / length;
+			}
+		}
+		return true;
+	}
+
+	// Endpoints at the extreme projections of the texels onto the principal axis
+	void fitEndpoints(const uint8_t texels[64], int channels, float low[4], float high[4])
+	{
+		float mean[4], axis[4];
+		if (!principalAxis(texels, channels, mean, axis))
+		{
+			std::copy(mean, mean + channels, low);
+			std::copy(mean, mean + channels, high);
+			return;
+		}
+
+		float axisLength = 0.0f;
+		for (int c = 0; c < channels; ++c)
+		{
+			axisLength += axis[c] * axis[c];
+		}
+		float minT = 1e30f, maxT = -1e30f;
+		for (int i = 0; i < 16; ++i)
+		{
+			float t = 0.0f;
+			for (int c = 0; c < channels; ++c)
+			{
+				t += (texels[i * 4 + c] - mean[c]) * axis[c];
+			}
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+		for (int c = 0; c < channels; ++c)
+		{
+			low[c] = std::min(std::max(mean[c] + axis[c] * minT / axisLength, 0.0f), 255.0f);
+			high[c] = std::min(std::max(mean[c] + axis[c] * maxT / axisLength, 0.0f), 255.0f);
+		}
+	}
+
+	// Nearest of the four BC1 colors for every texel, returns the squared error
+	int selectBc1Indices(const uint8_t texels[64], uint16_t color0, uint16_t color1, uint8_t indices[16])
+	{
+		int palette[4][3];
+		unpackRgb565(color0, palette[0]);
+		unpackRgb565(color1, palette[1]);
+		for (int c = 0; c < 3; ++c)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		int total = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			int best = 0, bestError = INT32_MAX;
+			for (int p = 0; p < 4; ++p)
+			{
+				int error = 0;
+				for (int c = 0; c < 3; ++c)
+				{
+					const int d = texels[i * 4 + c] - palette[p][c];
+					error += d * d;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					best = p;
+				}
+			}
+			indices[i] = static_cast<uint8_t>(best);
+			total += bestError;
+		}
+		return total;
+	}
+
+	// Least squares endpoints for fixed indices, false if the system is singular
+	bool refineBc1Endpoints(const uint8_t texels[64], const uint8_t indices[16], float low[3], float high[3])
+	{
+		static const float kWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };  // of color1
+		float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+		float ax[3] = {}, bx[3] = {};
+		for (int i = 0; i < 16; ++i)
+		{
+			const float b = kWeights[indices[i]];
+			const float a = 1.0f - b;
+			aa += a * a;
+			bb += b * b;
+			ab += a * b;
+			for (int c = 0; c < 3; ++c)
+			{
+				ax[c] += a * texels[i * 4 + c];
+				bx[c] += b * texels[i * 4 + c];
+			}
+		}
+		const float determinant = aa * bb - ab * ab;
+		if (std::fabs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+		for (int c = 0; c < 3; ++c)
+		{
+			high[c] = std::min(std::max((ax[c] * bb - bx[c] * ab) / determinant, 0.0f), 255.0f);
+			low[c] = std::min(std::max((bx[c] * aa - ax[c] * ab) / determinant, 0.0f), 255.0f);
+		}
+		return true;
+	}
+
+	void writeBc1(uint16_t color0, uint16_t color1, const uint8_t indices[16], uint8_t* block)
+	{
+		// four color mode needs color0 > color1
+		uint8_t remap[4] = { 0, 1, 2, 3 };
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+			remap[0] = 1;
+			remap[1] = 0;
+			remap[2] = 3;
+			remap[3] = 2;
+		}
+
+		uint32_t bits = 0;
+		if (color0 != color1)
+		{
+			for (int i = 0; i < 16; ++i)
+			{
+				bits |= uint32_t(remap[indices[i]]) << (i * 2);
+			}
+		}
+		block[0] = static_cast<uint8_t>(color0);
+		block[1] = static_cast<uint8_t>(color0 >> 8);
+		block[2] = static_cast<uint8_t>(color1);
+		block[3] = static_cast<uint8_t>(color1 >> 8);
+		for (int i = 0; i < 4; ++i)
+		{
+			block[4 + i] = static_cast<uint8_t>(bits >> (i * 8));
+		}
+	}
+
+	void encodeBc1(const uint8_t texels[64], uint8_t* block)
+	{
+		float low[4], high[4];
+		fitEndpoints(texels, 3, low, high);
+		uint16_t color0 = packRgb565(high);
+		uint16_t color1 = packRgb565(low);
+		uint8_t indices[16];
+		int error = selectBc1Indices(texels, color0, color1, indices);
+
+		// one least squares pass, kept only if it helps
+		if (error > 0 && refineBc1Endpoints(texels, indices, low, high))
+		{
+			const uint16_t refined0 = packRgb565(high);
+			const uint16_t refined1 = packRgb565(low);
+			uint8_t refinedIndices[16];
+			const int refinedError = selectBc1Indices(texels, refined0, refined1, refinedIndices);
+			if (refinedError < error)
+			{
+				color0 = refined0;
+				color1 = refined1;
+				std::copy(refinedIndices, refinedIndices + 16, indices);
+			}
+		}
+		writeBc1(color0, color1, indices, block);
+	}
+
+	// ---- BC4, one channel ----
+
+	void encodeBc4(const uint8_t texels[64], int channel, uint8_t* block)
+	{
+		int high = 0, low = 255;
+		for (int i = 0; i < 16; ++i)
+		{
+			high = std::max(high, int(texels[i * 4 + channel]));
+			low = std::min(low, int(texels[i * 4 + channel]));
+		}
+
+		// eight value mode: index 0 is high, 1 is low, 2..7 step from high to low
+		uint64_t bits = 0;
+		if (high != low)
+		{
+			const float scale = 7.0f / float(high - low);
+			for (int i = 0; i < 16; ++i)
+			{
+				const int step = static_cast<int>((high - texels[i * 4 + channel]) * scale + 0.5f);
+				const int index = step == 0 ? 0 : step == 7 ? 1 : step + 1;
+				bits |= uint64_t(index) << (i * 3);
+			}
+		}
+		block[0] = static_cast<uint8_t>(high);
+		block[1] = static_cast<uint8_t>(low);
+		for (int i = 0; i < 6; ++i)
+		{
+			block[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+		}
+	}
+
+	// ---- BC7 mode 6: one subset, RGBA endpoints of 7 bits plus a p-bit, 4 bit indices ----
+
+	const int kBc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	struct BitWriter
+	{
+		uint8_t* bytes;
+		unsigned int position = 0;
+
+		void write(uint32_t value, unsigned int count)
+		{
+			for (unsigned int i = 0; i < count; ++i, ++position)
+			{
+				if ((value >> i) & 1)
+				{
+					bytes[position >> 3] |= static_cast<uint8_t>(1 << (position & 7));
+				}
+			}
+		}
+	};
+
+	// 7 bit endpoint and the p-bit that together come closest to the color
+	void quantizeBc7Endpoint(const float color[4], uint8_t quantized[4], uint8_t& pBit)
+	{
+		float bestError = 1e30f;
+		for (uint8_t p = 0; p < 2; ++p)
+		{
+			float error = 0.0f;
+			uint8_t candidate[4];
+			for (int c = 0; c < 4; ++c)
+			{
+				const int q = std::min(std::max(static_cast<int>((color[c] - p) * 0.5f + 0.5f), 0), 127);
+				candidate[c] = static_cast<uint8_t>(q);
+				const float d = float(q << 1 | p) - color[c];
+				error += d * d;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				pBit = p;
+				std::copy(candidate, candidate + 4, quantized);
+			}
+		}
+	}
+
+	void encodeBc7(const uint8_t texels[64], uint8_t* block)
+	{
+		float low[4], high[4];
+		fitEndpoints(texels, 4, low, high);
+
+		uint8_t endpoints[2][4], pBits[2];
+		quantizeBc7Endpoint(low, endpoints[0], pBits[0]);
+		quantizeBc7Endpoint(high, endpoints[1], pBits[1]);
+
+		int palette[16][4];
+		for (int c = 0; c < 4; ++c)
+		{
+			const int e0 = endpoints[0][c] << 1 | pBits[0];
+			const int e1 = endpoints[1][c] << 1 | pBits[1];
+			for (int w = 0; w < 16; ++w)
+			{
+				palette[w][c] = ((64 - kBc7Weights[w]) * e0 + kBc7Weights[w] * e1 + 32) >> 6;
+			}
+		}
+
+		uint8_t indices[16];
+		for (int i = 0; i < 16; ++i)
+		{
+			int best = 0, bestError = INT32_MAX;
+			for (int w = 0; w < 16; ++w)
+			{
+				int error = 0;
+				for (int c = 0; c < 4; ++c)
+				{
+					const int d = texels[i * 4 + c] - palette[w][c];
+					error += d * d;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					best = w;
+				}
+			}
+			indices[i] = static_cast<uint8_t>(best);
+		}
+
+		// the first index is stored without its top bit, flip the endpoints if it is set
+		if (indices[0] & 8)
+		{
+			std::swap(endpoints[0], endpoints[1]);
+			std::swap(pBits[0], pBits[1]);
+			for (uint8_t& index : indices)
+			{
+				index = static_cast<uint8_t>(15 - index);
+			}
+		}
+
+		std::memset(block, 0, 16);
+		BitWriter writer{ block };
+		writer.write(1 << 6, 7);
+		for (int c = 0; c < 4; ++c)
+		{
+			writer.write(endpoints[0][c], 7);
+			writer.write(endpoints[1][c], 7);
+		}
+		writer.write(pBits[0], 1);
+		writer.write(pBits[1], 1);
+		writer.write(indices[0], 3);
+		for (int i = 1; i < 16; ++i)
+		{
+			writer.write(indices[i], 4);
+		}
+	}
+}
+
+const char* getBlockFormatName(BlockFormat format)
+{
+	switch (format)
+	{
+	case BlockFormat::BC1: return "BC1";
+	case BlockFormat::BC3: return "BC3";
+	case BlockFormat::BC5: return "BC5";
+	case BlockFormat::BC7: return "BC7";
+	}
+	return "unknown";
+}
+
+void encodeBlock(BlockFormat format, const uint8_t texels[64], uint8_t* block)
+{
+	switch (format)
+	{
+	case BlockFormat::BC1:
+		encodeBc1(texels, block);
+		break;
+	case BlockFormat::BC3:
+		encodeBc4(texels, 3, block);
+		encodeBc1(texels, block + 8);
+		break;
+	case BlockFormat::BC5:
+		encodeBc4(texels, 0, block);
+		encodeBc4(texels, 1, block + 8);
+		break;
+	case BlockFormat::BC7:
+		encodeBc7(texels, block);
+		break;
+	}
+}
+
+void encodeBlockRows(BlockFormat format, const MipLevel& image, uint32_t firstRow, uint32_t lastRow, uint8_t* output)
+{
+	const uint32_t blocksX = (image.width + 3) / 4;
+	const size_t blockSize = getBlockSize(format);
+	uint8_t texels[64];
+	for (uint32_t by = firstRow; by < lastRow; ++by)
+	{
+		for (uint32_t bx = 0; bx < blocksX; ++bx)
+		{
+			for (uint32_t y = 0; y < 4; ++y)
+			{
+				const uint32_t sy = std::min(by * 4 + y, image.height - 1);
+				for (uint32_t x = 0; x < 4; ++x)
+				{
+					const uint32_t sx = std::min(bx * 4 + x, image.width - 1);
+					std::memcpy(&texels[(y * 4 + x) * 4], &image.pixels[(size_t(sy) * image.width + sx) * 4], 4);
+				}
+			}
+			encodeBlock(format, texels, output + (size_t(by) * blocksX + bx) * blockSize);
+		}
+	}
+}
+
+}
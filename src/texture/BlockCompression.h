@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+enum class BlockFormat : uint8_t
+{
+	BC1,  // RGB, 4 bpp
+	BC3,  // RGBA, BC1 color plus BC4 alpha, 8 bpp
+	BC5,  // two channels (normal map XY), two BC4 blocks, 8 bpp
+	BC7,  // RGBA, 8 bpp, higher quality than BC3
+};
+
+const char* getBlockFormatName(BlockFormat format);
+
+struct CompressedMip
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> data;  // blocks row by row
+};
+
+struct CompressedTexture
+{
+	BlockFormat format = BlockFormat::BC1;
+	bool srgb = false;
+	std::vector<CompressedMip> mips;
+};
+
+// Bytes per 4x4 block
+inline size_t getBlockSize(BlockFormat format)
+{
+	return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+inline size_t getCompressedSize(BlockFormat format, uint32_t width, uint32_t height)
+{
+	return size_t((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+}
+
+// Encodes one 4x4 block of RGBA8 texels, row by row, into getBlockSize() bytes.
+// BC5 takes its two channels from red and green.
+void encodeBlock(BlockFormat format, const uint8_t texels[64], uint8_t* block);
+
+// Encodes the block rows [firstRow, lastRow) of an RGBA8 image into output,
+// which holds the whole image's getCompressedSize() bytes. Edge blocks repeat
+// the last row and column.
+void encodeBlockRows(BlockFormat format, const MipLevel& image, uint32_t firstRow, uint32_t lastRow, uint8_t* output);
+
+}
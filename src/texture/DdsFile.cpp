@@ -0,0 +1,178 @@
+#include "DdsFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace engine
+{
+
+namespace
+{
+	constexpr uint32_t kDdsMagic = 0x20534444;  // "DDS "
+	constexpr uint32_t kDx10FourCC = 0x30315844;  // "DX10"
+
+	constexpr uint32_t kFlagCaps = 0x1;
+	constexpr uint32_t kFlagHeight = 0x2;
+	constexpr uint32_t kFlagWidth = 0x4;
+	constexpr uint32_t kFlagPixelFormat = 0x1000;
+	constexpr uint32_t kFlagMipMapCount = 0x20000;
+	constexpr uint32_t kFlagLinearSize = 0x80000;
+	constexpr uint32_t kPixelFormatFourCC = 0x4;
+	constexpr uint32_t kCapsComplex = 0x8;
+	constexpr uint32_t kCapsTexture = 0x1000;
+	constexpr uint32_t kCapsMipMap = 0x400000;
+	constexpr uint32_t kDimensionTexture2D = 3;
+
+	struct DdsPixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t rgbBitCount;
+		uint32_t masks[4];
+	};
+
+	struct DdsHeader
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		DdsPixelFormat pixelFormat;
+		uint32_t caps[4];
+		uint32_t reserved2;
+	};
+
+	struct DdsHeaderDx10
+	{
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+
+	static_assert(sizeof(DdsHeader) == 124, "DDS header layout");
+	static_assert(sizeof(DdsHeaderDx10) == 20, "DX10 header layout");
+
+	uint32_t toDxgiFormat(BlockFormat format, bool srgb)
+	{
+		switch (format)
+		{
+		case BlockFormat::BC1: return srgb ? 72 : 71;
+		case BlockFormat::BC3: return srgb ? 78 : 77;
+		case BlockFormat::BC5: return 83;
+		case BlockFormat::BC7: return srgb ? 99 : 98;
+		}
+		return 0;
+	}
+
+	bool fromDxgiFormat(uint32_t dxgiFormat, BlockFormat& format, bool& srgb)
+	{
+		switch (dxgiFormat)
+		{
+		case 71: case 72: format = BlockFormat::BC1; break;
+		case 77: case 78: format = BlockFormat::BC3; break;
+		case 83: format = BlockFormat::BC5; break;
+		case 98: case 99: format = BlockFormat::BC7; break;
+		default: return false;
+		}
+		srgb = dxgiFormat == 72 || dxgiFormat == 78 || dxgiFormat == 99;
+		return true;
+	}
+}
+
+bool writeDdsFile(const std::string& path, const CompressedTexture& texture)
+{
+	if (texture.mips.empty())
+	{
+		return false;
+	}
+
+	DdsHeader header = {};
+	header.size = sizeof(DdsHeader);
+	header.flags = kFlagCaps | kFlagHeight | kFlagWidth | kFlagPixelFormat | kFlagMipMapCount | kFlagLinearSize;
+	header.height = texture.mips[0].height;
+	header.width = texture.mips[0].width;
+	header.pitchOrLinearSize = static_cast<uint32_t>(texture.mips[0].data.size());
+	header.mipMapCount = static_cast<uint32_t>(texture.mips.size());
+	header.pixelFormat.size = sizeof(DdsPixelFormat);
+	header.pixelFormat.flags = kPixelFormatFourCC;
+	header.pixelFormat.fourCC = kDx10FourCC;
+	header.caps[0] = kCapsTexture | (texture.mips.size() > 1 ? kCapsMipMap | kCapsComplex : 0);
+
+	DdsHeaderDx10 dx10 = {};
+	dx10.dxgiFormat = toDxgiFormat(texture.format, texture.srgb);
+	dx10.resourceDimension = kDimensionTexture2D;
+	dx10.arraySize = 1;
+
+	const std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&kDdsMagic), sizeof(kDdsMagic));
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+		for (const CompressedMip& mip : texture.mips)
+		{
+			file.write(reinterpret_cast<const char*>(mip.data.data()), static_cast<std::streamsize>(mip.data.size()));
+		}
+		if (!file)
+		{
+			file.close();
+			std::remove(temporary.c_str());
+			return false;
+		}
+	}
+	std::remove(path.c_str());
+	return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool readDdsFile(const std::string& path, CompressedTexture& texture)
+{
+	std::ifstream file(path, std::ios::binary);
+	uint32_t magic = 0;
+	DdsHeader header;
+	DdsHeaderDx10 dx10;
+	if (!file.read(reinterpret_cast<char*>(&magic), sizeof(magic))
+		|| !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+	{
+		return false;
+	}
+	if (magic != kDdsMagic || header.size != sizeof(DdsHeader) || header.pixelFormat.fourCC != kDx10FourCC
+		|| !file.read(reinterpret_cast<char*>(&dx10), sizeof(dx10)))
+	{
+		return false;
+	}
+	if (!fromDxgiFormat(dx10.dxgiFormat, texture.format, texture.srgb) || header.width == 0 || header.height == 0
+		|| header.mipMapCount == 0 || header.mipMapCount > 32)
+	{
+		return false;
+	}
+
+	texture.mips.resize(header.mipMapCount);
+	uint32_t width = header.width, height = header.height;
+	for (CompressedMip& mip : texture.mips)
+	{
+		mip.width = width;
+		mip.height = height;
+		mip.data.resize(getCompressedSize(texture.format, width, height));
+		if (!file.read(reinterpret_cast<char*>(mip.data.data()), static_cast<std::streamsize>(mip.data.size())))
+		{
+			return false;
+		}
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "BlockCompression.h"
+
+#include <string>
+
+namespace engine
+{
+
+// DDS with a DX10 header, the block format as a DXGI format and all mips.
+// Writing goes through a temporary file renamed into place, so a reader never
+// sees a partially written file.
+bool writeDdsFile(const std::string& path, const CompressedTexture& texture);
+
+// Reads files written by writeDdsFile(), false for anything else or a
+// truncated file
+bool readDdsFile(const std::string& path, CompressedTexture& texture);
+
+}
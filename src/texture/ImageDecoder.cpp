@@ -0,0 +1,79 @@
+#include "ImageDecoder.h"
+
+#include "assimp/texture.h"
+
+// Private copy of the stb_image implementation: its functions are static so
+// they never collide with the one assimp may compile for its own formats.
+// Reading files is the caller's business, decoding works on memory only.
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_NO_STDIO
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_TGA
+#define STBI_ONLY_BMP
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#endif
+#include "stb_image.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <climits>
+#include <cstring>
+
+namespace engine
+{
+
+bool decodeImage(const uint8_t* data, size_t size, MipLevel& image, std::string& error)
+{
+	if (data == nullptr || size == 0 || size > size_t(INT_MAX))
+	{
+		error = "empty or oversized image";
+		return false;
+	}
+
+	int width = 0, height = 0, channels = 0;
+	stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4);
+	if (pixels == nullptr)
+	{
+		const char* reason = stbi_failure_reason();
+		error = reason != nullptr ? reason : "unknown decode error";
+		return false;
+	}
+
+	image.width = static_cast<uint32_t>(width);
+	image.height = static_cast<uint32_t>(height);
+	image.pixels.assign(pixels, pixels + size_t(width) * height * 4);
+	stbi_image_free(pixels);
+	return true;
+}
+
+bool decodeEmbeddedTexture(const aiTexture& texture, MipLevel& image, std::string& error)
+{
+	if (texture.mHeight == 0)
+	{
+		return decodeImage(reinterpret_cast<const uint8_t*>(texture.pcData), texture.mWidth, image, error);
+	}
+
+	image.width = texture.mWidth;
+	image.height = texture.mHeight;
+	const size_t count = size_t(texture.mWidth) * texture.mHeight;
+	image.pixels.resize(count * 4);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const aiTexel& texel = texture.pcData[i];
+		uint8_t* out = &image.pixels[i * 4];
+		out[0] = texel.r;
+		out[1] = texel.g;
+		out[2] = texel.b;
+		out[3] = texel.a;
+	}
+	return true;
+}
+
+}
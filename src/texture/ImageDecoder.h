@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct aiTexture;
+
+namespace engine
+{
+
+// Decodes a PNG, JPEG, TGA or BMP file held in memory into RGBA8. Safe to call
+// from several threads at once. On failure returns false and sets error.
+bool decodeImage(const uint8_t* data, size_t size, MipLevel& image, std::string& error);
+
+// Embedded texture, either a compressed blob (mHeight == 0) or raw BGRA texels
+bool decodeEmbeddedTexture(const aiTexture& texture, MipLevel& image, std::string& error);
+
+}
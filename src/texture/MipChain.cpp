@@ -0,0 +1,254 @@
+#include "MipChain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace engine
+{
+
+namespace
+{
+	// Kaiser filter support in destination pixels and its shape parameter
+	constexpr float kKaiserRadius = 1.5f;
+	constexpr float kKaiserAlpha = 4.0f;
+	constexpr float kPi = 3.14159265358979f;
+
+	constexpr int kEncodeTableSize = 4096;
+
+	struct SrgbTables
+	{
+		float decode[256];
+		uint8_t encode[kEncodeTableSize];
+
+		SrgbTables()
+		{
+			for (int i = 0; i < 256; ++i)
+			{
+				const float c = i / 255.0f;
+				decode[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			}
+			for (int i = 0; i < kEncodeTableSize; ++i)
+			{
+				const float l = i / float(kEncodeTableSize - 1);
+				const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+				encode[i] = static_cast<uint8_t>(std::lround(std::min(std::max(c, 0.0f), 1.0f) * 255.0f));
+			}
+		}
+	};
+
+	const SrgbTables& srgbTables()
+	{
+		static const SrgbTables tables;
+		return tables;
+	}
+
+	struct FloatImage
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<float> pixels;  // RGBA
+	};
+
+	// Taps of one destination pixel along an axis
+	struct FilterTaps
+	{
+		uint32_t first;
+		uint32_t count;
+		uint32_t weightBegin;
+	};
+
+	float besselI0(float x)
+	{
+		// power series, converges quickly for the small arguments used here
+		float sum = 1.0f, term = 1.0f;
+		const float quarterSquare = x * x * 0.25f;
+		for (int k = 1; k < 20; ++k)
+		{
+			term *= quarterSquare / float(k * k);
+			sum += term;
+		}
+		return sum;
+	}
+
+	float kaiserSinc(float u)
+	{
+		if (std::fabs(u) >= kKaiserRadius)
+		{
+			return 0.0f;
+		}
+		const float sinc = u == 0.0f ? 1.0f : std::sin(kPi * u) / (kPi * u);
+		const float t = u / kKaiserRadius;
+		return sinc * besselI0(kKaiserAlpha * std::sqrt(1.0f - t * t)) / besselI0(kKaiserAlpha);
+	}
+
+	// Normalized taps for resampling src texels to dst, clamped at the edges
+	void buildTaps(uint32_t src, uint32_t dst, std::vector<FilterTaps>& taps, std::vector<float>& weights)
+	{
+		const float scale = float(src) / float(dst);
+		taps.resize(dst);
+		weights.clear();
+		for (uint32_t i = 0; i < dst; ++i)
+		{
+			const float center = (i + 0.5f) * scale;
+			const int first = static_cast<int>(std::floor(center - kKaiserRadius * scale));
+			const int last = static_cast<int>(std::ceil(center + kKaiserRadius * scale));
+
+			// clamped taps fold onto the edge texels
+			const int lo = std::max(first, 0);
+			const int hi = std::min(last, int(src) - 1);
+			FilterTaps& tap = taps[i];
+			tap.first = static_cast<uint32_t>(lo);
+			tap.count = static_cast<uint32_t>(hi - lo + 1);
+			tap.weightBegin = static_cast<uint32_t>(weights.size());
+			weights.resize(weights.size() + tap.count, 0.0f);
+
+			float total = 0.0f;
+			for (int j = first; j <= last; ++j)
+			{
+				const float w = kaiserSinc((j + 0.5f - center) / scale);
+				weights[tap.weightBegin + (std::min(std::max(j, lo), hi) - lo)] += w;
+				total += w;
+			}
+			for (uint32_t k = 0; k < tap.count; ++k)
+			{
+				weights[tap.weightBegin + k] /= total;
+			}
+		}
+	}
+
+	void downsampleKaiser(const FloatImage& src, FloatImage& dst)
+	{
+		std::vector<FilterTaps> taps;
+		std::vector<float> weights;
+
+		// horizontal into dst.width x src.height
+		FloatImage wide;
+		wide.width = dst.width;
+		wide.height = src.height;
+		wide.pixels.assign(size_t(wide.width) * wide.height * 4, 0.0f);
+		buildTaps(src.width, dst.width, taps, weights);
+		for (uint32_t y = 0; y < src.height; ++y)
+		{
+			const float* in = &src.pixels[size_t(y) * src.width * 4];
+			float* out = &wide.pixels[size_t(y) * wide.width * 4];
+			for (uint32_t x = 0; x < wide.width; ++x)
+			{
+				const FilterTaps& tap = taps[x];
+				float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+				for (uint32_t k = 0; k < tap.count; ++k)
+				{
+					const float w = weights[tap.weightBegin + k];
+					const float* texel = in + size_t(tap.first + k) * 4;
+					for (int c = 0; c < 4; ++c)
+					{
+						sum[c] += w * texel[c];
+					}
+				}
+				std::copy(sum, sum + 4, out + size_t(x) * 4);
+			}
+		}
+
+		// vertical, whole rows at a time so the inner loop runs over contiguous floats
+		dst.pixels.assign(size_t(dst.width) * dst.height * 4, 0.0f);
+		buildTaps(src.height, dst.height, taps, weights);
+		const size_t rowFloats = size_t(dst.width) * 4;
+		for (uint32_t y = 0; y < dst.height; ++y)
+		{
+			float* out = &dst.pixels[y * rowFloats];
+			const FilterTaps& tap = taps[y];
+			for (uint32_t k = 0; k < tap.count; ++k)
+			{
+				const float w = weights[tap.weightBegin + k];
+				const float* in = &wide.pixels[(tap.first + k) * rowFloats];
+				for (size_t i = 0; i < rowFloats; ++i)
+				{
+					out[i] += w * in[i];
+				}
+			}
+		}
+	}
+
+	void downsampleBox(const FloatImage& src, FloatImage& dst)
+	{
+		dst.pixels.resize(size_t(dst.width) * dst.height * 4);
+		for (uint32_t y = 0; y < dst.height; ++y)
+		{
+			const uint32_t y0 = std::min(y * 2, src.height - 1);
+			const uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+			const float* row0 = &src.pixels[size_t(y0) * src.width * 4];
+			const float* row1 = &src.pixels[size_t(y1) * src.width * 4];
+			float* out = &dst.pixels[size_t(y) * dst.width * 4];
+			for (uint32_t x = 0; x < dst.width; ++x)
+			{
+				const size_t x0 = size_t(std::min(x * 2, src.width - 1)) * 4;
+				const size_t x1 = size_t(std::min(x * 2 + 1, src.width - 1)) * 4;
+				for (int c = 0; c < 4; ++c)
+				{
+					out[x * 4 + c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c]) * 0.25f;
+				}
+			}
+		}
+	}
+
+	void toFloat(const MipLevel& level, bool srgb, FloatImage& image)
+	{
+		const SrgbTables& tables = srgbTables();
+		image.width = level.width;
+		image.height = level.height;
+		image.pixels.resize(level.pixels.size());
+		for (size_t i = 0; i < level.pixels.size(); ++i)
+		{
+			const uint8_t value = level.pixels[i];
+			image.pixels[i] = srgb && (i & 3) != 3 ? tables.decode[value] : value / 255.0f;
+		}
+	}
+
+	void toBytes(const FloatImage& image, bool srgb, MipLevel& level)
+	{
+		const SrgbTables& tables = srgbTables();
+		level.width = image.width;
+		level.height = image.height;
+		level.pixels.resize(image.pixels.size());
+		for (size_t i = 0; i < image.pixels.size(); ++i)
+		{
+			const float value = std::min(std::max(image.pixels[i], 0.0f), 1.0f);
+			level.pixels[i] = srgb && (i & 3) != 3
+				? tables.encode[static_cast<int>(value * (kEncodeTableSize - 1) + 0.5f)]
+				: static_cast<uint8_t>(value * 255.0f + 0.5f);
+		}
+	}
+}
+
+void generateMipChain(Texture& texture, const MipSettings& settings)
+{
+	if (texture.mips.empty() || texture.mips[0].width == 0 || texture.mips[0].height == 0)
+	{
+		return;
+	}
+	texture.mips.resize(1);
+	texture.srgb = settings.srgb;
+
+	FloatImage current, next;
+	toFloat(texture.mips[0], settings.srgb, current);
+	while ((current.width > 1 || current.height > 1)
+		&& (settings.maxLevels == 0 || texture.mips.size() < settings.maxLevels))
+	{
+		next.width = std::max(current.width / 2, 1u);
+		next.height = std::max(current.height / 2, 1u);
+		if (settings.filter == MipFilter::Box)
+		{
+			downsampleBox(current, next);
+		}
+		else
+		{
+			downsampleKaiser(current, next);
+		}
+
+		texture.mips.emplace_back();
+		toBytes(next, settings.srgb, texture.mips.back());
+		std::swap(current, next);
+	}
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <cstdint>
+
+namespace engine
+{
+
+enum class MipFilter : uint8_t
+{
+	Box,     // 2x2 average, cheapest
+	Kaiser,  // Kaiser windowed sinc, keeps more detail and aliases less
+};
+
+struct MipSettings
+{
+	MipFilter filter = MipFilter::Kaiser;
+
+	// Filter the color channels in linear space, alpha is always linear
+	bool srgb = true;
+
+	// 0 builds the full chain down to 1x1
+	uint32_t maxLevels = 0;
+};
+
+// Replaces mips[1..] of the texture with a chain downsampled from mips[0].
+// Every level is computed from the float result of the one above, not from
+// its 8 bit version.
+void generateMipChain(Texture& texture, const MipSettings& settings);
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+// One level of a mip chain, tightly packed RGBA8 rows
+struct MipLevel
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> pixels;
+};
+
+// Decoded texture, mips[0] is the full resolution image
+struct Texture
+{
+	std::vector<MipLevel> mips;
+	bool srgb = false;
+
+	uint32_t getWidth() const { return mips.empty() ? 0 : mips[0].width; }
+	uint32_t getHeight() const { return mips.empty() ? 0 : mips[0].height; }
+
+	size_t getByteSize() const
+	{
+		size_t size = 0;
+		for (const MipLevel& mip : mips)
+		{
+			size += mip.pixels.size();
+		}
+		return size;
+	}
+};
+
+}
@@ -0,0 +1,152 @@
+#include "TextureCache.h"
+
+#include "ImageDecoder.h"
+#include "TextureReferences.h"
+#include "../core/JobSystem.h"
+
+#include <cstdint>
+#include <cstdio>
+
+namespace engine
+{
+
+namespace
+{
+	struct TextureJob
+	{
+		std::string key;
+		std::string filePath;                 // empty for embedded textures
+		const aiTexture* embedded = nullptr;
+		bool srgb = false;
+		std::shared_ptr<Texture> result;
+		std::string error;
+	};
+}
+
+TextureCache::TextureCache(const TextureSettings& settings)
+	: m_settings(settings)
+{
+}
+
+TextureLoadStats TextureCache::loadSceneTextures(const aiScene& scene, const std::string& modelDirectory,
+	SceneTextures& textures, JobSystem* jobSystem)
+{
+	m_errors.clear();
+	textures.byPath.clear();
+
+	// cache key of every referenced path
+	std::vector<TextureReference> references = collectTextureReferences(scene, modelDirectory);
+	std::vector<std::string> keys(references.size());
+	for (size_t r = 0; r < references.size(); ++r)
+	{
+		const TextureReference& reference = references[r];
+		if (reference.embedded != nullptr)
+		{
+			const uint8_t* data;
+			size_t size;
+			getEmbeddedTextureData(*reference.embedded, data, size);
+			char hash[32];
+			std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashBytes(data, size)));
+			keys[r] = std::string("embedded:") + hash;
+		}
+		else
+		{
+			keys[r] = "file:" + reference.filePath;
+		}
+		keys[r] += reference.srgb ? "#srgb" : "#linear";
+	}
+
+	// one job per texture not cached yet, the color space is part of the key
+	TextureLoadStats stats;
+	stats.requested = references.size();
+	std::vector<TextureJob> jobs;
+	std::unordered_map<std::string, size_t> jobOfKey;
+	for (size_t r = 0; r < references.size(); ++r)
+	{
+		const TextureReference& reference = references[r];
+		if (m_textures.count(keys[r]) != 0)
+		{
+			++stats.cacheHits;
+			continue;
+		}
+		if (jobOfKey.emplace(keys[r], jobs.size()).second)
+		{
+			TextureJob job;
+			job.key = keys[r];
+			job.filePath = reference.filePath;
+			job.embedded = reference.embedded;
+			job.srgb = reference.srgb;
+			jobs.push_back(std::move(job));
+		}
+	}
+
+	const JobSystem::RangeFunction decode = [this, &jobs](size_t begin, size_t end)
+	{
+		for (size_t j = begin; j < end; ++j)
+		{
+			TextureJob& job = jobs[j];
+			MipLevel image;
+			bool decoded = false;
+			if (job.embedded != nullptr)
+			{
+				decoded = decodeEmbeddedTexture(*job.embedded, image, job.error);
+			}
+			else
+			{
+				std::vector<uint8_t> data;
+				if (!readFileBytes(job.filePath, data))
+				{
+					job.error = "cannot open file";
+				}
+				else
+				{
+					decoded = decodeImage(data.data(), data.size(), image, job.error);
+				}
+			}
+			if (!decoded)
+			{
+				continue;
+			}
+
+			auto texture = std::make_shared<Texture>();
+			texture->srgb = job.srgb;
+			texture->mips.push_back(std::move(image));
+			if (m_settings.generateMips)
+			{
+				MipSettings mipSettings = m_settings.mips;
+				mipSettings.srgb = job.srgb;
+				generateMipChain(*texture, mipSettings);
+			}
+			job.result = std::move(texture);
+		}
+	};
+	if (jobSystem != nullptr)
+	{
+		jobSystem->parallelFor(jobs.size(), 1, decode);
+	}
+	else
+	{
+		decode(0, jobs.size());
+	}
+
+	for (TextureJob& job : jobs)
+	{
+		if (job.result == nullptr)
+		{
+			++stats.failed;
+			m_errors.push_back(job.key + ": " + job.error);
+			continue;
+		}
+		++stats.decoded;
+		m_textures.emplace(job.key, std::move(job.result));
+	}
+
+	for (size_t r = 0; r < references.size(); ++r)
+	{
+		const auto it = m_textures.find(keys[r]);
+		textures.byPath.emplace(references[r].path, it != m_textures.end() ? it->second : nullptr);
+	}
+	return stats;
+}
+
+}
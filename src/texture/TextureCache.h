@@ -0,0 +1,72 @@
+#pragma once
+
+#include "MipChain.h"
+#include "Texture.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct aiScene;
+
+namespace engine
+{
+
+class JobSystem;
+
+struct TextureSettings
+{
+	bool generateMips = true;
+	MipSettings mips;
+};
+
+// Textures of one scene by the path its materials use, null for failures.
+// A path used for a color and a data texture alike is decoded as sRGB.
+struct SceneTextures
+{
+	std::unordered_map<std::string, std::shared_ptr<const Texture>> byPath;
+
+	std::shared_ptr<const Texture> find(const std::string& path) const
+	{
+		const auto it = byPath.find(path);
+		return it != byPath.end() ? it->second : nullptr;
+	}
+};
+
+struct TextureLoadStats
+{
+	size_t requested = 0;  // distinct textures referenced
+	size_t decoded = 0;
+	size_t cacheHits = 0;
+	size_t failed = 0;
+};
+
+// Decoded textures shared across scenes. Files are keyed by their resolved
+// path, embedded textures by a hash of their data, so a texture referenced by
+// several materials or scenes is read, decoded and mipmapped once.
+class TextureCache
+{
+public:
+	explicit TextureCache(const TextureSettings& settings = TextureSettings());
+
+	// Reads and decodes every texture referenced by the scene's materials that
+	// is not cached yet, one job per texture. Relative paths are resolved
+	// against modelDirectory.
+	TextureLoadStats loadSceneTextures(const aiScene& scene, const std::string& modelDirectory,
+		SceneTextures& textures, JobSystem* jobSystem = nullptr);
+
+	size_t size() const { return m_textures.size(); }
+	void clear() { m_textures.clear(); }
+
+	// Failures of the last loadSceneTextures() call, one line each
+	const std::vector<std::string>& getErrors() const { return m_errors; }
+
+private:
+	TextureSettings m_settings;
+	std::unordered_map<std::string, std::shared_ptr<const Texture>> m_textures;
+	std::vector<std::string> m_errors;
+};
+
+}
@@ -0,0 +1,255 @@
+#include "TextureCooker.h"
+
+#include "DdsFile.h"
+#include "ImageDecoder.h"
+#include "TextureReferences.h"
+#include "../core/JobSystem.h"
+
+#include "assimp/texture.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+namespace engine
+{
+
+namespace
+{
+	// Bump whenever encoder output changes, old cache files are then ignored
+	constexpr uint64_t kEncoderVersion = 1;
+
+	constexpr uint32_t kBlockRowsPerTask = 8;
+
+	struct CookJob
+	{
+		const TextureReference* reference = nullptr;
+		std::string cachePath;
+		std::shared_ptr<CompressedTexture> result;
+		Texture image;
+		bool cached = false;
+		std::string error;
+	};
+
+	// Block rows [firstRow, lastRow) of one mip
+	struct EncodeTask
+	{
+		uint32_t job;
+		uint32_t mip;
+		uint32_t firstRow;
+		uint32_t lastRow;
+	};
+
+	void forEach(JobSystem* jobSystem, size_t count, const JobSystem::RangeFunction& body)
+	{
+		if (jobSystem != nullptr)
+		{
+			jobSystem->parallelFor(count, 1, body);
+		}
+		else if (count != 0)
+		{
+			body(0, count);
+		}
+	}
+
+	bool hasTranslucency(const MipLevel& image)
+	{
+		for (size_t i = 3; i < image.pixels.size(); i += 4)
+		{
+			if (image.pixels[i] != 255)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint64_t hashSettings(const CookSettings& settings, const TextureReference& reference)
+	{
+		const uint8_t values[] = {
+			static_cast<uint8_t>(kEncoderVersion),
+			static_cast<uint8_t>(settings.preferBC7),
+			static_cast<uint8_t>(settings.generateMips),
+			static_cast<uint8_t>(settings.mips.filter),
+			static_cast<uint8_t>(settings.mips.maxLevels),
+			static_cast<uint8_t>(settings.mips.maxLevels >> 8),
+			static_cast<uint8_t>(reference.srgb),
+			static_cast<uint8_t>(reference.normalMap),
+		};
+		return hashBytes(values, sizeof(values));
+	}
+}
+
+TextureCooker::TextureCooker(const CookSettings& settings)
+	: m_settings(settings)
+{
+}
+
+CookStats TextureCooker::cookSceneTextures(const aiScene& scene, const std::string& modelDirectory,
+	CookedTextures& textures, JobSystem* jobSystem)
+{
+	m_errors.clear();
+	textures.byPath.clear();
+
+	const std::vector<TextureReference> references = collectTextureReferences(scene, modelDirectory);
+	std::vector<CookJob> jobs(references.size());
+	for (size_t j = 0; j < jobs.size(); ++j)
+	{
+		jobs[j].reference = &references[j];
+	}
+	if (!m_settings.cacheDirectory.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(m_settings.cacheDirectory, error);
+	}
+
+	// read and hash the sources, load cache hits, decode the rest
+	forEach(jobSystem, jobs.size(), [this, &jobs](size_t begin, size_t end)
+	{
+		for (size_t j = begin; j < end; ++j)
+		{
+			CookJob& job = jobs[j];
+			const TextureReference& reference = *job.reference;
+
+			std::vector<uint8_t> fileData;
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			if (reference.embedded != nullptr)
+			{
+				getEmbeddedTextureData(*reference.embedded, data, size);
+			}
+			else if (readFileBytes(reference.filePath, fileData))
+			{
+				data = fileData.data();
+				size = fileData.size();
+			}
+			else
+			{
+				job.error = "cannot open " + reference.filePath;
+				continue;
+			}
+
+			if (!m_settings.cacheDirectory.empty())
+			{
+				char name[48];
+				std::snprintf(name, sizeof(name), "%016llx%016llx.dds",
+					static_cast<unsigned long long>(hashBytes(data, size)),
+					static_cast<unsigned long long>(hashSettings(m_settings, reference)));
+				job.cachePath = (std::filesystem::path(m_settings.cacheDirectory) / name).string();
+
+				auto cached = std::make_shared<CompressedTexture>();
+				if (readDdsFile(job.cachePath, *cached))
+				{
+					job.result = std::move(cached);
+					job.cached = true;
+					continue;
+				}
+			}
+
+			MipLevel image;
+			const bool decoded = reference.embedded != nullptr && reference.embedded->mHeight != 0
+				? decodeEmbeddedTexture(*reference.embedded, image, job.error)
+				: decodeImage(data, size, image, job.error);
+			if (!decoded)
+			{
+				continue;
+			}
+
+			job.image.mips.push_back(std::move(image));
+			if (m_settings.generateMips)
+			{
+				MipSettings mipSettings = m_settings.mips;
+				mipSettings.srgb = reference.srgb;
+				generateMipChain(job.image, mipSettings);
+			}
+
+			auto result = std::make_shared<CompressedTexture>();
+			result->srgb = reference.srgb && !reference.normalMap;
+			result->format = reference.normalMap ? BlockFormat::BC5
+				: m_settings.preferBC7 ? BlockFormat::BC7
+				: hasTranslucency(job.image.mips[0]) ? BlockFormat::BC3
+				: BlockFormat::BC1;
+			result->mips.resize(job.image.mips.size());
+			for (size_t m = 0; m < job.image.mips.size(); ++m)
+			{
+				const MipLevel& level = job.image.mips[m];
+				result->mips[m].width = level.width;
+				result->mips[m].height = level.height;
+				result->mips[m].data.resize(getCompressedSize(result->format, level.width, level.height));
+			}
+			job.result = std::move(result);
+		}
+	});
+
+	// encode every mip of every decoded texture in block row ranges
+	std::vector<EncodeTask> tasks;
+	for (uint32_t j = 0; j < jobs.size(); ++j)
+	{
+		if (jobs[j].result == nullptr || jobs[j].cached)
+		{
+			continue;
+		}
+		for (uint32_t m = 0; m < jobs[j].image.mips.size(); ++m)
+		{
+			const uint32_t blockRows = (jobs[j].image.mips[m].height + 3) / 4;
+			for (uint32_t row = 0; row < blockRows; row += kBlockRowsPerTask)
+			{
+				tasks.push_back({ j, m, row, std::min(row + kBlockRowsPerTask, blockRows) });
+			}
+		}
+	}
+	forEach(jobSystem, tasks.size(), [&jobs, &tasks](size_t begin, size_t end)
+	{
+		for (size_t t = begin; t < end; ++t)
+		{
+			const EncodeTask& task = tasks[t];
+			CookJob& job = jobs[task.job];
+			encodeBlockRows(job.result->format, job.image.mips[task.mip], task.firstRow, task.lastRow,
+				job.result->mips[task.mip].data.data());
+		}
+	});
+
+	// store the new results for the next run
+	forEach(jobSystem, jobs.size(), [this, &jobs](size_t begin, size_t end)
+	{
+		for (size_t j = begin; j < end; ++j)
+		{
+			CookJob& job = jobs[j];
+			if (job.result != nullptr && !job.cached && !job.cachePath.empty() && !writeDdsFile(job.cachePath, *job.result))
+			{
+				job.error = "cannot write " + job.cachePath;
+			}
+		}
+	});
+
+	CookStats stats;
+	stats.requested = jobs.size();
+	for (CookJob& job : jobs)
+	{
+		if (!job.error.empty())
+		{
+			m_errors.push_back(job.reference->path + ": " + job.error);
+		}
+		if (job.result == nullptr)
+		{
+			++stats.failed;
+		}
+		else if (job.cached)
+		{
+			++stats.cacheHits;
+		}
+		else
+		{
+			++stats.encoded;
+			stats.uncompressedBytes += job.image.getByteSize();
+			for (const CompressedMip& mip : job.result->mips)
+			{
+				stats.compressedBytes += mip.data.size();
+			}
+		}
+		textures.byPath.emplace(job.reference->path, std::move(job.result));
+	}
+	return stats;
+}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "BlockCompression.h"
+#include "MipChain.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct aiScene;
+
+namespace engine
+{
+
+class JobSystem;
+
+struct CookSettings
+{
+	// Where encoded textures are kept between runs, empty disables the cache
+	std::string cacheDirectory;
+
+	// Color and data textures as BC7, otherwise BC1 (opaque) or BC3 (with
+	// alpha). Normal maps are always BC5.
+	bool preferBC7 = true;
+
+	bool generateMips = true;
+	MipSettings mips;
+};
+
+// Block compressed textures of one scene by the path its materials use, null
+// for failures
+struct CookedTextures
+{
+	std::unordered_map<std::string, std::shared_ptr<const CompressedTexture>> byPath;
+
+	std::shared_ptr<const CompressedTexture> find(const std::string& path) const
+	{
+		const auto it = byPath.find(path);
+		return it != byPath.end() ? it->second : nullptr;
+	}
+};
+
+struct CookStats
+{
+	size_t requested = 0;
+	size_t cacheHits = 0;
+	size_t encoded = 0;
+	size_t failed = 0;
+	size_t uncompressedBytes = 0;  // RGBA8 size of the encoded textures, mips included
+	size_t compressedBytes = 0;
+};
+
+// Turns the textures of a scene into block compressed mip chains on the CPU.
+// Results are cached on disk as DDS files named after a hash of the source
+// bytes and the cook settings, so an unchanged texture is only read and
+// hashed, never decoded or encoded again. Decoding runs one job per texture,
+// encoding is split into ranges of block rows across all textures at once.
+class TextureCooker
+{
+public:
+	explicit TextureCooker(const CookSettings& settings = CookSettings());
+
+	CookStats cookSceneTextures(const aiScene& scene, const std::string& modelDirectory,
+		CookedTextures& textures, JobSystem* jobSystem = nullptr);
+
+	// Failures of the last cookSceneTextures() call, one line each
+	const std::vector<std::string>& getErrors() const { return m_errors; }
+
+private:
+	CookSettings m_settings;
+	std::vector<std::string> m_errors;
+};
+
+}
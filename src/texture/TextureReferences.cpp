@@ -0,0 +1,114 @@
+#include "TextureReferences.h"
+
+#include "assimp/material.h"
+#include "assimp/scene.h"
+
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+namespace engine
+{
+
+namespace
+{
+	bool isColorTexture(aiTextureType type)
+	{
+		switch (type)
+		{
+		case aiTextureType_DIFFUSE:
+		case aiTextureType_BASE_COLOR:
+		case aiTextureType_AMBIENT:
+		case aiTextureType_EMISSIVE:
+		case aiTextureType_EMISSION_COLOR:
+		case aiTextureType_SPECULAR:
+		case aiTextureType_SHEEN:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	std::string resolvePath(const std::string& directory, std::string path)
+	{
+		for (char& c : path)
+		{
+			c = c == '\\' ? '/' : c;
+		}
+		const bool absolute = (!path.empty() && path[0] == '/') || (path.size() > 1 && path[1] == ':');
+		if (absolute || directory.empty())
+		{
+			return path;
+		}
+		return directory.back() == '/' || directory.back() == '\\' ? directory + path : directory + "/" + path;
+	}
+}
+
+std::vector<TextureReference> collectTextureReferences(const aiScene& scene, const std::string& modelDirectory)
+{
+	std::vector<TextureReference> references;
+	std::unordered_map<std::string, size_t> referenceOfPath;
+	for (unsigned int m = 0; m < scene.mNumMaterials; ++m)
+	{
+		const aiMaterial& material = *scene.mMaterials[m];
+		for (int type = aiTextureType_NONE + 1; type <= AI_TEXTURE_TYPE_MAX; ++type)
+		{
+			const aiTextureType textureType = static_cast<aiTextureType>(type);
+			for (unsigned int i = 0; i < material.GetTextureCount(textureType); ++i)
+			{
+				aiString path;
+				if (material.GetTexture(textureType, i, &path) != aiReturn_SUCCESS || path.length == 0)
+				{
+					continue;
+				}
+
+				const auto inserted = referenceOfPath.emplace(path.C_Str(), references.size());
+				if (inserted.second)
+				{
+					TextureReference reference;
+					reference.path = path.C_Str();
+					reference.embedded = scene.GetEmbeddedTexture(path.C_Str());
+					if (reference.embedded == nullptr)
+					{
+						reference.filePath = resolvePath(modelDirectory, reference.path);
+					}
+					references.push_back(std::move(reference));
+				}
+
+				TextureReference& reference = references[inserted.first->second];
+				reference.srgb = reference.srgb || isColorTexture(textureType);
+				reference.normalMap = reference.normalMap || textureType == aiTextureType_NORMALS
+					|| textureType == aiTextureType_NORMAL_CAMERA;
+			}
+		}
+	}
+	return references;
+}
+
+void getEmbeddedTextureData(const aiTexture& texture, const uint8_t*& data, size_t& size)
+{
+	data = reinterpret_cast<const uint8_t*>(texture.pcData);
+	size = texture.mHeight == 0 ? texture.mWidth : size_t(texture.mWidth) * texture.mHeight * sizeof(aiTexel);
+}
+
+bool readFileBytes(const std::string& path, std::vector<uint8_t>& data)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t hash)
+{
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+}
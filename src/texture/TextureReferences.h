@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct aiScene;
+struct aiTexture;
+
+namespace engine
+{
+
+// A distinct texture path used by a scene's materials
+struct TextureReference
+{
+	std::string path;                     // as stored in the material
+	std::string filePath;                 // resolved file, empty for embedded textures
+	const aiTexture* embedded = nullptr;
+	bool srgb = false;       // used as a color texture by some material
+	bool normalMap = false;  // used as a normal map by some material
+};
+
+// Every distinct texture path of the scene's materials. Relative file paths
+// are resolved against modelDirectory.
+std::vector<TextureReference> collectTextureReferences(const aiScene& scene, const std::string& modelDirectory);
+
+// The bytes an embedded texture stores, compressed file or raw texels
+void getEmbeddedTextureData(const aiTexture& texture, const uint8_t*& data, size_t& size);
+
+bool readFileBytes(const std::string& path, std::vector<uint8_t>& data);
+
+// FNV-1a, continuing from hash
+uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t hash = 14695981039346656037ull);
+
+}
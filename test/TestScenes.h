@@ -0,0 +1,126 @@
+#pragma once
+
+#include "assimp/scene.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace engine
+{
+namespace test
+{
+	// Cube of the given half size around the origin: 8 shared vertices, 12 triangles
+	inline aiMesh* createCubeMesh(unsigned int material, float halfSize = 1.0f)
+	{
+		aiMesh* mesh = new aiMesh();
+		mesh->mMaterialIndex = material;
+		mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+		mesh->mNumVertices = 8;
+		mesh->mVertices = new aiVector3D[8];
+		for (unsigned int v = 0; v < 8; ++v)
+		{
+			mesh->mVertices[v] = aiVector3D(v & 1 ? halfSize : -halfSize, v & 2 ? halfSize : -halfSize, v & 4 ? halfSize : -halfSize);
+		}
+
+		static const unsigned int kIndices[36] = {
+			0, 2, 3, 0, 3, 1,  4, 5, 7, 4, 7, 6,  0, 1, 5, 0, 5, 4,
+			2, 6, 7, 2, 7, 3,  0, 4, 6, 0, 6, 2,  1, 3, 7, 1, 7, 5 };
+		mesh->mNumFaces = 12;
+		mesh->mFaces = new aiFace[12];
+		for (unsigned int f = 0; f < 12; ++f)
+		{
+			mesh->mFaces[f].mNumIndices = 3;
+			mesh->mFaces[f].mIndices = new unsigned int[3]{ kIndices[f * 3], kIndices[f * 3 + 1], kIndices[f * 3 + 2] };
+		}
+		return mesh;
+	}
+
+	// Single point, a mesh without triangles
+	inline aiMesh* createPointMesh(unsigned int material)
+	{
+		aiMesh* mesh = new aiMesh();
+		mesh->mMaterialIndex = material;
+		mesh->mPrimitiveTypes = aiPrimitiveType_POINT;
+		mesh->mNumVertices = 1;
+		mesh->mVertices = new aiVector3D[1];
+		mesh->mNumFaces = 1;
+		mesh->mFaces = new aiFace[1];
+		mesh->mFaces[0].mNumIndices = 1;
+		mesh->mFaces[0].mIndices = new unsigned int[1]{ 0 };
+		return mesh;
+	}
+
+	// Child of the scene root drawing the given meshes, placed by translation and scale
+	inline aiNode* addNode(aiScene& scene, const std::string& name, const std::vector<unsigned int>& meshes,
+		const aiVector3D& position, const aiVector3D& scale = aiVector3D(1.0f, 1.0f, 1.0f))
+	{
+		aiNode* node = new aiNode(name);
+		aiMatrix4x4 scaling;
+		aiMatrix4x4::Scaling(scale, scaling);
+		aiMatrix4x4 translation;
+		aiMatrix4x4::Translation(position, translation);
+		node->mTransformation = translation * scaling;
+		if (!meshes.empty())
+		{
+			node->mNumMeshes = static_cast<unsigned int>(meshes.size());
+			node->mMeshes = new unsigned int[meshes.size()];
+			std::copy(meshes.begin(), meshes.end(), node->mMeshes);
+		}
+		scene.mRootNode->addChildren(1, &node);
+		return node;
+	}
+
+	// Raw BGRA texture of width x height texels, a gradient over red and green with constant alpha
+	inline aiTexture* createTexture(unsigned int width, unsigned int height, uint8_t alpha = 255)
+	{
+		aiTexture* texture = new aiTexture();
+		texture->mWidth = width;
+		texture->mHeight = height;
+		texture->pcData = new aiTexel[width * height];
+		for (unsigned int y = 0; y < height; ++y)
+		{
+			for (unsigned int x = 0; x < width; ++x)
+			{
+				aiTexel& texel = texture->pcData[y * width + x];
+				texel.r = static_cast<unsigned char>(x * 255 / (width > 1 ? width - 1 : 1));
+				texel.g = static_cast<unsigned char>(y * 255 / (height > 1 ? height - 1 : 1));
+				texel.b = 64;
+				texel.a = alpha;
+			}
+		}
+		return texture;
+	}
+
+	inline void addEmbeddedTextures(aiScene& scene, const std::vector<aiTexture*>& textures)
+	{
+		scene.mNumTextures = static_cast<unsigned int>(textures.size());
+		scene.mTextures = new aiTexture*[textures.size()];
+		std::copy(textures.begin(), textures.end(), scene.mTextures);
+	}
+
+	inline void addMaterialTexture(aiMaterial& material, aiTextureType type, const char* path)
+	{
+		const aiString value(path);
+		material.AddProperty(&value, AI_MATKEY_TEXTURE(type, material.GetTextureCount(type)));
+	}
+
+	// Scene with a root node, the given meshes and materialCount default materials
+	inline aiScene* createScene(const std::vector<aiMesh*>& meshes, unsigned int materialCount)
+	{
+		aiScene* scene = new aiScene();
+		scene->mRootNode = new aiNode("root");
+		scene->mNumMeshes = static_cast<unsigned int>(meshes.size());
+		scene->mMeshes = new aiMesh*[meshes.size()];
+		std::copy(meshes.begin(), meshes.end(), scene->mMeshes);
+		scene->mNumMaterials = materialCount;
+		scene->mMaterials = new aiMaterial*[materialCount];
+		for (unsigned int i = 0; i < materialCount; ++i)
+		{
+			scene->mMaterials[i] = new aiMaterial();
+		}
+		return scene;
+	}
+}
+}
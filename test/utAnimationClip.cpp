@@ -0,0 +1,250 @@
+#include "animation/AnimationClip.h"
+#include "animation/AnimationSampler.h"
+#include "core/JobSystem.h"
+
+#include "assimp/Importer.hpp"
+#include "assimp/anim.h"
+#include "assimp/scene.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace engine;
+
+namespace
+{
+	// Key interpolation straight from the aiNodeAnim arrays with a linear search,
+	// blending rotations the same way as the sampler (shortest-arc nlerp)
+	template <class Key>
+	unsigned int findKeyLinear(const Key* keys, unsigned int count, double tick)
+	{
+		unsigned int key = 0;
+		while (key + 1 < count && keys[key + 1].mTime <= tick)
+		{
+			++key;
+		}
+		return key;
+	}
+
+	aiVector3D sampleVectorKeys(const aiVectorKey* keys, unsigned int count, double tick, float fallback)
+	{
+		if (count == 0)
+		{
+			return aiVector3D(fallback, fallback, fallback);
+		}
+		const unsigned int key = findKeyLinear(keys, count, tick);
+		if (key + 1 == count || tick <= keys[key].mTime)
+		{
+			return keys[key].mValue;
+		}
+		const double alpha = (tick - keys[key].mTime) / (keys[key + 1].mTime - keys[key].mTime);
+		return keys[key].mValue + (keys[key + 1].mValue - keys[key].mValue) * static_cast<ai_real>(alpha);
+	}
+
+	void normalize(double q[4])
+	{
+		const double length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+		for (int c = 0; c < 4; ++c)
+		{
+			q[c] /= length;
+		}
+	}
+
+	void sampleQuatKeys(const aiQuatKey* keys, unsigned int count, double tick, double q[4])
+	{
+		if (count == 0)
+		{
+			q[0] = q[1] = q[2] = 0.0;
+			q[3] = 1.0;
+			return;
+		}
+		const unsigned int key = findKeyLinear(keys, count, tick);
+		double a[4] = { keys[key].mValue.x, keys[key].mValue.y, keys[key].mValue.z, keys[key].mValue.w };
+		normalize(a);
+		if (key + 1 == count || tick <= keys[key].mTime)
+		{
+			std::copy(a, a + 4, q);
+			return;
+		}
+		double b[4] = { keys[key + 1].mValue.x, keys[key + 1].mValue.y, keys[key + 1].mValue.z, keys[key + 1].mValue.w };
+		normalize(b);
+		const double alpha = (tick - keys[key].mTime) / (keys[key + 1].mTime - keys[key].mTime);
+		const double sign = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0.0 ? -1.0 : 1.0;
+		for (int c = 0; c < 4; ++c)
+		{
+			q[c] = a[c] + (b[c] * sign - a[c]) * alpha;
+		}
+		normalize(q);
+	}
+
+	struct ClipErrors
+	{
+		double translation = 0.0;  // largest absolute component error
+		double rotation = 0.0;     // largest angle, radians
+		double scale = 0.0;
+	};
+
+	// Compares the sampled clip with the reference at evenly spread times over the clip
+	ClipErrors measureClip(const aiAnimation& animation, const AnimationClip& clip)
+	{
+		const double ticksPerSecond = animation.mTicksPerSecond > 0.0 ? animation.mTicksPerSecond : 25.0;
+		const unsigned int sampleCount = 997;
+
+		ClipErrors errors;
+		Pose pose;
+		for (unsigned int s = 0; s <= sampleCount; ++s)
+		{
+			const float time = clip.duration * static_cast<float>(s) / sampleCount;
+			sampleClip(clip, time, false, pose);
+			const double tick = static_cast<double>(time) * ticksPerSecond;
+
+			for (unsigned int c = 0; c < animation.mNumChannels; ++c)
+			{
+				const aiNodeAnim& channel = *animation.mChannels[c];
+
+				const aiVector3D t = sampleVectorKeys(channel.mPositionKeys, channel.mNumPositionKeys, tick, 0.0f);
+				errors.translation = std::max({ errors.translation, std::fabs(double(pose.translationX[c]) - t.x),
+					std::fabs(double(pose.translationY[c]) - t.y), std::fabs(double(pose.translationZ[c]) - t.z) });
+
+				const aiVector3D scale = sampleVectorKeys(channel.mScalingKeys, channel.mNumScalingKeys, tick, 1.0f);
+				errors.scale = std::max({ errors.scale, std::fabs(double(pose.scaleX[c]) - scale.x),
+					std::fabs(double(pose.scaleY[c]) - scale.y), std::fabs(double(pose.scaleZ[c]) - scale.z) });
+
+				double q[4];
+				sampleQuatKeys(channel.mRotationKeys, channel.mNumRotationKeys, tick, q);
+				const double dot = std::fabs(q[0] * pose.rotationX[c] + q[1] * pose.rotationY[c]
+					+ q[2] * pose.rotationZ[c] + q[3] * pose.rotationW[c]);
+				errors.rotation = std::max(errors.rotation, 2.0 * std::acos(std::min(dot, 1.0)));
+			}
+		}
+		return errors;
+	}
+
+	size_t sourceKeyMemory(const aiAnimation& animation)
+	{
+		size_t size = 0;
+		for (unsigned int c = 0; c < animation.mNumChannels; ++c)
+		{
+			const aiNodeAnim& channel = *animation.mChannels[c];
+			size += (channel.mNumPositionKeys + channel.mNumScalingKeys) * sizeof(aiVectorKey)
+				+ channel.mNumRotationKeys * sizeof(aiQuatKey);
+		}
+		return size;
+	}
+
+	void expectClipAccuracy(const char* file)
+	{
+		Assimp::Importer importer;
+		const aiScene* scene = importer.ReadFile(std::string(ENGINE_TEST_MODELS_DIR) + "/" + file, 0);
+		ASSERT_NE(nullptr, scene) << importer.GetErrorString();
+		ASSERT_TRUE(scene->HasAnimations());
+
+		for (unsigned int a = 0; a < scene->mNumAnimations; ++a)
+		{
+			const aiAnimation& animation = *scene->mAnimations[a];
+			const AnimationClip clip = buildAnimationClip(animation);
+			ASSERT_EQ(animation.mNumChannels, clip.getChannelCount());
+
+			// the build tolerances bound the error at the dropped keys, in between the
+			// error stays well below them on these clips. The BVH root moves by tens of
+			// units, so a few float ulps there already come to 3.4e-5.
+			const ClipErrors errors = measureClip(animation, clip);
+			EXPECT_LE(errors.translation, 4e-5) << file;
+			EXPECT_LE(errors.rotation, 1.5e-3) << file;
+			EXPECT_LE(errors.scale, 3e-5) << file;
+
+			EXPECT_LT(clip.getMemoryUsage(), sourceKeyMemory(animation)) << file;
+		}
+	}
+}
+
+TEST(utAnimationClip, bvhMatchesReference)
+{
+	expectClipAccuracy("BVH/01_01.bvh");
+}
+
+TEST(utAnimationClip, fbxMatchesReference)
+{
+	expectClipAccuracy("FBX/animation_with_skeleton.fbx");
+}
+
+TEST(utAnimationClip, keysAndLooping)
+{
+	aiNodeAnim* channel = new aiNodeAnim();
+	channel->mNodeName.Set("bone");
+	channel->mNumPositionKeys = 3;
+	channel->mPositionKeys = new aiVectorKey[3];
+	channel->mPositionKeys[0] = aiVectorKey(0.0, aiVector3D(0.0f, 0.0f, 0.0f));
+	channel->mPositionKeys[1] = aiVectorKey(10.0, aiVector3D(1.0f, 0.0f, 0.0f));
+	channel->mPositionKeys[2] = aiVectorKey(20.0, aiVector3D(1.0f, 2.0f, 0.0f));
+
+	aiAnimation animation;
+	animation.mName.Set("walk");
+	animation.mDuration = 20.0;
+	animation.mTicksPerSecond = 10.0;
+	animation.mNumChannels = 1;
+	animation.mChannels = new aiNodeAnim*[1];
+	animation.mChannels[0] = channel;
+
+	const AnimationClip clip = buildAnimationClip(animation);
+	EXPECT_EQ("walk", clip.name);
+	EXPECT_FLOAT_EQ(2.0f, clip.duration);
+	EXPECT_EQ(0, clip.findChannel("bone"));
+	EXPECT_EQ(-1, clip.findChannel("missing"));
+
+	// the corner key can't be dropped, missing rotation and scale tracks collapse to one key
+	EXPECT_EQ(3u, clip.translationTracks.times.size());
+	EXPECT_EQ(1u, clip.rotationTracks.times.size());
+	EXPECT_EQ(1u, clip.scaleTracks.times.size());
+	EXPECT_EQ(0u, clip.translationTracks.findKey(0, 0.5f));
+	EXPECT_EQ(1u, clip.translationTracks.findKey(0, 1.0f));
+	EXPECT_EQ(2u, clip.translationTracks.findKey(0, 5.0f));
+
+	Pose pose;
+	sampleClip(clip, 0.5f, false, pose);
+	EXPECT_FLOAT_EQ(0.5f, pose.translationX[0]);
+	EXPECT_FLOAT_EQ(1.0f, pose.rotationW[0]);
+	EXPECT_FLOAT_EQ(1.0f, pose.scaleY[0]);
+
+	// 2.5 s wraps to 0.5 s when looping and clamps to the end otherwise
+	sampleClip(clip, 2.5f, true, pose);
+	EXPECT_FLOAT_EQ(0.5f, pose.translationX[0]);
+	EXPECT_FLOAT_EQ(0.0f, pose.translationY[0]);
+	sampleClip(clip, 2.5f, false, pose);
+	EXPECT_FLOAT_EQ(1.0f, pose.translationX[0]);
+	EXPECT_FLOAT_EQ(2.0f, pose.translationY[0]);
+}
+
+TEST(utAnimationClip, batchedSamplingMatchesSingle)
+{
+	Assimp::Importer importer;
+	const aiScene* scene = importer.ReadFile(std::string(ENGINE_TEST_MODELS_DIR) + "/BVH/01_01.bvh", 0);
+	ASSERT_NE(nullptr, scene);
+	ASSERT_TRUE(scene->HasAnimations());
+	const AnimationClip clip = buildAnimationClip(*scene->mAnimations[0]);
+
+	const size_t count = 40;
+	std::vector<Pose> poses(count);
+	std::vector<AnimationSampleJob> jobs(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		jobs[i].clip = &clip;
+		jobs[i].time = clip.duration * static_cast<float>(i) / count;
+		jobs[i].pose = &poses[i];
+	}
+	JobSystem jobSystem(2);
+	sampleClips(jobs.data(), count, jobSystem);
+
+	Pose single;
+	for (size_t i = 0; i < count; ++i)
+	{
+		sampleClip(clip, jobs[i].time, true, single);
+		EXPECT_EQ(single.translationX, poses[i].translationX);
+		EXPECT_EQ(single.rotationW, poses[i].rotationW);
+		EXPECT_EQ(single.scaleZ, poses[i].scaleZ);
+	}
+}
@@ -0,0 +1,141 @@
+#include "TestScenes.h"
+
+#include "render/Batching.h"
+#include "render/Renderer.h"
+#include "scene/SceneGraph.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+using namespace engine;
+
+namespace
+{
+	// Mesh 0 (material 0) is drawn by three nodes, meshes 1 and 2 (material 1) by
+	// one node each, mesh 3 (material 0) is too large to merge and mesh 4 has no
+	// triangles.
+	class utBatching : public ::testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			m_scene.reset(test::createScene({ test::createCubeMesh(0), test::createCubeMesh(1), test::createCubeMesh(1, 0.5f),
+				test::createCubeMesh(0), test::createPointMesh(0) }, 2));
+			test::addNode(*m_scene, "a", { 0 }, aiVector3D(0.0f, 0.0f, 0.0f));
+			test::addNode(*m_scene, "b", { 0, 1 }, aiVector3D(10.0f, 0.0f, 0.0f));
+			test::addNode(*m_scene, "c", { 0 }, aiVector3D(20.0f, 0.0f, 0.0f));
+			test::addNode(*m_scene, "d", { 2, 4 }, aiVector3D(0.0f, 5.0f, 0.0f), aiVector3D(2.0f, 2.0f, 2.0f));
+			test::addNode(*m_scene, "e", { 3 }, aiVector3D(0.0f, 0.0f, 5.0f));
+
+			// the large mesh gets more vertices than the merge limit
+			aiMesh* large = m_scene->mMeshes[3];
+			aiVector3D* vertices = new aiVector3D[16];
+			std::copy(large->mVertices, large->mVertices + 8, vertices);
+			std::copy(large->mVertices, large->mVertices + 8, vertices + 8);
+			delete[] large->mVertices;
+			large->mVertices = vertices;
+			large->mNumVertices = 16;
+
+			m_graph = SceneGraph(*m_scene);
+			m_graph.updateWorldTransforms();
+
+			m_settings.maxMergeVertices = 8;
+		}
+
+		std::unique_ptr<aiScene> m_scene;
+		SceneGraph m_graph;
+		BatchSettings m_settings;
+	};
+}
+
+TEST_F(utBatching, instancesAndMergesDraws)
+{
+	BatchList batches;
+	buildBatches(*m_scene, m_graph, m_settings, batches);
+
+	const BatchReport& report = batches.report;
+	EXPECT_EQ(7u, report.sourceDrawCalls);
+	EXPECT_EQ(3u, report.batchedDrawCalls);
+	EXPECT_EQ(1u, report.instancedMeshes);
+	EXPECT_EQ(3u, report.instancedNodes);
+	EXPECT_EQ(2u, report.mergedMeshes);
+	EXPECT_EQ(1u, report.skippedMeshes);
+
+	ASSERT_EQ(3u, batches.batches.size());
+	const Batch& instanced = batches.batches[0];
+	EXPECT_EQ(BatchKind::Instanced, instanced.kind);
+	EXPECT_EQ(0u, instanced.material);
+	EXPECT_EQ(0u, instanced.mesh);
+	EXPECT_EQ(3u, instanced.instanceCount);
+	EXPECT_EQ(36u, instanced.indexCount);
+	const std::vector<uint32_t> nodes(batches.instanceNodes.begin() + instanced.firstInstance,
+		batches.instanceNodes.begin() + instanced.firstInstance + instanced.instanceCount);
+	const std::vector<uint32_t> expectedNodes = { static_cast<uint32_t>(m_graph.findNode("a")),
+		static_cast<uint32_t>(m_graph.findNode("b")), static_cast<uint32_t>(m_graph.findNode("c")) };
+	EXPECT_EQ(expectedNodes, nodes);
+
+	const Batch& single = batches.batches[1];
+	EXPECT_EQ(BatchKind::Single, single.kind);
+	EXPECT_EQ(3u, single.mesh);
+	EXPECT_EQ(1u, single.instanceCount);
+	EXPECT_EQ(static_cast<uint32_t>(m_graph.findNode("e")), batches.instanceNodes[single.firstInstance]);
+
+	const Batch& merged = batches.batches[2];
+	EXPECT_EQ(BatchKind::Merged, merged.kind);
+	EXPECT_EQ(1u, merged.material);
+	EXPECT_EQ(kMergedMesh, merged.mesh);
+	EXPECT_EQ(0u, merged.instanceCount);
+	EXPECT_EQ(72u, merged.indexCount);
+	EXPECT_EQ(8u + 16u, merged.vertexOffset);
+	EXPECT_EQ(8u + 16u + 16u, batches.pool.getVertexCount());
+
+	// merged vertices are baked into world space: mesh 1 at node b, then mesh 2 at node d
+	const float* positions = &batches.pool.positions[size_t(merged.vertexOffset) * 3];
+	EXPECT_FLOAT_EQ(9.0f, positions[0]);
+	EXPECT_FLOAT_EQ(-1.0f, positions[1]);
+	EXPECT_FLOAT_EQ(-1.0f, positions[8 * 3]);
+	EXPECT_FLOAT_EQ(4.0f, positions[8 * 3 + 1]);
+	EXPECT_EQ(8u, batches.pool.indices[merged.indexOffset + 36]);
+}
+
+TEST_F(utBatching, withoutMerging)
+{
+	m_settings.mergeStatic = false;
+	BatchList batches;
+	buildBatches(*m_scene, m_graph, m_settings, batches);
+
+	EXPECT_EQ(7u, batches.report.sourceDrawCalls);
+	EXPECT_EQ(4u, batches.report.batchedDrawCalls);
+	EXPECT_EQ(0u, batches.report.mergedMeshes);
+	for (const Batch& batch : batches.batches)
+	{
+		EXPECT_NE(BatchKind::Merged, batch.kind);
+	}
+}
+
+TEST_F(utBatching, submittedBatchesCountOneDrawEach)
+{
+	BatchList batches;
+	buildBatches(*m_scene, m_graph, m_settings, batches);
+
+	RecordingBackend backend;
+	Renderer renderer(backend);
+	renderer.beginFrame(FrameInfo());
+	renderer.record(batches.batches.size(), 1, [&](CommandBuffer& buffer, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			const Batch& batch = batches.batches[i];
+			buffer.draw(makeSortKey(RenderLayer::Opaque, batch.material, batch.mesh & sortkey::kFieldMask, 0.0f),
+				DrawPacket{ batch.mesh, batch.material, batch.firstInstance, batch.instanceCount == 0 ? 1u : batch.instanceCount });
+		}
+	});
+	renderer.submit();
+
+	const FrameStats& stats = backend.getFrameStats();
+	EXPECT_EQ(3u, stats.drawCalls);
+	EXPECT_EQ(5u, stats.instances);
+	EXPECT_EQ(2u, stats.materialChanges);
+	EXPECT_EQ(3u, stats.meshChanges);
+}
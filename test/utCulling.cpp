@@ -0,0 +1,136 @@
+#include "TestScenes.h"
+
+#include "core/JobSystem.h"
+#include "culling/CullingSystem.h"
+#include "culling/InstanceBounds.h"
+#include "scene/SceneGraph.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <set>
+#include <string>
+
+using namespace engine;
+
+namespace
+{
+	// Camera at the origin looking down -z with a 1 radian vertical field of view.
+	// The wall fills the middle of the screen five units ahead.
+	class utCulling : public ::testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			m_scene.reset(test::createScene({ test::createCubeMesh(0), test::createCubeMesh(1) }, 2));
+			test::addNode(*m_scene, "wall", { 0 }, aiVector3D(0.0f, 0.0f, -5.0f), aiVector3D(2.0f, 2.0f, 0.5f));
+			test::addNode(*m_scene, "hidden", { 1 }, aiVector3D(0.0f, 0.0f, -30.0f));
+			test::addNode(*m_scene, "behind camera", { 1 }, aiVector3D(0.0f, 0.0f, 5.0f));
+			test::addNode(*m_scene, "far right", { 1 }, aiVector3D(100.0f, 0.0f, -10.0f));
+			test::addNode(*m_scene, "beside wall", { 0, 1 }, aiVector3D(-19.0f, 0.0f, -40.0f));
+			test::addNode(*m_scene, "beyond far plane", { 1 }, aiVector3D(0.0f, 0.0f, -200.0f));
+
+			m_graph = SceneGraph(*m_scene);
+			m_graph.updateWorldTransforms();
+			gatherInstanceBounds(m_graph, *m_scene, m_bounds);
+
+			const float eye[3] = { 0.0f, 0.0f, 0.0f };
+			const float target[3] = { 0.0f, 0.0f, -1.0f };
+			const float up[3] = { 0.0f, 1.0f, 0.0f };
+			m_viewProjection = perspectiveMatrix(1.0f, 1.0f, 0.1f, 100.0f) * lookAtMatrix(eye, target, up);
+		}
+
+		// (node name, mesh) of every draw list item
+		std::set<std::pair<std::string, uint32_t>> visibleSet(const DrawList& drawList) const
+		{
+			std::set<std::pair<std::string, uint32_t>> visible;
+			for (const DrawItem& item : drawList.items)
+			{
+				visible.emplace(m_graph.getName(item.node), item.mesh);
+			}
+			return visible;
+		}
+
+		std::unique_ptr<aiScene> m_scene;
+		SceneGraph m_graph;
+		InstanceBounds m_bounds;
+		Matrix4 m_viewProjection;
+	};
+}
+
+TEST_F(utCulling, boundsPerMeshReference)
+{
+	ASSERT_EQ(7u, m_bounds.size());
+	const int32_t wall = m_graph.findNode("wall");
+	for (size_t i = 0; i < m_bounds.size(); ++i)
+	{
+		if (m_bounds.nodes[i] == static_cast<uint32_t>(wall))
+		{
+			EXPECT_FLOAT_EQ(-2.0f, m_bounds.minX[i]);
+			EXPECT_FLOAT_EQ(2.0f, m_bounds.maxY[i]);
+			EXPECT_FLOAT_EQ(-5.5f, m_bounds.minZ[i]);
+			EXPECT_FLOAT_EQ(-4.5f, m_bounds.maxZ[i]);
+		}
+	}
+}
+
+TEST_F(utCulling, frustumOnly)
+{
+	CullingSettings settings;
+	settings.occlusionCulling = false;
+	CullingSystem culling(settings);
+	DrawList drawList;
+	culling.cull(m_bounds, m_graph, *m_scene, m_viewProjection, drawList);
+
+	const std::set<std::pair<std::string, uint32_t>> expected = {
+		{ "wall", 0 }, { "hidden", 1 }, { "beside wall", 0 }, { "beside wall", 1 } };
+	EXPECT_EQ(expected, visibleSet(drawList));
+	EXPECT_EQ(7u, drawList.stats.instances);
+	EXPECT_EQ(4u, drawList.stats.frustumVisible);
+	EXPECT_EQ(0u, drawList.stats.occluders);
+	EXPECT_EQ(4u, drawList.stats.visible);
+}
+
+TEST_F(utCulling, wallHidesTheBoxBehindIt)
+{
+	JobSystem jobSystem(2);
+	for (JobSystem* jobs : { static_cast<JobSystem*>(nullptr), &jobSystem })
+	{
+		CullingSystem culling;
+		DrawList drawList;
+		culling.cull(m_bounds, m_graph, *m_scene, m_viewProjection, drawList, jobs);
+
+		const std::set<std::pair<std::string, uint32_t>> expected = {
+			{ "wall", 0 }, { "beside wall", 0 }, { "beside wall", 1 } };
+		EXPECT_EQ(expected, visibleSet(drawList));
+		EXPECT_EQ(4u, drawList.stats.frustumVisible);
+		EXPECT_EQ(1u, drawList.stats.occluders);
+		EXPECT_EQ(3u, drawList.stats.visible);
+
+		// items keep the instance order and carry the mesh material and view depth
+		ASSERT_EQ(3u, drawList.items.size());
+		EXPECT_EQ(std::string("wall"), m_graph.getName(drawList.items[0].node));
+		EXPECT_FLOAT_EQ(5.0f, drawList.items[0].depth);
+		EXPECT_EQ(0u, drawList.items[1].material);
+		EXPECT_EQ(1u, drawList.items[2].material);
+		EXPECT_FLOAT_EQ(40.0f, drawList.items[2].depth);
+	}
+}
+
+TEST_F(utCulling, movingTheWallUncoversTheBox)
+{
+	Affine moved = m_graph.getLocalTransform(static_cast<uint32_t>(m_graph.findNode("wall")));
+	moved.m[1][3] = 6.0f;
+	m_graph.setLocalTransform(static_cast<uint32_t>(m_graph.findNode("wall")), moved);
+	m_graph.updateWorldTransforms();
+	gatherInstanceBounds(m_graph, *m_scene, m_bounds);
+
+	CullingSystem culling;
+	DrawList drawList;
+	culling.cull(m_bounds, m_graph, *m_scene, m_viewProjection, drawList);
+
+	// the wall now sits above the view, the boxes behind its old place show
+	const std::set<std::pair<std::string, uint32_t>> expected = {
+		{ "hidden", 1 }, { "beside wall", 0 }, { "beside wall", 1 } };
+	EXPECT_EQ(expected, visibleSet(drawList));
+}
@@ -0,0 +1,86 @@
+#include "core/JobSystem.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace engine;
+
+TEST(utJobSystem, coversEveryItemOnce)
+{
+	JobSystem jobSystem(3);
+	std::vector<std::atomic<int>> visits(1000);
+	jobSystem.parallelFor(visits.size(), 7, [&](size_t begin, size_t end)
+	{
+		EXPECT_EQ(0u, begin % 7);
+		for (size_t i = begin; i < end; ++i)
+		{
+			++visits[i];
+		}
+	});
+	for (const std::atomic<int>& count : visits)
+	{
+		EXPECT_EQ(1, count.load());
+	}
+}
+
+TEST(utJobSystem, nestedLoopsRunInline)
+{
+	JobSystem jobSystem(2);
+	std::atomic<size_t> total{ 0 };
+	jobSystem.parallelFor(16, 1, [&](size_t, size_t)
+	{
+		jobSystem.parallelFor(10, 1, [&](size_t begin, size_t end)
+		{
+			total += end - begin;
+		});
+	});
+	EXPECT_EQ(160u, total.load());
+}
+
+TEST(utJobSystem, rethrowsTheFirstException)
+{
+	JobSystem jobSystem(3);
+	std::atomic<int> started{ 0 };
+	EXPECT_THROW(jobSystem.parallelFor(1000, 1, [&](size_t begin, size_t)
+	{
+		++started;
+		if (begin == 10)
+		{
+			throw std::runtime_error("chunk 10");
+		}
+	}), std::runtime_error);
+
+	// chunks handed out after the failure are skipped
+	EXPECT_LT(started.load(), 1000);
+
+	// the pool is usable again, also for nested loops that rely on the inside-loop flag
+	std::atomic<size_t> total{ 0 };
+	jobSystem.parallelFor(64, 4, [&](size_t begin, size_t end)
+	{
+		jobSystem.parallelFor(end - begin, 1, [&](size_t b, size_t e)
+		{
+			total += e - b;
+		});
+	});
+	EXPECT_EQ(64u, total.load());
+}
+
+TEST(utJobSystem, inlineLoopPropagatesException)
+{
+	// a single chunk runs on the calling thread without waking the workers
+	JobSystem jobSystem(1);
+	EXPECT_THROW(jobSystem.parallelFor(4, 8, [](size_t, size_t)
+	{
+		throw std::logic_error("inline");
+	}), std::logic_error);
+
+	std::atomic<size_t> total{ 0 };
+	jobSystem.parallelFor(4, 1, [&](size_t begin, size_t end)
+	{
+		total += end - begin;
+	});
+	EXPECT_EQ(4u, total.load());
+}
@@ -0,0 +1,121 @@
+#include "core/JobSystem.h"
+#include "culling/DrawList.h"
+#include "render/Renderer.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace engine;
+
+namespace
+{
+	DrawItem makeItem(uint32_t node, uint32_t mesh, uint32_t material, float depth)
+	{
+		return DrawItem{ node, mesh, material, depth };
+	}
+
+	// Ten items over three materials and four meshes in scrambled order; material 2 is translucent
+	DrawList createDrawList()
+	{
+		DrawList drawList;
+		drawList.items = {
+			makeItem(0, 1, 1, 4.0f),
+			makeItem(1, 0, 0, 9.0f),
+			makeItem(2, 3, 2, 2.0f),
+			makeItem(3, 0, 0, 1.0f),
+			makeItem(4, 1, 1, 3.0f),
+			makeItem(5, 2, 0, 5.0f),
+			makeItem(6, 3, 2, 8.0f),
+			makeItem(7, 0, 0, 6.0f),
+			makeItem(8, 2, 1, 7.0f),
+			makeItem(9, 3, 2, 5.0f),
+		};
+		return drawList;
+	}
+
+	std::vector<uint32_t> submittedNodes(const RecordingBackend& backend)
+	{
+		std::vector<uint32_t> nodes;
+		for (const DrawPacket& packet : backend.getPackets())
+		{
+			nodes.push_back(packet.transform);
+		}
+		return nodes;
+	}
+}
+
+TEST(utRenderer, sortsByStateAndDepth)
+{
+	RecordingBackend backend(true);
+	Renderer renderer(backend);
+	renderer.setMaterialLayers({ RenderLayer::Opaque, RenderLayer::Opaque, RenderLayer::Translucent });
+
+	renderer.beginFrame(FrameInfo());
+	renderer.recordDrawList(createDrawList());
+	EXPECT_EQ(10u, renderer.getRecordedCount());
+	renderer.submit();
+
+	// opaque by material, mesh and front to back, then translucent back to front
+	const std::vector<uint32_t> expected = { 3, 7, 1, 5, 4, 0, 8, 6, 9, 2 };
+	EXPECT_EQ(expected, submittedNodes(backend));
+
+	const FrameStats& stats = backend.getFrameStats();
+	EXPECT_EQ(10u, stats.drawCalls);
+	EXPECT_EQ(10u, stats.instances);
+	EXPECT_EQ(3u, stats.materialChanges);
+	EXPECT_EQ(5u, stats.meshChanges);
+}
+
+TEST(utRenderer, parallelRecordingKeepsTheOrder)
+{
+	const DrawList drawList = createDrawList();
+	JobSystem jobSystem(3);
+
+	RecordingBackend serialBackend(true);
+	Renderer serial(serialBackend);
+	serial.beginFrame(FrameInfo());
+	serial.record(drawList.items.size(), 3, [&](CommandBuffer& buffer, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			const DrawItem& item = drawList.items[i];
+			buffer.draw(makeSortKey(RenderLayer::Opaque, item.material, item.mesh, item.depth),
+				DrawPacket{ item.mesh, item.material, item.node, 2 });
+		}
+	});
+	serial.submit();
+
+	RecordingBackend parallelBackend(true);
+	Renderer parallel(parallelBackend);
+	parallel.beginFrame(FrameInfo());
+	parallel.record(drawList.items.size(), 3, [&](CommandBuffer& buffer, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			const DrawItem& item = drawList.items[i];
+			buffer.draw(makeSortKey(RenderLayer::Opaque, item.material, item.mesh, item.depth),
+				DrawPacket{ item.mesh, item.material, item.node, 2 });
+		}
+	}, &jobSystem);
+	parallel.submit(&jobSystem);
+
+	EXPECT_EQ(submittedNodes(serialBackend), submittedNodes(parallelBackend));
+	EXPECT_EQ(10u, parallelBackend.getFrameStats().drawCalls);
+	EXPECT_EQ(20u, parallelBackend.getFrameStats().instances);
+	EXPECT_EQ(3u, parallelBackend.getFrameStats().materialChanges);
+	EXPECT_EQ(5u, parallelBackend.getFrameStats().meshChanges);
+}
+
+TEST(utRenderer, beginFrameDropsRecordedDraws)
+{
+	RecordingBackend backend;
+	Renderer renderer(backend);
+	renderer.beginFrame(FrameInfo());
+	renderer.recordDrawList(createDrawList());
+	renderer.beginFrame(FrameInfo());
+	EXPECT_EQ(0u, renderer.getRecordedCount());
+	renderer.submit();
+	EXPECT_EQ(0u, backend.getFrameStats().drawCalls);
+	EXPECT_EQ(0u, backend.getFrameStats().materialChanges);
+}
@@ -0,0 +1,170 @@
+#include "TestScenes.h"
+
+#include "core/JobSystem.h"
+#include "scene/SceneGraph.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace engine;
+
+namespace
+{
+	// Rotation about z by a node dependent angle, a translation and a slight scale
+	aiMatrix4x4 nodeTransform(unsigned int seed)
+	{
+		aiMatrix4x4 rotation;
+		aiMatrix4x4::RotationZ(0.01f * static_cast<float>(seed % 97), rotation);
+		aiMatrix4x4 translation;
+		aiMatrix4x4::Translation(aiVector3D(static_cast<float>(seed % 7), 1.0f, -static_cast<float>(seed % 5)), translation);
+		aiMatrix4x4 scaling;
+		aiMatrix4x4::Scaling(aiVector3D(1.0f + 0.001f * static_cast<float>(seed % 3)), scaling);
+		return translation * rotation * scaling;
+	}
+
+	// Root with branchCount children, each with leafCount children, each of those
+	// with one child of its own. The two deepest levels are larger than a job
+	// system chunk of the scene graph, so their updates are split across threads.
+	aiScene* createWideScene(unsigned int branchCount, unsigned int leafCount)
+	{
+		aiScene* scene = test::createScene({}, 0);
+		unsigned int seed = 0;
+		for (unsigned int b = 0; b < branchCount; ++b)
+		{
+			aiNode* branch = new aiNode("branch" + std::to_string(b));
+			branch->mTransformation = nodeTransform(++seed);
+			for (unsigned int l = 0; l < leafCount; ++l)
+			{
+				aiNode* leaf = new aiNode("leaf" + std::to_string(seed));
+				leaf->mTransformation = nodeTransform(++seed);
+				aiNode* tip = new aiNode("tip" + std::to_string(seed));
+				tip->mTransformation = nodeTransform(++seed);
+				leaf->addChildren(1, &tip);
+				branch->addChildren(1, &leaf);
+			}
+			scene->mRootNode->addChildren(1, &branch);
+		}
+		return scene;
+	}
+
+	// World transforms of the graph's current local transforms, computed in one serial pass
+	std::vector<Affine> referenceWorldTransforms(const SceneGraph& graph)
+	{
+		const NodeHierarchy& hierarchy = graph.getHierarchy();
+		std::vector<Affine> worlds(hierarchy.size());
+		computeWorldTransforms(hierarchy, hierarchy.localTransforms.data(), worlds.data());
+		return worlds;
+	}
+
+	void expectWorldTransforms(const SceneGraph& graph, const std::vector<Affine>& expected)
+	{
+		ASSERT_EQ(expected.size(), graph.getNodeCount());
+		size_t mismatches = 0;
+		for (uint32_t i = 0; i < graph.getNodeCount(); ++i)
+		{
+			if (std::memcmp(&expected[i], &graph.getWorldTransform(i), sizeof(Affine)) != 0)
+			{
+				++mismatches;
+			}
+		}
+		EXPECT_EQ(0u, mismatches);
+	}
+
+	// Changes the local transforms of a few nodes scattered over every level
+	void editScattered(SceneGraph& graph, uint32_t stride, float offset)
+	{
+		for (uint32_t level = 0; level < graph.getLevelCount(); ++level)
+		{
+			for (uint32_t i = graph.getLevelBegin(level); i < graph.getLevelBegin(level + 1); i += stride)
+			{
+				Affine local = graph.getLocalTransform(i);
+				local.m[0][3] += offset;
+				local.m[2][3] -= offset;
+				graph.setLocalTransform(i, local);
+			}
+		}
+	}
+}
+
+TEST(utSceneGraph, emptyGraphHasNoLevels)
+{
+	SceneGraph graph;
+	EXPECT_EQ(0u, graph.getNodeCount());
+	EXPECT_EQ(0u, graph.getLevelCount());
+	EXPECT_FALSE(graph.isDirty());
+	graph.updateWorldTransforms();
+}
+
+TEST(utSceneGraph, levelsAreBreadthFirst)
+{
+	std::unique_ptr<aiScene> scene(createWideScene(3, 4));
+	const SceneGraph graph(*scene);
+
+	ASSERT_EQ(4u, graph.getLevelCount());
+	EXPECT_EQ(1u + 3u + 12u + 12u, graph.getNodeCount());
+	const uint32_t expectedSizes[4] = { 1, 3, 12, 12 };
+	for (uint32_t level = 0; level < graph.getLevelCount(); ++level)
+	{
+		EXPECT_EQ(expectedSizes[level], graph.getLevelBegin(level + 1) - graph.getLevelBegin(level));
+		for (uint32_t i = graph.getLevelBegin(level); i < graph.getLevelBegin(level + 1); ++i)
+		{
+			const int32_t parent = graph.getParent(i);
+			if (level == 0)
+			{
+				EXPECT_EQ(-1, parent);
+			}
+			else
+			{
+				EXPECT_GE(static_cast<uint32_t>(parent), graph.getLevelBegin(level - 1));
+				EXPECT_LT(static_cast<uint32_t>(parent), graph.getLevelBegin(level));
+			}
+		}
+	}
+}
+
+TEST(utSceneGraph, updateMatchesSerialReference)
+{
+	std::unique_ptr<aiScene> scene(createWideScene(4, 2500));
+	JobSystem jobSystem(3);
+
+	for (JobSystem* jobs : { static_cast<JobSystem*>(nullptr), &jobSystem })
+	{
+		SCOPED_TRACE(jobs != nullptr ? "job system" : "inline");
+		SceneGraph graph(*scene);
+		ASSERT_EQ(4u, graph.getLevelCount());
+		ASSERT_GT(graph.getLevelBegin(3) - graph.getLevelBegin(2), 4096u);
+
+		EXPECT_TRUE(graph.isDirty());
+		graph.updateWorldTransforms(jobs);
+		EXPECT_FALSE(graph.isDirty());
+		expectWorldTransforms(graph, referenceWorldTransforms(graph));
+
+		// scattered edits, below them only the edited subtrees are recomputed
+		editScattered(graph, 997, 0.5f);
+		EXPECT_TRUE(graph.isDirty());
+		graph.updateWorldTransforms(jobs);
+		EXPECT_FALSE(graph.isDirty());
+		expectWorldTransforms(graph, referenceWorldTransforms(graph));
+
+		// an edit deep down only, the levels above it are skipped
+		const uint32_t tip = graph.getLevelBegin(3) + 1234;
+		Affine local = graph.getLocalTransform(tip);
+		local.m[1][3] += 2.0f;
+		graph.setLocalTransform(tip, local);
+		graph.updateWorldTransforms(jobs);
+		EXPECT_FALSE(graph.isDirty());
+		expectWorldTransforms(graph, referenceWorldTransforms(graph));
+
+		// a root edit moves everything
+		Affine root = graph.getLocalTransform(0);
+		root.m[0][3] -= 3.0f;
+		graph.setLocalTransform(0, root);
+		graph.updateWorldTransforms(jobs);
+		EXPECT_FALSE(graph.isDirty());
+		expectWorldTransforms(graph, referenceWorldTransforms(graph));
+	}
+}
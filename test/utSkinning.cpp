@@ -0,0 +1,286 @@
+#include "animation/AnimationClip.h"
+#include "animation/AnimationSampler.h"
+#include "animation/PoseBinding.h"
+#include "core/JobSystem.h"
+#include "scene/NodeHierarchy.h"
+#include "skinning/Skinning.h"
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace engine;
+
+namespace
+{
+	// Double precision 3x4 transform for the reference path
+	struct Transform
+	{
+		double m[3][4];
+	};
+
+	Transform toTransform(const Affine& affine)
+	{
+		Transform result;
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				result.m[row][column] = affine.m[row][column];
+			}
+		}
+		return result;
+	}
+
+	Transform multiply(const Transform& a, const Transform& b)
+	{
+		Transform result;
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				result.m[row][column] = a.m[row][0] * b.m[0][column] + a.m[row][1] * b.m[1][column] + a.m[row][2] * b.m[2][column];
+			}
+			result.m[row][3] += a.m[row][3];
+		}
+		return result;
+	}
+
+	Transform invert(const Transform& a)
+	{
+		aiMatrix4x4t<double> matrix;
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				matrix[row][column] = a.m[row][column];
+			}
+		}
+		matrix.Inverse();
+		Transform result;
+		for (int row = 0; row < 3; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				result.m[row][column] = matrix[row][column];
+			}
+		}
+		return result;
+	}
+
+	struct SkinnedScene
+	{
+		Assimp::Importer importer;
+		const aiScene* scene = nullptr;
+		NodeHierarchy hierarchy;
+		std::vector<Affine> locals;
+		std::vector<Affine> worlds;
+
+		// Loads the file and poses it with its first animation part way through the clip
+		bool load(const char* file)
+		{
+			scene = importer.ReadFile(std::string(ENGINE_TEST_MODELS_DIR) + "/" + file, 0);
+			if (scene == nullptr)
+			{
+				return false;
+			}
+			hierarchy = flattenNodeHierarchy(scene->mRootNode);
+			locals = hierarchy.localTransforms;
+			if (scene->HasAnimations())
+			{
+				const AnimationClip clip = buildAnimationClip(*scene->mAnimations[0]);
+				Pose pose;
+				sampleClip(clip, clip.duration * 0.37f, false, pose);
+				applyPose(pose, bindClipToHierarchy(clip, hierarchy), locals.data());
+			}
+			worlds.resize(locals.size());
+			computeWorldTransforms(hierarchy, locals.data(), worlds.data());
+			return true;
+		}
+
+		int32_t findMeshNode(unsigned int mesh) const
+		{
+			for (uint32_t n = 0; n < hierarchy.size(); ++n)
+			{
+				const aiNode* node = hierarchy.sourceNodes[n];
+				if (std::find(node->mMeshes, node->mMeshes + node->mNumMeshes, mesh) != node->mMeshes + node->mNumMeshes)
+				{
+					return static_cast<int32_t>(n);
+				}
+			}
+			return -1;
+		}
+	};
+
+	struct SkinningErrors
+	{
+		double largest = 0.0;  // largest position error relative to the size of the mesh
+		size_t comparedVertices = 0;
+	};
+
+	// Skins every mesh of the scene and compares the positions with a double
+	// precision blend of all aiBone influences. Only vertices selected by
+	// compare (given their influence count) are measured.
+	template <class Compare>
+	SkinningErrors measureSkinning(const SkinnedScene& skinned, SkinningMethod method, Compare compare)
+	{
+		SkinningErrors errors;
+		JobSystem jobSystem(2);
+		const aiScene& scene = *skinned.scene;
+
+		std::vector<Transform> worlds(skinned.locals.size());
+		for (uint32_t n = 0; n < skinned.hierarchy.size(); ++n)
+		{
+			const Transform local = toTransform(skinned.locals[n]);
+			const int32_t parent = skinned.hierarchy.parents[n];
+			worlds[n] = parent < 0 ? local : multiply(worlds[parent], local);
+		}
+
+		for (unsigned int m = 0; m < scene.mNumMeshes; ++m)
+		{
+			const aiMesh& source = *scene.mMeshes[m];
+			if (!source.HasBones())
+			{
+				continue;
+			}
+			const int32_t meshNode = skinned.findMeshNode(m);
+			const SkinnedMesh mesh = buildSkinnedMesh(source, skinned.hierarchy, meshNode);
+
+			std::vector<Affine> palette(mesh.getPaletteSize());
+			computeBonePalette(mesh, skinned.worlds.data(), palette.data());
+			SkinnedVertices output;
+			skinMesh(mesh, palette.data(), method, output, jobSystem);
+
+			const Transform meshInverse = meshNode >= 0 ? invert(worlds[meshNode]) : toTransform(affineIdentity());
+			std::vector<double> blended(size_t(source.mNumVertices) * 3, 0.0);
+			std::vector<double> totals(source.mNumVertices, 0.0);
+			std::vector<unsigned int> influences(source.mNumVertices, 0);
+			for (unsigned int b = 0; b < source.mNumBones; ++b)
+			{
+				const aiBone& bone = *source.mBones[b];
+				const int32_t boneNode = skinned.hierarchy.findNode(bone.mName.C_Str());
+				EXPECT_GE(boneNode, 0);
+				if (boneNode < 0)
+				{
+					continue;
+				}
+				const Transform boneMatrix = multiply(multiply(meshInverse, worlds[boneNode]),
+					toTransform(affineFromMatrix(bone.mOffsetMatrix)));
+				for (unsigned int w = 0; w < bone.mNumWeights; ++w)
+				{
+					const aiVertexWeight& weight = bone.mWeights[w];
+					if (!(weight.mWeight > 0.0f))
+					{
+						continue;
+					}
+					const aiVector3D& p = source.mVertices[weight.mVertexId];
+					for (int row = 0; row < 3; ++row)
+					{
+						blended[size_t(weight.mVertexId) * 3 + row] += weight.mWeight * (boneMatrix.m[row][0] * p.x
+							+ boneMatrix.m[row][1] * p.y + boneMatrix.m[row][2] * p.z + boneMatrix.m[row][3]);
+					}
+					totals[weight.mVertexId] += weight.mWeight;
+					++influences[weight.mVertexId];
+				}
+			}
+
+			double extent = 0.0;
+			for (unsigned int v = 0; v < source.mNumVertices; ++v)
+			{
+				extent = std::max({ extent, std::fabs(double(source.mVertices[v].x)),
+					std::fabs(double(source.mVertices[v].y)), std::fabs(double(source.mVertices[v].z)) });
+			}
+			extent = std::max(extent, 1.0);
+
+			for (unsigned int v = 0; v < source.mNumVertices; ++v)
+			{
+				if (influences[v] == 0 || !compare(influences[v]))
+				{
+					continue;
+				}
+				const double reference[3] = { blended[v * 3] / totals[v], blended[v * 3 + 1] / totals[v], blended[v * 3 + 2] / totals[v] };
+				const double error = std::max({ std::fabs(output.positionX[v] - reference[0]),
+					std::fabs(output.positionY[v] - reference[1]), std::fabs(output.positionZ[v] - reference[2]) });
+				errors.largest = std::max(errors.largest, error / extent);
+				++errors.comparedVertices;
+			}
+		}
+		return errors;
+	}
+
+	void expectSkinningAccuracy(const char* file)
+	{
+		SkinnedScene skinned;
+		ASSERT_TRUE(skinned.load(file)) << skinned.importer.GetErrorString();
+
+		const SkinningErrors linear = measureSkinning(skinned, SkinningMethod::LinearBlend,
+			[](unsigned int influences) { return influences <= kMaxBoneInfluences; });
+		EXPECT_GT(linear.comparedVertices, 0u) << file;
+		EXPECT_LE(linear.largest, 1e-6) << file;
+
+		const SkinningErrors dualQuaternion = measureSkinning(skinned, SkinningMethod::DualQuaternion,
+			[](unsigned int influences) { return influences == 1; });
+		EXPECT_LE(dualQuaternion.largest, 1e-6) << file;
+	}
+}
+
+TEST(utSkinning, huesitosMatchesReference)
+{
+	expectSkinningAccuracy("FBX/huesitos.fbx");
+}
+
+TEST(utSkinning, animationWithSkeletonMatchesReference)
+{
+	expectSkinningAccuracy("FBX/animation_with_skeleton.fbx");
+}
+
+TEST(utSkinning, unweightedVerticesKeepTheirBindPosition)
+{
+	aiMesh mesh;
+	mesh.mNumVertices = 2;
+	mesh.mVertices = new aiVector3D[2];
+	mesh.mVertices[0] = aiVector3D(1.0f, 0.0f, 0.0f);
+	mesh.mVertices[1] = aiVector3D(0.0f, 2.0f, 0.0f);
+	mesh.mNumBones = 1;
+	mesh.mBones = new aiBone*[1];
+	mesh.mBones[0] = new aiBone();
+	mesh.mBones[0]->mName.Set("bone");
+	mesh.mBones[0]->mNumWeights = 1;
+	mesh.mBones[0]->mWeights = new aiVertexWeight[1];
+	mesh.mBones[0]->mWeights[0] = aiVertexWeight(0, 1.0f);
+
+	aiNode root("root");
+	aiNode* bone = new aiNode("bone");
+	root.addChildren(1, &bone);
+	const NodeHierarchy hierarchy = flattenNodeHierarchy(&root);
+
+	const SkinnedMesh skinned = buildSkinnedMesh(mesh, hierarchy, 0);
+	ASSERT_EQ(2u, skinned.getPaletteSize());
+	EXPECT_EQ(1, skinned.boneNodes[0]);
+	EXPECT_EQ(1u, skinned.influenceBones[0][1]);  // the identity entry
+
+	// the bone moves by (0, 0, 3)
+	std::vector<Affine> locals = hierarchy.localTransforms;
+	locals[1].m[2][3] = 3.0f;
+	std::vector<Affine> worlds(locals.size());
+	computeWorldTransforms(hierarchy, locals.data(), worlds.data());
+	std::vector<Affine> palette(skinned.getPaletteSize());
+	computeBonePalette(skinned, worlds.data(), palette.data());
+
+	JobSystem jobSystem(1);
+	for (SkinningMethod method : { SkinningMethod::LinearBlend, SkinningMethod::DualQuaternion })
+	{
+		SkinnedVertices output;
+		skinMesh(skinned, palette.data(), method, output, jobSystem);
+		EXPECT_FLOAT_EQ(1.0f, output.positionX[0]);
+		EXPECT_FLOAT_EQ(3.0f, output.positionZ[0]);
+		EXPECT_FLOAT_EQ(2.0f, output.positionY[1]);
+		EXPECT_FLOAT_EQ(0.0f, output.positionZ[1]);
+	}
+}
@@ -0,0 +1,112 @@
+#include "TestScenes.h"
+
+#include "core/JobSystem.h"
+#include "texture/TextureCache.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+
+using namespace engine;
+
+namespace
+{
+	const std::string kModelDirectory = ENGINE_TEST_MODELS_DIR;
+
+	// Material 0 uses an embedded color texture and a normal map file, material 1
+	// the same embedded texture and a file that doesn't exist
+	aiScene* createTexturedScene()
+	{
+		aiScene* scene = test::createScene({ test::createCubeMesh(0) }, 2);
+		test::addEmbeddedTextures(*scene, { test::createTexture(8, 8) });
+		test::addMaterialTexture(*scene->mMaterials[0], aiTextureType_DIFFUSE, "*0");
+		test::addMaterialTexture(*scene->mMaterials[0], aiTextureType_NORMALS, "glTF2/ClearCoat-glTF/RibsNormal.png");
+		test::addMaterialTexture(*scene->mMaterials[1], aiTextureType_DIFFUSE, "*0");
+		test::addMaterialTexture(*scene->mMaterials[1], aiTextureType_SPECULAR, "missing.png");
+		return scene;
+	}
+}
+
+TEST(utTextureCache, decodesEveryReferenceOnce)
+{
+	std::unique_ptr<aiScene> scene(createTexturedScene());
+	TextureCache cache;
+	SceneTextures textures;
+	const TextureLoadStats stats = cache.loadSceneTextures(*scene, kModelDirectory, textures);
+
+	EXPECT_EQ(3u, stats.requested);
+	EXPECT_EQ(2u, stats.decoded);
+	EXPECT_EQ(0u, stats.cacheHits);
+	EXPECT_EQ(1u, stats.failed);
+	EXPECT_EQ(2u, cache.size());
+	ASSERT_EQ(1u, cache.getErrors().size());
+	EXPECT_NE(std::string::npos, cache.getErrors()[0].find("missing.png"));
+
+	// raw BGRA texels come out as RGBA with a full mip chain, color textures as sRGB
+	const std::shared_ptr<const Texture> embedded = textures.find("*0");
+	ASSERT_NE(nullptr, embedded);
+	EXPECT_TRUE(embedded->srgb);
+	ASSERT_EQ(4u, embedded->mips.size());
+	EXPECT_EQ(1u, embedded->mips[3].width);
+	EXPECT_EQ(255, embedded->mips[0].pixels[7 * 4]);      // red at the right edge
+	EXPECT_EQ(0, embedded->mips[0].pixels[7 * 4 + 1]);
+	EXPECT_EQ(64, embedded->mips[0].pixels[7 * 4 + 2]);
+	EXPECT_EQ(255, embedded->mips[0].pixels[7 * 4 + 3]);
+
+	const std::shared_ptr<const Texture> normals = textures.find("glTF2/ClearCoat-glTF/RibsNormal.png");
+	ASSERT_NE(nullptr, normals);
+	EXPECT_FALSE(normals->srgb);
+	EXPECT_EQ(512u, normals->getWidth());
+	EXPECT_EQ(10u, normals->mips.size());
+
+	EXPECT_EQ(1u, textures.byPath.count("missing.png"));
+	EXPECT_EQ(nullptr, textures.find("missing.png"));
+}
+
+TEST(utTextureCache, secondSceneHitsTheCache)
+{
+	std::unique_ptr<aiScene> scene(createTexturedScene());
+	TextureCache cache;
+	SceneTextures first;
+	cache.loadSceneTextures(*scene, kModelDirectory, first);
+
+	// a different scene embedding the same texels and using the same file
+	std::unique_ptr<aiScene> other(test::createScene({ test::createCubeMesh(0) }, 1));
+	test::addEmbeddedTextures(*other, { test::createTexture(8, 8) });
+	test::addMaterialTexture(*other->mMaterials[0], aiTextureType_BASE_COLOR, "*0");
+	test::addMaterialTexture(*other->mMaterials[0], aiTextureType_NORMALS, "glTF2/ClearCoat-glTF/RibsNormal.png");
+
+	JobSystem jobSystem(2);
+	SceneTextures second;
+	const TextureLoadStats stats = cache.loadSceneTextures(*other, kModelDirectory, second, &jobSystem);
+	EXPECT_EQ(2u, stats.requested);
+	EXPECT_EQ(2u, stats.cacheHits);
+	EXPECT_EQ(0u, stats.decoded);
+	EXPECT_EQ(first.find("*0"), second.find("*0"));
+	EXPECT_EQ(first.find("glTF2/ClearCoat-glTF/RibsNormal.png"), second.find("glTF2/ClearCoat-glTF/RibsNormal.png"));
+	EXPECT_EQ(2u, cache.size());
+}
+
+TEST(utTextureCache, colorAndDataUsesAreCachedSeparately)
+{
+	TextureCache cache;
+
+	std::unique_ptr<aiScene> color(test::createScene({ test::createCubeMesh(0) }, 1));
+	test::addMaterialTexture(*color->mMaterials[0], aiTextureType_DIFFUSE, "LWO/LWO2/boxuv.png");
+	SceneTextures colorTextures;
+	cache.loadSceneTextures(*color, kModelDirectory, colorTextures);
+
+	std::unique_ptr<aiScene> data(test::createScene({ test::createCubeMesh(0) }, 1));
+	test::addMaterialTexture(*data->mMaterials[0], aiTextureType_DIFFUSE_ROUGHNESS, "LWO/LWO2/boxuv.png");
+	SceneTextures dataTextures;
+	const TextureLoadStats stats = cache.loadSceneTextures(*data, kModelDirectory, dataTextures);
+
+	EXPECT_EQ(1u, stats.decoded);
+	EXPECT_EQ(0u, stats.cacheHits);
+	EXPECT_EQ(2u, cache.size());
+	ASSERT_NE(nullptr, colorTextures.find("LWO/LWO2/boxuv.png"));
+	ASSERT_NE(nullptr, dataTextures.find("LWO/LWO2/boxuv.png"));
+	EXPECT_TRUE(colorTextures.find("LWO/LWO2/boxuv.png")->srgb);
+	EXPECT_FALSE(dataTextures.find("LWO/LWO2/boxuv.png")->srgb);
+}
@@ -0,0 +1,172 @@
+#include "TestScenes.h"
+
+#include "core/JobSystem.h"
+#include "texture/DdsFile.h"
+#include "texture/TextureCooker.h"
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace engine;
+
+namespace
+{
+	const std::string kModelDirectory = ENGINE_TEST_MODELS_DIR;
+	const char* kNormalMap = "glTF2/ClearCoat-glTF/RibsNormal.png";
+
+	// An opaque and a translucent embedded color texture, a normal map file and a
+	// file that doesn't exist
+	class utTextureCooker : public ::testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			m_scene.reset(test::createScene({ test::createCubeMesh(0) }, 2));
+			test::addEmbeddedTextures(*m_scene, { test::createTexture(8, 8), test::createTexture(6, 5, 128) });
+			test::addMaterialTexture(*m_scene->mMaterials[0], aiTextureType_DIFFUSE, "*0");
+			test::addMaterialTexture(*m_scene->mMaterials[0], aiTextureType_NORMALS, kNormalMap);
+			test::addMaterialTexture(*m_scene->mMaterials[1], aiTextureType_DIFFUSE, "*1");
+			test::addMaterialTexture(*m_scene->mMaterials[1], aiTextureType_SPECULAR, "missing.png");
+
+			m_cacheDirectory = (std::filesystem::temp_directory_path() / "engine_unit_texture_cache").string();
+			std::filesystem::remove_all(m_cacheDirectory);
+			m_settings.cacheDirectory = m_cacheDirectory;
+			m_settings.preferBC7 = false;
+		}
+
+		void TearDown() override
+		{
+			std::filesystem::remove_all(m_cacheDirectory);
+		}
+
+		size_t countCacheFiles() const
+		{
+			size_t count = 0;
+			for (const auto& entry : std::filesystem::directory_iterator(m_cacheDirectory))
+			{
+				count += entry.path().extension() == ".dds" ? 1 : 0;
+			}
+			return count;
+		}
+
+		std::unique_ptr<aiScene> m_scene;
+		std::string m_cacheDirectory;
+		CookSettings m_settings;
+	};
+}
+
+TEST_F(utTextureCooker, picksTheBlockFormatPerUse)
+{
+	TextureCooker cooker(m_settings);
+	CookedTextures textures;
+	const CookStats stats = cooker.cookSceneTextures(*m_scene, kModelDirectory, textures);
+
+	EXPECT_EQ(4u, stats.requested);
+	EXPECT_EQ(3u, stats.encoded);
+	EXPECT_EQ(0u, stats.cacheHits);
+	EXPECT_EQ(1u, stats.failed);
+	ASSERT_EQ(1u, cooker.getErrors().size());
+	EXPECT_EQ(nullptr, textures.find("missing.png"));
+
+	const std::shared_ptr<const CompressedTexture> opaque = textures.find("*0");
+	ASSERT_NE(nullptr, opaque);
+	EXPECT_EQ(BlockFormat::BC1, opaque->format);
+	EXPECT_TRUE(opaque->srgb);
+	ASSERT_EQ(4u, opaque->mips.size());
+	EXPECT_EQ(32u, opaque->mips[0].data.size());
+	EXPECT_EQ(8u, opaque->mips[3].data.size());
+
+	// 6x5 rounds up to 2x2 blocks
+	const std::shared_ptr<const CompressedTexture> translucent = textures.find("*1");
+	ASSERT_NE(nullptr, translucent);
+	EXPECT_EQ(BlockFormat::BC3, translucent->format);
+	EXPECT_EQ(64u, translucent->mips[0].data.size());
+
+	const std::shared_ptr<const CompressedTexture> normals = textures.find(kNormalMap);
+	ASSERT_NE(nullptr, normals);
+	EXPECT_EQ(BlockFormat::BC5, normals->format);
+	EXPECT_FALSE(normals->srgb);
+	EXPECT_EQ(512u, normals->mips[0].width);
+	EXPECT_EQ(size_t(128) * 128 * 16, normals->mips[0].data.size());
+
+	EXPECT_LT(stats.compressedBytes, stats.uncompressedBytes);
+	EXPECT_EQ(3u, countCacheFiles());
+}
+
+TEST_F(utTextureCooker, unchangedTexturesComeFromTheCache)
+{
+	CookedTextures first;
+	TextureCooker(m_settings).cookSceneTextures(*m_scene, kModelDirectory, first);
+
+	JobSystem jobSystem(2);
+	CookedTextures second;
+	const CookStats stats = TextureCooker(m_settings).cookSceneTextures(*m_scene, kModelDirectory, second, &jobSystem);
+	EXPECT_EQ(3u, stats.cacheHits);
+	EXPECT_EQ(0u, stats.encoded);
+	EXPECT_EQ(1u, stats.failed);
+
+	for (const char* path : { "*0", "*1", kNormalMap })
+	{
+		const std::shared_ptr<const CompressedTexture> cooked = first.find(path);
+		const std::shared_ptr<const CompressedTexture> cached = second.find(path);
+		ASSERT_NE(nullptr, cooked);
+		ASSERT_NE(nullptr, cached);
+		EXPECT_EQ(cooked->format, cached->format) << path;
+		EXPECT_EQ(cooked->srgb, cached->srgb) << path;
+		ASSERT_EQ(cooked->mips.size(), cached->mips.size()) << path;
+		for (size_t m = 0; m < cooked->mips.size(); ++m)
+		{
+			EXPECT_EQ(cooked->mips[m].data, cached->mips[m].data) << path;
+		}
+	}
+}
+
+TEST_F(utTextureCooker, otherSettingsEncodeAgain)
+{
+	CookedTextures first;
+	TextureCooker(m_settings).cookSceneTextures(*m_scene, kModelDirectory, first);
+
+	m_settings.preferBC7 = true;
+	CookedTextures second;
+	const CookStats stats = TextureCooker(m_settings).cookSceneTextures(*m_scene, kModelDirectory, second);
+	EXPECT_EQ(0u, stats.cacheHits);
+	EXPECT_EQ(3u, stats.encoded);
+	ASSERT_NE(nullptr, second.find("*0"));
+	EXPECT_EQ(BlockFormat::BC7, second.find("*0")->format);
+	EXPECT_EQ(BlockFormat::BC5, second.find(kNormalMap)->format);
+	EXPECT_EQ(6u, countCacheFiles());
+}
+
+TEST_F(utTextureCooker, ddsRoundTrip)
+{
+	CompressedTexture texture;
+	texture.format = BlockFormat::BC3;
+	texture.srgb = true;
+	texture.mips.resize(2);
+	texture.mips[0].width = 8;
+	texture.mips[0].height = 4;
+	texture.mips[0].data.assign(getCompressedSize(BlockFormat::BC3, 8, 4), 0x5a);
+	texture.mips[1].width = 4;
+	texture.mips[1].height = 2;
+	texture.mips[1].data.assign(getCompressedSize(BlockFormat::BC3, 4, 2), 0xa5);
+
+	std::filesystem::create_directories(m_cacheDirectory);
+	const std::string path = m_cacheDirectory + "/roundtrip.dds";
+	ASSERT_TRUE(writeDdsFile(path, texture));
+
+	CompressedTexture read;
+	ASSERT_TRUE(readDdsFile(path, read));
+	EXPECT_EQ(BlockFormat::BC3, read.format);
+	EXPECT_TRUE(read.srgb);
+	ASSERT_EQ(2u, read.mips.size());
+	EXPECT_EQ(4u, read.mips[1].width);
+	EXPECT_EQ(texture.mips[0].data, read.mips[0].data);
+	EXPECT_EQ(texture.mips[1].data, read.mips[1].data);
+
+	// a truncated file is rejected
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+	EXPECT_FALSE(readDdsFile(path, read));
+}
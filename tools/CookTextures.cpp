@@ -0,0 +1,92 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+
+#include "core/JobSystem.h"
+#include "texture/TextureCooker.h"
+
+// Offline texture cooking: block compresses every texture a model references
+// into the DDS cache, so the engine later only reads and hashes the sources.
+//
+//   cook-textures <model> <cache directory> [--bc1] [--box] [--no-mips]
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "usage: cook-textures <model> <cache directory> [--bc1] [--box] [--no-mips]\n"
+			<< "  --bc1      BC1/BC3 for color and data textures instead of BC7\n"
+			<< "  --box      2x2 box filter for the mips instead of Kaiser\n"
+			<< "  --no-mips  encode the top level only" << std::endl;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		printUsage();
+		return 1;
+	}
+
+	engine::CookSettings settings;
+	settings.cacheDirectory = argv[2];
+	for (int i = 3; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		if (option == "--bc1")
+		{
+			settings.preferBC7 = false;
+		}
+		else if (option == "--box")
+		{
+			settings.mips.filter = engine::MipFilter::Box;
+		}
+		else if (option == "--no-mips")
+		{
+			settings.generateMips = false;
+		}
+		else
+		{
+			std::cout << "unknown option " << option << std::endl;
+			printUsage();
+			return 1;
+		}
+	}
+
+	// only the materials and embedded textures are needed
+	Assimp::Importer importer;
+	const aiScene* scene = importer.ReadFile(argv[1], 0);
+	if (scene == nullptr)
+	{
+		std::cout << "Failed to load " << argv[1] << ": " << importer.GetErrorString() << std::endl;
+		return 1;
+	}
+
+	engine::JobSystem jobSystem;
+	engine::TextureCooker cooker(settings);
+	engine::CookedTextures textures;
+	const std::string modelDirectory = std::filesystem::path(argv[1]).parent_path().string();
+	const engine::CookStats stats = cooker.cookSceneTextures(*scene, modelDirectory, textures, &jobSystem);
+
+	for (const std::string& error : cooker.getErrors())
+	{
+		std::cout << "error: " << error << std::endl;
+	}
+	for (const auto& entry : textures.byPath)
+	{
+		if (entry.second != nullptr)
+		{
+			std::cout << entry.first << ": " << engine::getBlockFormatName(entry.second->format) << ", "
+				<< entry.second->mips.size() << " mips" << std::endl;
+		}
+	}
+	std::cout << "Cooked " << stats.requested << " textures: " << stats.encoded << " encoded, "
+		<< stats.cacheHits << " from the cache, " << stats.failed << " failed ("
+		<< stats.uncompressedBytes << " -> " << stats.compressedBytes << " bytes)" << std::endl;
+
+	return stats.failed == 0 ? 0 : 2;
+}